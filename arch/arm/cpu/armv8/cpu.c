@@ -13,6 +13,7 @@
 #include <command.h>
 #include <cpu_func.h>
 #include <irq_func.h>
+#include <smp_work.h>
 #include <asm/cache.h>
 #include <asm/system.h>
 #include <asm/secure.h>
@@ -45,6 +46,9 @@ int cleanup_before_linux(void)
 
 	board_cleanup_before_linux();
 
+	/* Hand the secondary CPUs back to firmware, so the OS can start them */
+	smp_work_stop();
+
 	disable_interrupts();
 
 	if (IS_ENABLED(CONFIG_CMO_BY_VA_ONLY)) {
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Starting and stopping ARMv8 secondary CPUs for smp_work using PSCI
+ */
+
+#define LOG_CATEGORY	LOGC_ARCH
+
+#include <cpu_func.h>
+#include <dm.h>
+#include <log.h>
+#include <smp_work.h>
+#include <time.h>
+#include <asm/armv8/mmu.h>
+#include <asm/cache.h>
+#include <asm/global_data.h>
+#include <asm/system.h>
+#include <linux/libfdt.h>
+#include <linux/psci.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Timeout for a secondary CPU to power down after it stops */
+#define CPU_OFF_TIMEOUT_MS	100
+
+/* Affinity fields of MPIDR_EL1, as used in the devicetree 'reg' property */
+#define MPIDR_HWID_MASK		0xff00ffffffULL
+
+void smp_work_secondary_entry(void);
+void smp_work_secondary_init(struct smp_work_cpu *cpu);
+
+/**
+ * find_secondary_mpidr() - Find the MPIDR of a secondary CPU
+ *
+ * This looks through the /cpus node for CPUs other than the current one
+ *
+ * @idx: Secondary CPU to find, counting from 0
+ * @mpidrp: Returns the MPIDR of the CPU
+ * Return: 0 if OK, -ENODEV if there is no such CPU
+ */
+static int find_secondary_mpidr(int idx, u64 *mpidrp)
+{
+	u64 self = read_mpidr() & MPIDR_HWID_MASK;
+	const char *type;
+	const fdt32_t *reg;
+	ofnode cpus, node;
+	u64 mpidr;
+	int len;
+
+	cpus = ofnode_path("/cpus");
+	if (!ofnode_valid(cpus))
+		return -ENODEV;
+
+	ofnode_for_each_subnode(node, cpus) {
+		type = ofnode_read_string(node, "device_type");
+		if (!type || strcmp(type, "cpu") ||
+		    !ofnode_is_enabled(node))
+			continue;
+		reg = ofnode_get_property(node, "reg", &len);
+		if (!reg || (len != sizeof(u32) && len != sizeof(u64)))
+			continue;
+		mpidr = len == sizeof(u64) ? fdt64_to_cpu(*(fdt64_t *)reg) :
+			fdt32_to_cpu(*reg);
+		if (mpidr == self)
+			continue;
+		if (!idx--) {
+			*mpidrp = mpidr;
+			return 0;
+		}
+	}
+
+	return -ENODEV;
+}
+
+void smp_work_secondary_init(struct smp_work_cpu *cpu)
+{
+	int el = current_el();
+
+	/*
+	 * Use the boot CPU's translation tables, so that both CPUs see the
+	 * same memory attributes and the caches stay coherent
+	 */
+	__asm_invalidate_tlb_all();
+	set_ttbr_tcr_mair(el, gd->arch.tlb_addr, get_tcr(NULL, NULL),
+			  MEMORY_ATTRIBUTES);
+	set_sctlr(get_sctlr() | CR_M | CR_C | CR_I);
+
+	smp_work_loop(cpu);
+
+	invoke_psci_fn(PSCI_0_2_FN_CPU_OFF, 0, 0, 0);
+}
+
+int arch_smp_work_start(struct smp_work_cpu *cpu)
+{
+	struct udevice *dev;
+	u64 mpidr;
+	long ret;
+
+	/* Secondary CPUs only share data coherently with the caches on */
+	if (!dcache_status())
+		return -ENOTSUPP;
+
+	ret = find_secondary_mpidr(cpu->idx, &mpidr);
+	if (ret)
+		return ret;
+
+	ret = uclass_get_device_by_name(UCLASS_FIRMWARE, "psci", &dev);
+	if (ret)
+		return ret;
+
+	/* The CPU reads these with its caches off, so write them back */
+	flush_dcache_range((ulong)cpu, ALIGN((ulong)(cpu + 1),
+					     ARCH_DMA_MINALIGN));
+	flush_dcache_range((ulong)cpu->gd, ALIGN((ulong)(cpu->gd + 1),
+						 ARCH_DMA_MINALIGN));
+	flush_dcache_range((ulong)cpu->stack, cpu->stack_top);
+
+	ret = invoke_psci_fn(PSCI_0_2_FN64_CPU_ON, mpidr,
+			     (ulong)smp_work_secondary_entry, (ulong)cpu);
+	if (ret) {
+		log_debug("CPU_ON for %llx failed (err=%ld)\n", mpidr, ret);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+int arch_smp_work_stop(struct smp_work_cpu *cpu)
+{
+	ulong start;
+	u64 mpidr;
+	int ret;
+
+	ret = find_secondary_mpidr(cpu->idx, &mpidr);
+	if (ret)
+		return ret;
+
+	/*
+	 * A CPU which is still ON_PENDING powers itself off with CPU_OFF as
+	 * soon as it sees the stop flag, so this covers late CPUs too
+	 */
+	start = get_timer(0);
+	while (invoke_psci_fn(PSCI_0_2_FN64_AFFINITY_INFO, mpidr, 0, 0) !=
+	       PSCI_0_2_AFFINITY_LEVEL_OFF) {
+		if (get_timer(start) > CPU_OFF_TIMEOUT_MS) {
+			log_warning("CPU %llx did not power off\n", mpidr);
+			return -ETIMEDOUT;
+		}
+	}
+
+	return 0;
+}
@@ -59,6 +59,10 @@ static void announce_and_cleanup(int fake)
 	 */
 	dm_remove_devices_flags(DM_REMOVE_ACTIVE_ALL);
 
+	/* Make sure any buffered console output has been sent */
+	if (CONFIG_IS_ENABLED(SERIAL_TX_BUFFER))
+		flush();
+
 	cleanup_before_linux();
 }
 
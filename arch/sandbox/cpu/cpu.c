@@ -10,6 +10,7 @@
 #include <errno.h>
 #include <log.h>
 #include <os.h>
+#include <profiler.h>
 #include <asm/global_data.h>
 #include <asm/io.h>
 #include <asm/malloc.h>
@@ -51,6 +52,18 @@ void __udelay(unsigned long usec)
 		os_usleep(usec);
 }
 
+#if CONFIG_IS_ENABLED(PROFILER)
+int arch_profiler_start(uint rate_hz)
+{
+	return os_profiler_start(rate_hz, profiler_sample);
+}
+
+void arch_profiler_stop(void)
+{
+	os_profiler_stop();
+}
+#endif
+
 int cleanup_before_linux(void)
 {
 	return 0;
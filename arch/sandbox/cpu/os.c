@@ -384,6 +384,113 @@ int os_setup_signal_handlers(void)
 	return 0;
 }
 
+/* Function called for each profiler sample, NULL if not profiling */
+static void (*os_prof_func)(unsigned long pc, unsigned long fp);
+
+static void os_prof_handler(int sig, siginfo_t *info, void *con)
+{
+	ucontext_t __maybe_unused *context = con;
+	unsigned long pc, fp;
+
+#if defined(__x86_64__)
+	pc = context->uc_mcontext.gregs[REG_RIP];
+	fp = context->uc_mcontext.gregs[REG_RBP];
+#elif defined(__aarch64__)
+	pc = context->uc_mcontext.pc;
+	fp = context->uc_mcontext.regs[29];
+#elif defined(__riscv)
+	pc = context->uc_mcontext.__gregs[REG_PC];
+	fp = context->uc_mcontext.__gregs[REG_S0];
+#else
+	pc = 0;
+	fp = 0;
+#endif
+	if (os_prof_func && pc)
+		os_prof_func(pc, fp);
+}
+
+int os_profiler_start(unsigned int rate_hz,
+		      void (*func)(unsigned long pc, unsigned long fp))
+{
+	struct itimerval itv;
+	struct sigaction act;
+	unsigned long usecs;
+
+	if (!rate_hz || rate_hz > 1000000)
+		return -EINVAL;
+	usecs = 1000000 / rate_hz;
+
+	os_prof_func = func;
+	act.sa_sigaction = os_prof_handler;
+	sigemptyset(&act.sa_mask);
+	act.sa_flags = SA_SIGINFO | SA_RESTART;
+	if (sigaction(SIGPROF, &act, NULL))
+		return -errno;
+
+	itv.it_interval.tv_sec = usecs / 1000000;
+	itv.it_interval.tv_usec = usecs % 1000000;
+	itv.it_value = itv.it_interval;
+	if (setitimer(ITIMER_PROF, &itv, NULL)) {
+		os_prof_func = NULL;
+		return -errno;
+	}
+
+	return 0;
+}
+
+void os_profiler_stop(void)
+{
+	struct itimerval itv;
+
+	memset(&itv, '\0', sizeof(itv));
+	setitimer(ITIMER_PROF, &itv, NULL);
+	signal(SIGPROF, SIG_IGN);
+	os_prof_func = NULL;
+}
+
+struct os_thread {
+	pthread_t tid;
+	void (*func)(void *arg);
+	void *arg;
+};
+
+static void *os_thread_func(void *ptr)
+{
+	struct os_thread *thread = ptr;
+
+	thread->func(thread->arg);
+
+	return NULL;
+}
+
+int os_thread_start(void (*func)(void *arg), void *arg, void **threadp)
+{
+	struct os_thread *thread;
+	int ret;
+
+	thread = malloc(sizeof(*thread));
+	if (!thread)
+		return -ENOMEM;
+	thread->func = func;
+	thread->arg = arg;
+	ret = pthread_create(&thread->tid, NULL, os_thread_func, thread);
+	if (ret) {
+		free(thread);
+		return -ret;
+	}
+	*threadp = thread;
+
+	return 0;
+}
+
+void os_thread_join(void *ptr)
+{
+	struct os_thread *thread = ptr;
+
+	pthread_join(thread->tid, NULL);
+	free(thread);
+}
+
 /* Put tty into raw mode so <tab> and <ctrl+c> work */
 void os_tty_raw(int fd, bool allow_sigs)
 {
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Emulation of secondary CPUs for smp_work, using host threads
+ */
+
+#include <dm.h>
+#include <os.h>
+#include <smp_work.h>
+#include <asm/global_data.h>
+#include <asm/test.h>
+#include <linux/kernel.h>
+
+/* Delay for a slow CPU, longer than smp_work waits for it to start */
+#define SLOW_START_US	200000
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static int sandbox_cpus;
+static bool sandbox_last_slow;
+static void *threads[CONFIG_SMP_WORK_MAX_CPUS];
+static int num_threads;
+
+void sandbox_smp_work_set_cpus(int count, bool last_slow)
+{
+	sandbox_cpus = min(count, CONFIG_SMP_WORK_MAX_CPUS);
+	sandbox_last_slow = last_slow;
+}
+
+int sandbox_smp_work_threads(void)
+{
+	return num_threads;
+}
+
+static void sandbox_smp_work_thread(void *arg)
+{
+	struct smp_work_cpu *cpu = arg;
+
+	if (sandbox_last_slow && cpu->idx == sandbox_cpus - 1)
+		os_usleep(SLOW_START_US);
+	gd = cpu->gd;
+	smp_work_loop(cpu);
+}
+
+int arch_smp_work_start(struct smp_work_cpu *cpu)
+{
+	int ret;
+
+	if (cpu->idx >= sandbox_cpus)
+		return -ENODEV;
+	ret = os_thread_start(sandbox_smp_work_thread, cpu,
+			      &threads[cpu->idx]);
+	if (ret)
+		return ret;
+	num_threads++;
+
+	return 0;
+}
+
+int arch_smp_work_stop(struct smp_work_cpu *cpu)
+{
+	if (!threads[cpu->idx])
+		return -ENOENT;
+
+	/* The thread exits as soon as it sees the stop flag */
+	os_thread_join(threads[cpu->idx]);
+	threads[cpu->idx] = NULL;
+	num_threads--;
+
+	return 0;
+}
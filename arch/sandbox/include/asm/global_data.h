@@ -25,6 +25,10 @@ struct arch_global_data {
 
 #include <asm-generic/global_data.h>
 
-#define DECLARE_GLOBAL_DATA_PTR     extern gd_t *gd
+/*
+ * Each host thread has its own pointer, as each CPU has on real hardware, so
+ * that emulated secondary CPUs (see SMP_WORK) can use their own global data
+ */
+#define DECLARE_GLOBAL_DATA_PTR     extern __thread gd_t *gd
 
 #endif /* __ASM_GBL_DATA_H */
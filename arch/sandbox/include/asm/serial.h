@@ -38,6 +38,15 @@ size_t sandbox_serial_written(void);
  */
 void sandbox_serial_endisable(bool enabled);
 
+/**
+ * sandbox_serial_set_busy() - Make the serial device report that it is busy
+ * @count: Number of following putc()/puts() calls which should return -EAGAIN
+ *
+ * This allows tests to check how the serial subsystem handles a UART which
+ * is not ready to accept more characters.
+ */
+void sandbox_serial_set_busy(int count);
+
 /**
  * struct sandbox_serial_priv - Private data for this driver
  *
@@ -10,6 +10,7 @@
 
 #include <pci_ids.h>
 
+struct mtd_info;
 struct unit_test_state;
 
 /* The sandbox driver always permits an I2C device with this address */
@@ -361,4 +362,52 @@ bool sandbox_sf_bootdev_enabled(void);
  */
 void sandbox_sf_set_enable_bootdevs(bool enable);
 
+/**
+ * sand_nand_fail_reads() - Make page reads fail with an uncorrectable error
+ *
+ * The data of each of the next @count pages read from the chip has one more
+ * bit error than the ECC can correct, instead of the usual random errors
+ *
+ * @mtd: MTD device for a sandbox NAND chip
+ * @count: Number of page reads to fail
+ */
+void sand_nand_fail_reads(struct mtd_info *mtd, uint count);
+
+/**
+ * sand_nand_get_cache_reads() - Get the cache-read commands seen and reset
+ *
+ * @mtd: MTD device for a sandbox NAND chip
+ * @seqsp: Returns the number of READ CACHE SEQUENTIAL commands
+ * @endsp: Returns the number of READ CACHE END commands
+ */
+void sand_nand_get_cache_reads(struct mtd_info *mtd, uint *seqsp,
+			       uint *endsp);
+
+/**
+ * sandbox_mmc_get_blocks_read() - Get the number of blocks read from an MMC
+ *
+ * @dev: Sandbox MMC device
+ * Return: number of blocks read since the device was probed
+ */
+ulong sandbox_mmc_get_blocks_read(struct udevice *dev);
+
+/**
+ * sandbox_smp_work_set_cpus() - Set the number of emulated secondary CPUs
+ *
+ * These are used by smp_work the next time it starts its workers. By default
+ * there are none, so jobs run on the boot CPU.
+ *
+ * @count: Number of secondary CPUs, each run by a host thread
+ * @last_slow: true if the last CPU should be too slow to start, so that
+ *	smp_work gives up waiting for it
+ */
+void sandbox_smp_work_set_cpus(int count, bool last_slow);
+
+/**
+ * sandbox_smp_work_threads() - Get the number of running CPU threads
+ *
+ * Return: number of threads started for smp_work which have not been joined
+ */
+int sandbox_smp_work_threads(void);
+
 #endif
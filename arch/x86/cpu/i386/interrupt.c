@@ -16,6 +16,7 @@
 #include <init.h>
 #include <irq.h>
 #include <irq_func.h>
+#include <profiler.h>
 #include <asm/control_regs.h>
 #include <asm/global_data.h>
 #include <asm/i8259.h>
@@ -313,6 +314,8 @@ void irq_llsr(struct irq_regs *regs)
 		do_exception(regs);
 	} else {
 		/* Hardware or User IRQ */
+		if (IS_ENABLED(CONFIG_PROFILER) && regs->irq_id == 0x20)
+			profiler_sample(regs->context.ctx1.eip, regs->ebp);
 		do_irq(regs->irq_id);
 	}
 }
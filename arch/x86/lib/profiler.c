@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Sample timer for the profiler, using channel 0 of the 8254 PIT
+ *
+ * The samples are taken by irq_llsr(), which has the interrupted registers.
+ * The handler installed here does nothing, but is needed so that do_irq()
+ * sends an EOI to the 8259 PIC.
+ */
+
+#include <errno.h>
+#include <irq_func.h>
+#include <profiler.h>
+#include <asm/i8254.h>
+#include <asm/ibmpc.h>
+#include <asm/io.h>
+
+static void profiler_irq(void *arg)
+{
+}
+
+int arch_profiler_start(uint rate_hz)
+{
+	uint countdown = PIT_TICK_RATE / rate_hz;
+
+	if (!countdown || countdown > 0xffff)
+		return -EINVAL;
+
+	outb(PIT_CMD_CTR0 | PIT_CMD_BOTH | PIT_CMD_MODE2,
+	     PIT_BASE + PIT_COMMAND);
+	outb(countdown & 0xff, PIT_BASE + PIT_T0);
+	outb((countdown >> 8) & 0xff, PIT_BASE + PIT_T0);
+	irq_install_handler(0, profiler_irq, NULL);
+	enable_interrupts();
+
+	return 0;
+}
+
+void arch_profiler_stop(void)
+{
+	irq_free_handler(0);
+
+	/* Mode 0 counts down once, so no more interrupts are generated */
+	outb(PIT_CMD_CTR0 | PIT_CMD_BOTH | PIT_CMD_MODE0,
+	     PIT_BASE + PIT_COMMAND);
+}
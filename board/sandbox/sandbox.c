@@ -29,7 +29,7 @@
  *
  * Here we initialize it.
  */
-gd_t *gd;
+__thread gd_t *gd;
 
 #if IS_ENABLED(CONFIG_EFI_HAVE_CAPSULE_SUPPORT)
 struct efi_fw_image fw_images[] = {
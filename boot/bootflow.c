@@ -6,6 +6,7 @@
 
 #define LOG_CATEGORY UCLASS_BOOTSTD
 
+#include <blk.h>
 #include <bootdev.h>
 #include <bootflow.h>
 #include <bootmeth.h>
@@ -13,9 +14,12 @@
 #include <dm.h>
 #include <env_internal.h>
 #include <malloc.h>
+#include <mapmem.h>
 #include <serial.h>
 #include <dm/device-internal.h>
 #include <dm/uclass-internal.h>
+#include <linux/sizes.h>
+#include <u-boot/crc.h>
 
 /* error codes used to signal running out of things */
 enum {
@@ -484,6 +488,200 @@ void bootflow_remove(struct bootflow *bflow)
 	free(bflow);
 }
 
+#if CONFIG_IS_ENABLED(BOOTSTD_FILE_CACHE)
+/* Largest file copied into the file cache, enough for scripts and configs */
+#define BOOTFLOW_CACHE_COPY_MAX		SZ_64K
+
+/* Largest file whose address is kept in the file cache, e.g. a device tree */
+#define BOOTFLOW_CACHE_ADDR_MAX		SZ_4M
+
+/**
+ * struct bootflow_cache_entry - A file read by a bootmeth
+ *
+ * @lh: Link in the list of cached files
+ * @uclass_id: Uclass of the block device the file was read from
+ * @devnum: Device number of the block device
+ * @hwpart: Hardware partition selected when the file was read
+ * @part: Partition number the file was read from
+ * @path: Path of the file (allocated)
+ * @size: Size of the file in bytes
+ * @buf: Copy of the file (allocated), or NULL if only its address is kept
+ * @addr: Address the file was read to, if @buf is NULL
+ * @crc: CRC32 of the file, if @buf is NULL
+ */
+struct bootflow_cache_entry {
+	struct list_head lh;
+	enum uclass_id uclass_id;
+	int devnum;
+	int hwpart;
+	int part;
+	char *path;
+	ulong size;
+	void *buf;
+	ulong addr;
+	u32 crc;
+};
+
+static LIST_HEAD(bootflow_cache);
+
+static struct bootflow_cache_stats cache_stats;
+
+static struct bootflow_cache_entry *bootflow_cache_find(struct bootflow *bflow,
+							const char *path,
+							ulong size)
+{
+	struct bootflow_cache_entry *entry;
+	struct blk_desc *desc;
+
+	/* Only block devices tell us when they are written */
+	if (!bflow->blk)
+		return NULL;
+	desc = dev_get_uclass_plat(bflow->blk);
+
+	list_for_each_entry(entry, &bootflow_cache, lh) {
+		if (entry->uclass_id == desc->uclass_id &&
+		    entry->devnum == desc->devnum &&
+		    entry->hwpart == desc->hwpart &&
+		    entry->part == bflow->part && entry->size == size &&
+		    !strcmp(entry->path, path))
+			return entry;
+	}
+
+	return NULL;
+}
+
+static void bootflow_cache_drop(struct bootflow_cache_entry *entry)
+{
+	list_del(&entry->lh);
+	free(entry->path);
+	free(entry->buf);
+	free(entry);
+	cache_stats.entries--;
+}
+
+static u32 bootflow_cache_crc(ulong addr, ulong size)
+{
+	void *buf = map_sysmem(addr, size);
+	u32 crc;
+
+	crc = crc32(0, buf, size);
+	unmap_sysmem(buf);
+
+	return crc;
+}
+
+int bootflow_cache_get(struct bootflow *bflow, const char *path, ulong size,
+		       ulong addr)
+{
+	struct bootflow_cache_entry *entry;
+	void *buf;
+
+	entry = bootflow_cache_find(bflow, path, size);
+	if (entry && !entry->buf) {
+		/* Something else may have been loaded over it since */
+		if (entry->addr != addr) {
+			entry = NULL;
+		} else if (bootflow_cache_crc(addr, size) != entry->crc) {
+			bootflow_cache_drop(entry);
+			entry = NULL;
+		}
+	}
+	if (!entry) {
+		cache_stats.misses++;
+		return -ENOENT;
+	}
+
+	if (entry->buf) {
+		buf = map_sysmem(addr, size);
+		memcpy(buf, entry->buf, size);
+		unmap_sysmem(buf);
+	}
+	cache_stats.hits++;
+	cache_stats.saved += size;
+	bflow->cache_hits++;
+	bflow->cache_saved += size;
+	log_debug("cache hit: %s (%lx bytes)\n", path, size);
+
+	return 0;
+}
+
+void bootflow_cache_add(struct bootflow *bflow, const char *path, ulong size,
+			ulong addr, bool fixed)
+{
+	struct bootflow_cache_entry *entry;
+	struct blk_desc *desc;
+	void *buf;
+
+	if (!bflow->blk || size > BOOTFLOW_CACHE_ADDR_MAX)
+		return;
+	if (!fixed && size > BOOTFLOW_CACHE_COPY_MAX)
+		return;
+	desc = dev_get_uclass_plat(bflow->blk);
+
+	/* Replace any entry for the file at another address */
+	entry = bootflow_cache_find(bflow, path, size);
+	if (entry)
+		bootflow_cache_drop(entry);
+
+	entry = calloc(1, sizeof(*entry));
+	if (!entry)
+		return;
+	entry->path = strdup(path);
+	if (!entry->path)
+		goto err;
+	entry->uclass_id = desc->uclass_id;
+	entry->devnum = desc->devnum;
+	entry->hwpart = desc->hwpart;
+	entry->part = bflow->part;
+	entry->size = size;
+	if (size <= BOOTFLOW_CACHE_COPY_MAX) {
+		entry->buf = malloc(size);
+		if (!entry->buf)
+			goto err;
+		buf = map_sysmem(addr, size);
+		memcpy(entry->buf, buf, size);
+		unmap_sysmem(buf);
+	} else {
+		entry->addr = addr;
+		entry->crc = bootflow_cache_crc(addr, size);
+	}
+	list_add(&entry->lh, &bootflow_cache);
+	cache_stats.entries++;
+
+	return;
+err:
+	free(entry->path);
+	free(entry);
+}
+
+void bootflow_cache_invalidate(struct blk_desc *desc)
+{
+	struct bootflow_cache_entry *entry, *next;
+
+	list_for_each_entry_safe(entry, next, &bootflow_cache, lh) {
+		if (entry->uclass_id == desc->uclass_id &&
+		    entry->devnum == desc->devnum)
+			bootflow_cache_drop(entry);
+	}
+}
+
+void bootflow_cache_stats(struct bootflow_cache_stats *stats)
+{
+	*stats = cache_stats;
+	cache_stats.hits = 0;
+	cache_stats.misses = 0;
+	cache_stats.saved = 0;
+}
+
+void bootflow_cache_free(void)
+{
+	struct bootflow_cache_entry *entry, *next;
+
+	list_for_each_entry_safe(entry, next, &bootflow_cache, lh)
+		bootflow_cache_drop(entry);
+}
+#endif /* BOOTSTD_FILE_CACHE */
+
 #if CONFIG_IS_ENABLED(BOOTSTD_FULL)
 int bootflow_read_all(struct bootflow *bflow)
 {
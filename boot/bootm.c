@@ -19,6 +19,7 @@
 #include <malloc.h>
 #include <mapmem.h>
 #include <net.h>
+#include <smp_work.h>
 #include <asm/cache.h>
 #include <asm/global_data.h>
 #include <asm/io.h>
@@ -643,6 +644,8 @@ static int bootm_load_os(struct bootm_headers *images, int boot_progress)
 	}
 	/* We need the decompressed image size in the next steps */
 	images->os.image_len = load_end - load;
+	if (os.comp == IH_COMP_NONE && load != os.image_start)
+		images->copied += image_len;
 
 	flush_cache(flush_start, ALIGN(load_end, ARCH_DMA_MINALIGN) - flush_start);
 
@@ -711,6 +714,13 @@ ulong bootm_disable_interrupts(void)
 {
 	ulong iflag;
 
+	/* Make sure any buffered console output has been sent */
+	if (CONFIG_IS_ENABLED(SERIAL_TX_BUFFER))
+		flush();
+
+	/* Hand any secondary CPUs back to firmware, so the OS can start them */
+	smp_work_stop();
+
 	/*
 	 * We have reached the point of no return: we are going to
 	 * overwrite all exception vector code, so we cannot easily
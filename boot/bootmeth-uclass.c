@@ -326,6 +326,52 @@ int bootmeth_try_file(struct bootflow *bflow, struct blk_desc *desc,
 	return 0;
 }
 
+/**
+ * bootmeth_read_alloc() - Read a file into an allocated buffer
+ *
+ * This uses the bootflow file cache if possible. The buffer is nul-terminated,
+ * as with fs_read_alloc()
+ *
+ * @bflow: Bootflow the file is for
+ * @path: Path of the file
+ * @size: Size of the file in bytes
+ * @align: Alignment for the buffer, or 0 for none
+ * @bufp: Returns the allocated buffer
+ * Return: 0 if OK, -ENOMEM if out of memory, other -ve on read error
+ */
+static int bootmeth_read_alloc(struct bootflow *bflow, const char *path,
+			       ulong size, uint align, void **bufp)
+{
+	loff_t bytes_read;
+	ulong addr;
+	char *buf;
+	int ret;
+
+	buf = memalign(align, size + 1);
+	if (!buf)
+		return log_msg_ret("buf", -ENOMEM);
+	addr = map_to_sysmem(buf);
+
+	if (bootflow_cache_get(bflow, path, size, addr)) {
+		ret = fs_read(path, addr, 0, size, &bytes_read);
+		if (!ret && bytes_read != size)
+			ret = -EIO;
+		if (ret) {
+			free(buf);
+			return log_msg_ret("read", ret);
+		}
+		/* The buffer is freed later, so only a copy can be kept */
+		bootflow_cache_add(bflow, path, size, addr, false);
+	} else {
+		/* fs_read() would have closed the filesystem */
+		fs_close();
+	}
+	buf[size] = '\0';
+	*bufp = buf;
+
+	return 0;
+}
+
 int bootmeth_alloc_file(struct bootflow *bflow, uint size_limit, uint align)
 {
 	void *buf;
@@ -337,7 +383,7 @@ int bootmeth_alloc_file(struct bootflow *bflow, uint size_limit, uint align)
 	if (size > size_limit)
 		return log_msg_ret("chk", -E2BIG);
 
-	ret = fs_read_alloc(bflow->fname, bflow->size, align, &buf);
+	ret = bootmeth_read_alloc(bflow, bflow->fname, bflow->size, align, &buf);
 	if (ret)
 		return log_msg_ret("all", ret);
 
@@ -373,7 +419,7 @@ int bootmeth_alloc_other(struct bootflow *bflow, const char *fname,
 	if (ret)
 		return log_msg_ret("fs", ret);
 
-	ret = fs_read_alloc(path, size, 0, &buf);
+	ret = bootmeth_read_alloc(bflow, path, size, 0, &buf);
 	if (ret)
 		return log_msg_ret("all", ret);
 
@@ -404,6 +450,13 @@ int bootmeth_common_read_file(struct udevice *dev, struct bootflow *bflow,
 	if (size > *sizep)
 		return log_msg_ret("spc", -ENOSPC);
 
+	if (!bootflow_cache_get(bflow, file_path, size, addr)) {
+		/* Nothing is read, so make sure the filesystem is not left open */
+		fs_close();
+		*sizep = size;
+		return 0;
+	}
+
 	ret = bootmeth_setup_fs(bflow, desc);
 	if (ret)
 		return log_msg_ret("fs", ret);
@@ -411,6 +464,7 @@ int bootmeth_common_read_file(struct udevice *dev, struct bootflow *bflow,
 	ret = fs_read(file_path, addr, 0, 0, &len_read);
 	if (ret)
 		return ret;
+	bootflow_cache_add(bflow, file_path, len_read, addr, true);
 	*sizep = len_read;
 
 	return 0;
@@ -17,6 +17,7 @@
 #include <bootflow.h>
 #include <bootm.h>
 #include <bootmeth.h>
+#include <bootstage.h>
 #include <dm.h>
 #include <image.h>
 #include <malloc.h>
@@ -30,6 +31,9 @@
 #define BOOT_PART_NAME "boot"
 #define VENDOR_BOOT_PART_NAME "vendor_boot"
 
+/* Number of slotted partitions loaded to boot */
+#define ANDROID_MAX_LOADS 2
+
 /**
  * struct android_priv - Private data
  *
@@ -46,6 +50,20 @@ struct android_priv {
 	u32 header_version;
 };
 
+/**
+ * struct android_load - A slotted partition which is loaded to boot
+ *
+ * @name: Partition name, without the slot suffix
+ * @addr: Address where the partition content is loaded into
+ * @loaded: true if it was loaded while it was verified, so need not be read
+ *	again
+ */
+struct android_load {
+	const char *name;
+	ulong addr;
+	bool loaded;
+};
+
 static int android_check(struct udevice *dev, struct bootflow_iter *iter)
 {
 	/* This only works on mmc devices */
@@ -376,42 +394,87 @@ static int avb_append_commandline(struct bootflow *bflow, char *cmdline)
 	return 0;
 }
 
-static int run_avb_verification(struct bootflow *bflow)
+/**
+ * run_avb_verification() - Verify the partitions needed to boot
+ *
+ * The partitions in @loads are loaded to their addresses while they are
+ * verified, so that they do not need to be read again afterwards.
+ *
+ * @bflow: Bootflow being booted
+ * @loads: Partitions to verify. Each one loaded here has @loaded set
+ * @count: Number of entries in @loads
+ * Return: 0 if OK, negative errno on failure.
+ */
+static int run_avb_verification(struct bootflow *bflow,
+				struct android_load *loads, int count)
 {
 	struct blk_desc *desc = dev_get_uclass_plat(bflow->blk);
 	struct android_priv *priv = bflow->bootmeth_priv;
-	const char * const requested_partitions[] = {"boot", "vendor_boot"};
+	const char *requested_partitions[ANDROID_MAX_LOADS + 1];
+	char partnames[ANDROID_MAX_LOADS][PART_NAME_LEN];
+	struct avb_preload preload[ANDROID_MAX_LOADS];
 	struct AvbOps *avb_ops;
 	AvbSlotVerifyResult result;
-	AvbSlotVerifyData *out_data;
+	AvbSlotVerifyData *out_data = NULL;
+	AvbPartitionData *part_data;
 	enum avb_boot_state boot_state;
 	char *extra_args;
 	char slot_suffix[3];
 	bool unlocked = false;
-	int ret;
+	int ret, i, j;
+
+	if (count > ANDROID_MAX_LOADS)
+		return log_msg_ret("avb count", -E2BIG);
 
 	avb_ops = avb_ops_alloc(desc->devnum);
 	if (!avb_ops)
 		return log_msg_ret("avb ops", -ENOMEM);
 
 	sprintf(slot_suffix, "_%s", priv->slot);
+	for (i = 0; i < count; i++) {
+		snprintf(partnames[i], PART_NAME_LEN, "%s%s", loads[i].name,
+			 slot_suffix);
+		requested_partitions[i] = loads[i].name;
+		preload[i].name = partnames[i];
+		preload[i].addr = loads[i].addr;
+	}
+	requested_partitions[count] = NULL;
+	avb_ops_set_preload(avb_ops, preload, count);
 
 	ret = avb_ops->read_is_device_unlocked(avb_ops, &unlocked);
-	if (ret != AVB_IO_RESULT_OK)
-		return log_msg_ret("avb lock", -EIO);
+	if (ret != AVB_IO_RESULT_OK) {
+		ret = log_msg_ret("avb lock", -EIO);
+		goto free_ops;
+	}
 
+	bootstage_start(BOOTSTAGE_ID_ACCUM_AVB_VERIFY, "avb_verify");
 	result = avb_slot_verify(avb_ops,
 				 requested_partitions,
 				 slot_suffix,
 				 unlocked,
 				 AVB_HASHTREE_ERROR_MODE_RESTART_AND_INVALIDATE,
 				 &out_data);
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_AVB_VERIFY);
 
-	if (result != AVB_SLOT_VERIFY_RESULT_OK) {
+	/*
+	 * An unlocked device may boot images which fail verification, in the
+	 * ORANGE state. libavb still loads them in that case.
+	 */
+	if (result != AVB_SLOT_VERIFY_RESULT_OK &&
+	    (!unlocked || result != AVB_SLOT_VERIFY_RESULT_ERROR_VERIFICATION)) {
 		printf("Verification failed, reason: %s\n",
 		       str_avb_slot_error(result));
-		avb_slot_verify_data_free(out_data);
-		return log_msg_ret("avb verify", -EIO);
+		ret = log_msg_ret("avb verify", -EIO);
+		goto free_out_data;
+	}
+
+	for (i = 0; i < out_data->num_loaded_partitions; i++) {
+		part_data = &out_data->loaded_partitions[i];
+		for (j = 0; j < count; j++) {
+			if (part_data->preloaded &&
+			    !strcmp(part_data->partition_name, loads[j].name))
+				loads[j].loaded = true;
+		}
 	}
 
 	if (unlocked)
@@ -421,26 +484,36 @@ static int run_avb_verification(struct bootflow *bflow)
 
 	extra_args = avb_set_state(avb_ops, boot_state);
 	if (extra_args) {
-		/* extra_args will be modified after this. This is fine */
+		/* This is a string constant, so copy it before splitting it */
+		extra_args = strdup(extra_args);
+		if (!extra_args) {
+			ret = -ENOMEM;
+			goto err_cmdline;
+		}
 		ret = avb_append_commandline_arg(bflow, extra_args);
+		free(extra_args);
 		if (ret < 0)
-			goto free_out_data;
+			goto err_cmdline;
 	}
 
 	ret = avb_append_commandline(bflow, out_data->cmdline);
 	if (ret < 0)
-		goto free_out_data;
-
-	return 0;
+		goto err_cmdline;
+	goto free_out_data;
 
+ err_cmdline:
+	ret = log_msg_ret("avb cmdline", ret);
  free_out_data:
 	if (out_data)
 		avb_slot_verify_data_free(out_data);
+ free_ops:
+	avb_ops_free(avb_ops);
 
-	return log_msg_ret("avb cmdline", ret);
+	return ret;
 }
 #else
-static int run_avb_verification(struct bootflow *bflow)
+static int run_avb_verification(struct bootflow *bflow,
+				struct android_load *loads, int count)
 {
 	int ret;
 
@@ -459,11 +532,17 @@ static int boot_android_normal(struct bootflow *bflow)
 {
 	struct blk_desc *desc = dev_get_uclass_plat(bflow->blk);
 	struct android_priv *priv = bflow->bootmeth_priv;
-	int ret;
+	int ret, i;
 	ulong loadaddr = env_get_hex("loadaddr", 0);
 	ulong vloadaddr = env_get_hex("vendor_boot_comp_addr_r", 0);
-
-	ret = run_avb_verification(bflow);
+	struct android_load loads[ANDROID_MAX_LOADS] = {
+		{ BOOT_PART_NAME, loadaddr },
+		{ VENDOR_BOOT_PART_NAME, vloadaddr },
+	};
+	char slot;
+
+	slot = priv->slot[0];
+	ret = run_avb_verification(bflow, loads, ARRAY_SIZE(loads));
 	if (ret < 0)
 		return log_msg_ret("avb", ret);
 
@@ -472,17 +551,22 @@ static int boot_android_normal(struct bootflow *bflow)
 	if (ret < 0)
 		return log_msg_ret("read slot", ret);
 
-	ret = read_slotted_partition(desc, "boot", priv->slot, loadaddr);
-	if (ret < 0)
-		return log_msg_ret("read boot", ret);
-
-	ret = read_slotted_partition(desc, "vendor_boot", priv->slot, vloadaddr);
-	if (ret < 0)
-		return log_msg_ret("read vendor_boot", ret);
+	for (i = 0; i < ARRAY_SIZE(loads); i++) {
+		if (loads[i].loaded && priv->slot[0] == slot)
+			continue;
+		ret = read_slotted_partition(desc, loads[i].name, priv->slot,
+					     loads[i].addr);
+		if (ret < 0)
+			return log_msg_ret("read part", ret);
+	}
 
 	set_abootimg_addr(loadaddr);
 	set_avendor_bootimg_addr(vloadaddr);
 
+	/* Sandbox cannot run an Android kernel, so stop once it is loaded */
+	if (IS_ENABLED(CONFIG_SANDBOX))
+		return log_msg_ret("sandbox", -ENOSYS);
+
 	ret = bootm_boot_start(loadaddr, bflow->cmdline);
 
 	return log_msg_ret("boot", ret);
@@ -345,6 +345,23 @@ static int distro_efi_boot(struct udevice *dev, struct bootflow *bflow)
 		if (ret)
 			return log_msg_ret("read", ret);
 
+		/*
+		 * Scanning other partitions may have loaded their device tree
+		 * over this one, so read it again unless the file cache shows
+		 * that it is still there
+		 */
+		if (IS_ENABLED(CONFIG_BOOTSTD_FILE_CACHE) && bflow->fdt_size) {
+			/* Limit FDT files to 4MB, as when scanning */
+			ulong size = SZ_4M;
+
+			ret = bootmeth_common_read_file(dev, bflow,
+							bflow->fdt_fname,
+							bflow->fdt_addr, &size);
+			if (ret)
+				return log_msg_ret("fdt", ret);
+			bflow->fdt_size = size;
+		}
+
 		/*
 		 * use the provided device tree if not using the built-in fdt
 		 */
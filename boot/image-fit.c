@@ -20,12 +20,14 @@
 #include <linux/compiler.h>
 #include <linux/sizes.h>
 #include <errno.h>
+#include <lmb.h>
 #include <log.h>
 #include <mapmem.h>
 #include <asm/io.h>
 #include <malloc.h>
 #include <memalign.h>
 #include <asm/global_data.h>
+#include <smp_work.h>
 #ifdef CONFIG_DM_HASH
 #include <dm.h>
 #include <u-boot/hash.h>
@@ -1290,6 +1292,162 @@ int calculate_hash(const void *data, int data_len, const char *name,
 	return 0;
 }
 
+#if CONFIG_IS_ENABLED(SMP_WORK) && !defined(USE_HOSTCC)
+/**
+ * struct fit_hash_job - Hash of an image, calculated on a secondary CPU
+ *
+ * @hash: Hash job
+ * @noffset: Offset of the hash node
+ * @value: Calculated hash value
+ */
+struct fit_hash_job {
+	struct smp_work_hash hash;
+	int noffset;
+	u8 value[FIT_MAX_HASH_LEN];
+};
+
+/**
+ * struct fit_hash_precalc - Hashes calculated ahead of verification
+ *
+ * @fit: FIT the hashes belong to, or NULL if none
+ * @jobs: Hash jobs, one for each hash node
+ * @count: Number of jobs
+ */
+static struct fit_hash_precalc {
+	const void *fit;
+	struct fit_hash_job *jobs;
+	int count;
+} fit_hash_precalc;
+
+/**
+ * fit_hash_precalc_all() - Calculate the hashes of all images in parallel
+ *
+ * This posts a job for each hash node of each image in the FIT, so that the
+ * images are hashed on the secondary CPUs at the same time. The results are
+ * picked up by fit_image_check_hash() as each image is verified. Hashes which
+ * cannot be calculated here are left to fit_image_check_hash() as usual.
+ *
+ * @fit: FIT to process
+ * @images_noffset: Offset of the /images node
+ */
+static void fit_hash_precalc_all(const void *fit, int images_noffset)
+{
+	struct fit_hash_job *jobs, *job;
+	int image_noffset, noffset;
+	const void *data;
+	const char *algo;
+	size_t size;
+	int count, pass, i;
+
+	if (smp_work_init() < 1)
+		return;
+
+	/* Count the hash nodes in the first pass, fill them in the second */
+	jobs = NULL;
+	for (pass = 0; pass < 2; pass++) {
+		count = 0;
+		fdt_for_each_subnode(image_noffset, fit, images_noffset) {
+			if (fit_image_get_data_and_size(fit, image_noffset,
+							&data, &size))
+				continue;
+			fdt_for_each_subnode(noffset, fit, image_noffset) {
+				if (strncmp(fit_get_name(fit, noffset, NULL),
+					    FIT_HASH_NODENAME,
+					    strlen(FIT_HASH_NODENAME)) ||
+				    fit_image_hash_get_algo(fit, noffset,
+							    &algo))
+					continue;
+				if (jobs) {
+					job = &jobs[count];
+					job->noffset = noffset;
+					job->hash.algo = algo;
+					job->hash.data = data;
+					job->hash.size = size;
+					job->hash.value = job->value;
+				}
+				count++;
+			}
+		}
+		if (!count)
+			return;
+		if (!jobs) {
+			jobs = calloc(count, sizeof(*jobs));
+			if (!jobs)
+				return;
+		}
+	}
+
+	for (i = 0; i < count; i++)
+		smp_work_hash_post(&jobs[i].hash);
+	for (i = 0; i < count; i++)
+		smp_work_wait(&jobs[i].hash.work);
+
+	fit_hash_precalc.fit = fit;
+	fit_hash_precalc.jobs = jobs;
+	fit_hash_precalc.count = count;
+}
+
+/**
+ * fit_hash_precalc_free() - Drop the hashes calculated by fit_hash_precalc_all()
+ */
+static void fit_hash_precalc_free(void)
+{
+	free(fit_hash_precalc.jobs);
+	memset(&fit_hash_precalc, '\0', sizeof(fit_hash_precalc));
+}
+
+/**
+ * fit_hash_get_precalc() - Get a hash calculated by fit_hash_precalc_all()
+ *
+ * @fit: FIT containing the hash node
+ * @noffset: Offset of the hash node
+ * @data: Image data being verified
+ * @size: Size of image data
+ * @value: Returns the hash value
+ * @value_len: Returns the length of the hash value
+ * Return: true if the hash was found, false if it must be calculated
+ */
+static bool fit_hash_get_precalc(const void *fit, int noffset,
+				 const void *data, size_t size,
+				 uint8_t *value, int *value_len)
+{
+	struct fit_hash_job *job;
+	int i;
+
+	if (fit != fit_hash_precalc.fit)
+		return false;
+
+	for (i = 0; i < fit_hash_precalc.count; i++) {
+		job = &fit_hash_precalc.jobs[i];
+		if (job->noffset != noffset)
+			continue;
+		if (job->hash.data != data || job->hash.size != size ||
+		    job->hash.work.ret)
+			return false;
+		memcpy(value, job->value, job->hash.value_len);
+		*value_len = job->hash.value_len;
+		return true;
+	}
+
+	return false;
+}
+#else
+static inline void fit_hash_precalc_all(const void *fit, int images_noffset)
+{
+}
+
+static inline void fit_hash_precalc_free(void)
+{
+}
+
+static inline bool fit_hash_get_precalc(const void *fit, int noffset,
+					const void *data, size_t size,
+					uint8_t *value, int *value_len)
+{
+	return false;
+}
+#endif
+
 static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 				size_t size, char **err_msgp)
 {
@@ -1322,7 +1480,9 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 		return -1;
 	}
 
-	if (calculate_hash(data, size, algo, value, &value_len)) {
+	if (!fit_hash_get_precalc(fit, noffset, data, size, value,
+				  &value_len) &&
+	    calculate_hash(data, size, algo, value, &value_len)) {
 		*err_msgp = "Unsupported hash algorithm";
 		return -1;
 	}
@@ -1463,6 +1623,7 @@ int fit_all_image_verify(const void *fit)
 	int noffset;
 	int ndepth;
 	int count;
+	int ret = 1;
 
 	/* Find images parent node offset */
 	images_noffset = fdt_path_offset(fit, FIT_IMAGES_PATH);
@@ -1472,6 +1633,9 @@ int fit_all_image_verify(const void *fit)
 		return 0;
 	}
 
+	bootstage_start(BOOTSTAGE_ID_ACCUM_FIT_HASH, "fit_hash");
+	fit_hash_precalc_all(fit, images_noffset);
+
 	/* Process all image subnodes, check hashes for each */
 	printf("## Checking hash(es) for FIT Image at %08lx ...\n",
 	       (ulong)fit);
@@ -1488,12 +1652,17 @@ int fit_all_image_verify(const void *fit)
 			       fit_get_name(fit, noffset, NULL));
 			count++;
 
-			if (!fit_image_verify(fit, noffset))
-				return 0;
+			if (!fit_image_verify(fit, noffset)) {
+				ret = 0;
+				break;
+			}
 			printf("\n");
 		}
 	}
-	return 1;
+	fit_hash_precalc_free();
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_FIT_HASH);
+
+	return ret;
 }
 
 static int fit_image_uncipher(const void *fit, int image_noffset,
@@ -2279,8 +2448,16 @@ int fit_image_load(struct bootm_headers *images, ulong addr,
 		}
 		len = load_end - load;
 	} else if (load != data) {
+#ifndef USE_HOSTCC
+		if (CONFIG_IS_ENABLED(LMB) && lmb_read_check(load, len)) {
+			printf("Error: %s would overwrite reserved memory\n",
+			       prop_name);
+			return -EXDEV;
+		}
+#endif
 		loadbuf = map_sysmem(load, len);
 		memcpy(loadbuf, buf, len);
+		images->copied += len;
 	}
 
 	if (image_type == IH_TYPE_RAMDISK && comp != IH_COMP_NONE)
@@ -416,6 +416,10 @@ static int do_bootflow_info(struct cmd_tbl *cmdtp, int flag, int argc,
 		       bflow->fdt_size);
 		printf("FDT addr:  %lx\n", bflow->fdt_addr);
 	}
+	if (IS_ENABLED(CONFIG_BOOTSTD_FILE_CACHE)) {
+		printf("Cache:     %u hits, %lu bytes saved\n", bflow->cache_hits,
+		       bflow->cache_saved);
+	}
 	printf("Error:     %d\n", bflow->err);
 	if (dump && bflow->buf) {
 		/* Set some sort of maximum on the size */
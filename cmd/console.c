@@ -8,7 +8,9 @@
  * Boot support
  */
 #include <command.h>
+#include <dm.h>
 #include <iomux.h>
+#include <serial.h>
 #include <stdio_dev.h>
 
 extern void _do_coninfo (void);
@@ -43,6 +45,17 @@ static int do_coninfo(struct cmd_tbl *cmd, int flag, int argc,
 			}
 
 		}
+
+		if (CONFIG_IS_ENABLED(SERIAL_TX_BUFFER) &&
+		    (dev->flags & DEV_FLAGS_DM) &&
+		    device_get_uclass_id(dev->priv) == UCLASS_SERIAL) {
+			struct serial_tx_stats stats;
+
+			if (!serial_get_tx_stats(dev->priv, &stats))
+				printf("|   |-- tx buffer: %u/%u used, %lu overflows, %lu dropped\n",
+				       stats.used, stats.size, stats.overflows,
+				       stats.dropped);
+		}
 	}
 	return 0;
 }
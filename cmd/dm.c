@@ -47,6 +47,29 @@ static int do_dm_dump_mem(struct cmd_tbl *cmdtp, int flag, int argc,
 }
 #endif /* DM_STATS */
 
+#if CONFIG_IS_ENABLED(DM_PROBE_STATS)
+static int do_dm_probe_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			     char *const argv[])
+{
+	enum dm_probe_stats_by by = DM_PROBE_STATS_BY_DRIVER;
+	bool all = false;
+
+	for (; argc > 1; argc--, argv++) {
+		if (!strcmp(argv[1], "-a"))
+			all = true;
+		else if (!strcmp(argv[1], "-d"))
+			by = DM_PROBE_STATS_BY_DEVICE;
+		else if (!strcmp(argv[1], "-u"))
+			by = DM_PROBE_STATS_BY_UCLASS;
+		else
+			return CMD_RET_USAGE;
+	}
+	dm_dump_probe_stats(by, all);
+
+	return 0;
+}
+#endif /* DM_PROBE_STATS */
+
 static int do_dm_dump_static_driver_info(struct cmd_tbl *cmdtp, int flag,
 					 int argc, char * const argv[])
 {
@@ -111,11 +134,23 @@ static int do_dm_dump_uclass(struct cmd_tbl *cmdtp, int flag, int argc,
 #define DM_MEM
 #endif
 
+#if CONFIG_IS_ENABLED(DM_PROBE_STATS)
+#define DM_PROBE_STATS_HELP	\
+	"dm probe-stats [-a][-d|-u]  Show time taken to bind/probe (-d=per device,\n" \
+	"                 -u=per uclass, -a=include devices not probed)\n"
+#define DM_PROBE_STATS	\
+	U_BOOT_SUBCMD_MKENT(probe-stats, 4, 1, do_dm_probe_stats),
+#else
+#define DM_PROBE_STATS_HELP
+#define DM_PROBE_STATS
+#endif
+
 U_BOOT_LONGHELP(dm,
 	"compat        Dump list of drivers with compatibility strings\n"
 	"dm devres        Dump list of device resources for each device\n"
 	"dm drivers       Dump list of drivers with uclass and instances\n"
 	DM_MEM_HELP
+	DM_PROBE_STATS_HELP
 	"dm static        Dump list of drivers with static platform data\n"
 	"dm tree [-s][-e][name]   Dump tree of driver model devices (-s=sort)\n"
 	"dm uclass [-e][name]     Dump list of instances for each uclass");
@@ -125,6 +160,7 @@ U_BOOT_CMD_WITH_SUBCMDS(dm, "Driver model low level access", dm_help_text,
 	U_BOOT_SUBCMD_MKENT(devres, 1, 1, do_dm_dump_devres),
 	U_BOOT_SUBCMD_MKENT(drivers, 1, 1, do_dm_dump_drivers),
 	DM_MEM
+	DM_PROBE_STATS
 	U_BOOT_SUBCMD_MKENT(static, 1, 1, do_dm_dump_static_driver_info),
 	U_BOOT_SUBCMD_MKENT(tree, 4, 1, do_dm_dump_tree),
 	U_BOOT_SUBCMD_MKENT(uclass, 3, 1, do_dm_dump_uclass));
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Command for information about scripts run by the modern hush parser
+ */
+
+#include <cli_hush.h>
+#include <command.h>
+#include <vsprintf.h>
+
+static int do_hush_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			 char *const argv[])
+{
+	struct hush_stats stats;
+
+	hush_get_stats(&stats);
+	printf("Runs:          %lu\n", stats.runs);
+	printf("Hits:          %lu (already parsed)\n", stats.hits);
+	printf("Misses:        %lu (parsed)\n", stats.misses);
+	printf("Dropped:       %lu (cache full)\n", stats.evictions);
+	printf("Cached:        %u / %u\n", stats.cached,
+	       CONFIG_HUSH_SCRIPT_CACHE_SIZE);
+	printf("Parse time:    %llu us\n", stats.parse_us);
+	printf("Execute time:  %llu us\n", stats.exec_us);
+	if (argc > 1 && !strcmp(argv[1], "-r"))
+		hush_reset_stats();
+
+	return 0;
+}
+
+static int do_hush_flush(struct cmd_tbl *cmdtp, int flag, int argc,
+			 char *const argv[])
+{
+	hush_flush_cache();
+
+	return 0;
+}
+
+U_BOOT_LONGHELP(hush,
+	"stats [-r] - show cache hits and time taken by scripts (-r: reset)\n"
+	"hush flush - drop all parsed scripts");
+
+U_BOOT_CMD_WITH_SUBCMDS(hush, "Information about hush scripts", hush_help_text,
+	U_BOOT_SUBCMD_MKENT(stats, 2, 1, do_hush_stats),
+	U_BOOT_SUBCMD_MKENT(flush, 1, 1, do_hush_flush));
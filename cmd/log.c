@@ -374,6 +374,63 @@ static int do_log_rec(struct cmd_tbl *cmdtp, int flag, int argc,
 	return 0;
 }
 
+static int do_log_dump(struct cmd_tbl *cmdtp, int flag, int argc,
+		       char *const argv[])
+{
+	struct log_binary_stats stats;
+	bool clear = false, export = false, show_stats = false;
+	struct getopt_state gs;
+	int opt, ret;
+
+	getopt_init_state(&gs);
+	while ((opt = getopt(&gs, argc, argv, "ces")) > 0) {
+		switch (opt) {
+		case 'c':
+			clear = true;
+			break;
+		case 'e':
+			export = true;
+			break;
+		case 's':
+			show_stats = true;
+			break;
+		default:
+			return CMD_RET_USAGE;
+		}
+	}
+	if (gs.index != argc)
+		return CMD_RET_USAGE;
+
+	ret = log_binary_get_stats(&stats);
+	if (ret == -ENOSYS) {
+		printf("Binary log is not enabled\n");
+		return CMD_RET_FAILURE;
+	} else if (ret) {
+		printf("No binary log ring\n");
+		return CMD_RET_FAILURE;
+	}
+
+	if (show_stats) {
+		printf("Size:      %x\n", stats.size);
+		printf("Used:      %x\n", stats.used);
+		printf("Records:   %u\n", stats.count);
+		printf("Lost:      %u\n", stats.lost);
+		printf("Truncated: %u\n", stats.truncated);
+	} else if (export) {
+		ret = log_binary_export();
+		if (ret) {
+			printf("Cannot export log (err=%d)\n", ret);
+			return CMD_RET_FAILURE;
+		}
+	} else {
+		log_binary_dump();
+	}
+	if (clear)
+		log_binary_clear();
+
+	return 0;
+}
+
 U_BOOT_LONGHELP(log,
 	"level [<level>] - get/set log level\n"
 	"categories - list log categories\n"
@@ -403,7 +460,11 @@ U_BOOT_LONGHELP(log,
 	"\tc=category, l=level, F=file, L=line number, f=function, m=msg\n"
 	"\tor 'default', or 'all' for all\n"
 	"log rec <category> <level> <file> <line> <func> <message> - "
-		"output a log record");
+		"output a log record\n"
+	"log dump [OPTIONS] - show the records in the binary log ring\n"
+	"\t-c - Clear the ring afterwards\n"
+	"\t-e - Export the records as text to the bloblist instead\n"
+	"\t-s - Show information about the ring instead");
 
 U_BOOT_CMD_WITH_SUBCMDS(log, "log system", log_help_text,
 	U_BOOT_SUBCMD_MKENT(level, 2, 1, do_log_level),
@@ -415,4 +476,5 @@ U_BOOT_CMD_WITH_SUBCMDS(log, "log system", log_help_text,
 	U_BOOT_SUBCMD_MKENT(filter-remove, 4, 1, do_log_filter_remove),
 	U_BOOT_SUBCMD_MKENT(format, 2, 1, do_log_format),
 	U_BOOT_SUBCMD_MKENT(rec, 7, 1, do_log_rec),
+	U_BOOT_SUBCMD_MKENT(dump, 3, 1, do_log_dump),
 );
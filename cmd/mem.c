@@ -15,13 +15,16 @@
 #include <cli.h>
 #include <command.h>
 #include <console.h>
+#include <cpu_func.h>
 #include <display_options.h>
+#include <div64.h>
 #ifdef CONFIG_MTD_NOR_FLASH
 #include <flash.h>
 #endif
 #include <hash.h>
 #include <log.h>
 #include <mapmem.h>
+#include <memtest.h>
 #include <rand.h>
 #include <time.h>
 #include <watchdog.h>
@@ -1058,6 +1061,43 @@ static ulong mem_test_quick(vu_long *buf, ulong start_addr, ulong end_addr,
 	return errs;
 }
 
+static ulong mem_test_fast(vu_long *buf, ulong start_addr, ulong end_addr,
+			   ulong pattern, int iteration)
+{
+	struct memtest_result res;
+	enum memtest_t type;
+	ulong errs = 0;
+	int i, ret;
+
+	/* Use a different pattern each time, alternating with its inverse */
+	pattern += iteration / 2;
+	if (iteration & 1)
+		pattern = ~pattern;
+
+	for (type = 0; type < MEMTEST_COUNT; type++) {
+		printf("\n%-12s", memtest_get_name(type));
+		ret = memtest_run(type, (void *)buf, start_addr,
+				  end_addr - start_addr, pattern, &res);
+		if (ret)
+			return -1;
+		do_div(res.bytes, max(res.time_us, 1UL));
+		printf("%lu errors, %llu MB/s", res.errors, res.bytes);
+		for (i = 0; i < res.num_recorded; i++) {
+			struct memtest_error *err = &res.error[i];
+
+			printf("\nMem error @ 0x%08lX: found %016llX, expected %016llX",
+			       err->addr, err->found, err->expect);
+		}
+		if (res.errors > res.num_recorded)
+			printf("\n... and %lu more",
+			       res.errors - res.num_recorded);
+		errs += res.errors;
+	}
+	puts("\n");
+
+	return errs;
+}
+
 /*
  * Perform a memory test. A more complete alternative test can be
  * configured using CONFIG_SYS_ALT_MEMTEST. The complete test loops until
@@ -1103,6 +1143,9 @@ static int do_mem_mtest(struct cmd_tbl *cmdtp, int flag, int argc,
 	debug("%s:%d: start %#08lx end %#08lx\n", __func__, __LINE__,
 	      start, end);
 
+	if (IS_ENABLED(CONFIG_SYS_FAST_MEMTEST) && !dcache_status())
+		printf("Warning: data cache is off, test will be slow\n");
+
 	buf = map_sysmem(start, end - start);
 	for (iteration = 0;
 			!iteration_limit || iteration < iteration_limit;
@@ -1114,7 +1157,10 @@ static int do_mem_mtest(struct cmd_tbl *cmdtp, int flag, int argc,
 
 		printf("Iteration: %6d\r", iteration + 1);
 		debug("\n");
-		if (IS_ENABLED(CONFIG_SYS_ALT_MEMTEST)) {
+		if (IS_ENABLED(CONFIG_SYS_FAST_MEMTEST)) {
+			errs = mem_test_fast(buf, start, end, pattern,
+					     iteration);
+		} else if (IS_ENABLED(CONFIG_SYS_ALT_MEMTEST)) {
 			errs = mem_test_alt(buf, start, end, dummy);
 			if (errs == -1UL)
 				break;
@@ -10,6 +10,7 @@
 
 #include <command.h>
 #include <console.h>
+#include <div64.h>
 #include <led.h>
 #if CONFIG_IS_ENABLED(CMD_MTD_OTP)
 #include <hexdump.h>
@@ -17,6 +18,7 @@
 #include <malloc.h>
 #include <mapmem.h>
 #include <mtd.h>
+#include <time.h>
 #include <dm/devres.h>
 #include <linux/err.h>
 
@@ -570,6 +572,14 @@ static int do_mtd_io(struct cmd_tbl *cmdtp, int flag, int argc,
 			continue;
 		}
 
+		/*
+		 * Read data up to the end of the block at once, so that the
+		 * driver can use the chip's sequential read
+		 */
+		if (read && has_pages && !woob)
+			io_op.len = min_t(u64, remaining, mtd->erasesize -
+					  mtd_mod_by_eb(off, mtd));
+
 		if (read)
 			ret = mtd_read_oob(mtd, off, &io_op);
 		else
@@ -612,6 +622,123 @@ out_put_mtd:
 	return ret;
 }
 
+#if CONFIG_IS_ENABLED(CMD_MTD_BENCH)
+/**
+ * mtd_bench_read() - Read a region, skipping bad blocks, and time it
+ *
+ * @mtd: Device to read
+ * @off: Offset to start at
+ * @len: Number of bytes to read
+ * @chunk: Largest number of bytes to read at once; reads never cross a block
+ * @buf: Buffer to read into, at least @chunk bytes
+ * @time_us: Returns the time taken in microseconds
+ * Return: 0 if OK, -EINTR if interrupted, other -ve on error
+ */
+static int mtd_bench_read(struct mtd_info *mtd, u64 off, u64 len, u32 chunk,
+			  u8 *buf, ulong *time_us)
+{
+	ulong start = timer_get_us();
+	size_t retlen;
+	u32 size;
+	int ret;
+
+	while (len) {
+		if (off >= mtd->size)
+			return -ENOSPC;
+		if (mtd_is_aligned_with_block_size(mtd, off) &&
+		    mtd_block_isbad(mtd, off)) {
+			off += mtd->erasesize;
+			continue;
+		}
+
+		size = min_t(u64, len, chunk);
+		size = min(size, mtd->erasesize - mtd_mod_by_eb(off, mtd));
+		ret = mtd_read(mtd, off, size, &retlen, buf);
+		if (ret && ret != -EUCLEAN) {
+			printf("Failure while reading at offset 0x%llx\n", off);
+			return ret;
+		}
+		if (ctrlc())
+			return -EINTR;
+		off += size;
+		len -= size;
+	}
+	*time_us = timer_get_us() - start;
+
+	return 0;
+}
+
+static void mtd_bench_show(const char *name, u64 len, ulong time_us)
+{
+	u64 speed = len * 1000000;
+
+	do_div(speed, max(time_us, 1UL) * 1024);
+	printf("%-12s%llu bytes in %lu us, %llu KiB/s\n", name, len, time_us,
+	       speed);
+}
+
+static int do_mtd_bench(struct cmd_tbl *cmdtp, int flag, int argc,
+			char *const argv[])
+{
+	struct mtd_info *mtd;
+	u64 off, len;
+	ulong time_us;
+	int ret = CMD_RET_FAILURE;
+	u8 *buf;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+
+	mtd = get_mtd_by_name(argv[1]);
+	if (IS_ERR_OR_NULL(mtd))
+		return CMD_RET_FAILURE;
+
+	off = argc > 2 ? hextoul(argv[2], NULL) : 0;
+	len = argc > 3 ? hextoul(argv[3], NULL) : mtd->size - off;
+	if (!mtd_is_aligned_with_min_io_size(mtd, off) ||
+	    !mtd_is_aligned_with_min_io_size(mtd, len) || !len ||
+	    off + len > mtd->size) {
+		printf("Region must be page-aligned and within the device\n");
+		goto out_put_mtd;
+	}
+
+	buf = kmalloc(mtd->erasesize, GFP_KERNEL);
+	if (!buf) {
+		printf("Could not allocate a buffer\n");
+		goto out_put_mtd;
+	}
+
+	printf("Reading %lld byte(s) at offset 0x%08llx\n", len, off);
+
+	/* A page at a time, as a baseline */
+	if (mtd->writesize > 1) {
+		ret = mtd_bench_read(mtd, off, len, mtd->writesize, buf,
+				     &time_us);
+		if (ret)
+			goto out_free;
+		mtd_bench_show("page reads", len, time_us);
+	}
+
+	/* A block at a time, which lets the driver read sequentially */
+	ret = mtd_bench_read(mtd, off, len, mtd->erasesize, buf, &time_us);
+	if (ret)
+		goto out_free;
+	mtd_bench_show("block reads", len, time_us);
+
+out_free:
+	kfree(buf);
+	if (ret) {
+		printf("Benchmark on %s failed with error %d\n", mtd->name,
+		       ret);
+		ret = CMD_RET_FAILURE;
+	}
+out_put_mtd:
+	put_mtd_device(mtd);
+
+	return ret;
+}
+#endif
+
 static int do_mtd_erase(struct cmd_tbl *cmdtp, int flag, int argc,
 			char *const argv[])
 {
@@ -777,6 +904,9 @@ U_BOOT_LONGHELP(mtd,
 	"\n"
 	"Specific functions:\n"
 	"mtd bad                               <name>\n"
+#if CONFIG_IS_ENABLED(CMD_MTD_BENCH)
+	"mtd bench                             <name>        [<off> [<size>]]\n"
+#endif
 #if CONFIG_IS_ENABLED(CMD_MTD_OTP)
 	"mtd otpread                           <name> [u|f] <off> <size>\n"
 	"mtd otpwrite                          <name> <off> <hex string>\n"
@@ -816,5 +946,9 @@ U_BOOT_CMD_WITH_SUBCMDS(mtd, "MTD utils", mtd_help_text,
 					     mtd_name_complete),
 		U_BOOT_SUBCMD_MKENT_COMPLETE(erase, 4, 0, do_mtd_erase,
 					     mtd_name_complete),
+#if CONFIG_IS_ENABLED(CMD_MTD_BENCH)
+		U_BOOT_SUBCMD_MKENT_COMPLETE(bench, 4, 0, do_mtd_bench,
+					     mtd_name_complete),
+#endif
 		U_BOOT_SUBCMD_MKENT_COMPLETE(bad, 2, 1, do_mtd_bad,
 					     mtd_name_complete));
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Command for the sampling profiler
+ */
+
+#include <command.h>
+#include <env.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <profiler.h>
+#include <vsprintf.h>
+
+/* Default number of samples per second */
+#define PROFILE_DEFAULT_RATE	1000
+
+/* Buffer for the samples, allocated when first needed */
+static void *sample_buf;
+
+static int start_profiler(uint rate_hz)
+{
+	int ret;
+
+	if (!sample_buf) {
+		sample_buf = malloc(CONFIG_PROFILER_BUF_SIZE);
+		if (!sample_buf) {
+			printf("Out of memory\n");
+			return CMD_RET_FAILURE;
+		}
+	}
+	ret = profiler_start(sample_buf, CONFIG_PROFILER_BUF_SIZE, rate_hz);
+	if (ret) {
+		printf("Cannot start profiler (err=%d)\n", ret);
+		return CMD_RET_FAILURE;
+	}
+
+	return 0;
+}
+
+static int do_profile_start(struct cmd_tbl *cmdtp, int flag, int argc,
+			    char *const argv[])
+{
+	uint rate_hz = PROFILE_DEFAULT_RATE;
+
+	if (argc > 1)
+		rate_hz = dectoul(argv[1], NULL);
+
+	return start_profiler(rate_hz);
+}
+
+static int do_profile_stop(struct cmd_tbl *cmdtp, int flag, int argc,
+			   char *const argv[])
+{
+	if (profiler_stop()) {
+		printf("Profiler is not running\n");
+		return CMD_RET_FAILURE;
+	}
+
+	return 0;
+}
+
+static int do_profile_run(struct cmd_tbl *cmdtp, int flag, int argc,
+			  char *const argv[])
+{
+	int ret;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+	ret = start_profiler(PROFILE_DEFAULT_RATE);
+	if (ret)
+		return ret;
+	ret = run_command(argv[1], flag);
+	profiler_stop();
+
+	return ret ? CMD_RET_FAILURE : 0;
+}
+
+static int do_profile_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			    char *const argv[])
+{
+	struct profiler_stats stats;
+
+	profiler_get_stats(&stats);
+	printf("Profiler:  %s, %u Hz\n",
+	       profiler_running() ? "running" : "stopped", stats.rate_hz);
+	printf("Samples:   %lu\n", stats.samples);
+	printf("Dropped:   %lu (buffer full)\n", stats.dropped);
+	printf("Outside:   %lu (program counter not in U-Boot)\n",
+	       stats.outside);
+	printf("Buffer:    %lx / %lx bytes\n", stats.used, stats.size);
+
+	return 0;
+}
+
+static int do_profile_samples(struct cmd_tbl *cmdtp, int flag, int argc,
+			      char *const argv[])
+{
+	ulong buf_size, buf_ptr, avail, needed, used;
+	char *buf;
+
+	if (profiler_running()) {
+		printf("Profiler is running\n");
+		return CMD_RET_FAILURE;
+	}
+	if (argc < 3) {
+		buf_size = env_get_ulong("profsize", 16, 0);
+		buf = map_sysmem(env_get_ulong("profbase", 16, 0), buf_size);
+		buf_ptr = env_get_ulong("profoffset", 16, 0);
+	} else {
+		buf_size = hextoul(argv[2], NULL);
+		buf = map_sysmem(hextoul(argv[1], NULL), buf_size);
+		buf_ptr = 0;
+	}
+	if (!buf_size || buf_ptr > buf_size)
+		return CMD_RET_USAGE;
+
+	avail = buf_size - buf_ptr;
+	if (profiler_list_samples(buf + buf_ptr, avail, &needed)) {
+		printf("Error: buffer too small (%#lx bytes needed)\n", needed);
+		return CMD_RET_FAILURE;
+	}
+	used = needed;
+	printf("Samples dumped to %08lx, size %#lx\n",
+	       (ulong)map_to_sysmem(buf + buf_ptr), used);
+
+	env_set_hex("profbase", map_to_sysmem(buf));
+	env_set_hex("profsize", buf_size);
+	env_set_hex("profoffset", buf_ptr + used);
+
+	return 0;
+}
+
+U_BOOT_LONGHELP(profile,
+	"start [<rate>]             - start sampling at <rate> Hz (default 1000)\n"
+	"profile stop                       - stop sampling\n"
+	"profile run <command>              - sample while running a command\n"
+	"profile stats                      - show sampling statistics\n"
+	"profile samples [<addr> <size>]    - dump samples into buffer");
+
+U_BOOT_CMD_WITH_SUBCMDS(profile, "Sampling profiler", profile_help_text,
+	U_BOOT_SUBCMD_MKENT(start, 2, 1, do_profile_start),
+	U_BOOT_SUBCMD_MKENT(stop, 1, 1, do_profile_stop),
+	U_BOOT_SUBCMD_MKENT(run, 2, 1, do_profile_run),
+	U_BOOT_SUBCMD_MKENT(stats, 1, 1, do_profile_stats),
+	U_BOOT_SUBCMD_MKENT(samples, 3, 1, do_profile_samples));
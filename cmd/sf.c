@@ -16,6 +16,7 @@
 #include <spi.h>
 #include <time.h>
 #include <spi_flash.h>
+#include <spi-mem.h>
 #include <asm/cache.h>
 #include <jffs2/jffs2.h>
 #include <linux/mtd/mtd.h>
@@ -585,6 +586,91 @@ static int do_spi_flash_test(int argc, char *const argv[])
 	return 0;
 }
 
+/**
+ * spi_flash_bench_read() - Read a region of SPI flash and show the speed
+ *
+ * @flash: SPI flash to read
+ * @name: Name of the read path, to show
+ * @offset: Offset within flash to read
+ * @len: Number of bytes to read
+ * @buf: Buffer to read into
+ * Return: 0 if ok, -ve on error
+ */
+static int spi_flash_bench_read(struct spi_flash *flash, const char *name,
+				u32 offset, size_t len, void *buf)
+{
+	ulong start, time_us;
+	u64 speed;
+	int ret;
+
+	start = timer_get_us();
+	ret = spi_flash_read(flash, offset, len, buf);
+	if (ret) {
+		printf("%s: read failed (err = %d)\n", name, ret);
+		return ret;
+	}
+	time_us = max(timer_get_us() - start, 1UL);
+
+	speed = (u64)len * 1000000;
+	do_div(speed, time_us * 1024);
+	printf("%-18s%lu us, %u KiB/s\n", name, time_us, (uint)speed);
+
+	return 0;
+}
+
+static int do_spi_flash_bench(int argc, char *const argv[])
+{
+	enum spi_nor_protocol proto = flash->read_proto;
+	const char *dtr = spi_nor_protocol_is_dtr(proto) ? "D" : "";
+	struct spi_mem_dirmap_desc *rdesc = NULL;
+	unsigned long offset, len;
+	char *endp;
+	void *buf;
+	int ret;
+
+	if (argc < 3)
+		return CMD_RET_USAGE;
+	offset = hextoul(argv[1], &endp);
+	if (*argv[1] == 0 || *endp != 0)
+		return CMD_RET_USAGE;
+	len = hextoul(argv[2], &endp);
+	if (*argv[2] == 0 || *endp != 0 || !len)
+		return CMD_RET_USAGE;
+	if (offset + len > flash->size) {
+		printf("Region is outside the flash\n");
+		return CMD_RET_FAILURE;
+	}
+
+	buf = memalign(ARCH_DMA_MINALIGN, len);
+	if (!buf) {
+		printf("Cannot allocate memory (%lu bytes)\n", len);
+		return CMD_RET_FAILURE;
+	}
+
+	printf("Read opcode %02x, protocol %u%s-%u%s-%u%s, %u dummy cycles\n",
+	       flash->read_opcode, spi_nor_get_protocol_inst_nbits(proto), dtr,
+	       spi_nor_get_protocol_addr_nbits(proto), dtr,
+	       spi_nor_get_protocol_data_nbits(proto), dtr, flash->read_dummy);
+
+	/* Leave out the mapping so that spi-mem operations are used */
+	if (CONFIG_IS_ENABLED(SPI_DIRMAP)) {
+		rdesc = flash->dirmap.rdesc;
+		flash->dirmap.rdesc = NULL;
+	}
+	ret = spi_flash_bench_read(flash, "spi-mem ops", offset, len, buf);
+	if (CONFIG_IS_ENABLED(SPI_DIRMAP))
+		flash->dirmap.rdesc = rdesc;
+
+	/* A mapping the controller cannot create falls back to operations */
+	if (!ret && rdesc)
+		ret = spi_flash_bench_read(flash, rdesc->nodirmap ?
+					   "dirmap (emulated)" : "dirmap",
+					   offset, len, buf);
+	free(buf);
+
+	return ret ? CMD_RET_FAILURE : 0;
+}
+
 static int do_spi_flash(struct cmd_tbl *cmdtp, int flag, int argc,
 			char *const argv[])
 {
@@ -617,6 +703,8 @@ static int do_spi_flash(struct cmd_tbl *cmdtp, int flag, int argc,
 		ret = do_spi_protect(argc, argv);
 	else if (IS_ENABLED(CONFIG_CMD_SF_TEST) && !strcmp(cmd, "test"))
 		ret = do_spi_flash_test(argc, argv);
+	else if (IS_ENABLED(CONFIG_CMD_SF_BENCH) && !strcmp(cmd, "bench"))
+		ret = do_spi_flash_bench(argc, argv);
 	else
 		ret = CMD_RET_USAGE;
 
@@ -644,6 +732,9 @@ U_BOOT_LONGHELP(sf,
 #endif
 #ifdef CONFIG_CMD_SF_TEST
 	"\nsf test offset len		- run a very basic destructive test"
+#endif
+#ifdef CONFIG_CMD_SF_BENCH
+	"\nsf bench offset len		- measure the read speed of each read path"
 #endif
 	);
 
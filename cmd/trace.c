@@ -99,6 +99,9 @@ int do_trace(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 		break;
 	case 's':
 		trace_print_stats();
+		if (IS_ENABLED(CONFIG_TRACE_FUNC_TIMES))
+			trace_print_func_times(argc > 2 ?
+					       dectoul(argv[2], NULL) : 20);
 		break;
 	default:
 		return CMD_RET_USAGE;
@@ -110,7 +113,8 @@ int do_trace(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 U_BOOT_CMD(
 	trace,	4,	1,	do_trace,
 	"trace utility commands",
-	"stats                        - display tracing statistics\n"
+	"stats [<n>]                  - display tracing statistics and\n"
+	"                               the <n> slowest functions\n"
 	"trace pause                        - pause tracing\n"
 	"trace resume                       - resume tracing\n"
 	"trace funclist [<addr> <size>]     - dump function list into buffer\n"
@@ -16,6 +16,7 @@
 #include <exports.h>
 #include <led.h>
 #include <malloc.h>
+#include <mapmem.h>
 #include <memalign.h>
 #include <mtd.h>
 #include <nand.h>
@@ -836,15 +837,17 @@ static int do_ubi(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 		    strncmp(argv[1] + 5, ".part", 5) == 0) {
 			if (argc < 6) {
 				ret = ubi_volume_continue_write(argv[3],
-						(void *)addr, size);
+						map_sysmem(addr, size), size);
 			} else {
 				size_t full_size;
 				full_size = hextoul(argv[5], NULL);
 				ret = ubi_volume_begin_write(argv[3],
-						(void *)addr, size, full_size);
+						map_sysmem(addr, size), size,
+						full_size);
 			}
 		} else {
-			ret = ubi_volume_write(argv[3], (void *)addr, 0, size);
+			ret = ubi_volume_write(argv[3], map_sysmem(addr, size),
+					       0, size);
 		}
 		if (!ret) {
 			printf("%lld bytes written to volume %s\n", size,
@@ -870,7 +873,8 @@ static int do_ubi(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 		}
 
 		if (argc == 3) {
-			return ubi_volume_read(argv[3], (char *)addr, 0, size);
+			return ubi_volume_read(argv[3], map_sysmem(addr, size),
+					       0, size);
 		}
 	}
 
@@ -595,6 +595,56 @@ static AvbIOResult read_from_partition(AvbOps *ops,
 			   num_bytes, buffer, out_num_read, IO_READ);
 }
 
+/**
+ * get_preloaded_partition() - loads a partition to the address set by
+ * avb_ops_set_preload()
+ *
+ * @ops: contains AVB ops handlers
+ * @partition: partition name, NUL-terminated UTF-8 string
+ * @num_bytes: amount of bytes to read from the start of the partition
+ * @out_pointer: returns a pointer to the data, or NULL if the partition is not
+ *      preloaded, in which case libavb reads it with read_from_partition()
+ * @out_num_bytes_preloaded: returns the number of bytes read
+ *
+ * @return:
+ *      AVB_IO_RESULT_OK, if the partition was loaded or is not preloaded
+ *      AVB_IO_RESULT_ERROR_IO, if i/o error occurred from the underlying i/o
+ *            subsystem
+ *      AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION, if there is no partition with
+ *      the given name
+ */
+static AvbIOResult get_preloaded_partition(AvbOps *ops,
+					   const char *partition,
+					   size_t num_bytes,
+					   u8 **out_pointer,
+					   size_t *out_num_bytes_preloaded)
+{
+	struct AvbOpsData *data = ops->user_data;
+	const struct avb_preload *preload;
+	AvbIOResult ret;
+	void *buf;
+	int i;
+
+	*out_pointer = NULL;
+	for (i = 0; i < data->preload_count; i++) {
+		preload = &data->preload[i];
+		if (strcmp(preload->name, partition))
+			continue;
+
+		buf = map_sysmem(preload->addr, num_bytes);
+		ret = mmc_byte_io(ops, partition, 0, num_bytes, buf,
+				  out_num_bytes_preloaded, IO_READ);
+		if (ret != AVB_IO_RESULT_OK) {
+			unmap_sysmem(buf);
+			return ret;
+		}
+		*out_pointer = buf;
+		break;
+	}
+
+	return AVB_IO_RESULT_OK;
+}
+
 /**
  * write_to_partition() - writes N bytes to a partition identified by a string
  * name
@@ -1055,11 +1105,21 @@ AvbOps *avb_ops_alloc(int boot_device)
 	ops_data->ops.read_persistent_value = read_persistent_value;
 #endif
 	ops_data->ops.get_size_of_partition = get_size_of_partition;
+	ops_data->ops.get_preloaded_partition = get_preloaded_partition;
 	ops_data->mmc_dev = boot_device;
 
 	return &ops_data->ops;
 }
 
+void avb_ops_set_preload(AvbOps *ops, const struct avb_preload *preload,
+			 int count)
+{
+	struct AvbOpsData *ops_data = ops->user_data;
+
+	ops_data->preload = preload;
+	ops_data->preload_count = count;
+}
+
 void avb_ops_free(AvbOps *ops)
 {
 	struct AvbOpsData *ops_data;
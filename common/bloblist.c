@@ -61,6 +61,10 @@ static struct tag_name {
 	{ BLOBLISTT_U_BOOT_SPL_HANDOFF, "SPL hand-off" },
 	{ BLOBLISTT_VBE, "VBE" },
 	{ BLOBLISTT_U_BOOT_VIDEO, "SPL video handoff" },
+	{ BLOBLISTT_U_BOOT_DM_PROBE_STATS, "Device probe stats" },
+	{ BLOBLISTT_U_BOOT_DM_BIND_PLAN, "Devicetree bind plan" },
+	{ BLOBLISTT_U_BOOT_LOG_BINARY, "Binary log ring" },
+	{ BLOBLISTT_U_BOOT_LOG_TEXT, "Log text" },
 
 	/* BLOBLISTT_VENDOR_AREA */
 };
@@ -17,6 +17,7 @@
 #include <sort.h>
 #include <spl.h>
 #include <asm/global_data.h>
+#include <dm/util.h>
 #include <linux/compiler.h>
 #include <linux/libfdt.h>
 
@@ -317,6 +318,10 @@ static int add_bootstages_devicetree(struct fdt_header *blob)
 			return -EINVAL;
 	}
 
+	if (CONFIG_IS_ENABLED(DM_PROBE_STATS) &&
+	    dm_probe_stats_fdt_add(blob, bootstage, i))
+		return -EINVAL;
+
 	return 0;
 }
 
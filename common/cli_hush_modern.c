@@ -20,6 +20,8 @@
 #include <cli.h>
 #include <cli_hush.h>
 #include <command.h>        /* find_cmd */
+#include <search.h>
+#include <time.h>
 #include <asm/global_data.h>
 
 /*
@@ -259,6 +261,8 @@ static int u_boot_cli_readline(struct in_str *i);
 struct in_str;
 static int u_boot_cli_readline(struct in_str *i);
 
+static int u_boot_hush_run_script(const char *cmd);
+
 /*
  * BusyBox globals which are needed for hush.
  */
@@ -321,3 +325,199 @@ static int u_boot_cli_readline(struct in_str *i)
 
 	return cli_readline(prompt);
 }
+
+#if CONFIG_IS_ENABLED(HUSH_SCRIPT_CACHE)
+/**
+ * struct hush_script - A script which has been parsed
+ *
+ * @text: Copy of the script text, or NULL if this entry is not in use
+ * @len: Length of the text in bytes
+ * @hash: Hash of the text, to avoid comparing every script
+ * @pipe_list: Parsed script, ready to run
+ * @busy: Number of times the script is currently running (it may run itself)
+ * @last_used: Value of hush_cache.clock when the script was last run
+ */
+struct hush_script {
+	char *text;
+	uint len;
+	u32 hash;
+	struct pipe *pipe_list;
+	uint busy;
+	ulong last_used;
+};
+
+/**
+ * struct hush_cache - Scripts which have been parsed, to save parsing again
+ *
+ * @script: Cached scripts
+ * @clock: Incremented each time a script is run, to find the least recent one
+ * @depth: Number of scripts currently running
+ * @stats: Information about the scripts run
+ */
+struct hush_cache {
+	struct hush_script script[CONFIG_HUSH_SCRIPT_CACHE_SIZE];
+	ulong clock;
+	uint depth;
+	struct hush_stats stats;
+};
+
+static struct hush_cache hush_cache;
+
+static struct hush_script *hush_script_find(const char *text, uint len,
+					    u32 hash)
+{
+	struct hush_script *script;
+
+	for (script = hush_cache.script;
+	     script < hush_cache.script + CONFIG_HUSH_SCRIPT_CACHE_SIZE;
+	     script++) {
+		if (script->text && script->hash == hash && script->len == len &&
+		    !memcmp(script->text, text, len))
+			return script;
+	}
+
+	return NULL;
+}
+
+static void hush_script_free(struct hush_script *script)
+{
+	free_pipe_list(script->pipe_list);
+	free(script->text);
+	script->pipe_list = NULL;
+	script->text = NULL;
+	hush_cache.stats.cached--;
+}
+
+/*
+ * Find an entry for a new script, dropping the least recently used one if
+ * needed. Scripts which are running cannot be dropped.
+ */
+static struct hush_script *hush_script_alloc(void)
+{
+	struct hush_script *script, *lru = NULL;
+
+	for (script = hush_cache.script;
+	     script < hush_cache.script + CONFIG_HUSH_SCRIPT_CACHE_SIZE;
+	     script++) {
+		if (!script->text)
+			return script;
+		if (!script->busy &&
+		    (!lru || script->last_used < lru->last_used))
+			lru = script;
+	}
+	if (lru) {
+		hush_script_free(lru);
+		hush_cache.stats.evictions++;
+	}
+
+	return lru;
+}
+
+/* Parse a script, or find it in the cache, then run it */
+static int hush_script_run(const char *cmd)
+{
+	struct hush_stats *stats = &hush_cache.stats;
+	struct hush_script *script;
+	struct in_str input;
+	ulong start;
+	uint len;
+	u32 hash;
+
+	hash = hash_string(cmd);
+	len = strlen(cmd);
+	script = hush_script_find(cmd, len, hash);
+	if (script) {
+		stats->hits++;
+	} else {
+		stats->misses++;
+		script = hush_script_alloc();
+		if (!script)
+			return parse_and_run_string(cmd);
+
+		start = timer_get_us();
+		setup_string_in_str(&input, cmd);
+		script->pipe_list = parse_stream(NULL, NULL, &input, '\0');
+		stats->parse_us += timer_get_us() - start;
+
+		/* Same as parse_and_run_stream() for an empty script or error */
+		if (!script->pipe_list) {
+			G.last_exitcode = 0;
+			return 0;
+		}
+		if (script->pipe_list == ERR_PTR) {
+			script->pipe_list = NULL;
+			return G.last_exitcode;
+		}
+		script->text = strdup(cmd);
+		if (!script->text) {
+			run_and_free_list(script->pipe_list);
+			script->pipe_list = NULL;
+			return G.last_exitcode;
+		}
+		script->len = len;
+		script->hash = hash;
+		stats->cached++;
+	}
+	script->last_used = ++hush_cache.clock;
+
+	script->busy++;
+	run_list(script->pipe_list);
+	script->busy--;
+
+	return G.last_exitcode;
+}
+
+static int u_boot_hush_run_script(const char *cmd)
+{
+	struct hush_stats *stats = &hush_cache.stats;
+	u64 parse_us = stats->parse_us;
+	ulong start = timer_get_us();
+	int ret;
+
+	stats->runs++;
+	hush_cache.depth++;
+	ret = hush_script_run(cmd);
+	hush_cache.depth--;
+
+	/*
+	 * Nested scripts are included in the time for the outermost one, so
+	 * only count that, leaving out any time spent parsing
+	 */
+	if (!hush_cache.depth)
+		stats->exec_us += timer_get_us() - start -
+			(stats->parse_us - parse_us);
+
+	return ret;
+}
+
+void hush_get_stats(struct hush_stats *stats)
+{
+	*stats = hush_cache.stats;
+}
+
+void hush_flush_cache(void)
+{
+	struct hush_script *script;
+
+	for (script = hush_cache.script;
+	     script < hush_cache.script + CONFIG_HUSH_SCRIPT_CACHE_SIZE;
+	     script++) {
+		if (script->text && !script->busy)
+			hush_script_free(script);
+	}
+}
+
+void hush_reset_stats(void)
+{
+	struct hush_stats *stats = &hush_cache.stats;
+	uint cached = stats->cached;
+
+	memset(stats, '\0', sizeof(*stats));
+	stats->cached = cached;
+}
+#else
+static int u_boot_hush_run_script(const char *cmd)
+{
+	return parse_and_run_string(cmd);
+}
+#endif /* HUSH_SCRIPT_CACHE */
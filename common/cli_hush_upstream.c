@@ -8124,7 +8124,7 @@ int parse_string_outer_modern(const char *cmd, int flags)
 	old_flags = G.run_command_flags;
 	G.run_command_flags = flags;
 
-	ret = parse_and_run_string(cmd);
+	ret = u_boot_hush_run_script(cmd);
 
 	G.run_command_flags = old_flags;
 
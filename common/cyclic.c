@@ -42,7 +42,8 @@ void cyclic_register(struct cyclic_info *cyclic, cyclic_func_t func,
 
 void cyclic_unregister(struct cyclic_info *cyclic)
 {
-	hlist_del(&cyclic->list);
+	/* Allow this to be called for a function that is not registered */
+	hlist_del_init(&cyclic->list);
 }
 
 static void cyclic_run(void)
@@ -98,7 +99,7 @@ void schedule(void)
 	 * schedule() might get called very early before the cyclic IF is
 	 * ready. Make sure to only call cyclic_run() when it's initalized.
 	 */
-	if (gd)
+	if (gd && !(gd->flags & GD_FLG_SMP_WORKER))
 		cyclic_run();
 }
 
@@ -196,7 +196,8 @@ static bool log_passes_filters(struct log_device *ldev, struct log_rec *rec)
  * log_dispatch() - Send a log record to all log devices for processing
  *
  * The log record is sent to each log device in turn, skipping those which have
- * filters which block the record.
+ * filters which block the record. The message is only formatted if a device
+ * needs it, i.e. one without an emit_args() method.
  *
  * All log messages created while processing log record @rec are ignored.
  *
@@ -221,6 +222,14 @@ static int log_dispatch(struct log_rec *rec, const char *fmt, va_list args)
 	list_for_each_entry(ldev, &gd->log_head, sibling_node) {
 		if ((ldev->flags & LOGDF_ENABLE) &&
 		    log_passes_filters(ldev, rec)) {
+			if (ldev->drv->emit_args) {
+				va_list copy;
+
+				va_copy(copy, args);
+				ldev->drv->emit_args(ldev, rec, fmt, copy);
+				va_end(copy);
+				continue;
+			}
 			if (!rec->msg) {
 				int len;
 
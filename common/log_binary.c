@@ -0,0 +1,882 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Log driver which records unformatted log messages in a ring in the bloblist
+ *
+ * Formatting a message is much more expensive than recording it, so this
+ * driver stores the format string pointer and the raw arguments, leaving the
+ * formatting until the records are dumped. Strings passed with %s are copied,
+ * since they may not last, and %p extensions (%pM, %pU, etc.) are formatted
+ * straight away for the same reason.
+ *
+ * The ring is in a BLOBLISTT_U_BOOT_LOG_BINARY blob, which starts with
+ * struct log_bin_hdr and is followed by the records. Each record is a
+ * struct log_bin_rec followed by its arguments, padded to a multiple of 8
+ * bytes. Records do not wrap: if there is not enough space before the end of
+ * the ring, a pad record fills it and the next record starts at the
+ * beginning. The oldest records are dropped to make room for new ones.
+ *
+ * Arguments are stored one after the other, in the order they appear in the
+ * format string, with no alignment:
+ *
+ *    - '*' width or precision: int
+ *    - integer conversions: int, long or long long depending on the length
+ *      modifier (h, hh and none: int; l, z, Z and t: long; ll, L, q and j:
+ *      long long)
+ *    - %p: void *
+ *    - %s and %p with an extension: nul-terminated string
+ *
+ * The format string, file and function are stored as pointers, so the ring
+ * can only be decoded by the U-Boot binary which wrote it. The header holds
+ * a CRC32 of the version string, so a ring left by a different binary is
+ * discarded.
+ */
+
+#include <bloblist.h>
+#include <div64.h>
+#include <log.h>
+#include <time.h>
+#include <version_string.h>
+#include <asm/global_data.h>
+#include <linux/ctype.h>
+#include <linux/string.h>
+#include <u-boot/crc.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Identifies a valid ring: 'LBIN' */
+#define LOG_BIN_MAGIC		0x4e49424c
+
+/* Maximum number of bytes of arguments in a record */
+#define LOG_BIN_MAX_ARGS	256
+
+/* Maximum length of a string argument, including the terminator */
+#define LOG_BIN_MAX_STR		80
+
+/* Value of log_bin_rec.level used for a pad record */
+#define LOG_BIN_PAD		0xff
+
+/**
+ * enum log_bin_rec_flags - Flags for a binary log record
+ *
+ * These are in addition to enum log_rec_flags
+ *
+ * @LOG_BIN_RECF_PRE_RELOC: Record was written before relocation, so its
+ *	pointers must be adjusted by gd->reloc_off after relocation
+ * @LOG_BIN_RECF_TRUNC: Not all arguments fitted in the record
+ */
+enum log_bin_rec_flags {
+	LOG_BIN_RECF_PRE_RELOC	= BIT(6),
+	LOG_BIN_RECF_TRUNC	= BIT(7),
+};
+
+/**
+ * struct log_bin_hdr - Header for the binary log ring
+ *
+ * @magic: LOG_BIN_MAGIC
+ * @version_crc: CRC32 of the U-Boot version string
+ * @size: Size of the ring in bytes, a multiple of 8
+ * @head: Offset where the next record is written
+ * @tail: Offset of the oldest record
+ * @used: Number of bytes used by records, including pad records
+ * @count: Number of records, excluding pad records
+ * @lost: Number of records dropped to make room for newer ones
+ * @truncated: Number of records with LOG_BIN_RECF_TRUNC
+ * @data: The ring itself
+ */
+struct log_bin_hdr {
+	u32 magic;
+	u32 version_crc;
+	u32 size;
+	u32 head;
+	u32 tail;
+	u32 used;
+	u32 count;
+	u32 lost;
+	u32 truncated;
+	u32 reserved;
+	u8 data[];
+};
+
+/**
+ * struct log_bin_rec - A record in the binary log ring
+ *
+ * @size: Size of the record in bytes, including the arguments and padding
+ * @cat: Category (enum log_category_t)
+ * @line: Line number where the record was generated
+ * @level: Level (enum log_level_t), or LOG_BIN_PAD for a pad record, which
+ *	has no other fields
+ * @flags: enum log_rec_flags and enum log_bin_rec_flags
+ * @time_us: Time when the record was generated, in microseconds
+ * @fmt: Format string
+ * @file: Name of the file where the record was generated
+ * @func: Function where the record was generated
+ * @args: Arguments for @fmt
+ */
+struct log_bin_rec {
+	u16 size;
+	u16 cat;
+	u16 line;
+	u8 level;
+	u8 flags;
+	u64 time_us;
+	const char *fmt;
+	const char *file;
+	const char *func;
+	u8 args[];
+};
+
+/**
+ * enum log_bin_arg_t - Type of argument needed by a conversion
+ *
+ * @ARG_NONE: No argument, e.g. %%
+ * @ARG_INT: int
+ * @ARG_LONG: long
+ * @ARG_LLONG: long long
+ * @ARG_PTR: void *
+ * @ARG_STR: String, stored in the record
+ * @ARG_PTR_EXT: %p with an extension, stored as a string in the record
+ * @ARG_BAD: Unsupported conversion; the rest of the format string is ignored
+ */
+enum log_bin_arg_t {
+	ARG_NONE,
+	ARG_INT,
+	ARG_LONG,
+	ARG_LLONG,
+	ARG_PTR,
+	ARG_STR,
+	ARG_PTR_EXT,
+	ARG_BAD,
+};
+
+/**
+ * struct log_bin_spec - A conversion in a format string
+ *
+ * @end: Pointer to the character after the conversion
+ * @nstar: Number of '*' width and precision arguments (0-2)
+ * @type: Type of argument needed
+ * @buf: The conversion, nul-terminated, for passing to snprintf()
+ */
+struct log_bin_spec {
+	const char *end;
+	int nstar;
+	enum log_bin_arg_t type;
+	char buf[20];
+};
+
+/* Size of the ring, which must be a multiple of 8 */
+#define LOG_BIN_SIZE		(CONFIG_LOG_BINARY_SIZE & ~7)
+
+/* Ring which has been checked, to avoid checking it for every record */
+static struct log_bin_hdr *ring __section(".data");
+
+/*
+ * Bloblist and its used size when @ring was found. The ring moves if the
+ * bloblist is relocated or an earlier blob is resized, both of which change
+ * one of these.
+ */
+static struct bloblist_hdr *ring_bloblist __section(".data");
+static ulong ring_bloblist_size __section(".data");
+
+/**
+ * is_ptr_ext() - Check if a %p conversion has an extension
+ *
+ * Only the extensions handled by pointer() in vsprintf.c are recognised. These
+ * read the data at the pointer, so must be formatted when the record is
+ * written. Anything else is printed as a plain pointer.
+ *
+ * @p: Pointer to the character after the 'p'
+ * Return: true if this is an extension, false if not
+ */
+static bool is_ptr_ext(const char *p)
+{
+	switch (*p) {
+	case 'a':
+	case 'D':
+	case 'm':
+	case 'M':
+	case 'U':
+		return true;
+	case 'i':
+	case 'I':
+		return p[1] == '4' || p[1] == '6';
+	default:
+		return false;
+	}
+}
+
+/**
+ * parse_spec() - Parse a conversion in a format string
+ *
+ * This follows the conversions supported by vsnprintf()
+ *
+ * @p: Pointer to the '%' which starts the conversion
+ * @spec: Returns information about the conversion
+ */
+static void parse_spec(const char *p, struct log_bin_spec *spec)
+{
+	const char *start = p++;
+	int len = 0;
+
+	spec->nstar = 0;
+	spec->type = ARG_BAD;
+	if (*p == '%') {
+		spec->type = ARG_NONE;
+		spec->end = p + 1;
+		return;
+	}
+	while (*p && strchr("-+ #0", *p))
+		p++;
+	if (*p == '*') {
+		spec->nstar++;
+		p++;
+	}
+	while (isdigit(*p))
+		p++;
+	if (*p == '.') {
+		p++;
+		if (*p == '*') {
+			spec->nstar++;
+			p++;
+		}
+		while (isdigit(*p))
+			p++;
+	}
+	if (*p == 'h') {
+		p++;
+		if (*p == 'h')
+			p++;
+	} else if (*p == 'l') {
+		len = 1;
+		p++;
+		if (*p == 'l') {
+			len = 2;
+			p++;
+		}
+	} else if (*p && strchr("zZt", *p)) {
+		len = 1;
+		p++;
+	} else if (*p && strchr("Lqj", *p)) {
+		len = 2;
+		p++;
+	}
+
+	switch (*p) {
+	case 'c':
+		spec->type = ARG_INT;
+		break;
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'o':
+		spec->type = len == 2 ? ARG_LLONG : len ? ARG_LONG : ARG_INT;
+		break;
+	case 's':
+		spec->type = ARG_STR;
+		break;
+	case 'p':
+		spec->type = is_ptr_ext(p + 1) ? ARG_PTR_EXT : ARG_PTR;
+		/* vsnprintf() skips all alphanumeric suffixes, so do the same */
+		while (isalnum(p[1]))
+			p++;
+		break;
+	default:
+		spec->end = p;
+		return;
+	}
+	spec->end = ++p;
+	if (spec->end - start >= sizeof(spec->buf)) {
+		spec->type = ARG_BAD;
+		return;
+	}
+	strlcpy(spec->buf, start, spec->end - start + 1);
+}
+
+/* Remember where the ring is, so it need not be looked up again */
+static struct log_bin_hdr *set_ring(struct log_bin_hdr *hdr)
+{
+	ring = hdr;
+	ring_bloblist = gd->bloblist;
+	ring_bloblist_size = bloblist_get_size();
+
+	return hdr;
+}
+
+/**
+ * get_ring() - Get the binary log ring, setting it up if needed
+ *
+ * Return: pointer to the ring, or NULL if there is none and it cannot be
+ * created
+ */
+static struct log_bin_hdr *get_ring(void)
+{
+	struct log_bin_hdr *hdr;
+	u32 crc;
+	int size;
+
+	if (!gd->bloblist)
+		return NULL;
+
+	/* The ring only moves if the bloblist or its used size changes */
+	if (ring && gd->bloblist == ring_bloblist &&
+	    bloblist_get_size() == ring_bloblist_size &&
+	    ring->magic == LOG_BIN_MAGIC)
+		return ring;
+
+	size = sizeof(*hdr) + LOG_BIN_SIZE;
+	hdr = bloblist_find(BLOBLISTT_U_BOOT_LOG_BINARY, size);
+	if (hdr && hdr == ring)
+		return set_ring(hdr);
+
+	crc = crc32(0, (const uchar *)version_string, strlen(version_string));
+	if (!hdr) {
+		/* Avoid an error message if the bloblist is too small */
+		if (bloblist_find(BLOBLISTT_U_BOOT_LOG_BINARY, 0) ||
+		    bloblist_get_size() + sizeof(struct bloblist_rec) +
+		    ALIGN(size, BLOBLIST_BLOB_ALIGN) >
+		    bloblist_get_total_size())
+			return NULL;
+		hdr = bloblist_add(BLOBLISTT_U_BOOT_LOG_BINARY, size, 0);
+		if (!hdr)
+			return NULL;
+	} else if (hdr->magic == LOG_BIN_MAGIC && hdr->version_crc == crc &&
+		   hdr->size == LOG_BIN_SIZE &&
+		   hdr->head < hdr->size && hdr->tail < hdr->size &&
+		   hdr->used <= hdr->size) {
+		/* Keep the records from before the reset */
+		return set_ring(hdr);
+	}
+	memset(hdr, '\0', sizeof(*hdr));
+	hdr->magic = LOG_BIN_MAGIC;
+	hdr->version_crc = crc;
+	hdr->size = LOG_BIN_SIZE;
+
+	return set_ring(hdr);
+}
+
+/* Drop the oldest record from the ring */
+static void drop_oldest(struct log_bin_hdr *hdr)
+{
+	struct log_bin_rec *rec = (struct log_bin_rec *)(hdr->data + hdr->tail);
+
+	hdr->tail += rec->size;
+	if (hdr->tail == hdr->size)
+		hdr->tail = 0;
+	hdr->used -= rec->size;
+	if (rec->level != LOG_BIN_PAD) {
+		hdr->count--;
+		hdr->lost++;
+	}
+}
+
+/**
+ * reserve() - Make space for a record in the ring
+ *
+ * @hdr: Ring to use
+ * @size: Size of the record in bytes, a multiple of 8
+ * Return: pointer to the space, or NULL if the record is too large
+ */
+static void *reserve(struct log_bin_hdr *hdr, uint size)
+{
+	void *ptr;
+
+	if (size > hdr->size)
+		return NULL;
+	for (;;) {
+		uint avail;
+
+		if (!hdr->used)
+			hdr->head = hdr->tail = 0;
+		if (!hdr->used || hdr->tail < hdr->head)
+			avail = hdr->size - hdr->head;
+		else
+			avail = hdr->tail - hdr->head;
+		if (avail >= size)
+			break;
+
+		if (hdr->tail < hdr->head) {
+			struct log_bin_rec *pad;
+
+			/* Fill the end of the ring and start again at 0 */
+			pad = (struct log_bin_rec *)(hdr->data + hdr->head);
+			pad->size = avail;
+			pad->level = LOG_BIN_PAD;
+			hdr->used += avail;
+			hdr->head = 0;
+		} else {
+			drop_oldest(hdr);
+		}
+	}
+	ptr = hdr->data + hdr->head;
+	hdr->head += size;
+	if (hdr->head == hdr->size)
+		hdr->head = 0;
+	hdr->used += size;
+
+	return ptr;
+}
+
+/* Add @size bytes at @src to the arguments, returning false if no space */
+static bool add_arg(u8 *buf, uint *posp, const void *src, uint size)
+{
+	if (*posp + size > LOG_BIN_MAX_ARGS)
+		return false;
+	memcpy(buf + *posp, src, size);
+	*posp += size;
+
+	return true;
+}
+
+/* Add a string to the arguments, truncating it if needed */
+static bool add_str(u8 *buf, uint *posp, const char *str)
+{
+	uint len = strnlen(str, LOG_BIN_MAX_STR - 1);
+
+	if (*posp + len + 1 > LOG_BIN_MAX_ARGS)
+		return false;
+	memcpy(buf + *posp, str, len);
+	buf[*posp + len] = '\0';
+	*posp += len + 1;
+
+	return true;
+}
+
+static int log_binary_emit_args(struct log_device *ldev, struct log_rec *rec,
+				const char *fmt, va_list args)
+{
+	union {
+		struct log_bin_rec rec;
+		u8 buf[sizeof(struct log_bin_rec) + LOG_BIN_MAX_ARGS];
+	} out;
+	struct log_bin_hdr *hdr;
+	struct log_bin_spec spec;
+	const char *p;
+	uint pos = 0;
+	void *ptr;
+	int i;
+
+	hdr = get_ring();
+	if (!hdr)
+		return -ENOSPC;
+
+	out.rec.cat = rec->cat;
+	out.rec.line = rec->line;
+	out.rec.level = rec->level;
+	out.rec.flags = rec->flags;
+	if (!(gd->flags & GD_FLG_RELOC))
+		out.rec.flags |= LOG_BIN_RECF_PRE_RELOC;
+	out.rec.time_us = 0;
+	/* Avoid recursion while the timer itself is being probed */
+	if (!CONFIG_IS_ENABLED(TIMER) || gd->timer)
+		out.rec.time_us = timer_get_us();
+	out.rec.fmt = fmt;
+	out.rec.file = rec->file;
+	out.rec.func = rec->func;
+
+	for (p = strchr(fmt, '%'); p; p = strchr(spec.end, '%')) {
+		bool ok = true;
+		int star[2] = {};
+
+		parse_spec(p, &spec);
+		if (spec.type == ARG_BAD)
+			break;
+		for (i = 0; ok && i < spec.nstar; i++) {
+			star[i] = va_arg(args, int);
+			ok = add_arg(out.rec.args, &pos, &star[i], sizeof(int));
+		}
+		switch (spec.type) {
+		case ARG_INT: {
+			int val = va_arg(args, int);
+
+			ok = ok && add_arg(out.rec.args, &pos, &val, sizeof(val));
+			break;
+		}
+		case ARG_LONG: {
+			long val = va_arg(args, long);
+
+			ok = ok && add_arg(out.rec.args, &pos, &val, sizeof(val));
+			break;
+		}
+		case ARG_LLONG: {
+			long long val = va_arg(args, long long);
+
+			ok = ok && add_arg(out.rec.args, &pos, &val, sizeof(val));
+			break;
+		}
+		case ARG_PTR:
+			ptr = va_arg(args, void *);
+			ok = ok && add_arg(out.rec.args, &pos, &ptr, sizeof(ptr));
+			break;
+		case ARG_STR:
+			ptr = va_arg(args, char *);
+			ok = ok && add_str(out.rec.args, &pos, ptr ?: "(null)");
+			break;
+		case ARG_PTR_EXT: {
+			char str[LOG_BIN_MAX_STR];
+
+			ptr = va_arg(args, void *);
+			if (spec.nstar == 2)
+				snprintf(str, sizeof(str), spec.buf, star[0],
+					 star[1], ptr);
+			else if (spec.nstar)
+				snprintf(str, sizeof(str), spec.buf, star[0],
+					 ptr);
+			else
+				snprintf(str, sizeof(str), spec.buf, ptr);
+			ok = ok && add_str(out.rec.args, &pos, str);
+			break;
+		}
+		default:
+			break;
+		}
+		if (!ok) {
+			out.rec.flags |= LOG_BIN_RECF_TRUNC;
+			break;
+		}
+	}
+
+	out.rec.size = ALIGN(sizeof(out.rec) + pos, 8);
+	ptr = reserve(hdr, out.rec.size);
+	if (!ptr)
+		return -E2BIG;
+	memcpy(ptr, &out, sizeof(out.rec) + pos);
+	hdr->count++;
+	if (out.rec.flags & LOG_BIN_RECF_TRUNC)
+		hdr->truncated++;
+
+	return 0;
+}
+
+/* Read an argument from a record, returning false if there are no more */
+static bool get_arg(const struct log_bin_rec *rec, uint *posp, void *dest,
+		    uint size)
+{
+	if (sizeof(*rec) + *posp + size > rec->size)
+		return false;
+	memcpy(dest, rec->args + *posp, size);
+	*posp += size;
+
+	return true;
+}
+
+/* Read a string argument from a record, returning NULL if there are no more */
+static const char *get_str(const struct log_bin_rec *rec, uint *posp)
+{
+	const char *str = (const char *)rec->args + *posp;
+	uint max = rec->size - sizeof(*rec) - *posp;
+	uint len;
+
+	if (*posp >= rec->size - sizeof(*rec))
+		return NULL;
+	len = strnlen(str, max);
+	if (len == max)
+		return NULL;
+	*posp += len + 1;
+
+	return str;
+}
+
+/* Call snprintf() with the '*' arguments needed by the conversion */
+#define FMT_ARG(val) \
+	(spec.nstar == 2 ? \
+		snprintf(out, end - out, spec.buf, star[0], star[1], val) : \
+	 spec.nstar ? snprintf(out, end - out, spec.buf, star[0], val) : \
+		snprintf(out, end - out, spec.buf, val))
+
+/**
+ * format_msg() - Format the message for a record
+ *
+ * @rec: Record to format
+ * @fmt: Format string for the record
+ * @buf: Buffer for the message
+ * @size: Size of @buf
+ */
+static void format_msg(const struct log_bin_rec *rec, const char *fmt,
+		       char *buf, int size)
+{
+	struct log_bin_spec spec;
+	char *out = buf, *end = buf + size;
+	const char *p, *str;
+	uint pos = 0;
+
+	for (p = fmt; *p && out < end - 1;) {
+		int star[2] = {};
+		bool ok = true;
+		int i, len;
+
+		if (*p != '%') {
+			*out++ = *p++;
+			continue;
+		}
+		parse_spec(p, &spec);
+		if (spec.type == ARG_BAD) {
+			/* Show the rest of the format string as it is */
+			strlcpy(out, p, end - out);
+			out += strlen(out);
+			p += strlen(p);
+			break;
+		}
+		for (i = 0; ok && i < spec.nstar; i++)
+			ok = get_arg(rec, &pos, &star[i], sizeof(int));
+
+		len = 0;
+		switch (spec.type) {
+		case ARG_NONE:
+			*out = '%';
+			len = 1;
+			break;
+		case ARG_INT: {
+			int val;
+
+			ok = ok && get_arg(rec, &pos, &val, sizeof(val));
+			if (ok)
+				len = FMT_ARG(val);
+			break;
+		}
+		case ARG_LONG: {
+			long val;
+
+			ok = ok && get_arg(rec, &pos, &val, sizeof(val));
+			if (ok)
+				len = FMT_ARG(val);
+			break;
+		}
+		case ARG_LLONG: {
+			long long val;
+
+			ok = ok && get_arg(rec, &pos, &val, sizeof(val));
+			if (ok)
+				len = FMT_ARG(val);
+			break;
+		}
+		case ARG_PTR: {
+			void *val;
+
+			ok = ok && get_arg(rec, &pos, &val, sizeof(val));
+			if (ok)
+				len = FMT_ARG(val);
+			break;
+		}
+		case ARG_STR:
+			str = ok ? get_str(rec, &pos) : NULL;
+			ok = str;
+			if (ok)
+				len = FMT_ARG(str);
+			break;
+		case ARG_PTR_EXT:
+			str = ok ? get_str(rec, &pos) : NULL;
+			ok = str;
+			if (ok)
+				len = snprintf(out, end - out, "%s", str);
+			break;
+		default:
+			break;
+		}
+		if (!ok)
+			break;
+		out += min(len, (int)(end - out - 1));
+		p = spec.end;
+	}
+	if (*p && out < end - 1)
+		out += snprintf(out, end - out, "...");
+	*out = '\0';
+}
+
+/* Adjust a pointer recorded before relocation, if needed */
+static const char *fix_ptr(const struct log_bin_rec *rec, const char *ptr)
+{
+	if (ptr && (rec->flags & LOG_BIN_RECF_PRE_RELOC) &&
+	    (gd->flags & GD_FLG_RELOC))
+		return ptr + gd->reloc_off;
+
+	return ptr;
+}
+
+/**
+ * format_rec() - Format a record in the same way as the console driver
+ *
+ * The timestamp is always included
+ *
+ * @rec: Record to format
+ * @buf: Buffer for the output
+ * @size: Size of @buf
+ * Return: length of the output
+ */
+static int format_rec(const struct log_bin_rec *rec, char *buf, int size)
+{
+	const char *func = fix_ptr(rec, rec->func);
+	int fmt = gd->log_fmt;
+	int len = 0;
+
+	if (!(rec->flags & LOGRECF_CONT)) {
+		u64 secs = rec->time_us;
+		uint usecs = do_div(secs, 1000000);
+
+		len = snprintf(buf, size, "[%5lu.%06u] ", (ulong)secs, usecs);
+		if (fmt & BIT(LOGF_LEVEL))
+			len += snprintf(buf + len, size - len, "%s.",
+					log_get_level_name(rec->level));
+		if (fmt & BIT(LOGF_CAT))
+			len += snprintf(buf + len, size - len, "%s,",
+					log_get_cat_name(rec->cat));
+		if (fmt & BIT(LOGF_FILE))
+			len += snprintf(buf + len, size - len, "%s:",
+					fix_ptr(rec, rec->file));
+		if (fmt & BIT(LOGF_LINE))
+			len += snprintf(buf + len, size - len, "%d-", rec->line);
+		if (fmt & BIT(LOGF_FUNC))
+			len += snprintf(buf + len, size - len, "%s()",
+					func ?: "?");
+		if (fmt != BIT(LOGF_MSG))
+			len += snprintf(buf + len, size - len, " ");
+	}
+	if (len < size - 1)
+		format_msg(rec, fix_ptr(rec, rec->fmt), buf + len, size - len);
+
+	return strlen(buf);
+}
+
+/**
+ * walk_ring() - Format each record in the ring, oldest first
+ *
+ * @hdr: Ring to use
+ * @func: Function to call with each formatted record
+ * @priv: Private data for @func
+ */
+static void walk_ring(const struct log_bin_hdr *hdr,
+		      void (*func)(const char *line, int len, void *priv),
+		      void *priv)
+{
+	char buf[CONFIG_SYS_CBSIZE];
+	uint pos = hdr->tail;
+	uint left = hdr->used;
+
+	while (left) {
+		const struct log_bin_rec *rec;
+
+		rec = (const struct log_bin_rec *)(hdr->data + pos);
+		if (rec->size < sizeof(u64) || rec->size % 8 ||
+		    rec->size > left || pos + rec->size > hdr->size ||
+		    (rec->level != LOG_BIN_PAD && rec->size < sizeof(*rec))) {
+			func("(corrupted)\n", 12, priv);
+			break;
+		}
+		if (rec->level != LOG_BIN_PAD) {
+			int len = format_rec(rec, buf, sizeof(buf));
+
+			func(buf, len, priv);
+		}
+		pos += rec->size;
+		if (pos == hdr->size)
+			pos = 0;
+		left -= rec->size;
+	}
+}
+
+static void show_line(const char *line, int len, void *priv)
+{
+	puts(line);
+}
+
+int log_binary_dump(void)
+{
+	struct log_bin_hdr *hdr = get_ring();
+
+	if (!hdr)
+		return -ENOENT;
+	walk_ring(hdr, show_line, NULL);
+
+	return 0;
+}
+
+/**
+ * struct export_info - Information for exporting the ring as text
+ *
+ * @buf: Buffer to write to, or NULL to just count the bytes
+ * @len: Number of bytes written so far (or which would be written)
+ */
+struct export_info {
+	char *buf;
+	uint len;
+};
+
+static void export_line(const char *line, int len, void *priv)
+{
+	struct export_info *info = priv;
+
+	if (info->buf)
+		memcpy(info->buf + info->len, line, len);
+	info->len += len;
+}
+
+int log_binary_export(void)
+{
+	struct log_bin_hdr *hdr = get_ring();
+	struct export_info info = {};
+	int size, ret;
+	char *text;
+
+	if (!hdr)
+		return -ENOENT;
+
+	/* Work out the size, then format the records again into the blob */
+	walk_ring(hdr, export_line, &info);
+	size = info.len + 1;
+	if (bloblist_find(BLOBLISTT_U_BOOT_LOG_TEXT, 0)) {
+		ret = bloblist_resize(BLOBLISTT_U_BOOT_LOG_TEXT, size);
+		if (ret)
+			return ret;
+		text = bloblist_find(BLOBLISTT_U_BOOT_LOG_TEXT, size);
+	} else {
+		text = bloblist_add(BLOBLISTT_U_BOOT_LOG_TEXT, size, 0);
+	}
+	if (!text)
+		return -ENOSPC;
+
+	/* The ring moves if it comes after the text */
+	hdr = get_ring();
+	if (!hdr)
+		return -ENOENT;
+	info.buf = text;
+	info.len = 0;
+	walk_ring(hdr, export_line, &info);
+	text[info.len] = '\0';
+
+	return 0;
+}
+
+void log_binary_clear(void)
+{
+	struct log_bin_hdr *hdr = get_ring();
+
+	if (!hdr)
+		return;
+	hdr->head = 0;
+	hdr->tail = 0;
+	hdr->used = 0;
+	hdr->count = 0;
+	hdr->lost = 0;
+	hdr->truncated = 0;
+}
+
+int log_binary_get_stats(struct log_binary_stats *stats)
+{
+	struct log_bin_hdr *hdr = get_ring();
+
+	if (!hdr)
+		return -ENOENT;
+	stats->size = hdr->size;
+	stats->used = hdr->used;
+	stats->count = hdr->count;
+	stats->lost = hdr->lost;
+	stats->truncated = hdr->truncated;
+
+	return 0;
+}
+
+LOG_DRIVER(binary) = {
+	.name		= "binary",
+	.emit_args	= log_binary_emit_args,
+	.flags		= LOGDF_ENABLE,
+};
@@ -0,0 +1,371 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Offloading of simple jobs to secondary CPUs
+ *
+ * Each secondary CPU has a mailbox (struct smp_work_cpu) holding a pointer to
+ * the job it should run next. Only the boot CPU posts jobs, so it can safely
+ * pick any worker whose mailbox is empty. The worker clears its mailbox after
+ * marking the job done, at which point it can accept another one.
+ */
+
+#define LOG_CATEGORY	LOGC_BOOT
+
+#include <bootstage.h>
+#include <hash.h>
+#include <log.h>
+#include <malloc.h>
+#include <smp_work.h>
+#include <time.h>
+#include <asm/cache.h>
+#include <asm/global_data.h>
+#include <linux/kernel.h>
+#include <linux/sizes.h>
+#include <u-boot/schedule.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Timeout for a secondary CPU to report that it is running */
+#define SMP_WORK_START_TIMEOUT_MS	100
+
+/* Ranges smaller than this are not worth splitting across CPUs */
+#define SMP_WORK_MIN_SPLIT		SZ_64K
+
+static struct smp_work_cpu *workers[CONFIG_SMP_WORK_MAX_CPUS];
+static int num_workers;
+/* CPUs which were started but did not report in time */
+static struct smp_work_cpu *pending[CONFIG_SMP_WORK_MAX_CPUS];
+static int num_pending;
+static int next_worker;
+static bool inited;
+
+static void smp_work_run(struct smp_work *work, int cpu)
+{
+	work->cpu = cpu;
+	__atomic_store_n(&work->state, SMP_WORK_RUNNING, __ATOMIC_RELAXED);
+	work->ret = work->func(work->arg);
+	__atomic_store_n(&work->state, SMP_WORK_DONE, __ATOMIC_RELEASE);
+}
+
+void smp_work_loop(struct smp_work_cpu *cpu)
+{
+	struct smp_work *work;
+
+	__atomic_store_n(&cpu->running, true, __ATOMIC_RELEASE);
+	while (!__atomic_load_n(&cpu->stop, __ATOMIC_ACQUIRE)) {
+		work = __atomic_load_n(&cpu->work, __ATOMIC_ACQUIRE);
+		if (!work)
+			continue;
+		smp_work_run(work, cpu->idx + 1);
+		cpu->jobs++;
+		__atomic_store_n(&cpu->work, NULL, __ATOMIC_RELEASE);
+	}
+	__atomic_store_n(&cpu->running, false, __ATOMIC_RELEASE);
+}
+
+__weak int arch_smp_work_start(struct smp_work_cpu *cpu)
+{
+	return -ENODEV;
+}
+
+__weak int arch_smp_work_stop(struct smp_work_cpu *cpu)
+{
+	return 0;
+}
+
+static void smp_work_free_cpu(struct smp_work_cpu *cpu)
+{
+	free(cpu->stack);
+	free(cpu->gd);
+	free(cpu);
+}
+
+static int smp_work_start_cpu(int idx)
+{
+	struct smp_work_cpu *cpu;
+	gd_t *new_gd;
+	ulong start;
+	int ret;
+
+	cpu = memalign(ARCH_DMA_MINALIGN, sizeof(*cpu));
+	new_gd = memalign(ARCH_DMA_MINALIGN, sizeof(*new_gd));
+	if (!cpu || !new_gd) {
+		ret = -ENOMEM;
+		goto err;
+	}
+	memset(cpu, '\0', sizeof(*cpu));
+	cpu->stack = memalign(16, CONFIG_SMP_WORK_STACK_SIZE);
+	if (!cpu->stack) {
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	/*
+	 * The worker gets its own copy of the global data, so that it cannot
+	 * disturb the boot CPU. It has no console and must not run cyclic
+	 * functions.
+	 */
+	memcpy(new_gd, (void *)gd, sizeof(*new_gd));
+	new_gd->flags |= GD_FLG_SMP_WORKER;
+	new_gd->flags &= ~GD_FLG_HAVE_CONSOLE;
+	cpu->gd = new_gd;
+	cpu->idx = idx;
+	cpu->stack_top = ALIGN_DOWN((ulong)cpu->stack +
+				    CONFIG_SMP_WORK_STACK_SIZE, 16);
+
+	ret = arch_smp_work_start(cpu);
+	if (ret)
+		goto err;
+
+	start = get_timer(0);
+	while (!__atomic_load_n(&cpu->running, __ATOMIC_ACQUIRE)) {
+		if (get_timer(start) > SMP_WORK_START_TIMEOUT_MS) {
+			/*
+			 * The CPU may still start later, so its memory cannot
+			 * be freed. Keep track of it so that smp_work_stop()
+			 * can stop it before the OS takes over.
+			 */
+			log_warning("Secondary CPU %d did not start\n", idx);
+			pending[num_pending++] = cpu;
+			return -ETIMEDOUT;
+		}
+	}
+	workers[num_workers++] = cpu;
+
+	return 0;
+
+err:
+	if (cpu)
+		free(cpu->stack);
+	free(new_gd);
+	free(cpu);
+
+	return ret;
+}
+
+int smp_work_init(void)
+{
+	int ret;
+	int i;
+
+	if (inited)
+		return num_workers;
+	inited = true;
+
+	bootstage_start(BOOTSTAGE_ID_ACCUM_SMP_WORK, "smp_work_init");
+	for (i = 0; i < CONFIG_SMP_WORK_MAX_CPUS; i++) {
+		ret = smp_work_start_cpu(i);
+		if (ret) {
+			if (ret != -ENODEV)
+				log_debug("Cannot start CPU %d (err=%d)\n", i,
+					  ret);
+			break;
+		}
+	}
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_SMP_WORK);
+	log_debug("%d secondary CPU(s) accepting work\n", num_workers);
+
+	return num_workers;
+}
+
+void smp_work_stop(void)
+{
+	struct smp_work_cpu *cpu;
+	int i;
+
+	for (i = 0; i < num_workers; i++) {
+		cpu = workers[i];
+		__atomic_store_n(&cpu->stop, true, __ATOMIC_RELEASE);
+		while (__atomic_load_n(&cpu->running, __ATOMIC_ACQUIRE))
+			;
+		log_debug("CPU %d stopped after %lu job(s)\n", i, cpu->jobs);
+		if (!arch_smp_work_stop(cpu))
+			smp_work_free_cpu(cpu);
+	}
+	num_workers = 0;
+	next_worker = 0;
+
+	/*
+	 * A CPU which was slow to start sees its stop flag as soon as it
+	 * enters smp_work_loop(), so it goes straight back down. Its memory
+	 * can only be freed once it is known to be off.
+	 */
+	for (i = 0; i < num_pending; i++) {
+		cpu = pending[i];
+		__atomic_store_n(&cpu->stop, true, __ATOMIC_RELEASE);
+		if (!arch_smp_work_stop(cpu)) {
+			log_debug("Late CPU %d stopped\n", cpu->idx);
+			smp_work_free_cpu(cpu);
+		} else {
+			log_warning("Late CPU %d may still be running\n",
+				    cpu->idx);
+		}
+	}
+	num_pending = 0;
+	inited = false;
+}
+
+int smp_work_num_workers(void)
+{
+	return num_workers;
+}
+
+int smp_work_post(struct smp_work *work)
+{
+	struct smp_work_cpu *cpu;
+	int i;
+
+	if (!work->func)
+		return -EINVAL;
+	smp_work_init();
+
+	__atomic_store_n(&work->state, SMP_WORK_QUEUED, __ATOMIC_RELAXED);
+	for (i = 0; i < num_workers; i++) {
+		cpu = workers[(next_worker + i) % num_workers];
+		if (!__atomic_load_n(&cpu->work, __ATOMIC_ACQUIRE)) {
+			__atomic_store_n(&cpu->work, work, __ATOMIC_RELEASE);
+			next_worker = (cpu->idx + 1) % num_workers;
+			return 0;
+		}
+	}
+
+	/* Everyone is busy, so do it here */
+	smp_work_run(work, 0);
+
+	return 0;
+}
+
+int smp_work_wait(struct smp_work *work)
+{
+	int state;
+
+	for (;;) {
+		state = __atomic_load_n(&work->state, __ATOMIC_ACQUIRE);
+		if (state == SMP_WORK_IDLE)
+			return -ENOENT;
+		if (state == SMP_WORK_DONE)
+			break;
+		schedule();
+	}
+
+	return work->ret;
+}
+
+int smp_work_run_all(struct smp_work *works, int count)
+{
+	int ret = 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		ret = smp_work_post(&works[i]);
+		if (ret)
+			break;
+	}
+	/* Wait for everything that was posted, even after an error */
+	count = i;
+	for (i = 0; i < count; i++) {
+		int err = smp_work_wait(&works[i]);
+
+		if (!ret)
+			ret = err;
+	}
+
+	return ret;
+}
+
+/**
+ * struct smp_work_range - A slice of a memory operation
+ *
+ * @work: Job information
+ * @dst: Destination address
+ * @src: Source address, or NULL to fill with @val
+ * @val: Value to fill with, if @src is NULL
+ * @len: Number of bytes in this slice
+ */
+struct smp_work_range {
+	struct smp_work work;
+	void *dst;
+	const void *src;
+	int val;
+	size_t len;
+};
+
+static int smp_work_range_func(void *arg)
+{
+	struct smp_work_range *range = arg;
+
+	if (range->src)
+		memcpy(range->dst, range->src, range->len);
+	else
+		memset(range->dst, range->val, range->len);
+
+	return 0;
+}
+
+static int smp_work_range(void *dst, const void *src, int val, size_t len)
+{
+	struct smp_work_range ranges[CONFIG_SMP_WORK_MAX_CPUS + 1];
+	struct smp_work_range *range;
+	size_t slice, done;
+	int count, i;
+
+	count = smp_work_init() + 1;
+	if (count == 1 || len < SMP_WORK_MIN_SPLIT) {
+		if (src)
+			memcpy(dst, src, len);
+		else
+			memset(dst, val, len);
+		return 0;
+	}
+
+	/* Use whole cache lines per slice so that CPUs rarely share a line */
+	slice = ALIGN(DIV_ROUND_UP(len, count), ARCH_DMA_MINALIGN);
+	for (i = 0, done = 0; done < len; i++, done += slice) {
+		range = &ranges[i];
+		range->dst = dst + done;
+		range->src = src ? src + done : NULL;
+		range->val = val;
+		range->len = min(slice, len - done);
+		smp_work_setup(&range->work, smp_work_range_func, range);
+	}
+	count = i;
+
+	for (i = 0; i < count; i++)
+		smp_work_post(&ranges[i].work);
+	for (i = 0; i < count; i++)
+		smp_work_wait(&ranges[i].work);
+
+	return 0;
+}
+
+int smp_work_memcpy(void *dst, const void *src, size_t len)
+{
+	return smp_work_range(dst, src, 0, len);
+}
+
+int smp_work_memset(void *dst, int val, size_t len)
+{
+	return smp_work_range(dst, NULL, val, len);
+}
+
+static int smp_work_hash_func(void *arg)
+{
+	struct smp_work_hash *hash = arg;
+	struct hash_algo *algo;
+	int ret;
+
+	ret = hash_lookup_algo(hash->algo, &algo);
+	if (ret)
+		return ret;
+	algo->hash_func_ws(hash->data, hash->size, hash->value,
+			   algo->chunk_size);
+	hash->value_len = algo->digest_size;
+
+	return 0;
+}
+
+int smp_work_hash_post(struct smp_work_hash *hash)
+{
+	smp_work_setup(&hash->work, smp_work_hash_func, hash);
+
+	return smp_work_post(&hash->work);
+}
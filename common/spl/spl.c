@@ -791,6 +791,11 @@ void board_init_r(gd_t *dummy1, ulong dummy2)
 	ret = bootstage_stash_default();
 	if (ret)
 		debug("Failed to stash bootstage: err=%d\n", ret);
+	if (CONFIG_IS_ENABLED(DM_PROBE_STATS)) {
+		ret = dm_probe_stats_stash();
+		if (ret)
+			debug("Failed to stash probe stats: err=%d\n", ret);
+	}
 
 	if (IS_ENABLED(CONFIG_SPL_VIDEO_REMOVE)) {
 		struct udevice *dev;
@@ -8,6 +8,7 @@
 #include <fpga.h>
 #include <gzip.h>
 #include <image.h>
+#include <lmb.h>
 #include <log.h>
 #include <memalign.h>
 #include <mapmem.h>
@@ -187,6 +188,84 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return ALIGN(data_size, spl_get_bl_len(info));
 }
 
+/**
+ * spl_fit_region_is_free() - Check that memory is not needed by the FIT
+ *
+ * @ctx:	Pointer to the FIT info
+ * @node:	Image being loaded, which is allowed to use the memory
+ * @start:	Start address of the region
+ * @end:	End address of the region (exclusive)
+ * Return:	true if the region is not used by the FIT or its other images
+ */
+static bool spl_fit_region_is_free(const struct spl_fit_info *ctx, int node,
+				   ulong start, ulong end)
+{
+	const void *fit = ctx->fit;
+	ulong fit_start = map_to_sysmem(fit);
+	const void *data;
+	size_t size;
+	ulong load;
+	int child;
+
+	if (start < fit_start + ctx->ext_data_offset && end > fit_start)
+		return false;
+
+	fdt_for_each_subnode(child, fit, ctx->images_node) {
+		if (child == node || fit_image_get_load(fit, child, &load) ||
+		    fit_image_get_data_and_size(fit, child, &data, &size))
+			continue;
+		if (start < load + size && end > load)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * spl_fit_read_addr() - Work out where to read an image's external data to
+ *
+ * Reads start on a block boundary, so the data lands @overhead bytes into the
+ * buffer. Where possible the buffer is placed @overhead bytes below the load
+ * address so that the data is read straight to where it belongs, leaving
+ * nothing to copy. Otherwise the buffer starts at the (aligned) load address
+ * and the data must be moved down afterwards.
+ *
+ * @ctx:	Pointer to the FIT info
+ * @node:	Image being loaded
+ * @load_addr:	Address the image is to be loaded to
+ * @overhead:	Offset of the data within the first block read
+ * @size:	Number of bytes to read
+ * @addrp:	Returns the address to read to
+ * Return:	0 on success, -ENOSPC if reading would overwrite reserved memory
+ */
+static int spl_fit_read_addr(const struct spl_fit_info *ctx, int node,
+			     ulong load_addr, ulong overhead, ulong size,
+			     ulong *addrp)
+{
+	ulong addr = load_addr - overhead;
+
+	if (!overhead && IS_ALIGNED(load_addr, ARCH_DMA_MINALIGN)) {
+		/* Nothing to do, the data is read in place anyway */
+	} else if (IS_ENABLED(CONFIG_SPL_LOAD_FIT_IN_PLACE) &&
+		   load_addr >= overhead &&
+		   IS_ALIGNED(addr, ARCH_DMA_MINALIGN) &&
+		   spl_fit_region_is_free(ctx, node, addr, load_addr)) {
+		debug("Reading '%s' in place\n", fit_get_name(ctx->fit, node,
+							      NULL));
+	} else {
+		addr = ALIGN(load_addr, ARCH_DMA_MINALIGN);
+	}
+
+	if (CONFIG_IS_ENABLED(LMB) && lmb_read_check(addr, size)) {
+		log_err("Reading '%s' would overwrite reserved memory\n",
+			fit_get_name(ctx->fit, node, NULL));
+		return -ENOSPC;
+	}
+	*addrp = addr;
+
+	return 0;
+}
+
 /**
  * load_simple_fit(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -217,6 +296,7 @@ static int load_simple_fit(struct spl_load_info *info, ulong fit_offset,
 	const void *data;
 	const void *fit = ctx->fit;
 	bool external_data = false;
+	int ret;
 
 	if (IS_ENABLED(CONFIG_SPL_FPGA) ||
 	    (IS_ENABLED(CONFIG_SPL_OS_BOOT) && spl_decompression_enabled())) {
@@ -248,6 +328,7 @@ static int load_simple_fit(struct spl_load_info *info, ulong fit_offset,
 	}
 
 	if (external_data) {
+		ulong read_addr;
 		void *src_ptr;
 
 		/* External data */
@@ -261,16 +342,22 @@ static int load_simple_fit(struct spl_load_info *info, ulong fit_offset,
 			return 0;
 		}
 
-		if (spl_decompression_enabled() &&
-		    (image_comp == IH_COMP_GZIP || image_comp == IH_COMP_LZMA))
-			src_ptr = map_sysmem(ALIGN(CONFIG_SYS_LOAD_ADDR, ARCH_DMA_MINALIGN), len);
-		else
-			src_ptr = map_sysmem(ALIGN(load_addr, ARCH_DMA_MINALIGN), len);
 		length = len;
-
 		overhead = get_aligned_image_overhead(info, offset);
 		size = get_aligned_image_size(info, length, offset);
 
+		if (spl_decompression_enabled() &&
+		    (image_comp == IH_COMP_GZIP || image_comp == IH_COMP_LZMA)) {
+			read_addr = ALIGN(CONFIG_SYS_LOAD_ADDR,
+					  ARCH_DMA_MINALIGN);
+		} else {
+			ret = spl_fit_read_addr(ctx, node, load_addr,
+						overhead, size, &read_addr);
+			if (ret)
+				return ret;
+		}
+		src_ptr = map_sysmem(read_addr, len);
+
 		if (info->read(info,
 			       fit_offset +
 			       get_aligned_image_offset(info, offset), size,
@@ -321,8 +408,9 @@ static int load_simple_fit(struct spl_load_info *info, ulong fit_offset,
 			return -EIO;
 		}
 		length = loadEnd - CONFIG_SYS_LOAD_ADDR;
-	} else {
-		memcpy(load_ptr, src, length);
+	} else if (src != load_ptr) {
+		/* The data may have been read a little above the load address */
+		memmove(load_ptr, src, length);
 	}
 
 	if (image_info) {
@@ -63,6 +63,11 @@ ifdef FTRACE
 PLATFORM_CPPFLAGS += -finstrument-functions -DFTRACE
 endif
 
+# The sampling profiler follows the frame-pointer chain to find callers
+ifeq ($(CONFIG_PROFILER),y)
+PLATFORM_CPPFLAGS += -fno-omit-frame-pointer
+endif
+
 #########################################################################
 
 RELFLAGS := $(PLATFORM_RELFLAGS)
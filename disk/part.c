@@ -5,6 +5,7 @@
  */
 
 #include <blk.h>
+#include <bootflow.h>
 #include <command.h>
 #include <env.h>
 #include <errno.h>
@@ -284,6 +285,8 @@ void part_init(struct blk_desc *desc)
 	struct part_driver *entry;
 
 	blkcache_invalidate(desc->uclass_id, desc->devnum);
+	part_cache_invalidate(desc);
+	bootflow_cache_invalidate(desc);
 
 	if (desc->part_type != PART_TYPE_UNKNOWN) {
 		for (entry = drv; entry != drv + n_ents; entry++) {
@@ -361,7 +364,7 @@ int part_get_info_by_type(struct blk_desc *desc, int part, int part_type,
 			       drv->name);
 			return -ENOSYS;
 		}
-		if (drv->get_info(desc, part, info) == 0) {
+		if (part_cache_get_info(desc, drv, part, info) == 0) {
 			PRINTF("## Valid %s partition found ##\n", drv->name);
 			return 0;
 		}
@@ -681,7 +684,7 @@ int part_get_info_by_name(struct blk_desc *desc, const char *name,
 	}
 
 	for (i = 1; i < part_drv->max_entries; i++) {
-		ret = part_drv->get_info(desc, i, info);
+		ret = part_cache_get_info(desc, part_drv, i, info);
 		if (ret != 0) {
 			/*
 			 * Partition with this index can't be obtained, but
@@ -0,0 +1,198 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Cache of partition information for each block device
+ *
+ * Looking up a partition normally reads and checks the partition table again,
+ * which for GPT means the header and the whole entry array, with their CRC32s.
+ * Callers which iterate through the partitions (part list, bootflow scanning,
+ * part_get_info_by_name(), EFI disk registration) do this for every partition
+ * number, so keep the information instead.
+ *
+ * The information for a device is dropped when the device is written or
+ * erased, or when part_init() looks at its partition table again.
+ */
+
+#include <alist.h>
+#include <blk.h>
+#include <log.h>
+#include <malloc.h>
+#include <part.h>
+#include <linux/list.h>
+
+/**
+ * struct part_cache_entry - Information about one partition
+ *
+ * @part: Partition number (1 = first)
+ * @info: Partition information
+ */
+struct part_cache_entry {
+	int part;
+	struct disk_partition info;
+};
+
+/**
+ * struct part_cache_node - Cached partitions for a block device
+ *
+ * @lh: Link in the list of cached devices
+ * @uclass_id: Uclass of the block device
+ * @devnum: Device number
+ * @hwpart: Hardware partition selected when the information was read
+ * @part_type: Partition-table type (PART_TYPE_...)
+ * @complete: true if @parts holds every partition in the table, so any other
+ *	partition number does not exist
+ * @missing: Partition numbers known not to exist, when not @complete
+ * @parts: Partitions which exist, each a struct part_cache_entry
+ */
+struct part_cache_node {
+	struct list_head lh;
+	enum uclass_id uclass_id;
+	int devnum;
+	int hwpart;
+	int part_type;
+	bool complete;
+	bool missing[MAX_SEARCH_PARTITIONS + 1];
+	struct alist parts;
+};
+
+static LIST_HEAD(part_cache);
+
+static struct part_cache_stats _stats;
+
+static struct part_cache_node *part_cache_find(struct blk_desc *desc,
+					       int part_type)
+{
+	struct part_cache_node *node;
+
+	list_for_each_entry(node, &part_cache, lh) {
+		if (node->uclass_id == desc->uclass_id &&
+		    node->devnum == desc->devnum &&
+		    node->hwpart == desc->hwpart &&
+		    node->part_type == part_type)
+			return node;
+	}
+
+	return NULL;
+}
+
+static void part_cache_drop(struct part_cache_node *node)
+{
+	list_del(&node->lh);
+	alist_uninit(&node->parts);
+	free(node);
+	_stats.entries--;
+}
+
+static int part_cache_add(void *priv, int part, struct disk_partition *info)
+{
+	struct part_cache_node *node = priv;
+	struct part_cache_entry entry;
+
+	entry.part = part;
+	entry.info = *info;
+	if (!alist_add(&node->parts, entry))
+		return -ENOMEM;
+
+	return 0;
+}
+
+/* Create a node for a device, reading the whole table if possible */
+static struct part_cache_node *part_cache_create(struct blk_desc *desc,
+						 struct part_driver *drv)
+{
+	struct part_cache_node *node;
+	int ret;
+
+	node = calloc(1, sizeof(*node));
+	if (!node)
+		return NULL;
+	node->uclass_id = desc->uclass_id;
+	node->devnum = desc->devnum;
+	node->hwpart = desc->hwpart;
+	node->part_type = drv->part_type;
+	alist_init_struct(&node->parts, struct part_cache_entry);
+	list_add(&node->lh, &part_cache);
+	_stats.entries++;
+
+	if (drv->get_all) {
+		ret = drv->get_all(desc, part_cache_add, node);
+		if (!ret) {
+			node->complete = true;
+			_stats.reads++;
+		} else {
+			/* Fall back to looking up each partition */
+			log_debug("Cannot read %s table (err=%d)\n", drv->name,
+				  ret);
+			alist_uninit(&node->parts);
+			alist_init_struct(&node->parts, struct part_cache_entry);
+		}
+	}
+
+	return node;
+}
+
+int part_cache_get_info(struct blk_desc *desc, struct part_driver *drv,
+			int part, struct disk_partition *info)
+{
+	const struct part_cache_entry *entry;
+	struct part_cache_node *node;
+	int ret, i;
+
+	node = part_cache_find(desc, drv->part_type);
+	if (!node) {
+		node = part_cache_create(desc, drv);
+		if (!node)
+			return drv->get_info(desc, part, info);
+	}
+
+	for (i = 0; i < node->parts.count; i++) {
+		entry = alist_get(&node->parts, i, struct part_cache_entry);
+		if (entry->part == part) {
+			*info = entry->info;
+			_stats.hits++;
+			return 0;
+		}
+	}
+	if (node->complete || (part >= 0 && part <= MAX_SEARCH_PARTITIONS &&
+			       node->missing[part])) {
+		_stats.hits++;
+		return -ENOENT;
+	}
+
+	_stats.misses++;
+	ret = drv->get_info(desc, part, info);
+	if (!ret) {
+		/* If this fails we just don't cache the partition */
+		part_cache_add(node, part, info);
+	} else if (part >= 0 && part <= MAX_SEARCH_PARTITIONS) {
+		node->missing[part] = true;
+	}
+
+	return ret;
+}
+
+void part_cache_invalidate(struct blk_desc *desc)
+{
+	struct part_cache_node *node, *next;
+
+	list_for_each_entry_safe(node, next, &part_cache, lh) {
+		if (node->uclass_id == desc->uclass_id &&
+		    node->devnum == desc->devnum)
+			part_cache_drop(node);
+	}
+}
+
+void part_cache_stats(struct part_cache_stats *stats)
+{
+	*stats = _stats;
+	_stats.hits = 0;
+	_stats.misses = 0;
+	_stats.reads = 0;
+}
+
+void part_cache_free(void)
+{
+	struct part_cache_node *node, *next;
+
+	list_for_each_entry_safe(node, next, &part_cache, lh)
+		part_cache_drop(node);
+}
@@ -258,6 +258,35 @@ void part_print_efi(struct blk_desc *desc)
 	return;
 }
 
+/* Fill in the information for a partition from its GPT entry */
+static void part_efi_fill_info(struct blk_desc *desc, gpt_entry *pte,
+			       struct disk_partition *info)
+{
+	/* The 'lbaint_t' casting may limit the maximum disk size to 2 TB */
+	info->start = (lbaint_t)le64_to_cpu(pte->starting_lba);
+	/* The ending LBA is inclusive, to calculate size, add 1 to it */
+	info->size = (lbaint_t)le64_to_cpu(pte->ending_lba) + 1 - info->start;
+	info->blksz = desc->blksz;
+
+	snprintf((char *)info->name, sizeof(info->name), "%s",
+		 print_efiname(pte));
+	strcpy((char *)info->type, "U-Boot");
+	info->bootable = get_bootable(pte);
+	if (CONFIG_IS_ENABLED(PARTITION_UUIDS)) {
+		uuid_bin_to_str(pte->unique_partition_guid.b,
+				(char *)disk_partition_uuid(info),
+				UUID_STR_FORMAT_GUID);
+	}
+	if (IS_ENABLED(CONFIG_PARTITION_TYPE_GUID)) {
+		uuid_bin_to_str(pte->partition_type_guid.b,
+				(char *)disk_partition_type_guid(info),
+				UUID_STR_FORMAT_GUID);
+	}
+
+	log_debug("start 0x" LBAF ", size 0x" LBAF ", name %s\n", info->start,
+		  info->size, info->name);
+}
+
 int part_get_info_efi(struct blk_desc *desc, int part,
 		      struct disk_partition *info)
 {
@@ -281,34 +310,37 @@ int part_get_info_efi(struct blk_desc *desc, int part,
 		return -EPERM;
 	}
 
-	/* The 'lbaint_t' casting may limit the maximum disk size to 2 TB */
-	info->start = (lbaint_t)le64_to_cpu(gpt_pte[part - 1].starting_lba);
-	/* The ending LBA is inclusive, to calculate size, add 1 to it */
-	info->size = (lbaint_t)le64_to_cpu(gpt_pte[part - 1].ending_lba) + 1
-		     - info->start;
-	info->blksz = desc->blksz;
+	part_efi_fill_info(desc, &gpt_pte[part - 1], info);
 
-	snprintf((char *)info->name, sizeof(info->name), "%s",
-		 print_efiname(&gpt_pte[part - 1]));
-	strcpy((char *)info->type, "U-Boot");
-	info->bootable = get_bootable(&gpt_pte[part - 1]);
-	if (CONFIG_IS_ENABLED(PARTITION_UUIDS)) {
-		uuid_bin_to_str(gpt_pte[part - 1].unique_partition_guid.b,
-				(char *)disk_partition_uuid(info),
-				UUID_STR_FORMAT_GUID);
-	}
-	if (IS_ENABLED(CONFIG_PARTITION_TYPE_GUID)) {
-		uuid_bin_to_str(gpt_pte[part - 1].partition_type_guid.b,
-				(char *)disk_partition_type_guid(info),
-				UUID_STR_FORMAT_GUID);
-	}
+	/* Remember to free pte */
+	free(gpt_pte);
+	return 0;
+}
 
-	log_debug("start 0x" LBAF ", size 0x" LBAF ", name %s\n", info->start,
-		  info->size, info->name);
+static int __maybe_unused part_get_all_efi(struct blk_desc *desc,
+					   part_info_func_t func, void *priv)
+{
+	ALLOC_CACHE_ALIGN_BUFFER_PAD(gpt_header, gpt_head, 1, desc->blksz);
+	struct disk_partition info;
+	gpt_entry *gpt_pte = NULL;
+	int i, ret = 0;
+
+	if (find_valid_gpt(desc, gpt_head, &gpt_pte) != 1)
+		return -EINVAL;
+
+	for (i = 0; i < le32_to_cpu(gpt_head->num_partition_entries); i++) {
+		if (!is_pte_valid(&gpt_pte[i]))
+			continue;
+		memset(&info, '\0', sizeof(info));
+		part_efi_fill_info(desc, &gpt_pte[i], &info);
+		ret = func(priv, i + 1, &info);
+		if (ret)
+			break;
+	}
 
 	/* Remember to free pte */
 	free(gpt_pte);
-	return 0;
+	return ret;
 }
 
 static int part_test_efi(struct blk_desc *desc)
@@ -1212,4 +1244,7 @@ U_BOOT_PART_TYPE(a_efi) = {
 	.get_info	= part_get_info_ptr(part_get_info_efi),
 	.print		= part_print_ptr(part_print_efi),
 	.test		= part_test_efi,
+#if CONFIG_IS_ENABLED(PARTITION_CACHE)
+	.get_all	= part_get_all_efi,
+#endif
 };
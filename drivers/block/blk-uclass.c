@@ -7,6 +7,7 @@
 #define LOG_CATEGORY UCLASS_BLK
 
 #include <blk.h>
+#include <bootflow.h>
 #include <dm.h>
 #include <log.h>
 #include <malloc.h>
@@ -478,6 +479,8 @@ long blk_write(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
 		return -ENOSYS;
 
 	blkcache_invalidate(desc->uclass_id, desc->devnum);
+	part_cache_invalidate(desc);
+	bootflow_cache_invalidate(desc);
 
 	if (IS_ENABLED(CONFIG_BOUNCE_BUFFER) && desc->bb) {
 		struct blk_bounce_buffer bbstate = { .dev = dev };
@@ -510,6 +513,8 @@ long blk_erase(struct udevice *dev, lbaint_t start, lbaint_t blkcnt)
 		return -ENOSYS;
 
 	blkcache_invalidate(desc->uclass_id, desc->devnum);
+	part_cache_invalidate(desc);
+	bootflow_cache_invalidate(desc);
 
 	return ops->erase(dev, start, blkcnt);
 }
@@ -0,0 +1,302 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Cached plan for binding devices from the devicetree
+ *
+ * See include/dm/bind_plan.h for an overview. While a plan is being followed,
+ * the entries are copied to a new plan as well, so that if the plan has to be
+ * abandoned part-way through, the new plan is complete and can be written to
+ * the bloblist at the end of the scan.
+ */
+
+#define LOG_CATEGORY	LOGC_DM
+
+#include <bloblist.h>
+#include <dm.h>
+#include <log.h>
+#include <malloc.h>
+#include <version_string.h>
+#include <asm/global_data.h>
+#include <dm/bind_plan.h>
+#include <linux/libfdt.h>
+#include <u-boot/crc.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/**
+ * struct bind_plan_state - State of the bind plan during a scan
+ *
+ * @active: true if a scan is in progress
+ * @failed: true if recording failed, so no plan can be written
+ * @fdt_crc: CRC32 of the control devicetree
+ * @drv_crc: CRC32 of the version string and driver names
+ * @plan: Plan being followed, or NULL if none
+ * @pos: Position of the next entry in @plan
+ * @ents: New plan being recorded
+ * @count: Number of entries in @ents
+ * @size: Number of entries allocated for @ents
+ * @stats: Information about the scan
+ */
+struct bind_plan_state {
+	bool active;
+	bool failed;
+	u32 fdt_crc;
+	u32 drv_crc;
+	const struct dm_bind_plan_hdr *plan;
+	uint pos;
+	struct dm_bind_plan_ent *ents;
+	uint count;
+	uint size;
+	struct dm_bind_plan_stats stats;
+};
+
+static struct bind_plan_state state;
+
+static u32 calc_drv_crc(void)
+{
+	struct driver *drv = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct driver *entry;
+	u32 crc;
+
+	crc = crc32(0, (const uchar *)version_string, strlen(version_string));
+	crc = crc32(crc, (const uchar *)&n_ents, sizeof(n_ents));
+	for (entry = drv; entry != drv + n_ents; entry++)
+		crc = crc32(crc, (const uchar *)entry->name,
+			    strlen(entry->name) + 1);
+
+	return crc;
+}
+
+void dm_bind_plan_start(void)
+{
+	const struct dm_bind_plan_hdr *plan;
+
+	free(state.ents);
+	memset(&state, '\0', sizeof(state));
+	state.fdt_crc = crc32(0, gd->fdt_blob, fdt_totalsize(gd->fdt_blob));
+	state.drv_crc = calc_drv_crc();
+	state.active = true;
+
+	plan = bloblist_find(BLOBLISTT_U_BOOT_DM_BIND_PLAN, 0);
+	if (!plan)
+		return;
+	if (plan->version != DM_BIND_PLAN_VERSION ||
+	    !bloblist_find(BLOBLISTT_U_BOOT_DM_BIND_PLAN,
+			   sizeof(*plan) + plan->count * sizeof(plan->ent[0]))) {
+		log_debug("Invalid bind plan\n");
+		return;
+	}
+	if (plan->fdt_crc != state.fdt_crc || plan->drv_crc != state.drv_crc) {
+		log_debug("Bind plan is out of date\n");
+		return;
+	}
+	state.plan = plan;
+	state.stats.planned = plan->count;
+}
+
+bool dm_bind_plan_active(void)
+{
+	return state.active;
+}
+
+static void set_ent(struct dm_bind_plan_ent *ent, uint drv_idx,
+		    uint match_idx, uint compat_ofs, uint compat_len)
+{
+	ent->drv_idx = drv_idx;
+	ent->match_idx = match_idx;
+	ent->compat_ofs = compat_ofs;
+	ent->compat_len = compat_len;
+}
+
+static int add_ent(uint drv_idx, uint match_idx, uint compat_ofs,
+		   uint compat_len)
+{
+	struct dm_bind_plan_ent *ent;
+
+	if (state.failed)
+		return -ENOMEM;
+	if (state.count == state.size) {
+		uint size = state.size ? state.size * 2 : 64;
+
+		ent = realloc(state.ents, size * sizeof(*ent));
+		if (!ent) {
+			state.failed = true;
+			return -ENOMEM;
+		}
+		state.ents = ent;
+		state.size = size;
+	}
+	set_ent(&state.ents[state.count], drv_idx, match_idx, compat_ofs,
+		compat_len);
+
+	return state.count++;
+}
+
+static void stop_plan(void)
+{
+	log_debug("Abandoning bind plan at entry %u\n", state.pos - 1);
+	state.plan = NULL;
+}
+
+void dm_bind_plan_abandon(void)
+{
+	if (!state.plan)
+		return;
+	stop_plan();
+
+	/* Drop the entry added by dm_bind_plan_next() */
+	if (!state.failed)
+		state.count--;
+	state.stats.hits--;
+}
+
+int dm_bind_plan_next(const char *compat_list, int compat_length,
+		      struct driver **drvp, const struct udevice_id **idp)
+{
+	struct driver *drv = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct dm_bind_plan_ent *ent;
+	const struct udevice_id *id;
+	int i;
+
+	if (!state.plan)
+		goto search;
+	if (state.pos == state.plan->count) {
+		state.pos++;
+		goto mismatch;
+	}
+	ent = &state.plan->ent[state.pos++];
+	if (ent->compat_len != compat_length)
+		goto mismatch;
+
+	/* The caller searches and adds the entry, so the plan stays in step */
+	if (ent->drv_idx == DM_BIND_PLAN_SEARCH)
+		goto search;
+	if (ent->drv_idx == DM_BIND_PLAN_NONE) {
+		*drvp = NULL;
+		goto found;
+	}
+	if (ent->drv_idx >= n_ents || ent->compat_ofs >= compat_length)
+		goto mismatch;
+
+	drv += ent->drv_idx;
+	if (!drv->of_match)
+		goto mismatch;
+	for (i = 0, id = drv->of_match; i < ent->match_idx; i++, id++) {
+		if (!id->compatible)
+			goto mismatch;
+	}
+	if (!id->compatible ||
+	    strcmp(id->compatible, compat_list + ent->compat_ofs))
+		goto mismatch;
+	*drvp = drv;
+	*idp = id;
+
+found:
+	add_ent(ent->drv_idx, ent->match_idx, ent->compat_ofs, ent->compat_len);
+	state.stats.hits++;
+
+	return 0;
+
+mismatch:
+	stop_plan();
+search:
+	state.stats.searched++;
+
+	return -EAGAIN;
+}
+
+int dm_bind_plan_reserve(void)
+{
+	if (!state.active)
+		return -ENOENT;
+
+	return add_ent(DM_BIND_PLAN_SEARCH, 0, 0, 0);
+}
+
+void dm_bind_plan_add(int slot, const char *compat_list, int compat_length,
+		      const char *compat, struct driver *drv,
+		      const struct udevice_id *id, bool search)
+{
+	struct driver *start = ll_entry_start(struct driver, driver);
+	struct dm_bind_plan_ent *ent;
+
+	if (!state.active || slot < 0 || state.failed)
+		return;
+	ent = &state.ents[slot];
+	if (search)
+		set_ent(ent, DM_BIND_PLAN_SEARCH, 0, 0, compat_length);
+	else if (!drv)
+		set_ent(ent, DM_BIND_PLAN_NONE, 0, 0, compat_length);
+	else
+		set_ent(ent, drv - start, id - drv->of_match,
+			compat - compat_list, compat_length);
+}
+
+int dm_bind_plan_finish(int scan_ret)
+{
+	struct dm_bind_plan_hdr *hdr;
+	int size, ret;
+
+	if (!state.active)
+		return 0;
+	state.active = false;
+
+	/* Nothing to do if the plan was followed to the end */
+	if (scan_ret || (state.plan && state.pos == state.plan->count))
+		goto done;
+	if (state.failed) {
+		ret = -ENOMEM;
+		goto err;
+	}
+	if (!gd->bloblist) {
+		ret = -ENOSPC;
+		goto err;
+	}
+
+	size = sizeof(*hdr) + state.count * sizeof(hdr->ent[0]);
+	if (bloblist_find(BLOBLISTT_U_BOOT_DM_BIND_PLAN, 0)) {
+		ret = bloblist_resize(BLOBLISTT_U_BOOT_DM_BIND_PLAN, size);
+		if (ret)
+			goto err;
+		hdr = bloblist_find(BLOBLISTT_U_BOOT_DM_BIND_PLAN, size);
+	} else {
+		/* Avoid an error message if the bloblist is too small */
+		if (bloblist_get_size() + sizeof(struct bloblist_rec) +
+		    ALIGN(size, BLOBLIST_BLOB_ALIGN) >
+		    bloblist_get_total_size()) {
+			ret = -ENOSPC;
+			goto err;
+		}
+		hdr = bloblist_add(BLOBLISTT_U_BOOT_DM_BIND_PLAN, size, 0);
+	}
+	if (!hdr) {
+		ret = -ENOSPC;
+		goto err;
+	}
+	hdr->version = DM_BIND_PLAN_VERSION;
+	hdr->fdt_crc = state.fdt_crc;
+	hdr->drv_crc = state.drv_crc;
+	hdr->count = state.count;
+	memcpy(hdr->ent, state.ents, state.count * sizeof(hdr->ent[0]));
+	state.stats.written = true;
+	log_debug("Wrote bind plan with %u entries\n", state.count);
+
+done:
+	ret = 0;
+err:
+	if (ret)
+		log_debug("Cannot write bind plan (err=%d)\n", ret);
+	state.plan = NULL;
+	free(state.ents);
+	state.ents = NULL;
+	state.count = 0;
+	state.size = 0;
+
+	return ret;
+}
+
+void dm_bind_plan_get_stats(struct dm_bind_plan_stats *stats)
+{
+	*stats = state.stats;
+}
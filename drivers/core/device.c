@@ -45,6 +45,7 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 	struct udevice *dev;
 	struct uclass *uc;
 	int size, ret = 0;
+	struct dm_probe_timer tmr;
 	bool auto_seq = true;
 	void *ptr;
 
@@ -65,6 +66,7 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 	dev = calloc(1, sizeof(struct udevice));
 	if (!dev)
 		return -ENOMEM;
+	dm_probe_stats_bind_begin(&tmr);
 
 	INIT_LIST_HEAD(&dev->sibling_node);
 	INIT_LIST_HEAD(&dev->child_head);
@@ -187,6 +189,7 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 		*devp = dev;
 
 	dev_or_flags(dev, DM_FLAG_BOUND);
+	dm_probe_stats_bind_end(dev, &tmr);
 
 	return 0;
 
@@ -233,6 +236,7 @@ fail_alloc1:
 	devres_release_all(dev);
 
 	free(dev);
+	dm_probe_stats_bind_end(NULL, &tmr);
 
 	return ret;
 }
@@ -427,9 +431,12 @@ int device_of_to_plat(struct udevice *dev)
 
 	if (drv->of_to_plat &&
 	    (CONFIG_IS_ENABLED(OF_PLATDATA) || dev_has_ofnode(dev))) {
+		ulong start = dm_probe_stats_time();
+
 		ret = drv->of_to_plat(dev);
 		if (ret)
 			goto fail;
+		dm_probe_stats_add(dev, DM_PROBE_STAT_OF_TO_PLAT, start);
 	}
 
 	dev_or_flags(dev, DM_FLAG_PLATDATA_VALID);
@@ -478,7 +485,7 @@ static int device_get_dma_constraints(struct udevice *dev)
 	return 0;
 }
 
-int device_probe(struct udevice *dev)
+static int _device_probe(struct udevice *dev)
 {
 	const struct driver *drv;
 	int ret;
@@ -616,6 +623,22 @@ fail:
 	return ret;
 }
 
+int device_probe(struct udevice *dev)
+{
+	struct dm_probe_timer tmr;
+	int ret;
+
+	if (!CONFIG_IS_ENABLED(DM_PROBE_STATS) || !dev ||
+	    (dev_get_flags(dev) & DM_FLAG_ACTIVATED))
+		return _device_probe(dev);
+
+	dm_probe_stats_begin(&tmr);
+	ret = _device_probe(dev);
+	dm_probe_stats_end(dev, &tmr);
+
+	return ret;
+}
+
 void *dev_get_plat(const struct udevice *dev)
 {
 	if (!dev) {
@@ -11,6 +11,7 @@
 #include <debug_uart.h>
 #include <errno.h>
 #include <log.h>
+#include <dm/bind_plan.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -204,9 +205,9 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 	const struct udevice_id *id;
 	struct driver *entry;
 	struct udevice *dev;
-	bool found = false;
+	bool found = false, refused = false;
 	const char *name, *compat_list, *compat;
-	int compat_length, i;
+	int compat_length, i, slot = -ENOENT;
 	int result = 0;
 	int ret = 0;
 
@@ -227,6 +228,27 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 		return compat_length;
 	}
 
+	if (!drv && !pre_reloc_only && dm_bind_plan_active() &&
+	    !dm_bind_plan_next(compat_list, compat_length, &entry, &id)) {
+		if (!entry)
+			return 0;
+		ret = device_bind_with_driver_data(parent, entry, name,
+						   id->data, node, &dev);
+		if (!ret) {
+			if (devp)
+				*devp = dev;
+			return 0;
+		}
+		if (ret != -ENODEV) {
+			dm_warn("Error binding driver '%s': %d\n", entry->name,
+				ret);
+			return log_msg_ret("plan", ret);
+		}
+		dm_bind_plan_abandon();
+	}
+	if (!drv && !pre_reloc_only)
+		slot = dm_bind_plan_reserve();
+
 	/*
 	 * Walk through the compatible string list, attempting to match each
 	 * compatible string in order such that we match in order of priority
@@ -269,6 +291,7 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 						   &dev);
 		if (ret == -ENODEV) {
 			log_debug("Driver '%s' refuses to bind\n", entry->name);
+			refused = true;
 			continue;
 		}
 		if (ret) {
@@ -285,6 +308,8 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 
 	if (!found && !result && ret != -ENODEV)
 		log_debug("No match for node '%s'\n", name);
+	dm_bind_plan_add(slot, compat_list, compat_length, found ? compat : NULL,
+			 found ? entry : NULL, id, !found && refused);
 
 	return result;
 }
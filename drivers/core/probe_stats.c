@@ -0,0 +1,326 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Time taken to bind and probe devices
+ *
+ * Each device records how long it took to bind, to read its platform data and
+ * to probe. Probing a device often probes others (its parents, clocks,
+ * regulators, etc.), so the time spent in those nested probes is recorded
+ * separately, allowing the time spent in each driver itself to be worked out.
+ */
+
+#define LOG_CATEGORY	LOGC_DM
+
+#include <bloblist.h>
+#include <dm.h>
+#include <log.h>
+#include <malloc.h>
+#include <sort.h>
+#include <time.h>
+#include <asm/global_data.h>
+#include <dm/device-internal.h>
+#include <dm/uclass-internal.h>
+#include <dm/util.h>
+#include <linux/libfdt.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Time spent in nested probes of the device currently being probed */
+static ulong nested_us __section(".data");
+
+/* Time spent binding children of the device currently being bound */
+static ulong bind_nested_us __section(".data");
+
+/**
+ * struct probe_entry - Probe stats for a device, driver or uclass
+ *
+ * @name: Name of the device, driver or uclass
+ * @uclass_id: Uclass ID
+ * @dev_count: Number of devices included
+ * @probe_count: Number of times those devices were probed
+ * @time_us: Total time taken for each step (indexed by enum dm_probe_stat_t)
+ */
+struct probe_entry {
+	const char *name;
+	enum uclass_id uclass_id;
+	uint dev_count;
+	uint probe_count;
+	ulong time_us[DM_PROBE_STAT_COUNT];
+};
+
+ulong dm_probe_stats_time(void)
+{
+	/* Avoid recursion while the timer itself is being probed */
+	if (CONFIG_IS_ENABLED(TIMER) && !gd->timer)
+		return 0;
+
+	return timer_get_us();
+}
+
+void dm_probe_stats_add(struct udevice *dev, enum dm_probe_stat_t stat,
+			ulong start)
+{
+	if (start)
+		dev->probe_stats.time_us[stat] += dm_probe_stats_time() - start;
+}
+
+void dm_probe_stats_bind_begin(struct dm_probe_timer *tmr)
+{
+	tmr->start = dm_probe_stats_time();
+	tmr->outer_nested = bind_nested_us;
+	bind_nested_us = 0;
+}
+
+void dm_probe_stats_bind_end(struct udevice *dev, struct dm_probe_timer *tmr)
+{
+	ulong taken = 0;
+
+	if (tmr->start)
+		taken = dm_probe_stats_time() - tmr->start;
+
+	/* Children bound along the way have their own time */
+	if (dev && taken > bind_nested_us)
+		dev->probe_stats.time_us[DM_PROBE_STAT_BIND] +=
+			taken - bind_nested_us;
+	bind_nested_us = tmr->outer_nested + taken;
+}
+
+void dm_probe_stats_begin(struct dm_probe_timer *tmr)
+{
+	tmr->start = dm_probe_stats_time();
+	tmr->outer_nested = nested_us;
+	nested_us = 0;
+}
+
+void dm_probe_stats_end(struct udevice *dev, struct dm_probe_timer *tmr)
+{
+	struct dm_probe_stats *stats = &dev->probe_stats;
+	ulong taken = 0;
+
+	if (tmr->start) {
+		taken = dm_probe_stats_time() - tmr->start;
+		stats->time_us[DM_PROBE_STAT_PROBE] += taken;
+		stats->time_us[DM_PROBE_STAT_NESTED] += nested_us;
+	}
+	stats->probe_count++;
+
+	/* As far as the outer probe is concerned, all this time was nested */
+	nested_us = tmr->outer_nested + taken;
+}
+
+static void add_dev(struct probe_entry *entry, struct udevice *dev)
+{
+	const struct dm_probe_stats *stats = &dev->probe_stats;
+	int i;
+
+	entry->dev_count++;
+	entry->probe_count += stats->probe_count;
+	for (i = 0; i < DM_PROBE_STAT_COUNT; i++)
+		entry->time_us[i] += stats->time_us[i];
+}
+
+/**
+ * collect() - Collect probe stats for all devices
+ *
+ * @by: How to group the devices
+ * @entriesp: Returns an allocated list of entries, which the caller must free
+ * Return: number of entries, or -ENOMEM if out of memory
+ */
+static int collect(enum dm_probe_stats_by by, struct probe_entry **entriesp)
+{
+	struct driver *drv_start = ll_entry_start(struct driver, driver);
+	const int n_drivers = ll_entry_count(struct driver, driver);
+	struct probe_entry *entries, *entry;
+	struct udevice *dev;
+	struct uclass *uc;
+	enum uclass_id id;
+	int count;
+
+	switch (by) {
+	case DM_PROBE_STATS_BY_DEVICE:
+		count = 0;
+		for (id = 0; id < UCLASS_COUNT; id++) {
+			uc = uclass_find(id);
+			if (!uc)
+				continue;
+			uclass_foreach_dev(dev, uc)
+				count++;
+		}
+		break;
+	case DM_PROBE_STATS_BY_DRIVER:
+		count = n_drivers;
+		break;
+	case DM_PROBE_STATS_BY_UCLASS:
+	default:
+		count = UCLASS_COUNT;
+		break;
+	}
+	entries = calloc(count, sizeof(*entries));
+	if (!entries)
+		return -ENOMEM;
+
+	count = 0;
+	for (id = 0; id < UCLASS_COUNT; id++) {
+		uc = uclass_find(id);
+		if (!uc)
+			continue;
+		if (by == DM_PROBE_STATS_BY_UCLASS) {
+			entry = &entries[count++];
+			entry->name = uc->uc_drv->name;
+			entry->uclass_id = id;
+		}
+		uclass_foreach_dev(dev, uc) {
+			if (by == DM_PROBE_STATS_BY_DEVICE) {
+				entry = &entries[count++];
+				entry->name = dev->name;
+				entry->uclass_id = id;
+			} else if (by == DM_PROBE_STATS_BY_DRIVER) {
+				entry = &entries[dev->driver - drv_start];
+				entry->name = dev->driver->name;
+				entry->uclass_id = id;
+			}
+			add_dev(entry, dev);
+		}
+	}
+
+	/* Drop drivers without any devices */
+	if (by == DM_PROBE_STATS_BY_DRIVER) {
+		int i;
+
+		for (i = 0; i < n_drivers; i++) {
+			if (entries[i].dev_count)
+				entries[count++] = entries[i];
+		}
+	}
+	*entriesp = entries;
+
+	return count;
+}
+
+static ulong self_us(const struct probe_entry *entry)
+{
+	return entry->time_us[DM_PROBE_STAT_PROBE] -
+		entry->time_us[DM_PROBE_STAT_NESTED];
+}
+
+static int h_cmp_self(const void *v1, const void *v2)
+{
+	const struct probe_entry *e1 = v1, *e2 = v2;
+	ulong t1 = self_us(e1), t2 = self_us(e2);
+
+	if (t1 != t2)
+		return t1 < t2 ? 1 : -1;
+
+	return e2->probe_count - e1->probe_count;
+}
+
+void dm_dump_probe_stats(enum dm_probe_stats_by by, bool all)
+{
+	static const char *const by_name[] = {
+		[DM_PROBE_STATS_BY_DEVICE]	= "Device",
+		[DM_PROBE_STATS_BY_DRIVER]	= "Driver",
+		[DM_PROBE_STATS_BY_UCLASS]	= "Uclass",
+	};
+	struct probe_entry *entries, *entry, total;
+	int count, i;
+
+	count = collect(by, &entries);
+	if (count < 0) {
+		printf("Out of memory\n");
+		return;
+	}
+	qsort(entries, count, sizeof(*entries), h_cmp_self);
+
+	printf("%-20s %4s %6s %8s %8s %8s %8s %8s\n", by_name[by], "Devs",
+	       "Probes", "Bind", "OfToPlat", "Probe", "Nested", "Self");
+	printf("%-20s %4s %6s %8s %8s %8s %8s %8s\n", "--------------------",
+	       "----", "------", "--------", "--------", "--------", "--------",
+	       "--------");
+	memset(&total, '\0', sizeof(total));
+	for (entry = entries; entry < entries + count; entry++) {
+		if (!all && !entry->probe_count)
+			continue;
+		printf("%-20.20s %4u %6u %8lu %8lu %8lu %8lu %8lu\n",
+		       entry->name, entry->dev_count, entry->probe_count,
+		       entry->time_us[DM_PROBE_STAT_BIND],
+		       entry->time_us[DM_PROBE_STAT_OF_TO_PLAT],
+		       entry->time_us[DM_PROBE_STAT_PROBE],
+		       entry->time_us[DM_PROBE_STAT_NESTED], self_us(entry));
+		total.dev_count += entry->dev_count;
+		total.probe_count += entry->probe_count;
+		for (i = 0; i < DM_PROBE_STAT_COUNT; i++)
+			total.time_us[i] += entry->time_us[i];
+	}
+	printf("%-20s %4u %6u %8lu %8s %8s %8s %8lu\n", "Total (us)",
+	       total.dev_count, total.probe_count,
+	       total.time_us[DM_PROBE_STAT_BIND], "", "", "", self_us(&total));
+	free(entries);
+}
+
+int dm_probe_stats_fdt_add(void *blob, int parent, int index)
+{
+	struct probe_entry *entries, *entry;
+	char name[DM_PROBE_STATS_NAME_LEN + 6];
+	int count, node, ret = 0;
+
+	count = collect(DM_PROBE_STATS_BY_DRIVER, &entries);
+	if (count < 0)
+		return count;
+
+	for (entry = entries; entry < entries + count; entry++) {
+		if (!entry->probe_count)
+			continue;
+		node = fdt_add_subnode(blob, parent, simple_itoa(index++));
+		if (node < 0) {
+			ret = -ENOSPC;
+			break;
+		}
+		snprintf(name, sizeof(name), "probe %s", entry->name);
+		if (fdt_setprop_string(blob, node, "name", name) ||
+		    fdt_setprop_u32(blob, node, "accum", self_us(entry))) {
+			ret = -ENOSPC;
+			break;
+		}
+	}
+	free(entries);
+
+	return ret;
+}
+
+int dm_probe_stats_stash(void)
+{
+	struct probe_entry *entries, *entry;
+	struct dm_probe_stats_hdr *hdr;
+	struct dm_probe_stats_rec *rec;
+	int count, i;
+
+	if (!CONFIG_IS_ENABLED(BLOBLIST))
+		return -ENOSYS;
+
+	count = collect(DM_PROBE_STATS_BY_DRIVER, &entries);
+	if (count < 0)
+		return count;
+
+	hdr = bloblist_add(BLOBLISTT_U_BOOT_DM_PROBE_STATS,
+			   sizeof(*hdr) + count * sizeof(*rec), 0);
+	if (!hdr) {
+		free(entries);
+		return -ENOSPC;
+	}
+	hdr->version = DM_PROBE_STATS_VERSION;
+	hdr->hdr_size = sizeof(*hdr);
+	hdr->rec_size = sizeof(*rec);
+	hdr->count = count;
+
+	rec = (struct dm_probe_stats_rec *)(hdr + 1);
+	for (entry = entries; entry < entries + count; entry++, rec++) {
+		strlcpy(rec->name, entry->name, sizeof(rec->name));
+		rec->uclass_id = entry->uclass_id;
+		rec->dev_count = entry->dev_count;
+		rec->probe_count = entry->probe_count;
+		for (i = 0; i < DM_PROBE_STAT_COUNT; i++)
+			rec->time_us[i] = entry->time_us[i];
+	}
+	free(entries);
+
+	return 0;
+}
@@ -16,6 +16,7 @@
 #include <asm/global_data.h>
 #include <linux/libfdt.h>
 #include <dm/acpi.h>
+#include <dm/bind_plan.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -326,7 +327,10 @@ static int dm_scan(bool pre_reloc_only)
 	}
 
 	if (CONFIG_IS_ENABLED(OF_REAL)) {
+		if (CONFIG_IS_ENABLED(DM_BIND_PLAN) && !pre_reloc_only)
+			dm_bind_plan_start();
 		ret = dm_extended_scan(pre_reloc_only);
+		dm_bind_plan_finish(ret);
 		if (ret) {
 			dm_warn("dm_extended_scan() failed: %d\n", ret);
 			return ret;
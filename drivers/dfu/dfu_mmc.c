@@ -13,6 +13,7 @@
 #include <dfu.h>
 #include <ext4fs.h>
 #include <fat.h>
+#include <mapmem.h>
 #include <mmc.h>
 #include <part.h>
 #include <command.h>
@@ -128,7 +129,8 @@ static int mmc_file_op(enum dfu_op op, struct dfu_entity *dfu,
 
 	switch (op) {
 	case DFU_OP_READ:
-		ret = fs_read(dfu->name, (size_t)buf, offset, *len, &size);
+		ret = fs_read(dfu->name, map_to_sysmem(buf), offset, *len,
+			      &size);
 		if (ret) {
 			puts("dfu: fs_read error!\n");
 			return ret;
@@ -136,7 +138,8 @@ static int mmc_file_op(enum dfu_op op, struct dfu_entity *dfu,
 		*len = size;
 		break;
 	case DFU_OP_WRITE:
-		ret = fs_write(dfu->name, (size_t)buf, offset, *len, &size);
+		ret = fs_write(dfu->name, map_to_sysmem(buf), offset, *len,
+			       &size);
 		if (ret) {
 			puts("dfu: fs_write error!\n");
 			return ret;
@@ -157,6 +160,30 @@ static int mmc_file_op(enum dfu_op op, struct dfu_entity *dfu,
 	return ret;
 }
 
+/*
+ * Check whether file data can be written as it arrives, rather than collected
+ * in dfu_file_buf first. This needs the filesystem to support writing at an
+ * offset, which ext4 does not.
+ *
+ * The write still happens in the DFU request handler, so the host waits for it
+ * before sending the next block. It cannot be passed to an smp_work CPU to
+ * overlap with reception, since smp_work jobs may not access devices.
+ */
+static bool mmc_file_stream(struct dfu_entity *dfu)
+{
+	return IS_ENABLED(CONFIG_DFU_MMC_FILE_STREAM) &&
+		dfu->layout == DFU_FS_FAT;
+}
+
+static int mmc_file_stream_write(struct dfu_entity *dfu, u64 offset,
+				 void *buf, long *len)
+{
+	u64 size = *len;
+
+	/* Writing at offset 0 truncates the file, so any old contents go */
+	return mmc_file_op(DFU_OP_WRITE, dfu, offset, buf, &size);
+}
+
 static int mmc_file_buf_write(struct dfu_entity *dfu, u64 offset, void *buf, long *len)
 {
 	int ret = 0;
@@ -205,7 +232,10 @@ int dfu_write_medium_mmc(struct dfu_entity *dfu,
 		break;
 	case DFU_FS_FAT:
 	case DFU_FS_EXT4:
-		ret = mmc_file_buf_write(dfu, offset, buf, len);
+		if (mmc_file_stream(dfu))
+			ret = mmc_file_stream_write(dfu, offset, buf, len);
+		else
+			ret = mmc_file_buf_write(dfu, offset, buf, len);
 		break;
 	case DFU_SCRIPT:
 		ret = run_command_list(buf, *len, 0);
@@ -228,7 +258,18 @@ int dfu_flush_medium_mmc(struct dfu_entity *dfu)
 	switch (dfu->layout) {
 	case DFU_FS_FAT:
 	case DFU_FS_EXT4:
-		ret = mmc_file_buf_write_finish(dfu);
+		if (!mmc_file_stream(dfu)) {
+			ret = mmc_file_buf_write_finish(dfu);
+		} else if (!dfu->offset) {
+			long len = 0;
+
+			/* Nothing was received, so create an empty file */
+			if (dfu_file_buf)
+				ret = mmc_file_stream_write(dfu, 0, dfu_file_buf,
+							    &len);
+			else
+				ret = -ENOMEM;
+		}
 		break;
 	case DFU_SCRIPT:
 		/* script may have changed the dfu_alt_info */
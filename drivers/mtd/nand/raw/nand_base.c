@@ -2282,6 +2282,66 @@ static int nand_setup_read_retry(struct mtd_info *mtd, int retry_mode)
 	return chip->setup_read_retry(mtd, retry_mode);
 }
 
+/**
+ * nand_cache_read_last - [INTERN] Find the last page of a cache-read sequence
+ * @mtd: MTD device structure
+ * @realpage: first page to read
+ * @pages: number of whole pages to read, starting at @realpage
+ *
+ * Whole pages within an eraseblock can be read with READ CACHE SEQUENTIAL,
+ * which loads the next page into the chip's data register while the current
+ * one is transferred from its cache register, so that the array read time
+ * (tR) is mostly hidden.
+ *
+ * Returns the last page of the sequence, or -1 to read @realpage on its own.
+ */
+static int nand_cache_read_last(struct mtd_info *mtd, int realpage, int pages)
+{
+	struct nand_chip *chip = mtd_to_nand(mtd);
+	int ppb = 1 << (chip->phys_erase_shift - chip->page_shift);
+
+	/* HW_OOB_FIRST reads the OOB before the data, breaking the sequence */
+	if (!NAND_HAS_CACHE_READ(chip) ||
+	    !nand_standard_page_accessors(&chip->ecc) ||
+	    chip->ecc.mode == NAND_ECC_HW_OOB_FIRST)
+		return -1;
+
+	pages = min(pages, ppb - (realpage & (ppb - 1)));
+
+	return pages > 1 ? realpage + pages - 1 : -1;
+}
+
+/**
+ * nand_cache_read_op - [INTERN] Make a page of a cache-read sequence ready
+ * @chip: NAND chip object
+ * @page: page to read, relative to the chip
+ * @first: this is the first page of the sequence
+ * @last: this is the last page of the sequence
+ *
+ * The first page is loaded into the data register with READ PAGE. READ CACHE
+ * SEQUENTIAL then moves each page to the cache register, from which it is
+ * transferred, and starts loading the next one. READ CACHE END moves the last
+ * page without loading another.
+ *
+ * Returns 0 on success, a negative error code otherwise.
+ */
+static int nand_cache_read_op(struct nand_chip *chip, int page, bool first,
+			      bool last)
+{
+	struct mtd_info *mtd = nand_to_mtd(chip);
+	int ret;
+
+	if (first) {
+		ret = nand_read_page_op(chip, page, 0, NULL, 0);
+		if (ret)
+			return ret;
+	}
+	chip->cmdfunc(mtd, last ? NAND_CMD_READCACHEEND : NAND_CMD_READCACHESEQ,
+		      -1, -1);
+
+	return 0;
+}
+
 /**
  * nand_do_read_ops - [INTERN] Read data with ECC
  * @mtd: MTD device structure
@@ -2304,6 +2364,7 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 	int use_bufpoi;
 	unsigned int max_bitflips = 0;
 	int retry_mode = 0;
+	int seq_first = -1, seq_last = -1;
 	bool ecc_fail = false;
 
 	chipnr = (int)(from >> chip->chip_shift);
@@ -2342,7 +2403,23 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 						 __func__, buf);
 
 read_retry:
-			if (nand_standard_page_accessors(&chip->ecc)) {
+			/* Start a cache-read sequence if possible */
+			if (realpage > seq_last && aligned && !oob &&
+			    !retry_mode) {
+				seq_first = realpage;
+				seq_last = nand_cache_read_last(mtd, realpage,
+						readlen >> chip->page_shift);
+				if (seq_last != -1)
+					chip->pagebuf = -1;
+			}
+
+			if (realpage <= seq_last) {
+				ret = nand_cache_read_op(chip, page,
+							 realpage == seq_first,
+							 realpage == seq_last);
+				if (ret)
+					break;
+			} else if (nand_standard_page_accessors(&chip->ecc)) {
 				ret = nand_read_page_op(chip, page, 0, NULL, 0);
 				if (ret)
 					break;
@@ -2407,6 +2484,13 @@ read_retry:
 
 			if (mtd->ecc_stats.failed - ecc_failures) {
 				if (retry_mode + 1 < chip->read_retries) {
+					/* Leave the sequence to retry the page */
+					if (realpage < seq_last)
+						chip->cmdfunc(mtd,
+							NAND_CMD_READCACHEEND,
+							-1, -1);
+					seq_last = -1;
+
 					retry_mode++;
 					ret = nand_setup_read_retry(mtd,
 							retry_mode);
@@ -2456,6 +2540,9 @@ read_retry:
 			chip->select_chip(mtd, chipnr);
 		}
 	}
+	/* End a cache-read sequence cut short by an error */
+	if (realpage < seq_last)
+		chip->cmdfunc(mtd, NAND_CMD_READCACHEEND, -1, -1);
 	chip->select_chip(mtd, -1);
 
 	ops->retlen = ops->len - (size_t) readlen;
@@ -5147,6 +5234,14 @@ int nand_scan_tail(struct mtd_info *mtd)
 	/* Invalidate the pagebuffer reference */
 	chip->pagebuf = -1;
 
+	/*
+	 * Drivers set NAND_CACHE_READ if their controller can issue READ CACHE
+	 * SEQUENTIAL. Only use it if the chip says it supports it.
+	 */
+	if (!IS_ENABLED(CONFIG_SYS_NAND_CACHE_READ) ||
+	    !(onfi_opt_cmd(chip) & ONFI_OPT_CMD_READ_CACHE))
+		chip->options &= ~NAND_CACHE_READ;
+
 	/* Large page NAND with SOFT_ECC should support subpage reads */
 	switch (ecc->mode) {
 	case NAND_ECC_SOFT:
@@ -1,7 +1,24 @@
+#ifndef NAND_SPL_HAS_READ_PAGES
+/*
+ * Drivers which can read a run of pages with a single request, e.g. using the
+ * cache-read support in nand_base, define NAND_SPL_HAS_READ_PAGES and provide
+ * nand_read_pages() instead of nand_read_page(). Otherwise the pages are read
+ * one by one.
+ */
+static int nand_read_pages(int block, int page, int count, void *dst)
+{
+	for (; count; count--, page++, dst += CONFIG_SYS_NAND_PAGE_SIZE)
+		nand_read_page(block, page, dst);
+
+	return 0;
+}
+#endif
+
 int nand_spl_load_image(uint32_t offs, unsigned int size, void *dst)
 {
 	unsigned int block, lastblock;
 	unsigned int page, page_offset;
+	unsigned int count, len;
 
 	/* offs has to be aligned to a page address! */
 	block = offs / CONFIG_SYS_NAND_BLOCK_SIZE;
@@ -11,28 +28,26 @@ int nand_spl_load_image(uint32_t offs, unsigned int size, void *dst)
 
 	while (block <= lastblock) {
 		if (!nand_is_bad_block(block)) {
-			/* Skip bad blocks */
-			while (size && page < SYS_NAND_BLOCK_PAGES) {
-				nand_read_page(block, page, dst);
-
-				size -= min(size, CONFIG_SYS_NAND_PAGE_SIZE -
-						  page_offset);
-				/*
-				 * When offs is not aligned to page address the
-				 * extra offset is copied to dst as well. Copy
-				 * the image such that its first byte will be
-				 * at the dst.
-				 */
-				if (unlikely(page_offset)) {
-					memmove(dst, dst + page_offset,
-						CONFIG_SYS_NAND_PAGE_SIZE);
-					dst = (void *)(dst - page_offset);
-					page_offset = 0;
-				}
-				dst += CONFIG_SYS_NAND_PAGE_SIZE;
-				page++;
+			/* Read the rest of the image in this block at once */
+			count = DIV_ROUND_UP(size + page_offset,
+					     CONFIG_SYS_NAND_PAGE_SIZE);
+			count = min_t(uint, count, SYS_NAND_BLOCK_PAGES - page);
+			if (count)
+				nand_read_pages(block, page, count, dst);
+
+			len = count * CONFIG_SYS_NAND_PAGE_SIZE - page_offset;
+			size -= min(size, len);
+			/*
+			 * When offs is not aligned to page address the
+			 * extra offset is copied to dst as well. Copy
+			 * the image such that its first byte will be
+			 * at the dst.
+			 */
+			if (unlikely(page_offset)) {
+				memmove(dst, dst + page_offset, len);
+				page_offset = 0;
 			}
-
+			dst += len;
 			page = 0;
 		} else {
 			lastblock++;
@@ -118,12 +133,12 @@ int nand_spl_read_block(int block, int offset, int len, void *dst)
 		 * Page aligned reads go directly to the destination.
 		 */
 		if (offset || len < CONFIG_SYS_NAND_PAGE_SIZE) {
-			nand_read_page(block, page, scratch_buf);
+			nand_read_pages(block, page, 1, scratch_buf);
 			read = min(len, CONFIG_SYS_NAND_PAGE_SIZE - offset);
 			memcpy(dst, scratch_buf + offset, read);
 			offset = 0;
 		} else {
-			nand_read_page(block, page, dst);
+			nand_read_pages(block, page, 1, dst);
 			read = CONFIG_SYS_NAND_PAGE_SIZE;
 		}
 		page++;
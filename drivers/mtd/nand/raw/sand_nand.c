@@ -16,6 +16,7 @@
 #include <dm/read.h>
 #include <dm/uclass.h>
 #include <asm/bitops.h>
+#include <asm/test.h>
 #include <linux/bitmap.h>
 #include <linux/mtd/rawnand.h>
 #include <linux/sizes.h>
@@ -64,6 +65,12 @@ static const char *const state_name[] = {
  * @state: Current state of the device
  * @column: Column of the most-recent command
  * @page_addr: Page address of the most-recent command
+ * @cache_page: Page address loaded into the data register by a read, to be
+ *	moved to the cache register by NAND_CMD_READCACHESEQ or
+ *	NAND_CMD_READCACHEEND, or -1 if none
+ * @cache_seqs: Number of NAND_CMD_READCACHESEQ commands received
+ * @cache_ends: Number of NAND_CMD_READCACHEEND commands received
+ * @fail_reads: Number of page reads still to fail with an uncorrectable error
  * @fd: File descriptor for the backing data
  * @fd_page_addr: Page address that @fd is seek'd to
  * @selected: Whether this device is selected
@@ -83,7 +90,8 @@ struct sand_nand_chip {
 	u32 err_count, err_step_bits, err_steps, ecc_bits;
 	unsigned int cs;
 	enum sand_nand_state state;
-	int column, page_addr, fd, fd_page_addr;
+	int column, page_addr, cache_page, fd, fd_page_addr;
+	uint cache_seqs, cache_ends, fail_reads;
 	bool selected, tmp_dirty;
 	u8 status;
 	u8 id_len;
@@ -191,6 +199,14 @@ static int sand_nand_read(struct sand_nand_chip *chip)
 	 * our error generation by ECC step.
 	 */
 	chip->tmp_dirty = true;
+	if (chip->fail_reads && !stop) {
+		/* One more error than can be corrected, in the first step */
+		for (i = 0; i <= chip->nand.ecc.strength; i++)
+			__change_bit(i, chip->tmp);
+		chip->fail_reads--;
+		return 0;
+	}
+
 	for (i = 0; i < chip->err_steps; i++) {
 		u32 bit_errors = chip->err_count;
 		unsigned int j = chip->err_step_bits + chip->ecc_bits;
@@ -224,6 +240,7 @@ static void sand_nand_command(struct mtd_info *mtd, unsigned int command,
 	struct nand_chip *nand = mtd_to_nand(mtd);
 	struct sand_nand_chip *chip = to_sand_nand(nand);
 	enum sand_nand_state new_state = chip->state;
+	int cache_page = chip->cache_page;
 
 	SAND_DEBUG(chip, "command=%02x column=%d page_addr=%d\n", command,
 		   column, page_addr);
@@ -231,6 +248,15 @@ static void sand_nand_command(struct mtd_info *mtd, unsigned int command,
 	if (!chip->selected)
 		return;
 
+	/* Move within the page in the data register, e.g. for a sub-page */
+	if (command == NAND_CMD_RNDOUT && chip->state == STATE_READ) {
+		if (column < 0 || column >= chip->chunksize)
+			to_state(chip, STATE_IDLE);
+		else
+			chip->column = column;
+		return;
+	}
+
 	switch (chip->state) {
 	case STATE_READY:
 		if (command == NAND_CMD_RESET)
@@ -276,6 +302,7 @@ static void sand_nand_command(struct mtd_info *mtd, unsigned int command,
 	default:
 		chip->column = column;
 		chip->page_addr = page_addr;
+		chip->cache_page = -1;
 		switch (command) {
 		case NAND_CMD_READOOB:
 			if (column >= 0)
@@ -293,6 +320,32 @@ static void sand_nand_command(struct mtd_info *mtd, unsigned int command,
 				break;
 
 			chip->page_addr = page_addr;
+			chip->cache_page = page_addr;
+			new_state = STATE_READ;
+			break;
+		case NAND_CMD_READCACHESEQ:
+		case NAND_CMD_READCACHEEND:
+			if (command == NAND_CMD_READCACHESEQ)
+				chip->cache_seqs++;
+			else
+				chip->cache_ends++;
+			new_state = STATE_IDLE;
+			page_addr = cache_page;
+			if (page_addr < 0)
+				break;
+
+			/*
+			 * Transfer the page which was loaded, then load the
+			 * next one unless the sequence is ending
+			 */
+			chip->column = 0;
+			chip->page_addr = page_addr;
+			if (sand_nand_read(chip))
+				break;
+
+			if (command == NAND_CMD_READCACHESEQ &&
+			    page_addr + 1 < chip->pages)
+				chip->cache_page = page_addr + 1;
 			new_state = STATE_READ;
 			break;
 		case NAND_CMD_ERASE1:
@@ -448,6 +501,22 @@ static void sand_nand_write_buf(struct mtd_info *mtd, const u8 *buf, int len)
 
 static struct nand_chip *nand_chip;
 
+void sand_nand_fail_reads(struct mtd_info *mtd, uint count)
+{
+	to_sand_nand(mtd_to_nand(mtd))->fail_reads = count;
+}
+
+void sand_nand_get_cache_reads(struct mtd_info *mtd, uint *seqsp,
+			       uint *endsp)
+{
+	struct sand_nand_chip *chip = to_sand_nand(mtd_to_nand(mtd));
+
+	*seqsp = chip->cache_seqs;
+	*endsp = chip->cache_ends;
+	chip->cache_seqs = 0;
+	chip->cache_ends = 0;
+}
+
 int sand_nand_remove(struct udevice *dev)
 {
 	struct sand_nand_priv *priv = dev_get_priv(dev);
@@ -570,6 +639,7 @@ static int sand_nand_probe(struct udevice *dev)
 		chip->pagesize = pagesize;
 		chip->pages = pages;
 		chip->pages_per_erase = erasesize / pagesize;
+		chip->cache_page = -1;
 		memset(chip->tmp, 0xff, chip->chunksize);
 
 		chip->err_count = err_count;
@@ -601,7 +671,10 @@ static int sand_nand_probe(struct udevice *dev)
 		}
 
 		nand = &chip->nand;
-		nand->options = not_xpl() ? 0 : NAND_SKIP_BBTSCAN;
+		/* Each page can only be programmed once, so no sub-pages */
+		nand->options = NAND_CACHE_READ | NAND_NO_SUBPAGE_WRITE;
+		if (!not_xpl())
+			nand->options |= NAND_SKIP_BBTSCAN;
 		nand->flash_node = np;
 		nand->dev_ready = sand_nand_dev_ready;
 		nand->cmdfunc = sand_nand_command;
@@ -693,12 +766,15 @@ static int nand_is_bad_block(int block)
 	return mtd_block_isbad(mtd, block << mtd->erasesize_shift);
 }
 
-static int nand_read_page(int block, int page, uchar *dst)
+/* Read whole runs of pages, so that nand_base can use cache reads */
+#define NAND_SPL_HAS_READ_PAGES
+
+static int nand_read_pages(int block, int page, int count, void *dst)
 {
 	struct mtd_info *mtd = nand_to_mtd(nand_chip);
 	loff_t ofs = ((loff_t)block << mtd->erasesize_shift) +
 		     ((loff_t)page << mtd->writesize_shift);
-	size_t len = mtd->writesize;
+	size_t len = (size_t)count << mtd->writesize_shift;
 
 	return nand_read(mtd, ofs, &len, dst);
 }
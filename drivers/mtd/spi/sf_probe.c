@@ -29,6 +29,7 @@ static int spi_nor_create_read_dirmap(struct spi_nor *nor)
 		.length = nor->mtd.size,
 	};
 	struct spi_mem_op *op = &info.op_tmpl;
+	int ret;
 
 	/* get transfer protocols. */
 	spi_nor_setup_op(nor, op, nor->read_proto);
@@ -40,8 +41,11 @@ static int spi_nor_create_read_dirmap(struct spi_nor *nor)
 		op->dummy.nbytes *= 2;
 
 	nor->dirmap.rdesc = spi_mem_dirmap_create(nor->spi, &info);
-	if (IS_ERR(nor->dirmap.rdesc))
-		return PTR_ERR(nor->dirmap.rdesc);
+	if (IS_ERR(nor->dirmap.rdesc)) {
+		ret = PTR_ERR(nor->dirmap.rdesc);
+		nor->dirmap.rdesc = NULL;
+		return ret;
+	}
 
 	return 0;
 }
@@ -57,6 +61,7 @@ static int spi_nor_create_write_dirmap(struct spi_nor *nor)
 		.length = nor->mtd.size,
 	};
 	struct spi_mem_op *op = &info.op_tmpl;
+	int ret;
 
 	/* get transfer protocols. */
 	spi_nor_setup_op(nor, op, nor->write_proto);
@@ -66,8 +71,11 @@ static int spi_nor_create_write_dirmap(struct spi_nor *nor)
 		op->addr.nbytes = 0;
 
 	nor->dirmap.wdesc = spi_mem_dirmap_create(nor->spi, &info);
-	if (IS_ERR(nor->dirmap.wdesc))
-		return PTR_ERR(nor->dirmap.wdesc);
+	if (IS_ERR(nor->dirmap.wdesc)) {
+		ret = PTR_ERR(nor->dirmap.wdesc);
+		nor->dirmap.wdesc = NULL;
+		return ret;
+	}
 
 	return 0;
 }
@@ -100,14 +108,19 @@ static int spi_flash_probe_slave(struct spi_flash *flash)
 	if (ret)
 		goto err_read_id;
 
+	/*
+	 * If a mapping cannot be created (e.g. the controller cannot send the
+	 * operation as it is), use the flash through spi-mem operations
+	 */
 	if (CONFIG_IS_ENABLED(SPI_DIRMAP)) {
 		ret = spi_nor_create_read_dirmap(flash);
 		if (ret)
-			return ret;
+			log_debug("No read mapping (err=%d)\n", ret);
 
 		ret = spi_nor_create_write_dirmap(flash);
 		if (ret)
-			return ret;
+			log_debug("No write mapping (err=%d)\n", ret);
+		ret = 0;
 	}
 
 	if (CONFIG_IS_ENABLED(SPI_FLASH_MTD))
@@ -1246,12 +1246,16 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		cond_resched();
 
 		dbg_gen("process PEB %d", pnum);
+		ubi_io_read_hdrs(ubi, pnum);
 		err = scan_peb(ubi, ai, pnum, NULL, NULL);
 		if (err < 0)
 			goto out_vidh;
 	}
+	ubi_io_free_hdrs(ubi);
 
 	ubi_msg(ubi, "scanning is finished");
+	dbg_gen("PEB headers read together: %d, separately after an error: %d",
+		ubi->hdrs_together, ubi->hdrs_apart);
 
 	/* Calculate mean erase counter */
 	if (ai->ec_count)
@@ -1294,6 +1298,7 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	return 0;
 
 out_vidh:
+	ubi_io_free_hdrs(ubi);
 	ubi_free_vid_hdr(ubi, vidh);
 out_ech:
 	kfree(ech);
@@ -1357,6 +1362,7 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 		cond_resched();
 
 		dbg_gen("process PEB %d", pnum);
+		ubi_io_read_hdrs(ubi, pnum);
 		err = scan_peb(ubi, *ai, pnum, &vol_id, &sqnum);
 		if (err < 0)
 			goto out_vidh;
@@ -1367,6 +1373,7 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 		}
 	}
 
+	ubi_io_free_hdrs(ubi);
 	ubi_free_vid_hdr(ubi, vidh);
 	kfree(ech);
 
@@ -1381,6 +1388,7 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 	return ubi_scan_fastmap(ubi, *ai, fm_anchor);
 
 out_vidh:
+	ubi_io_free_hdrs(ubi);
 	ubi_free_vid_hdr(ubi, vidh);
 out_ech:
 	kfree(ech);
@@ -1428,6 +1436,8 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 				err = scan_all(ubi, ai, 0);
 			} else {
 				err = scan_all(ubi, ai, UBI_FM_MAX_START);
+				if (!err && ubi->fm_disabled)
+					ubi_msg(ubi, "no fastmap, attached by scanning; set CONFIG_MTD_UBI_FASTMAP_AUTOCONVERT to write one");
 			}
 		}
 	}
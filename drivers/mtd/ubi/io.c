@@ -697,6 +697,84 @@ bad:
 	return 1;
 }
 
+/* Size of the area holding both headers */
+static int hdrs_size(const struct ubi_device *ubi)
+{
+	return ubi->vid_hdr_aloffset + ubi->vid_hdr_alsize;
+}
+
+/**
+ * ubi_io_read_hdrs - read both headers of a physical eraseblock at once.
+ * @ubi: UBI device description object
+ * @pnum: physical eraseblock to read from
+ *
+ * When attaching, both headers of each physical eraseblock are read. This
+ * function reads them with a single request, which on NAND reads the pages
+ * holding them in one go, and keeps them for 'ubi_io_read_ec_hdr()' and
+ * 'ubi_io_read_vid_hdr()'. This is only done if the headers are in the first
+ * two min. I/O units. If anything goes wrong, nothing is kept and the headers
+ * are read separately as usual, so that errors are reported as before. This
+ * includes correctable bit-flips, which MTD reports as -EUCLEAN once they
+ * reach its bit-flip threshold.
+ *
+ * The headers are kept until this function is called for another eraseblock
+ * or 'ubi_io_free_hdrs()' is called, so the eraseblock must not be written
+ * meanwhile.
+ */
+void ubi_io_read_hdrs(struct ubi_device *ubi, int pnum)
+{
+	int err, len = hdrs_size(ubi);
+	size_t read;
+
+	ubi->hdrs_pnum = -1;
+	if (len > 2 * ubi->min_io_size || ubi_io_is_bad(ubi, pnum))
+		return;
+
+	if (!ubi->hdrs_buf) {
+		ubi->hdrs_buf = kmalloc(len, GFP_KERNEL);
+		if (!ubi->hdrs_buf)
+			return;
+	}
+
+	err = mtd_read(ubi->mtd, (loff_t)pnum * ubi->peb_size, len, &read,
+		       ubi->hdrs_buf);
+	if (err || read != len) {
+		dbg_io("cannot read headers of PEB %d together, error %d",
+		       pnum, err);
+		ubi->hdrs_apart++;
+		return;
+	}
+	ubi->hdrs_pnum = pnum;
+	ubi->hdrs_together++;
+}
+
+/**
+ * ubi_io_free_hdrs - drop the headers read by 'ubi_io_read_hdrs()'.
+ * @ubi: UBI device description object
+ */
+void ubi_io_free_hdrs(struct ubi_device *ubi)
+{
+	kfree(ubi->hdrs_buf);
+	ubi->hdrs_buf = NULL;
+	ubi->hdrs_pnum = -1;
+}
+
+/*
+ * Read part of the header area, using the headers read by 'ubi_io_read_hdrs()'
+ * if possible.
+ */
+static int read_hdr(const struct ubi_device *ubi, void *buf, int pnum,
+		    int offset, int len)
+{
+	if (ubi->hdrs_buf && pnum == ubi->hdrs_pnum &&
+	    offset + len <= hdrs_size(ubi)) {
+		memcpy(buf, ubi->hdrs_buf + offset, len);
+		return 0;
+	}
+
+	return ubi_io_read(ubi, buf, pnum, offset, len);
+}
+
 /**
  * ubi_io_read_ec_hdr - read and check an erase counter header.
  * @ubi: UBI device description object
@@ -728,7 +806,7 @@ int ubi_io_read_ec_hdr(struct ubi_device *ubi, int pnum,
 	dbg_io("read EC header from PEB %d", pnum);
 	ubi_assert(pnum >= 0 && pnum < ubi->peb_count);
 
-	read_err = ubi_io_read(ubi, ec_hdr, pnum, 0, UBI_EC_HDR_SIZE);
+	read_err = read_hdr(ubi, ec_hdr, pnum, 0, UBI_EC_HDR_SIZE);
 	if (read_err) {
 		if (read_err != UBI_IO_BITFLIPS && !mtd_is_eccerr(read_err))
 			return read_err;
@@ -1003,8 +1081,8 @@ int ubi_io_read_vid_hdr(struct ubi_device *ubi, int pnum,
 	ubi_assert(pnum >= 0 &&  pnum < ubi->peb_count);
 
 	p = (char *)vid_hdr - ubi->vid_hdr_shift;
-	read_err = ubi_io_read(ubi, p, pnum, ubi->vid_hdr_aloffset,
-			  ubi->vid_hdr_alsize);
+	read_err = read_hdr(ubi, p, pnum, ubi->vid_hdr_aloffset,
+			    ubi->vid_hdr_alsize);
 	if (read_err && read_err != UBI_IO_BITFLIPS && !mtd_is_eccerr(read_err))
 		return read_err;
 
@@ -526,6 +526,11 @@ struct ubi_debug_info {
  * @mtd: MTD device descriptor
  *
  * @peb_buf: a buffer of PEB size used for different purposes
+ * @hdrs_buf: both headers of PEB @hdrs_pnum, read together while attaching
+ * @hdrs_pnum: PEB whose headers are in @hdrs_buf, or %-1 if none
+ * @hdrs_together: number of PEBs whose headers were read together
+ * @hdrs_apart: number of PEBs whose headers had to be read separately
+ *		because reading them together failed
  * @buf_mutex: protects @peb_buf
  * @ckvol_mutex: serializes static volume checking when opening
  *
@@ -625,6 +630,10 @@ struct ubi_device {
 	struct mtd_info *mtd;
 
 	void *peb_buf;
+	void *hdrs_buf;
+	int hdrs_pnum;
+	int hdrs_together;
+	int hdrs_apart;
 	struct mutex buf_mutex;
 	struct mutex ckvol_mutex;
 
@@ -891,6 +900,8 @@ int ubi_io_write(struct ubi_device *ubi, const void *buf, int pnum, int offset,
 int ubi_io_sync_erase(struct ubi_device *ubi, int pnum, int torture);
 int ubi_io_is_bad(const struct ubi_device *ubi, int pnum);
 int ubi_io_mark_bad(const struct ubi_device *ubi, int pnum);
+void ubi_io_read_hdrs(struct ubi_device *ubi, int pnum);
+void ubi_io_free_hdrs(struct ubi_device *ubi);
 int ubi_io_read_ec_hdr(struct ubi_device *ubi, int pnum,
 		       struct ubi_ec_hdr *ec_hdr, int verbose);
 int ubi_io_write_ec_hdr(struct ubi_device *ubi, int pnum,
@@ -23,6 +23,7 @@ DECLARE_GLOBAL_DATA_PTR;
 
 static size_t _sandbox_serial_written = 1;
 static bool sandbox_serial_enabled = true;
+static int sandbox_serial_busy_count;
 
 size_t sandbox_serial_written(void)
 {
@@ -34,6 +35,21 @@ void sandbox_serial_endisable(bool enabled)
 	sandbox_serial_enabled = enabled;
 }
 
+void sandbox_serial_set_busy(int count)
+{
+	sandbox_serial_busy_count = count;
+}
+
+/* Pretend that the UART is not ready, if requested */
+static bool sandbox_serial_busy(void)
+{
+	if (!sandbox_serial_busy_count)
+		return false;
+	sandbox_serial_busy_count--;
+
+	return true;
+}
+
 /**
  * output_ansi_colour() - Output an ANSI colour code
  *
@@ -95,6 +111,8 @@ static int sandbox_serial_putc(struct udevice *dev, const char ch)
 {
 	struct sandbox_serial_priv *priv = dev_get_priv(dev);
 
+	if (sandbox_serial_busy())
+		return -EAGAIN;
 	if (ch == '\n')
 		priv->start_of_line = true;
 
@@ -112,6 +130,8 @@ static ssize_t sandbox_serial_puts(struct udevice *dev, const char *s,
 	struct sandbox_serial_priv *priv = dev_get_priv(dev);
 	ssize_t ret;
 
+	if (sandbox_serial_busy())
+		return -EAGAIN;
 	if (len && s[len - 1] == '\n')
 		priv->start_of_line = true;
 
@@ -6,6 +6,7 @@
 #define LOG_CATEGORY UCLASS_SERIAL
 
 #include <config.h>
+#include <cyclic.h>
 #include <dm.h>
 #include <env_internal.h>
 #include <errno.h>
@@ -232,10 +233,123 @@ int serial_initialize(void)
 	return serial_init();
 }
 
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+static bool serial_tx_buffered(struct udevice *dev)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+
+	return upriv->tx_dev;
+}
+
+/* Send as much of the TX buffer as the UART accepts without waiting */
+static void serial_tx_drain(struct udevice *dev)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+	struct dm_serial_ops *ops = serial_get_ops(dev);
+	ssize_t written;
+	uint rd, len;
+
+	/* Avoid recursion, e.g. if the driver calls schedule() */
+	if (upriv->tx_busy)
+		return;
+	upriv->tx_busy = true;
+	while (upriv->tx_rd != upriv->tx_wr) {
+		rd = upriv->tx_rd % CONFIG_SERIAL_TX_BUFFER_SIZE;
+		if (CONFIG_IS_ENABLED(SERIAL_PUTS) && ops->puts) {
+			len = min(upriv->tx_wr - upriv->tx_rd,
+				  CONFIG_SERIAL_TX_BUFFER_SIZE - rd);
+			written = ops->puts(dev, upriv->tx_buf + rd, len);
+		} else {
+			len = 1;
+			written = ops->putc(dev, upriv->tx_buf[rd]);
+			if (!written)
+				written = 1;
+		}
+		if (!written || written == -EAGAIN)
+			break;
+		if (written < 0) {
+			upriv->tx_dropped += len;
+			written = len;
+		}
+		upriv->tx_rd += written;
+	}
+	upriv->tx_busy = false;
+}
+
+/* Wait until the TX buffer is empty */
+static void serial_tx_wait(struct udevice *dev)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+
+	while (upriv->tx_rd != upriv->tx_wr && !upriv->tx_busy)
+		serial_tx_drain(dev);
+}
+
+static void serial_tx_add(struct udevice *dev, char ch)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+
+	BUILD_BUG_ON_NOT_POWER_OF_2(CONFIG_SERIAL_TX_BUFFER_SIZE);
+
+	if (upriv->tx_wr - upriv->tx_rd == CONFIG_SERIAL_TX_BUFFER_SIZE) {
+		/* Output from within the driver cannot wait for itself */
+		if (upriv->tx_busy) {
+			upriv->tx_dropped++;
+			return;
+		}
+		upriv->tx_overflows++;
+		while (upriv->tx_wr - upriv->tx_rd ==
+		       CONFIG_SERIAL_TX_BUFFER_SIZE)
+			serial_tx_drain(dev);
+	}
+	upriv->tx_buf[upriv->tx_wr++ % CONFIG_SERIAL_TX_BUFFER_SIZE] = ch;
+}
+
+static void serial_tx_cyclic(struct cyclic_info *c)
+{
+	struct serial_dev_priv *upriv;
+
+	upriv = container_of(c, struct serial_dev_priv, tx_cyclic);
+	serial_tx_drain(upriv->tx_dev);
+}
+
+int serial_get_tx_stats(struct udevice *dev, struct serial_tx_stats *stats)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+
+	if (!upriv->tx_dev)
+		return -ENOSYS;
+	stats->used = upriv->tx_wr - upriv->tx_rd;
+	stats->size = CONFIG_SERIAL_TX_BUFFER_SIZE;
+	stats->overflows = upriv->tx_overflows;
+	stats->dropped = upriv->tx_dropped;
+
+	return 0;
+}
+#else
+static bool serial_tx_buffered(struct udevice *dev)
+{
+	return false;
+}
+
+static void serial_tx_drain(struct udevice *dev)
+{
+}
+
+static void serial_tx_wait(struct udevice *dev)
+{
+}
+
+static void serial_tx_add(struct udevice *dev, char ch)
+{
+}
+#endif /* CONFIG_IS_ENABLED(SERIAL_TX_BUFFER) */
+
 static void _serial_flush(struct udevice *dev)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
 
+	serial_tx_wait(dev);
 	if (!ops->pending)
 		return;
 	while (ops->pending(dev, false) > 0)
@@ -247,6 +361,16 @@ static void _serial_putc(struct udevice *dev, char ch)
 	struct dm_serial_ops *ops = serial_get_ops(dev);
 	int err;
 
+	if (serial_tx_buffered(dev)) {
+		if (ch == '\n')
+			serial_tx_add(dev, '\r');
+		serial_tx_add(dev, ch);
+		serial_tx_drain(dev);
+		if (IS_ENABLED(CONFIG_CONSOLE_FLUSH_ON_NEWLINE) && ch == '\n')
+			_serial_flush(dev);
+		return;
+	}
+
 	if (ch == '\n')
 		_serial_putc(dev, '\r');
 
@@ -278,6 +402,22 @@ static void _serial_puts(struct udevice *dev, const char *str)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
 
+	if (serial_tx_buffered(dev)) {
+		bool newline = false;
+
+		for (; *str; str++) {
+			if (*str == '\n') {
+				serial_tx_add(dev, '\r');
+				newline = true;
+			}
+			serial_tx_add(dev, *str);
+		}
+		serial_tx_drain(dev);
+		if (IS_ENABLED(CONFIG_CONSOLE_FLUSH_ON_NEWLINE) && newline)
+			_serial_flush(dev);
+		return;
+	}
+
 	if (!CONFIG_IS_ENABLED(SERIAL_PUTS) || !ops->puts) {
 		while (*str)
 			_serial_putc(dev, *str++);
@@ -319,6 +459,9 @@ static int __serial_tstc(struct udevice *dev)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
 
+	/* Keep output moving while waiting for input */
+	serial_tx_drain(dev);
+
 	if (ops->pending)
 		return ops->pending(dev, true);
 
@@ -574,6 +717,17 @@ static int serial_post_probe(struct udevice *dev)
 			return ret;
 	}
 
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+	/* Devices probed before relocation are not used afterwards */
+	if (gd->flags & GD_FLG_RELOC) {
+		struct serial_dev_priv *uc_priv = dev_get_uclass_priv(dev);
+
+		uc_priv->tx_dev = dev;
+		cyclic_register(&uc_priv->tx_cyclic, serial_tx_cyclic, 0,
+				dev->name);
+	}
+#endif
+
 #if CONFIG_IS_ENABLED(DM_STDIO)
 	if (!(gd->flags & GD_FLG_RELOC))
 		return 0;
@@ -595,12 +749,19 @@ static int serial_post_probe(struct udevice *dev)
 
 static int serial_pre_remove(struct udevice *dev)
 {
-#if CONFIG_IS_ENABLED(SYS_STDIO_DEREGISTER)
-	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+	struct serial_dev_priv *upriv __maybe_unused = dev_get_uclass_priv(dev);
 
+#if CONFIG_IS_ENABLED(SYS_STDIO_DEREGISTER)
 	if (stdio_deregister_dev(upriv->sdev, true))
 		return -EPERM;
 #endif
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+	if (upriv->tx_dev) {
+		serial_tx_wait(dev);
+		cyclic_unregister(&upriv->tx_cyclic);
+		upriv->tx_dev = NULL;
+	}
+#endif
 
 	return 0;
 }
@@ -597,13 +597,18 @@ EXPORT_SYMBOL_GPL(spi_mem_dirmap_create);
  * @desc: the direct mapping descriptor to destroy
  *
  * This function destroys a direct mapping descriptor previously created by
- * spi_mem_dirmap_create().
+ * spi_mem_dirmap_create(). Nothing is done if @desc is NULL.
  */
 void spi_mem_dirmap_destroy(struct spi_mem_dirmap_desc *desc)
 {
-	struct udevice *bus = desc->slave->dev->parent;
-	struct dm_spi_ops *ops = spi_get_ops(bus);
+	struct udevice *bus;
+	struct dm_spi_ops *ops;
+
+	if (!desc)
+		return;
 
+	bus = desc->slave->dev->parent;
+	ops = spi_get_ops(bus);
 	if (!desc->nodirmap && ops->mem_ops && ops->mem_ops->dirmap_destroy)
 		ops->mem_ops->dirmap_destroy(desc);
 
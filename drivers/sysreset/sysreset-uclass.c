@@ -14,6 +14,7 @@
 #include <log.h>
 #include <regmap.h>
 #include <spl.h>
+#include <stdio.h>
 #include <sysreset.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -95,6 +96,10 @@ void sysreset_walk_halt(enum sysreset_t type)
 {
 	int ret;
 
+	/* Make sure any buffered console output has been sent */
+	if (CONFIG_IS_ENABLED(SERIAL_TX_BUFFER))
+		flush();
+
 	ret = sysreset_walk(type);
 
 	/* Wait for the reset to take effect */
@@ -5,6 +5,7 @@
  * 2017 Marek Behún, CZ.NIC, kabel@kernel.org
  */
 
+#include <fs_io.h>
 #include <linux/kernel.h>
 #include <malloc.h>
 #include <memalign.h>
@@ -661,6 +662,69 @@ static int read_and_truncate_page(struct btrfs_path *path,
 	return len;
 }
 
+/*
+ * Queue the read of part of an uncompressed regular extent, which has only one
+ * copy, to be read by fs_io_submit().
+ *
+ * @offset and @len should not cross the extent boundary.
+ * Return the number of bytes queued.
+ * Return -EAGAIN if the extent must be read by btrfs_read_extent_reg() instead.
+ * Return <0 for other errors.
+ */
+static int btrfs_queue_extent_reg(struct fs_io *io, struct btrfs_path *path,
+				  struct btrfs_file_extent_item *fi,
+				  u64 offset, int len, char *dest)
+{
+	struct extent_buffer *leaf = path->nodes[0];
+	struct btrfs_fs_info *fs_info = leaf->fs_info;
+	struct btrfs_multi_bio *multi;
+	struct btrfs_device *device;
+	struct btrfs_key key;
+	u64 logical, physical;
+	u64 cur, cur_len;
+	int ret;
+
+	if (!CONFIG_IS_ENABLED(FS_IO) ||
+	    btrfs_file_extent_compression(leaf, fi) != BTRFS_COMPRESS_NONE)
+		return -EAGAIN;
+
+	btrfs_item_key_to_cpu(leaf, &key, path->slots[0]);
+	logical = btrfs_file_extent_disk_bytenr(leaf, fi) +
+		  btrfs_file_extent_offset(leaf, fi) + offset - key.offset;
+	if (btrfs_num_copies(fs_info, logical, len) != 1)
+		return -EAGAIN;
+
+	for (cur = logical; cur < logical + len; cur += cur_len) {
+		cur_len = logical + len - cur;
+		multi = NULL;
+		ret = btrfs_map_block(fs_info, READ, cur, &cur_len, &multi, 1,
+				      NULL);
+		if (ret) {
+			error("Couldn't map the block %llu", cur);
+			return ret;
+		}
+		device = multi->stripes[0].dev;
+		physical = multi->stripes[0].physical;
+		kfree(multi);
+		if (!device->desc || !device->part)
+			return -EAGAIN;
+
+		/* All the reads in the list must be for the same device */
+		if (!io->desc)
+			fs_io_init(io, device->desc, device->part);
+		else if (io->desc != device->desc || io->part != device->part)
+			return -EAGAIN;
+
+		ret = fs_io_add(io, physical >> io->desc->log2blksz,
+				physical & (io->desc->blksz - 1), cur_len,
+				dest + cur - logical);
+		if (ret)
+			return ret;
+	}
+
+	return len;
+}
+
 int btrfs_file_read(struct btrfs_root *root, u64 ino, u64 file_offset, u64 len,
 		    char *dest)
 {
@@ -672,6 +736,7 @@ int btrfs_file_read(struct btrfs_root *root, u64 ino, u64 file_offset, u64 len,
 	u64 aligned_end = round_down(file_offset + len, fs_info->sectorsize);
 	u64 next_offset;
 	u64 cur = aligned_start;
+	struct fs_io io = { NULL };
 	int ret = 0;
 
 	btrfs_init_path(&path);
@@ -748,9 +813,13 @@ int btrfs_file_read(struct btrfs_root *root, u64 ino, u64 file_offset, u64 len,
 		/* Read the remaining part of the extent */
 		extent_num_bytes = btrfs_file_extent_num_bytes(path.nodes[0],
 							       fi);
-		ret = btrfs_read_extent_reg(&path, fi, cur,
+		ret = btrfs_queue_extent_reg(&io, &path, fi, cur,
 				min(extent_num_bytes, aligned_end - cur),
 				dest + cur - file_offset);
+		if (ret == -EAGAIN)
+			ret = btrfs_read_extent_reg(&path, fi, cur,
+					min(extent_num_bytes, aligned_end - cur),
+					dest + cur - file_offset);
 		if (ret < 0)
 			goto out;
 		cur += min(extent_num_bytes, aligned_end - cur);
@@ -771,6 +840,10 @@ int btrfs_file_read(struct btrfs_root *root, u64 ino, u64 file_offset, u64 len,
 				dest + aligned_end - file_offset);
 	}
 out:
+	/* Read the extents which were queued */
+	if (io.desc && ret >= 0 && fs_io_submit(&io))
+		ret = -EIO;
+	fs_io_uninit(&io);
 	btrfs_release_path(&path);
 	if (ret < 0)
 		return ret;
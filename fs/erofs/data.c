@@ -216,11 +216,98 @@ static int erofs_read_raw_data(struct erofs_inode *inode, char *buffer,
 	return 0;
 }
 
+/**
+ * struct z_erofs_extent - A compressed extent to be decompressed
+ *
+ * @pa: Physical address of the pcluster
+ * @la: Logical address of the extent
+ * @plen: Length of the pcluster
+ * @flags: Mapping flags (EROFS_MAP_...)
+ * @alg: Compression algorithm (Z_EROFS_COMPRESSION_...)
+ * @out: Where to put the decompressed data, after skipping @skip bytes
+ * @skip: Number of decompressed bytes to skip
+ * @length: Number of bytes to decompress, including @skip
+ * @trimmed: true if only part of the extent is needed
+ */
+struct z_erofs_extent {
+	erofs_off_t pa, la;
+	u64 plen;
+	unsigned int flags;
+	char alg;
+	char *out;
+	erofs_off_t skip, length;
+	bool trimmed;
+};
+
+/* Maximum number of pclusters, and bytes, read together */
+#define Z_EROFS_BATCH_MAX	16
+#define Z_EROFS_BATCH_BYTES	(256 * 1024)
+
+/**
+ * struct z_erofs_batch - Physically adjacent pclusters to read in one go
+ *
+ * @ext: Extents to decompress, in descending order of address
+ * @count: Number of extents in @ext
+ * @pa: Physical address of the first pcluster (that of the last extent)
+ * @len: Total length of the pclusters
+ * @raw: Buffer for the compressed data
+ * @bufsize: Size of @raw
+ */
+struct z_erofs_batch {
+	struct z_erofs_extent ext[Z_EROFS_BATCH_MAX];
+	unsigned int count;
+	erofs_off_t pa;
+	u64 len;
+	char *raw;
+	u64 bufsize;
+};
+
+static int z_erofs_decompress_extent(struct z_erofs_extent *ext, char *raw)
+{
+	int ret;
+
+	ret = z_erofs_decompress(&(struct z_erofs_decompress_req) {
+			.in = raw,
+			.out = ext->out,
+			.decodedskip = ext->skip,
+			.interlaced_offset =
+				ext->alg == Z_EROFS_COMPRESSION_INTERLACED ?
+					erofs_blkoff(ext->la) : 0,
+			.inputsize = ext->plen,
+			.decodedlength = ext->length,
+			.alg = ext->alg,
+			.partial_decoding = ext->trimmed ? true :
+				!(ext->flags & EROFS_MAP_FULL_MAPPED) ||
+					(ext->flags & EROFS_MAP_PARTIAL_REF),
+			 });
+	if (ret < 0)
+		return ret;
+	return 0;
+}
+
+static int z_erofs_read_raw(char *raw, erofs_off_t pa, u64 len)
+{
+	struct erofs_map_dev mdev;
+	int ret;
+
+	/* no device id here, thus it will always succeed */
+	mdev = (struct erofs_map_dev) {
+		.m_pa = pa,
+	};
+	ret = erofs_map_dev(&mdev);
+	if (ret) {
+		DBG_BUGON(1);
+		return ret;
+	}
+
+	return erofs_dev_read(mdev.m_deviceid, raw, mdev.m_pa, len);
+}
+
 int z_erofs_read_one_data(struct erofs_inode *inode,
 			  struct erofs_map_blocks *map, char *raw, char *buffer,
 			  erofs_off_t skip, erofs_off_t length, bool trimmed)
 {
-	struct erofs_map_dev mdev;
+	struct z_erofs_extent ext;
 	int ret = 0;
 
 	if (map->m_flags & EROFS_MAP_FRAGMENT) {
@@ -238,36 +325,82 @@ int z_erofs_read_one_data(struct erofs_inode *inode,
 				   inode->fragmentoff + skip);
 	}
 
-	/* no device id here, thus it will always succeed */
-	mdev = (struct erofs_map_dev) {
-		.m_pa = map->m_pa,
-	};
-	ret = erofs_map_dev(&mdev);
-	if (ret) {
-		DBG_BUGON(1);
+	ret = z_erofs_read_raw(raw, map->m_pa, map->m_plen);
+	if (ret < 0)
 		return ret;
+
+	ext = (struct z_erofs_extent) {
+		.pa = map->m_pa,
+		.la = map->m_la,
+		.plen = map->m_plen,
+		.flags = map->m_flags,
+		.alg = map->m_algorithmformat,
+		.out = buffer,
+		.skip = skip,
+		.length = length,
+		.trimmed = trimmed,
+	};
+
+	return z_erofs_decompress_extent(&ext, raw);
+}
+
+/* Read all the pclusters in a batch with one read, then decompress them */
+static int z_erofs_flush_batch(struct z_erofs_batch *batch)
+{
+	unsigned int i;
+	int ret;
+
+	if (!batch->count)
+		return 0;
+
+	if (batch->len > batch->bufsize) {
+		char *raw = realloc(batch->raw, batch->len);
+
+		if (!raw)
+			return -ENOMEM;
+		batch->raw = raw;
+		batch->bufsize = batch->len;
 	}
 
-	ret = erofs_dev_read(mdev.m_deviceid, raw, mdev.m_pa, map->m_plen);
+	ret = z_erofs_read_raw(batch->raw, batch->pa, batch->len);
 	if (ret < 0)
 		return ret;
 
-	ret = z_erofs_decompress(&(struct z_erofs_decompress_req) {
-			.in = raw,
-			.out = buffer,
-			.decodedskip = skip,
-			.interlaced_offset =
-				map->m_algorithmformat == Z_EROFS_COMPRESSION_INTERLACED ?
-					erofs_blkoff(map->m_la) : 0,
-			.inputsize = map->m_plen,
-			.decodedlength = length,
-			.alg = map->m_algorithmformat,
-			.partial_decoding = trimmed ? true :
-				!(map->m_flags & EROFS_MAP_FULL_MAPPED) ||
-					(map->m_flags & EROFS_MAP_PARTIAL_REF),
-			 });
-	if (ret < 0)
-		return ret;
+	for (i = 0; i < batch->count; i++) {
+		struct z_erofs_extent *ext = &batch->ext[i];
+
+		ret = z_erofs_decompress_extent(ext,
+						batch->raw + ext->pa - batch->pa);
+		if (ret)
+			return ret;
+	}
+	batch->count = 0;
+	batch->len = 0;
+
+	return 0;
+}
+
+/*
+ * Add an extent to a batch. The file is read backwards, so the extent is
+ * added to the batch if its pcluster ends where the batch starts.
+ */
+static int z_erofs_add_to_batch(struct z_erofs_batch *batch,
+				struct z_erofs_extent *ext)
+{
+	int ret;
+
+	if (batch->count && (ext->pa + ext->plen != batch->pa ||
+			     batch->count == Z_EROFS_BATCH_MAX ||
+			     batch->len + ext->plen > Z_EROFS_BATCH_BYTES)) {
+		ret = z_erofs_flush_batch(batch);
+		if (ret)
+			return ret;
+	}
+
+	batch->ext[batch->count++] = *ext;
+	batch->pa = ext->pa;
+	batch->len += ext->plen;
+
 	return 0;
 }
 
@@ -278,9 +411,11 @@ static int z_erofs_read_data(struct erofs_inode *inode, char *buffer,
 	struct erofs_map_blocks map = {
 		.index = UINT_MAX,
 	};
+	struct z_erofs_batch batch = {
+		.count = 0,
+	};
+	struct z_erofs_extent ext;
 	bool trimmed;
-	unsigned int bufsize = 0;
-	char *raw = NULL;
 	int ret = 0;
 
 	end = offset + size;
@@ -318,23 +453,47 @@ static int z_erofs_read_data(struct erofs_inode *inode, char *buffer,
 			continue;
 		}
 
-		if (map.m_plen > bufsize) {
-			bufsize = map.m_plen;
-			raw = realloc(raw, bufsize);
-			if (!raw) {
-				ret = -ENOMEM;
+		if (map.m_flags & EROFS_MAP_FRAGMENT) {
+			ret = z_erofs_read_one_data(inode, &map, NULL,
+						    buffer + end - offset, skip,
+						    length, trimmed);
+			if (ret < 0)
+				break;
+			continue;
+		}
+
+		/* uncompressed data can be read straight into the buffer */
+		if (map.m_algorithmformat == Z_EROFS_COMPRESSION_SHIFTED) {
+			if (length > map.m_plen) {
+				ret = -EFSCORRUPTED;
 				break;
 			}
+			ret = erofs_read_one_data(&map, buffer + end - offset,
+						  skip, length - skip);
+			if (ret < 0)
+				break;
+			continue;
 		}
 
-		ret = z_erofs_read_one_data(inode, &map, raw,
-					    buffer + end - offset, skip, length,
-					    trimmed);
+		ext = (struct z_erofs_extent) {
+			.pa = map.m_pa,
+			.la = map.m_la,
+			.plen = map.m_plen,
+			.flags = map.m_flags,
+			.alg = map.m_algorithmformat,
+			.out = buffer + end - offset,
+			.skip = skip,
+			.length = length,
+			.trimmed = trimmed,
+		};
+		ret = z_erofs_add_to_batch(&batch, &ext);
 		if (ret < 0)
 			break;
 	}
-	if (raw)
-		free(raw);
+	if (!ret)
+		ret = z_erofs_flush_batch(&batch);
+	free(batch.raw);
+
 	return ret < 0 ? ret : 0;
 }
 
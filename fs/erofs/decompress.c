@@ -138,6 +138,172 @@ out:
 }
 #endif
 
+#if IS_ENABLED(CONFIG_FS_EROFS_ZIP_ZSTD)
+#include <linux/zstd.h>
+
+/*
+ * streaming context, kept across calls since it is large to set up, and
+ * freed by z_erofs_decompress_exit() when the filesystem is closed
+ */
+static zstd_dstream *z_erofs_zstd_stream;
+static void *z_erofs_zstd_wksp;
+
+static int z_erofs_decompress_zstd(struct z_erofs_decompress_req *rq)
+{
+	zstd_in_buffer in_buf;
+	zstd_out_buffer out_buf;
+	u8 *src = (u8 *)rq->in;
+	u8 *buff = NULL;
+	unsigned int inputmargin = 0;
+	size_t zret;
+	int ret = 0;
+
+	while (!src[inputmargin & (erofs_blksiz() - 1)])
+		if (!(++inputmargin & (erofs_blksiz() - 1)))
+			break;
+
+	if (inputmargin >= rq->inputsize)
+		return -EFSCORRUPTED;
+
+	if (!z_erofs_zstd_stream) {
+		size_t wsize;
+		void *wksp;
+
+		wsize = zstd_dstream_workspace_bound(Z_EROFS_ZSTD_MAX_DICT_SIZE);
+		wksp = malloc(wsize);
+		if (!wksp)
+			return -ENOMEM;
+		z_erofs_zstd_stream = zstd_init_dstream(Z_EROFS_ZSTD_MAX_DICT_SIZE,
+							wksp, wsize);
+		if (!z_erofs_zstd_stream) {
+			free(wksp);
+			return -EIO;
+		}
+		z_erofs_zstd_wksp = wksp;
+	} else {
+		zstd_reset_dstream(z_erofs_zstd_stream);
+	}
+
+	out_buf.dst = rq->out;
+	if (rq->decodedskip) {
+		buff = malloc(rq->decodedlength);
+		if (!buff)
+			return -ENOMEM;
+		out_buf.dst = buff;
+	}
+	out_buf.pos = 0;
+	out_buf.size = rq->decodedlength;
+	in_buf.src = src + inputmargin;
+	in_buf.pos = 0;
+	in_buf.size = rq->inputsize - inputmargin;
+
+	/* stop once the output is full, since only part may be wanted */
+	do {
+		zret = zstd_decompress_stream(z_erofs_zstd_stream, &out_buf,
+					      &in_buf);
+		if (zstd_is_error(zret)) {
+			erofs_err("zstd decompression failed: %s",
+				  zstd_get_error_name(zret));
+			ret = -EIO;
+			goto out;
+		}
+	} while (zret && out_buf.pos < out_buf.size &&
+		 in_buf.pos < in_buf.size);
+
+	if (out_buf.pos != rq->decodedlength) {
+		erofs_err("failed to decompress %zu in[%u, %u] out[%u]",
+			  out_buf.pos, rq->inputsize, inputmargin,
+			  rq->decodedlength);
+		ret = -EIO;
+		goto out;
+	}
+
+	if (rq->decodedskip)
+		memcpy(rq->out, buff + rq->decodedskip,
+		       rq->decodedlength - rq->decodedskip);
+
+out:
+	if (buff)
+		free(buff);
+	return ret;
+}
+#endif
+
+#if IS_ENABLED(CONFIG_FS_EROFS_ZIP_LZMA)
+#include <lzma/LzmaTypes.h>
+#include <lzma/LzmaDec.h>
+
+static void *z_erofs_lzma_alloc(void *p, size_t size)
+{
+	return malloc(size);
+}
+
+static void z_erofs_lzma_free(void *p, void *address)
+{
+	free(address);
+}
+
+/*
+ * MicroLZMA is a raw LZMA stream without end marker, whose first byte (always
+ * zero for the range coder) is replaced by the inverted properties byte.
+ */
+static int z_erofs_decompress_lzma(struct z_erofs_decompress_req *rq)
+{
+	ISzAlloc alloc = { z_erofs_lzma_alloc, z_erofs_lzma_free };
+	u8 *dest = (u8 *)rq->out;
+	u8 *src = (u8 *)rq->in;
+	u8 *buff = NULL;
+	unsigned int inputmargin = 0;
+	u8 props[LZMA_PROPS_SIZE];
+	SizeT destlen, srclen;
+	ELzmaStatus status;
+	SRes res;
+	u8 first;
+	int ret = 0;
+
+	while (!src[inputmargin & (erofs_blksiz() - 1)])
+		if (!(++inputmargin & (erofs_blksiz() - 1)))
+			break;
+
+	if (inputmargin >= rq->inputsize)
+		return -EFSCORRUPTED;
+
+	if (rq->decodedskip) {
+		buff = malloc(rq->decodedlength);
+		if (!buff)
+			return -ENOMEM;
+		dest = buff;
+	}
+
+	first = src[inputmargin];
+	props[0] = ~first;
+	put_unaligned_le32(Z_EROFS_LZMA_MAX_DICT_SIZE, &props[1]);
+
+	src[inputmargin] = 0;
+	destlen = rq->decodedlength;
+	srclen = rq->inputsize - inputmargin;
+	res = LzmaDecode(dest, &destlen, src + inputmargin, &srclen, props,
+			 LZMA_PROPS_SIZE, LZMA_FINISH_ANY, &status, &alloc);
+	src[inputmargin] = first;
+
+	if (res != SZ_OK || destlen != rq->decodedlength) {
+		erofs_err("failed to decompress %d in[%u, %u] out[%u]", res,
+			  rq->inputsize, inputmargin, rq->decodedlength);
+		ret = -EIO;
+		goto out;
+	}
+
+	if (rq->decodedskip)
+		memcpy(rq->out, dest + rq->decodedskip,
+		       rq->decodedlength - rq->decodedskip);
+
+out:
+	if (buff)
+		free(buff);
+	return ret;
+}
+#endif
+
 int z_erofs_decompress(struct z_erofs_decompress_req *rq)
 {
 	if (rq->alg == Z_EROFS_COMPRESSION_INTERLACED) {
@@ -176,6 +342,23 @@ int z_erofs_decompress(struct z_erofs_decompress_req *rq)
 #if IS_ENABLED(CONFIG_ZLIB)
 	if (rq->alg == Z_EROFS_COMPRESSION_DEFLATE)
 		return z_erofs_decompress_deflate(rq);
+#endif
+#if IS_ENABLED(CONFIG_FS_EROFS_ZIP_ZSTD)
+	if (rq->alg == Z_EROFS_COMPRESSION_ZSTD)
+		return z_erofs_decompress_zstd(rq);
+#endif
+#if IS_ENABLED(CONFIG_FS_EROFS_ZIP_LZMA)
+	if (rq->alg == Z_EROFS_COMPRESSION_LZMA)
+		return z_erofs_decompress_lzma(rq);
 #endif
 	return -EOPNOTSUPP;
 }
+
+void z_erofs_decompress_exit(void)
+{
+#if IS_ENABLED(CONFIG_FS_EROFS_ZIP_ZSTD)
+	free(z_erofs_zstd_wksp);
+	z_erofs_zstd_wksp = NULL;
+	z_erofs_zstd_stream = NULL;
+#endif
+}
@@ -24,4 +24,7 @@ struct z_erofs_decompress_req {
 
 int z_erofs_decompress(struct z_erofs_decompress_req *rq);
 
+/* free any decompression state kept between calls */
+void z_erofs_decompress_exit(void);
+
 #endif
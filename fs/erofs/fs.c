@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: GPL-2.0+
 #include "internal.h"
+#include "decompress.h"
 #include <fs_internal.h>
 
 struct erofs_sb_info sbi;
@@ -252,6 +253,7 @@ int erofs_read(const char *filename, void *buf, loff_t offset, loff_t len,
 
 void erofs_close(void)
 {
+	z_erofs_decompress_exit();
 	ctxt.cur_dev = NULL;
 }
 
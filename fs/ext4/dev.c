@@ -25,6 +25,7 @@
 #include <blk.h>
 #include <config.h>
 #include <fs_internal.h>
+#include <fs_io.h>
 #include <ext4fs.h>
 #include <ext_common.h>
 #include "ext4_common.h"
@@ -53,6 +54,11 @@ int ext4fs_devread(lbaint_t sector, int byte_offset, int byte_len,
 			  byte_len, buffer);
 }
 
+void ext4fs_io_init(struct fs_io *io)
+{
+	fs_io_init(io, get_fs()->dev_desc, part_info);
+}
+
 int ext4_read_superblock(char *buffer)
 {
 	struct ext_filesystem *fs = get_fs();
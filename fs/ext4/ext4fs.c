@@ -23,6 +23,7 @@
 #include <blk.h>
 #include <ext_common.h>
 #include <ext4fs.h>
+#include <fs_io.h>
 #include "ext4_common.h"
 #include <div64.h>
 #include <malloc.h>
@@ -65,19 +66,20 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 	lbaint_t delayed_next = 0;
 	char *delayed_buf = NULL;
 	char *start_buf = buf;
-	short status;
 	struct ext_block_cache cache;
-
-	ext_cache_init(&cache);
+	struct fs_io io;
+	int ret = -1;
 
 	/* Adjust len so it we can't read past the end of the file. */
 	if (len + pos > filesize)
 		len = (filesize - pos);
 
-	if (blocksize <= 0 || len <= 0) {
-		ext_cache_fini(&cache);
+	if (blocksize <= 0 || len <= 0)
 		return -1;
-	}
+
+	ext_cache_init(&cache);
+	/* The data is queued and read once all the blocks are known */
+	ext4fs_io_init(&io);
 
 	blockcnt = lldiv(((len + pos) + blocksize - 1), blocksize);
 
@@ -87,10 +89,8 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 		int blockend = blocksize;
 		int skipfirst = 0;
 		blknr = read_allocated_block(&node->inode, i, &cache);
-		if (blknr < 0) {
-			ext_cache_fini(&cache);
-			return -1;
-		}
+		if (blknr < 0)
+			goto out;
 
 		blknr = blknr << log2_fs_blocksize;
 
@@ -109,21 +109,16 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 			blockend -= skipfirst;
 		}
 		if (blknr) {
-			int status;
-
 			if (previous_block_number != -1) {
 				if (delayed_next == blknr) {
 					delayed_extent += blockend;
 					delayed_next += blockend >> log2blksz;
 				} else {	/* spill */
-					status = ext4fs_devread(delayed_start,
-							delayed_skipfirst,
-							delayed_extent,
-							delayed_buf);
-					if (status == 0) {
-						ext_cache_fini(&cache);
-						return -1;
-					}
+					if (fs_io_add(&io, delayed_start,
+						      delayed_skipfirst,
+						      delayed_extent,
+						      delayed_buf))
+						goto out;
 					previous_block_number = blknr;
 					delayed_start = blknr;
 					delayed_extent = blockend;
@@ -146,14 +141,10 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 			int n_left;
 			if (previous_block_number != -1) {
 				/* spill */
-				status = ext4fs_devread(delayed_start,
-							delayed_skipfirst,
-							delayed_extent,
-							delayed_buf);
-				if (status == 0) {
-					ext_cache_fini(&cache);
-					return -1;
-				}
+				if (fs_io_add(&io, delayed_start,
+					      delayed_skipfirst, delayed_extent,
+					      delayed_buf))
+					goto out;
 				previous_block_number = -1;
 			}
 			/* Zero no more than `len' bytes. */
@@ -167,19 +158,20 @@ int ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 	}
 	if (previous_block_number != -1) {
 		/* spill */
-		status = ext4fs_devread(delayed_start,
-					delayed_skipfirst, delayed_extent,
-					delayed_buf);
-		if (status == 0) {
-			ext_cache_fini(&cache);
-			return -1;
-		}
+		if (fs_io_add(&io, delayed_start, delayed_skipfirst,
+			      delayed_extent, delayed_buf))
+			goto out;
 		previous_block_number = -1;
 	}
+	if (fs_io_submit(&io))
+		goto out;
 
 	*actread  = len;
+	ret = 0;
+out:
+	fs_io_uninit(&io);
 	ext_cache_fini(&cache);
-	return 0;
+	return ret;
 }
 
 int ext4fs_ls(const char *dirname)
@@ -15,6 +15,7 @@
 #include <exports.h>
 #include <fat.h>
 #include <fs.h>
+#include <fs_io.h>
 #include <log.h>
 #include <asm/byteorder.h>
 #include <asm/unaligned.h>
@@ -308,6 +309,34 @@ get_cluster(fsdata *mydata, __u32 clustnum, __u8 *buffer, unsigned long size)
 	return 0;
 }
 
+/*
+ * Queue a read of at most 'size' bytes from the specified cluster, to be read
+ * by fs_io_submit(). Misaligned buffers are read straight away, since they
+ * need a bounce buffer.
+ * Return 0 on success, -1 otherwise.
+ */
+static int queue_cluster(fsdata *mydata, struct fs_io *io, __u32 clustnum,
+			 __u8 *buffer, unsigned long size)
+{
+	__u32 startsect;
+
+	if (!CONFIG_IS_ENABLED(FS_IO) ||
+	    ((unsigned long)buffer & (ARCH_DMA_MINALIGN - 1)))
+		return get_cluster(mydata, clustnum, buffer, size);
+
+	if (clustnum > 0)
+		startsect = clust_to_sect(mydata, clustnum);
+	else
+		startsect = mydata->rootdir_sect;
+
+	if (fs_io_add(io, startsect, 0, size, buffer)) {
+		debug("Error reading data\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 /**
  * get_contents() - read from file
  *
@@ -330,7 +359,9 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
 	__u32 curclust = START(dentptr);
 	__u32 endclust, newclust;
+	struct fs_io io;
 	loff_t actsize;
+	int ret = -1;
 
 	*gotsize = 0;
 	debug("Filesize: %llu bytes\n", filesize);
@@ -398,6 +429,7 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 
 	actsize = bytesperclust;
 	endclust = curclust;
+	fs_io_init(&io, cur_dev, &cur_part_info);
 
 	do {
 		/* search for consecutive clusters */
@@ -408,7 +440,7 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 			if (CHECK_CLUST(newclust, mydata->fatsize)) {
 				debug("curclust: 0x%x\n", newclust);
 				printf("Invalid FAT entry\n");
-				return -1;
+				goto out;
 			}
 			endclust = newclust;
 			actsize += bytesperclust;
@@ -416,16 +448,18 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 
 		/* get remaining bytes */
 		actsize = filesize;
-		if (get_cluster(mydata, curclust, buffer, (int)actsize) != 0) {
+		if (queue_cluster(mydata, &io, curclust, buffer,
+				  (int)actsize) != 0) {
 			printf("Error reading cluster\n");
-			return -1;
+			goto out;
 		}
 		*gotsize += actsize;
-		return 0;
+		break;
 getit:
-		if (get_cluster(mydata, curclust, buffer, (int)actsize) != 0) {
+		if (queue_cluster(mydata, &io, curclust, buffer,
+				  (int)actsize) != 0) {
 			printf("Error reading cluster\n");
-			return -1;
+			goto out;
 		}
 		*gotsize += (int)actsize;
 		filesize -= actsize;
@@ -435,11 +469,21 @@ getit:
 		if (CHECK_CLUST(curclust, mydata->fatsize)) {
 			debug("curclust: 0x%x\n", curclust);
 			printf("Invalid FAT entry\n");
-			return -1;
+			goto out;
 		}
 		actsize = bytesperclust;
 		endclust = curclust;
 	} while (1);
+
+	if (fs_io_submit(&io)) {
+		printf("Error reading cluster\n");
+		goto out;
+	}
+	ret = 0;
+out:
+	fs_io_uninit(&io);
+
+	return ret;
 }
 
 /*
@@ -18,6 +18,7 @@
 #include <ext4fs.h>
 #include <fat.h>
 #include <fs.h>
+#include <fs_io.h>
 #include <sandboxfs.h>
 #include <semihostingfs.h>
 #include <time.h>
@@ -579,7 +580,9 @@ static int _fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 	 * means read the whole file.
 	 */
 	buf = map_sysmem(addr, len);
+	fs_io_readahead_start();
 	ret = info->read(filename, buf, offset, len, actread);
+	fs_io_readahead_stop();
 	unmap_sysmem(buf);
 
 	/* If we requested a specific number of bytes, check we got it */
@@ -738,10 +741,17 @@ int do_load(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[],
 	loff_t bytes;
 	loff_t pos;
 	loff_t len_read;
+	struct fs_io_stats stats;
 	int ret;
 	unsigned long time;
+	bool verbose = false;
 	char *ep;
 
+	if (argc > 1 && !strcmp(argv[1], "-v")) {
+		verbose = true;
+		argc--;
+		argv++;
+	}
 	if (argc < 2)
 		return CMD_RET_USAGE;
 	if (argc > 7)
@@ -781,6 +791,8 @@ int do_load(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[],
 	else
 		pos = 0;
 
+	if (verbose)
+		fs_io_stats(&stats);
 	time = get_timer(0);
 	ret = _fs_read(filename, addr, pos, bytes, 1, &len_read);
 	time = get_timer(time);
@@ -800,6 +812,16 @@ int do_load(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[],
 		puts(")");
 	}
 	puts("\n");
+	if (verbose) {
+		fs_io_stats(&stats);
+		printf("requests %lu, merged %lu, reads %lu, bytes %llu",
+		       stats.requests, stats.merged, stats.reads, stats.bytes);
+		if (time > 0)
+			printf(", %llu MB/s",
+			       (div_u64(stats.bytes, time) * 1000) >> 20);
+		printf("\nread-ahead hits %lu, fills %lu\n", stats.ra_hits,
+		       stats.ra_fills);
+	}
 
 	env_set_hex("fileaddr", addr);
 	env_set_hex("filesize", len_read);
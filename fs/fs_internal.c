@@ -9,6 +9,7 @@
 
 #include <blk.h>
 #include <compiler.h>
+#include <fs_io.h>
 #include <log.h>
 #include <part.h>
 #include <memalign.h>
@@ -38,6 +39,10 @@ int fs_devread(struct blk_desc *blk, struct disk_partition *partition,
 
 	log_debug(" <" LBAFU ", %d, %d>\n", sector, byte_offset, byte_len);
 
+	if (fs_io_read_cached(blk, partition, sector, byte_offset, byte_len,
+			      buf))
+		return 1;
+
 	if (byte_offset != 0) {
 		int readlen;
 		/* read first part which isn't aligned with start of sector */
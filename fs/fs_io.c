@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Batched reads and read-ahead for filesystems
+ *
+ * See include/fs_io.h for an overview. Queued reads are sorted by their
+ * position in the partition. Each run of reads which follow on from each other
+ * is read with one call to fs_devread(): straight into the buffer if the
+ * buffers follow on from each other too, otherwise into a bounce buffer which
+ * is then copied out.
+ */
+
+#define LOG_CATEGORY LOGC_CORE
+
+#include <alist.h>
+#include <blk.h>
+#include <fs_io.h>
+#include <log.h>
+#include <malloc.h>
+#include <memalign.h>
+#include <part.h>
+#include <sort.h>
+#include <linux/kernel.h>
+#include <linux/sizes.h>
+
+/* Number of reads which can be queued before they are submitted */
+#define FS_IO_MAX_REQS		256
+
+/* Largest run read through a bounce buffer */
+#define FS_IO_BOUNCE_MAX	SZ_1M
+
+/* Largest run read at once (fs_devread() takes an int) */
+#define FS_IO_RUN_MAX		SZ_1G
+
+/**
+ * struct fs_io_window - Read-ahead window
+ *
+ * @active: true while a file is being read
+ * @desc: Block device the window holds data for
+ * @start: First sector held, counting from the start of the device
+ * @count: Number of sectors held, 0 if none
+ * @size: Size of the window in bytes
+ * @buf: Data in the window, or NULL if not allocated yet
+ */
+struct fs_io_window {
+	bool active;
+	struct blk_desc *desc;
+	lbaint_t start;
+	lbaint_t count;
+	ulong size;
+	char *buf;
+};
+
+static struct fs_io_window window = {
+	.size = CONFIG_FS_IO_READAHEAD,
+};
+
+static struct fs_io_stats _stats;
+
+void fs_io_init(struct fs_io *io, struct blk_desc *desc,
+		struct disk_partition *part)
+{
+	io->desc = desc;
+	io->part = part;
+	alist_init_struct(&io->reqs, struct fs_io_req);
+}
+
+int fs_io_add(struct fs_io *io, lbaint_t sector, int byte_offset,
+	      ulong byte_len, void *buf)
+{
+	struct fs_io_req req;
+	int ret;
+
+	if (!byte_len)
+		return 0;
+	if (io->reqs.count == FS_IO_MAX_REQS) {
+		ret = fs_io_submit(io);
+		if (ret)
+			return ret;
+	}
+
+	req.pos = ((u64)sector << io->desc->log2blksz) + byte_offset;
+	req.len = byte_len;
+	req.buf = buf;
+	if (!alist_add(&io->reqs, req))
+		return -ENOMEM;
+	_stats.requests++;
+
+	return 0;
+}
+
+static int fs_io_req_cmp(const void *a, const void *b)
+{
+	const struct fs_io_req *ra = a, *rb = b;
+
+	if (ra->pos != rb->pos)
+		return ra->pos < rb->pos ? -1 : 1;
+
+	return 0;
+}
+
+static int fs_io_devread(struct fs_io *io, u64 pos, ulong len, void *buf)
+{
+	struct blk_desc *desc = io->desc;
+
+	_stats.reads++;
+	_stats.bytes += len;
+	if (!fs_devread(desc, io->part, pos >> desc->log2blksz,
+			pos & (desc->blksz - 1), len, buf))
+		return -EIO;
+
+	return 0;
+}
+
+/* Read a run of @count reads, each following on from the one before */
+static int fs_io_read_run(struct fs_io *io, struct fs_io_req *req, int count,
+			  ulong len, bool contig)
+{
+	char *bounce;
+	ulong done;
+	int i, ret;
+
+	if (contig || count == 1)
+		return fs_io_devread(io, req->pos, len, req->buf);
+
+	bounce = malloc_cache_aligned(len);
+	if (!bounce) {
+		/* Read them one at a time instead */
+		for (i = 0; i < count; i++) {
+			ret = fs_io_devread(io, req[i].pos, req[i].len,
+					    req[i].buf);
+			if (ret)
+				return ret;
+		}
+		return 0;
+	}
+
+	ret = fs_io_devread(io, req->pos, len, bounce);
+	if (!ret) {
+		for (i = 0, done = 0; i < count; done += req[i].len, i++)
+			memcpy(req[i].buf, bounce + done, req[i].len);
+	}
+	free(bounce);
+
+	return ret;
+}
+
+int fs_io_submit(struct fs_io *io)
+{
+	struct fs_io_req *reqs, *req, *prev;
+	int count, i, j, ret = 0;
+	bool contig;
+	ulong len;
+
+	count = io->reqs.count;
+	if (!count)
+		return 0;
+	reqs = alist_getw(&io->reqs, 0, struct fs_io_req);
+	qsort(reqs, count, sizeof(*reqs), fs_io_req_cmp);
+
+	for (i = 0; i < count; i = j) {
+		len = reqs[i].len;
+		contig = true;
+		for (j = i + 1; j < count; j++) {
+			prev = &reqs[j - 1];
+			req = &reqs[j];
+			if (req->pos != prev->pos + prev->len ||
+			    len + req->len > FS_IO_RUN_MAX)
+				break;
+			if (req->buf != prev->buf + prev->len) {
+				if (len + req->len > FS_IO_BOUNCE_MAX)
+					break;
+				contig = false;
+			}
+			len += req->len;
+		}
+		_stats.merged += j - i - 1;
+		ret = fs_io_read_run(io, &reqs[i], j - i, len, contig);
+		if (ret)
+			break;
+	}
+	io->reqs.count = 0;
+
+	return ret;
+}
+
+void fs_io_uninit(struct fs_io *io)
+{
+	alist_uninit(&io->reqs);
+}
+
+void fs_io_readahead_start(void)
+{
+	window.active = true;
+}
+
+void fs_io_readahead_stop(void)
+{
+	window.active = false;
+	window.count = 0;
+}
+
+ulong fs_io_set_readahead(ulong size)
+{
+	ulong old = window.size;
+
+	window.size = size;
+	window.count = 0;
+	free(window.buf);
+	window.buf = NULL;
+
+	return old;
+}
+
+bool fs_io_read_cached(struct blk_desc *blk, struct disk_partition *part,
+		       lbaint_t sector, int byte_offset, int byte_len,
+		       char *buf)
+{
+	lbaint_t start, count, num;
+
+	/* Large reads go straight to the device */
+	if (!window.active || byte_len > window.size / 2)
+		return false;
+
+	start = part->start + sector;
+	count = DIV_ROUND_UP(byte_offset + byte_len, blk->blksz);
+	if (window.desc != blk || start < window.start ||
+	    start + count > window.start + window.count) {
+		num = min_t(lbaint_t, window.size >> blk->log2blksz,
+			    part->size - sector);
+		if (num < count)
+			return false;
+		if (!window.buf) {
+			window.buf = malloc_cache_aligned(window.size);
+			if (!window.buf)
+				return false;
+		}
+		window.count = 0;
+		if (blk_dread(blk, start, num, window.buf) != num) {
+			log_debug("Read-ahead failed at " LBAFU "\n", start);
+			return false;
+		}
+		window.desc = blk;
+		window.start = start;
+		window.count = num;
+		_stats.ra_fills++;
+	} else {
+		_stats.ra_hits++;
+	}
+	memcpy(buf, window.buf + ((start - window.start) << blk->log2blksz) +
+	       byte_offset, byte_len);
+
+	return true;
+}
+
+void fs_io_stats(struct fs_io_stats *stats)
+{
+	*stats = _stats;
+	memset(&_stats, '\0', sizeof(_stats));
+}
@@ -92,13 +92,13 @@
  * - implemented fragment sorting to ensure that the newest data is copied
  *   if there are multiple copies of fragments for a certain file offset.
  *
- * The fragment sorting feature must be enabled by CONFIG_SYS_JFFS2_SORT_FRAGMENTS.
- * Sorting is done while adding fragments to the lists, which is more or less a
- * bubble sort. This takes a lot of time, and is most probably not an issue if
- * the boot filesystem is always mounted readonly.
- *
- * You should define it if the boot filesystem is mounted writable, and updates
- * to the boot files are done by copying files to that filesystem.
+ * After the scan, each list gets an index: an array of its nodes sorted by
+ * inode number (or parent inode and name hash, for directory entries) and then
+ * by version. Lookups use a binary search on the index rather than walking the
+ * whole list, and the fragments of a file are copied oldest first, so the
+ * newest data wins if the filesystem was written to after it was created.
+ * The lists and their indices are kept until jffs2_1pass_rescan_needed() finds
+ * that the partition has changed.
  *
  *
  * There's a big issue left: endianess is completely ignored in this code. Duh!
@@ -113,6 +113,7 @@
 #include <config.h>
 #include <malloc.h>
 #include <div64.h>
+#include <sort.h>
 #include <linux/compiler.h>
 #include <linux/stat.h>
 #include <linux/time.h>
@@ -567,7 +568,7 @@ insert_node(struct b_list *list)
 		putstr("add_node failed!\r\n");
 		return NULL;
 	}
-	new->next = NULL;
+	memset(new, '\0', sizeof(*new));
 
 	if (list->listTail != NULL)
 		list->listTail->next = new;
@@ -578,64 +579,6 @@ insert_node(struct b_list *list)
 	return new;
 }
 
-#ifdef CONFIG_SYS_JFFS2_SORT_FRAGMENTS
-/* Sort data entries with the latest version last, so that if there
- * is overlapping data the latest version will be used.
- */
-static int compare_inodes(struct b_node *new, struct b_node *old)
-{
-	return new->version > old->version;
-}
-
-/* Sort directory entries so all entries in the same directory
- * with the same name are grouped together, with the latest version
- * last. This makes it easy to eliminate all but the latest version
- * by marking the previous version dead by setting the inode to 0.
- */
-static int compare_dirents(struct b_node *new, struct b_node *old)
-{
-	/*
-	 * Using NULL as the buffer for NOR flash prevents the entire node
-	 * being read. This makes most comparisons much quicker as only one
-	 * or two entries from the node will be used most of the time.
-	 */
-	struct jffs2_raw_dirent *jNew = get_node_mem(new->offset, NULL);
-	struct jffs2_raw_dirent *jOld = get_node_mem(old->offset, NULL);
-	int cmp;
-	int ret;
-
-	if (jNew->pino != jOld->pino) {
-		/* ascending sort by pino */
-		ret = jNew->pino > jOld->pino;
-	} else if (jNew->nsize != jOld->nsize) {
-		/*
-		 * pino is the same, so use ascending sort by nsize,
-		 * so we don't do strncmp unless we really must.
-		 */
-		ret = jNew->nsize > jOld->nsize;
-	} else {
-		/*
-		 * length is also the same, so use ascending sort by name
-		 */
-		cmp = strncmp((char *)jNew->name, (char *)jOld->name,
-			jNew->nsize);
-		if (cmp != 0) {
-			ret = cmp > 0;
-		} else {
-			/*
-			 * we have duplicate names in this directory,
-			 * so use ascending sort by version
-			 */
-			ret = jNew->version > jOld->version;
-		}
-	}
-	put_fl_mem(jNew, NULL);
-	put_fl_mem(jOld, NULL);
-
-	return ret;
-}
-#endif
-
 void
 jffs2_free_cache(struct part_info *part)
 {
@@ -645,8 +588,11 @@ jffs2_free_cache(struct part_info *part)
 		pL = (struct b_lists *)part->jffs2_priv;
 		free_nodes(&pL->frag);
 		free_nodes(&pL->dir);
+		free(pL->frag.listIndex);
+		free(pL->dir.listIndex);
 		free(pL->readbuf);
 		free(pL);
+		part->jffs2_priv = NULL;
 	}
 }
 
@@ -661,14 +607,118 @@ jffs_init_1pass_list(struct part_info *part)
 		pL = (struct b_lists *)part->jffs2_priv;
 
 		memset(pL, 0, sizeof(*pL));
-#ifdef CONFIG_SYS_JFFS2_SORT_FRAGMENTS
-		pL->dir.listCompare = compare_dirents;
-		pL->frag.listCompare = compare_inodes;
-#endif
 	}
 	return 0;
 }
 
+/* Hash a directory-entry name, so that lookups need not read it from flash */
+static u32
+jffs2_name_hash(const u8 *name, int len)
+{
+	u32 hash = 0;
+
+	while (len--)
+		hash = hash * 31 + *name++;
+
+	return hash;
+}
+
+/* Order nodes by inode (or parent), then name hash, version and offset */
+static int
+compare_nodes(const void *a, const void *b)
+{
+	const struct b_node *n1 = *(const struct b_node **)a;
+	const struct b_node *n2 = *(const struct b_node **)b;
+
+	if (n1->ino != n2->ino)
+		return n1->ino < n2->ino ? -1 : 1;
+	if (n1->hash != n2->hash)
+		return n1->hash < n2->hash ? -1 : 1;
+	if (n1->version != n2->version)
+		return n1->version < n2->version ? -1 : 1;
+	if (n1->offset != n2->offset)
+		return n1->offset < n2->offset ? -1 : 1;
+
+	return 0;
+}
+
+/* Build the sorted index of a list, once all its nodes have been added */
+static int
+jffs2_1pass_index_list(struct b_list *list)
+{
+	struct b_node *b;
+	u32 i = 0;
+
+	free(list->listIndex);
+	list->listIndex = NULL;
+	if (!list->listCount)
+		return 0;
+
+	list->listIndex = malloc(list->listCount * sizeof(*list->listIndex));
+	if (!list->listIndex) {
+		putstr("index_list: malloc failed\n");
+		return -ENOMEM;
+	}
+	for (b = list->listHead; b; b = b->next)
+		list->listIndex[i++] = b;
+	qsort(list->listIndex, list->listCount, sizeof(*list->listIndex),
+	      compare_nodes);
+
+	return 0;
+}
+
+/*
+ * Find the position of the first node in a list's index with the given inode
+ * (or parent) and hash, or the position where it would be if there is none
+ */
+static u32
+jffs2_1pass_index_find(struct b_list *list, u32 ino, u32 hash)
+{
+	u32 low = 0, high = list->listCount;
+
+	while (low < high) {
+		u32 mid = low + (high - low) / 2;
+		struct b_node *b = list->listIndex[mid];
+
+		if (b->ino < ino || (b->ino == ino && b->hash < hash))
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+/* Find the range of fragments of an inode, oldest first; returns the count */
+static u32
+jffs2_1pass_find_frags(struct b_lists *pL, u32 inode, u32 *firstp)
+{
+	struct b_list *list = &pL->frag;
+	u32 first, i;
+
+	first = jffs2_1pass_index_find(list, inode, 0);
+	for (i = first; i < list->listCount; i++) {
+		if (list->listIndex[i]->ino != inode)
+			break;
+	}
+	*firstp = first;
+
+	return i - first;
+}
+
+/* Get the newest fragment of an inode, which has its current attributes */
+static struct b_node *
+jffs2_1pass_latest_frag(struct b_lists *pL, u32 inode)
+{
+	u32 first, count;
+
+	count = jffs2_1pass_find_frags(pL, inode, &first);
+	if (!count)
+		return NULL;
+
+	return pL->frag.listIndex[first + count - 1];
+}
+
 /* find the inode from the slashless name given a parent */
 static long
 jffs2_1pass_read_inode(struct b_lists *pL, u32 inode, char *dest)
@@ -676,11 +726,10 @@ jffs2_1pass_read_inode(struct b_lists *pL, u32 inode, char *dest)
 	struct b_node *b;
 	struct jffs2_raw_inode *jNode;
 	u32 totalSize = 0;
-	u32 latestVersion = 0;
+	u32 first, count;
 	uchar *lDest;
 	uchar *src;
-	int i;
-	u32 counter = 0;
+	u32 i, j;
 
 	/* Find file size before loading any data, so fragments that
 	 * start past the end of file can be ignored. A fragment
@@ -689,19 +738,11 @@ jffs2_1pass_read_inode(struct b_lists *pL, u32 inode, char *dest)
 	 * This shouldn't cause trouble when loading kernel images, so
 	 * we will live with it.
 	 */
-	int latestOffset = -1;
-	for (b = pL->frag.listHead; b != NULL; b = b->next) {
-		if (inode == b->ino) {
-			/* get actual file length from the newest node */
-			if (b->version >= latestVersion) {
-				latestVersion = b->version;
-				latestOffset = b->offset;
-			}
-		}
-	}
-
-	if (latestOffset >= 0) {
-		jNode = (struct jffs2_raw_inode *)get_fl_mem(latestOffset,
+	count = jffs2_1pass_find_frags(pL, inode, &first);
+	if (count) {
+		/* get actual file length from the newest node */
+		b = pL->frag.listIndex[first + count - 1];
+		jNode = (struct jffs2_raw_inode *)get_fl_mem(b->offset,
 			sizeof(struct jffs2_raw_inode), pL->readbuf);
 		totalSize = jNode->isize;
 		put_fl_mem(jNode, pL->readbuf);
@@ -714,99 +755,57 @@ jffs2_1pass_read_inode(struct b_lists *pL, u32 inode, char *dest)
 	if (!dest)
 		return totalSize;
 
-	for (b = pL->frag.listHead; b != NULL; b = b->next) {
-		if (inode == b->ino) {
-			/*
-			 * Copy just the node and not the data at this point,
-			 * since we don't yet know if we need this data.
-			 */
-			jNode = (struct jffs2_raw_inode *)get_fl_mem(b->offset,
-					sizeof(struct jffs2_raw_inode),
-					pL->readbuf);
-#if 0
-			putLabeledWord("\r\n\r\nread_inode: totlen = ", jNode->totlen);
-			putLabeledWord("read_inode: inode = ", jNode->ino);
-			putLabeledWord("read_inode: version = ", jNode->version);
-			putLabeledWord("read_inode: isize = ", jNode->isize);
-			putLabeledWord("read_inode: offset = ", jNode->offset);
-			putLabeledWord("read_inode: csize = ", jNode->csize);
-			putLabeledWord("read_inode: dsize = ", jNode->dsize);
-			putLabeledWord("read_inode: compr = ", jNode->compr);
-			putLabeledWord("read_inode: usercompr = ", jNode->usercompr);
-			putLabeledWord("read_inode: flags = ", jNode->flags);
-#endif
-
-			if(dest) {
-				/*
-				 * Now that the inode has been checked,
-				 * read the entire inode, including data.
-				 */
-				put_fl_mem(jNode, pL->readbuf);
-				jNode = (struct jffs2_raw_inode *)
-					get_node_mem(b->offset, pL->readbuf);
-				src = ((uchar *)jNode) +
-					sizeof(struct jffs2_raw_inode);
-				/* ignore data behind latest known EOF */
-				if (jNode->offset > totalSize) {
-					put_fl_mem(jNode, pL->readbuf);
-					continue;
-				}
-				if (b->datacrc == CRC_UNKNOWN)
-					b->datacrc = data_crc(jNode) ?
-						CRC_OK : CRC_BAD;
-				if (b->datacrc == CRC_BAD) {
-					put_fl_mem(jNode, pL->readbuf);
-					continue;
-				}
+	/* Copy the oldest fragments first, so newer data replaces them */
+	for (i = first; i < first + count; i++) {
+		b = pL->frag.listIndex[i];
+		jNode = (struct jffs2_raw_inode *)get_node_mem(b->offset,
+							       pL->readbuf);
+		src = ((uchar *)jNode) + sizeof(struct jffs2_raw_inode);
+		/* ignore data behind latest known EOF */
+		if (jNode->offset > totalSize) {
+			put_fl_mem(jNode, pL->readbuf);
+			continue;
+		}
+		if (b->datacrc == CRC_UNKNOWN)
+			b->datacrc = data_crc(jNode) ? CRC_OK : CRC_BAD;
+		if (b->datacrc == CRC_BAD) {
+			put_fl_mem(jNode, pL->readbuf);
+			continue;
+		}
 
-				lDest = (uchar *) (dest + jNode->offset);
-#if 0
-				putLabeledWord("read_inode: src = ", src);
-				putLabeledWord("read_inode: dest = ", lDest);
-#endif
-				switch (jNode->compr) {
-				case JFFS2_COMPR_NONE:
-					ldr_memcpy(lDest, src, jNode->dsize);
-					break;
-				case JFFS2_COMPR_ZERO:
-					for (i = 0; i < jNode->dsize; i++)
-						*(lDest++) = 0;
-					break;
-				case JFFS2_COMPR_RTIME:
-					rtime_decompress(src, lDest, jNode->csize, jNode->dsize);
-					break;
-				case JFFS2_COMPR_DYNRUBIN:
-					/* this is slow but it works */
-					dynrubin_decompress(src, lDest, jNode->csize, jNode->dsize);
-					break;
-				case JFFS2_COMPR_ZLIB:
-					zlib_decompress(src, lDest, jNode->csize, jNode->dsize);
-					break;
+		lDest = (uchar *) (dest + jNode->offset);
+		switch (jNode->compr) {
+		case JFFS2_COMPR_NONE:
+			ldr_memcpy(lDest, src, jNode->dsize);
+			break;
+		case JFFS2_COMPR_ZERO:
+			for (j = 0; j < jNode->dsize; j++)
+				*(lDest++) = 0;
+			break;
+		case JFFS2_COMPR_RTIME:
+			rtime_decompress(src, lDest, jNode->csize, jNode->dsize);
+			break;
+		case JFFS2_COMPR_DYNRUBIN:
+			/* this is slow but it works */
+			dynrubin_decompress(src, lDest, jNode->csize, jNode->dsize);
+			break;
+		case JFFS2_COMPR_ZLIB:
+			zlib_decompress(src, lDest, jNode->csize, jNode->dsize);
+			break;
 #if defined(CONFIG_JFFS2_LZO)
-				case JFFS2_COMPR_LZO:
-					lzo_decompress(src, lDest, jNode->csize, jNode->dsize);
-					break;
-#endif
-				default:
-					/* unknown */
-					putLabeledWord("UNKNOWN COMPRESSION METHOD = ", jNode->compr);
-					put_fl_mem(jNode, pL->readbuf);
-					return -1;
-					break;
-				}
-			}
-
-#if 0
-			putLabeledWord("read_inode: totalSize = ", totalSize);
+		case JFFS2_COMPR_LZO:
+			lzo_decompress(src, lDest, jNode->csize, jNode->dsize);
+			break;
 #endif
+		default:
+			/* unknown */
+			putLabeledWord("UNKNOWN COMPRESSION METHOD = ", jNode->compr);
 			put_fl_mem(jNode, pL->readbuf);
+			return -1;
 		}
-		counter++;
+		put_fl_mem(jNode, pL->readbuf);
 	}
 
-#if 0
-	putLabeledWord("read_inode: returning = ", totalSize);
-#endif
 	return totalSize;
 }
 
@@ -814,28 +813,32 @@ jffs2_1pass_read_inode(struct b_lists *pL, u32 inode, char *dest)
 static u32
 jffs2_1pass_find_inode(struct b_lists * pL, const char *name, u32 pino)
 {
+	struct b_list *list = &pL->dir;
 	struct b_node *b;
 	struct jffs2_raw_dirent *jDir;
 	int len;
-	u32 counter;
+	u32 hash;
+	u32 i;
 	u32 version = 0;
 	u32 inode = 0;
 
 	/* name is assumed slash free */
 	len = strlen(name);
+	hash = jffs2_name_hash((const u8 *)name, len);
 
-	counter = 0;
-	/* we need to search all and return the inode with the highest version */
-	for(b = pL->dir.listHead; b; b = b->next, counter++) {
+	/*
+	 * Entries with this parent and hash are together in the index, oldest
+	 * first, so the last match is the one to use
+	 */
+	for (i = jffs2_1pass_index_find(list, pino, hash); i < list->listCount;
+	     i++) {
+		b = list->listIndex[i];
+		if (b->pino != pino || b->hash != hash)
+			break;
 		jDir = (struct jffs2_raw_dirent *) get_node_mem(b->offset,
 								pL->readbuf);
-		if ((pino == jDir->pino) && (len == jDir->nsize) &&
+		if ((len == jDir->nsize) &&
 		    (!strncmp((char *)jDir->name, name, len))) {	/* a match */
-			if (jDir->version < version) {
-				put_fl_mem(jDir, pL->readbuf);
-				continue;
-			}
-
 			if (jDir->version == version && inode != 0) {
 				/* I'm pretty sure this isn't legal */
 				putstr(" ** ERROR ** ");
@@ -845,15 +848,6 @@ jffs2_1pass_find_inode(struct b_lists * pL, const char *name, u32 pino)
 			inode = jDir->ino;
 			version = jDir->version;
 		}
-#if 0
-		putstr("\r\nfind_inode:p&l ->");
-		putnstr(jDir->name, jDir->nsize);
-		putstr("\r\n");
-		putLabeledWord("pino = ", jDir->pino);
-		putLabeledWord("nsize = ", jDir->nsize);
-		putLabeledWord("b = ", (u32) b);
-		putLabeledWord("counter = ", counter);
-#endif
 		put_fl_mem(jDir, pL->readbuf);
 	}
 	return inode;
@@ -940,80 +934,97 @@ static inline u32 dump_inode(struct b_lists * pL, struct jffs2_raw_dirent *d, st
 	return 0;
 }
 
+/*
+ * Check whether a newer directory entry with the same parent and name follows
+ * entry @i in the index, i.e. whether entry @i has been replaced
+ */
+static int
+jffs2_1pass_dirent_replaced(struct b_lists *pL, u32 i)
+{
+	struct b_list *list = &pL->dir;
+	struct b_node *b = list->listIndex[i];
+	struct jffs2_raw_dirent *jDir = NULL;
+	struct jffs2_raw_dirent *jDirNext;
+	int match = 0;
+
+	/*
+	 * Using NULL as the buffer for NOR flash prevents the entire node
+	 * being read, and there is usually no other entry with the same hash
+	 */
+	while (!match && ++i < list->listCount) {
+		struct b_node *next = list->listIndex[i];
+
+		if (next->pino != b->pino || next->hash != b->hash)
+			break;
+		if (!jDir)
+			jDir = get_node_mem(b->offset, NULL);
+		jDirNext = get_node_mem(next->offset, NULL);
+		match = jDirNext->nsize == jDir->nsize &&
+			strncmp((char *)jDirNext->name, (char *)jDir->name,
+				jDir->nsize) == 0;
+		put_fl_mem(jDirNext, NULL);
+	}
+	if (jDir)
+		put_fl_mem(jDir, NULL);
+
+	return match;
+}
+
 /* list inodes with the given pino */
 static u32
 jffs2_1pass_list_inodes(struct b_lists * pL, u32 pino)
 {
+	struct b_list *list = &pL->dir;
 	struct b_node *b;
 	struct jffs2_raw_dirent *jDir;
+	u32 i;
 
-	for (b = pL->dir.listHead; b; b = b->next) {
-		if (pino == b->pino) {
-			u32 i_version = 0;
-			int i_offset = -1;
-			struct jffs2_raw_inode *jNode = NULL;
-			struct b_node *b2;
-
-			jDir = (struct jffs2_raw_dirent *)
-				get_node_mem(b->offset, pL->readbuf);
-#ifdef CONFIG_SYS_JFFS2_SORT_FRAGMENTS
-			/* Check for more recent versions of this file */
-			int match;
-			do {
-				struct b_node *next = b->next;
-				struct jffs2_raw_dirent *jDirNext;
-				if (!next)
-					break;
-				jDirNext = (struct jffs2_raw_dirent *)
-					get_node_mem(next->offset, NULL);
-				match = jDirNext->pino == jDir->pino &&
-					jDirNext->nsize == jDir->nsize &&
-					strncmp((char *)jDirNext->name,
-						(char *)jDir->name,
-						jDir->nsize) == 0;
-				if (match) {
-					/* Use next. It is more recent */
-					b = next;
-					/* Update buffer with the new info */
-					*jDir = *jDirNext;
-				}
-				put_fl_mem(jDirNext, NULL);
-			} while (match);
-#endif
-			if (jDir->ino == 0) {
-				/* Deleted file */
-				put_fl_mem(jDir, pL->readbuf);
-				continue;
-			}
-
-			for (b2 = pL->frag.listHead; b2; b2 = b2->next) {
-				if (b2->ino == jDir->ino &&
-				    b2->version >= i_version) {
-					i_version = b2->version;
-					i_offset = b2->offset;
-				}
-			}
+	for (i = jffs2_1pass_index_find(list, pino, 0); i < list->listCount;
+	     i++) {
+		struct jffs2_raw_inode *jNode = NULL;
+		struct b_node *b2;
 
-			if (i_version >= 0) {
-				if (jDir->type == DT_LNK)
-					jNode = get_node_mem(i_offset, NULL);
-				else
-					jNode = get_fl_mem(i_offset,
-							   sizeof(*jNode),
-							   NULL);
-			}
+		b = list->listIndex[i];
+		if (b->pino != pino)
+			break;
 
-			dump_inode(pL, jDir, jNode);
-			put_fl_mem(jNode, NULL);
+		/* Skip entries which have a more recent version */
+		if (jffs2_1pass_dirent_replaced(pL, i))
+			continue;
 
+		jDir = (struct jffs2_raw_dirent *)
+			get_node_mem(b->offset, pL->readbuf);
+		if (jDir->ino == 0) {
+			/* Deleted file */
 			put_fl_mem(jDir, pL->readbuf);
+			continue;
+		}
+
+		b2 = jffs2_1pass_latest_frag(pL, jDir->ino);
+		if (b2) {
+			if (jDir->type == DT_LNK)
+				jNode = get_node_mem(b2->offset, NULL);
+			else
+				jNode = get_fl_mem(b2->offset, sizeof(*jNode),
+						   NULL);
 		}
+
+		dump_inode(pL, jDir, jNode);
+		if (jNode)
+			put_fl_mem(jNode, NULL);
+
+		put_fl_mem(jDir, pL->readbuf);
 	}
 	return pino;
 }
 
+/*
+ * find the inode from a path given a parent, optionally returning the inode
+ * of the directory which holds it in @parentp
+ */
 static u32
-jffs2_1pass_search_inode(struct b_lists * pL, const char *fname, u32 pino)
+jffs2_1pass_search_inode(struct b_lists * pL, const char *fname, u32 pino,
+			 u32 *parentp)
 {
 	int i;
 	char tmp[256];
@@ -1030,25 +1041,9 @@ jffs2_1pass_search_inode(struct b_lists * pL, const char *fname, u32 pino)
 	{
 		strncpy(working_tmp, tmp, c - tmp);
 		working_tmp[c - tmp] = '\0';
-#if 0
-		putstr("search_inode: tmp = ");
-		putstr(tmp);
-		putstr("\r\n");
-		putstr("search_inode: wtmp = ");
-		putstr(working_tmp);
-		putstr("\r\n");
-		putstr("search_inode: c = ");
-		putstr(c);
-		putstr("\r\n");
-#endif
 		for (i = 0; i < strlen(c) - 1; i++)
 			tmp[i] = c[i + 1];
 		tmp[i] = '\0';
-#if 0
-		putstr("search_inode: post tmp = ");
-		putstr(tmp);
-		putstr("\r\n");
-#endif
 
 		if (!(pino = jffs2_1pass_find_inode(pL, working_tmp, pino))) {
 			putstr("find_inode failed for name=");
@@ -1057,6 +1052,8 @@ jffs2_1pass_search_inode(struct b_lists * pL, const char *fname, u32 pino)
 			return 0;
 		}
 	}
+	if (parentp)
+		*parentp = pino;
 	/* this is for the bare filename, directories have already been mapped */
 	if (!(pino = jffs2_1pass_find_inode(pL, tmp, pino))) {
 		putstr("find_inode failed for name=");
@@ -1068,80 +1065,39 @@ jffs2_1pass_search_inode(struct b_lists * pL, const char *fname, u32 pino)
 
 }
 
+/* follow the inode if it is a symlink; pino is the directory holding it */
 static u32
-jffs2_1pass_resolve_inode(struct b_lists * pL, u32 ino)
+jffs2_1pass_resolve_inode(struct b_lists * pL, u32 ino, u32 pino)
 {
 	struct b_node *b;
-	struct b_node *b2;
-	struct jffs2_raw_dirent *jDir;
 	struct jffs2_raw_inode *jNode;
-	u8 jDirFoundType = 0;
-	u32 jDirFoundIno = 0;
-	u32 jDirFoundPino = 0;
 	char tmp[256];
-	u32 version = 0;
-	u32 pino;
 	unsigned char *src;
+	u32 len;
 
-	/* we need to search all and return the inode with the highest version */
-	for(b = pL->dir.listHead; b; b = b->next) {
-		jDir = (struct jffs2_raw_dirent *) get_node_mem(b->offset,
-								pL->readbuf);
-		if (ino == jDir->ino) {
-			if (jDir->version < version) {
-				put_fl_mem(jDir, pL->readbuf);
-				continue;
-			}
-
-			if (jDir->version == version && jDirFoundType) {
-				/* I'm pretty sure this isn't legal */
-				putstr(" ** ERROR ** ");
-				putnstr(jDir->name, jDir->nsize);
-				putLabeledWord(" has dup version (resolve) = ",
-					version);
-			}
+	b = jffs2_1pass_latest_frag(pL, ino);
+	if (!b)
+		return ino;
 
-			jDirFoundType = jDir->type;
-			jDirFoundIno = jDir->ino;
-			jDirFoundPino = jDir->pino;
-			version = jDir->version;
-		}
-		put_fl_mem(jDir, pL->readbuf);
+	jNode = (struct jffs2_raw_inode *) get_node_mem(b->offset, pL->readbuf);
+	if (!S_ISLNK(jNode->mode)) {
+		put_fl_mem(jNode, pL->readbuf);
+		return ino;
 	}
-	/* now we found the right entry again. (shoulda returned inode*) */
-	if (jDirFoundType != DT_LNK)
-		return jDirFoundIno;
 
 	/* it's a soft link so we follow it again. */
-	b2 = pL->frag.listHead;
-	while (b2) {
-		jNode = (struct jffs2_raw_inode *) get_node_mem(b2->offset,
-								pL->readbuf);
-		if (jNode->ino == jDirFoundIno) {
-			src = (unsigned char *)jNode + sizeof(struct jffs2_raw_inode);
+	src = (unsigned char *)jNode + sizeof(struct jffs2_raw_inode);
+	len = min_t(u32, jNode->dsize, sizeof(tmp) - 1);
+	strncpy(tmp, (char *)src, len);
+	tmp[len] = '\0';
+	put_fl_mem(jNode, pL->readbuf);
 
-#if 0
-			putLabeledWord("\t\t dsize = ", jNode->dsize);
-			putstr("\t\t target = ");
-			putnstr(src, jNode->dsize);
-			putstr("\r\n");
-#endif
-			strncpy(tmp, (char *)src, jNode->dsize);
-			tmp[jNode->dsize] = '\0';
-			put_fl_mem(jNode, pL->readbuf);
-			break;
-		}
-		b2 = b2->next;
-		put_fl_mem(jNode, pL->readbuf);
-	}
 	/* ok so the name of the new file to find is in tmp */
 	/* if it starts with a slash it is root based else shared dirs */
 	if (tmp[0] == '/')
 		pino = 1;
-	else
-		pino = jDirFoundPino;
 
-	return jffs2_1pass_search_inode(pL, tmp, pino);
+	return jffs2_1pass_search_inode(pL, tmp, pino, NULL);
 }
 
 static u32
@@ -1307,6 +1263,8 @@ static int jffs2_sum_process_sum_data(struct part_info *part, uint32_t offset,
 							&spd->version);
 						b->pino = sum_get_unaligned32(
 							&spd->pino);
+						b->hash = jffs2_name_hash(
+							spd->name, spd->nsize);
 						b->datacrc = CRC_UNKNOWN;
 					}
 
@@ -1766,6 +1724,8 @@ jffs2_1pass_build_lists(struct part_info * part)
 				b->offset = (u32)part->offset + ofs;
 				b->version = node->d.version;
 				b->pino = node->d.pino;
+				b->hash = jffs2_name_hash(node->d.name,
+							  node->d.nsize);
 				if (max_totlen < node->u.totlen)
 					max_totlen = node->u.totlen;
 				counterN++;
@@ -1808,13 +1768,14 @@ jffs2_1pass_build_lists(struct part_info * part)
 	}
 
 	free(buf);
-#if defined(CONFIG_SYS_JFFS2_SORT_FRAGMENTS)
 	/*
-	 * Sort the lists.
+	 * Index the lists, so that lookups need not walk them.
 	 */
-	sort_list(&pL->frag);
-	sort_list(&pL->dir);
-#endif
+	if (jffs2_1pass_index_list(&pL->frag) ||
+	    jffs2_1pass_index_list(&pL->dir)) {
+		jffs2_free_cache(part);
+		return 0;
+	}
 	putstr("\b\b done.\r\n");		/* close off the dots */
 
 	/* We don't care if malloc failed - then each read operation will
@@ -1922,17 +1883,18 @@ jffs2_1pass_load(char *dest, struct part_info * part, const char *fname)
 	struct b_lists *pl;
 	long ret = 1;
 	u32 inode;
+	u32 pino;
 
 	if (! (pl  = jffs2_get_list(part, "load")))
 		return 0;
 
-	if (! (inode = jffs2_1pass_search_inode(pl, fname, 1))) {
+	if (! (inode = jffs2_1pass_search_inode(pl, fname, 1, &pino))) {
 		putstr("load: Failed to find inode\r\n");
 		return 0;
 	}
 
 	/* Resolve symlinks */
-	if (! (inode = jffs2_1pass_resolve_inode(pl, inode))) {
+	if (! (inode = jffs2_1pass_resolve_inode(pl, inode, pino))) {
 		putstr("load: Failed to resolve inode structure\r\n");
 		return 0;
 	}
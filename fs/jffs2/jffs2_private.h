@@ -12,18 +12,16 @@ struct b_node {
 		u32 ino; /* for inodes */
 		u32 pino; /* for dirents */
 	};
+	u32 hash; /* for dirents: hash of the name, else 0 */
 };
 
 struct b_list {
 	struct b_node *listTail;
 	struct b_node *listHead;
-#ifdef CONFIG_SYS_JFFS2_SORT_FRAGMENTS
-	struct b_node *listLast;
-	int (*listCompare)(struct b_node *new, struct b_node *node);
-	u32 listLoops;
-#endif
 	u32 listCount;
 	struct mem_block *listMemBase;
+	/* all nodes, sorted by inode (or parent), hash and version */
+	struct b_node **listIndex;
 };
 
 struct b_lists {
@@ -102,8 +100,4 @@ data_crc(struct jffs2_raw_inode *node)
 	}
 }
 
-#if defined(CONFIG_SYS_JFFS2_SORT_FRAGMENTS)
-/* External merge sort. */
-int sort_list(struct b_list *list);
-#endif
 #endif /* jffs2_private.h */
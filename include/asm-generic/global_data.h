@@ -664,6 +664,12 @@ enum gd_flags {
 	 * drivers shall not be called.
 	 */
 	GD_FLG_HAVE_CONSOLE = 0x8000000,
+	/**
+	 * @GD_FLG_SMP_WORKER: This global data belongs to a secondary CPU
+	 * running jobs posted with smp_work_post(). Such CPUs must not run
+	 * cyclic functions or access devices.
+	 */
+	GD_FLG_SMP_WORKER = 0x10000000,
 };
 
 #endif /* __ASSEMBLY__ */
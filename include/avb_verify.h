@@ -22,10 +22,24 @@ enum avb_boot_state {
 	AVB_RED,
 };
 
+/**
+ * struct avb_preload - Where to load a partition while it is verified
+ *
+ * @name: Partition name, including the slot suffix (e.g. "boot_a")
+ * @addr: Address to load the partition to. There must be room for the whole
+ *	partition, as the whole partition is loaded when the device is unlocked
+ */
+struct avb_preload {
+	const char *name;
+	ulong addr;
+};
+
 struct AvbOpsData {
 	struct AvbOps ops;
 	int mmc_dev;
 	enum avb_boot_state boot_state;
+	const struct avb_preload *preload;
+	int preload_count;
 #ifdef CONFIG_OPTEE_TA_AVB
 	struct udevice *tee;
 	u32 session;
@@ -47,6 +61,22 @@ enum mmc_io_type {
 AvbOps *avb_ops_alloc(int boot_device);
 void avb_ops_free(AvbOps *ops);
 
+/**
+ * avb_ops_set_preload() - Set where partitions are loaded while verified
+ *
+ * Normally libavb reads each partition it verifies into a buffer from the
+ * malloc() pool, which is freed afterwards, so the caller must read the
+ * partition again to use it. Partitions listed here are read straight to
+ * their address instead and left there. The AvbPartitionData for each of them
+ * in the verification result has @preloaded set.
+ *
+ * @ops: AVB ops, as returned by avb_ops_alloc()
+ * @preload: Partitions to load, which must stay valid while @ops is used
+ * @count: Number of entries in @preload
+ */
+void avb_ops_set_preload(AvbOps *ops, const struct avb_preload *preload,
+			 int count);
+
 char *avb_set_state(AvbOps *ops, enum avb_boot_state boot_state);
 char *avb_set_enforce_verity(const char *cmdline);
 char *avb_set_ignore_corruption(const char *cmdline);
@@ -152,6 +152,10 @@ enum bloblist_tag_t {
 	BLOBLISTT_U_BOOT_SPL_HANDOFF	= 0xfff000, /* Hand-off info from SPL */
 	BLOBLISTT_VBE			= 0xfff001, /* VBE per-phase state */
 	BLOBLISTT_U_BOOT_VIDEO		= 0xfff002, /* Video info from SPL */
+	BLOBLISTT_U_BOOT_DM_PROBE_STATS	= 0xfff003, /* Device probe times */
+	BLOBLISTT_U_BOOT_DM_BIND_PLAN	= 0xfff004, /* Devicetree bind plan */
+	BLOBLISTT_U_BOOT_LOG_BINARY	= 0xfff005, /* Binary log ring */
+	BLOBLISTT_U_BOOT_LOG_TEXT	= 0xfff006, /* Log exported as text */
 };
 
 /**
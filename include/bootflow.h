@@ -9,8 +9,11 @@
 
 #include <bootdev.h>
 #include <dm/ofnode_decl.h>
+#include <linux/errno.h>
 #include <linux/list.h>
+#include <linux/string.h>
 
+struct blk_desc;
 struct bootstd_priv;
 struct expo;
 
@@ -90,6 +93,9 @@ enum bootflow_flags_t {
  * @cmdline: OS command line, or NULL if not known (allocated)
  * @x86_setup: Pointer to x86 setup block inside @buf, NULL if not present
  * @bootmeth_priv: Private data for the bootmeth
+ * @cache_hits: Number of files for this bootflow found in the file cache
+ * @cache_saved: Number of bytes not read from the media because of
+ *	@cache_hits
  */
 struct bootflow {
 	struct list_head bm_node;
@@ -116,6 +122,8 @@ struct bootflow {
 	char *cmdline;
 	void *x86_setup;
 	void *bootmeth_priv;
+	uint cache_hits;
+	ulong cache_saved;
 };
 
 /**
@@ -399,6 +407,98 @@ const char *bootflow_state_get_name(enum bootflow_state_t state);
  */
 void bootflow_remove(struct bootflow *bflow);
 
+/**
+ * struct bootflow_cache_stats - Statistics for the bootflow file cache
+ *
+ * @hits: Number of files found in the cache
+ * @misses: Number of files not found in the cache
+ * @saved: Number of bytes not read from the media because of @hits
+ * @entries: Number of files in the cache
+ */
+struct bootflow_cache_stats {
+	ulong hits;
+	ulong misses;
+	u64 saved;
+	uint entries;
+};
+
+#if CONFIG_IS_ENABLED(BOOTSTD_FILE_CACHE)
+/**
+ * bootflow_cache_get() - Get a file from the bootflow file cache
+ *
+ * Files read by bootmeths are kept in the cache, keyed by the block device,
+ * partition, path and size. Small files are copied into the cache and can be
+ * copied out to any address. For larger files only their address is kept,
+ * along with a CRC32, so they can only be used if they are still there.
+ *
+ * @bflow: Bootflow the file is for
+ * @path: Path of the file
+ * @size: Size of the file in bytes
+ * @addr: Address to put the file at
+ * Return: 0 if the file is now at @addr, -ENOENT if it must be read
+ */
+int bootflow_cache_get(struct bootflow *bflow, const char *path, ulong size,
+		       ulong addr);
+
+/**
+ * bootflow_cache_add() - Add a file to the bootflow file cache
+ *
+ * This is called after a bootmeth reads a file. Files on a block device are
+ * added, unless they are too large. If this runs out of memory, the file is
+ * just not added.
+ *
+ * @bflow: Bootflow the file is for
+ * @path: Path of the file
+ * @size: Size of the file in bytes
+ * @addr: Address the file was read to
+ * @fixed: true if the file stays at @addr, e.g. a load address, so that a
+ *	large file can be cached by address. If false, only a copy is kept
+ */
+void bootflow_cache_add(struct bootflow *bflow, const char *path, ulong size,
+			ulong addr, bool fixed);
+
+/**
+ * bootflow_cache_invalidate() - Drop cached files for a block device
+ *
+ * This is called when the device is written or erased, or its partition table
+ * is read again
+ *
+ * @desc: Block device descriptor
+ */
+void bootflow_cache_invalidate(struct blk_desc *desc);
+
+/**
+ * bootflow_cache_stats() - Get file-cache statistics and reset them
+ *
+ * @stats: Returns the statistics
+ */
+void bootflow_cache_stats(struct bootflow_cache_stats *stats);
+
+/** bootflow_cache_free() - Free all memory allocated to the file cache */
+void bootflow_cache_free(void);
+#else
+static inline int bootflow_cache_get(struct bootflow *bflow, const char *path,
+				     ulong size, ulong addr)
+{
+	return -ENOENT;
+}
+
+static inline void bootflow_cache_add(struct bootflow *bflow,
+				      const char *path, ulong size, ulong addr,
+				      bool fixed)
+{
+}
+
+static inline void bootflow_cache_invalidate(struct blk_desc *desc) {}
+
+static inline void bootflow_cache_stats(struct bootflow_cache_stats *stats)
+{
+	memset(stats, '\0', sizeof(*stats));
+}
+
+static inline void bootflow_cache_free(void) {}
+#endif
+
 /**
  * bootflow_iter_check_blk() - Check that a bootflow uses a block device
  *
@@ -213,6 +213,10 @@ enum bootstage_id {
 	BOOTSTAGE_ID_ACCUM_FSP_M,
 	BOOTSTAGE_ID_ACCUM_FSP_S,
 	BOOTSTAGE_ID_ACCUM_MMAP_SPI,
+	BOOTSTAGE_ID_ACCUM_SMP_WORK,
+	BOOTSTAGE_ID_ACCUM_FIT_HASH,
+	BOOTSTAGE_ID_ACCUM_UBI_ATTACH,
+	BOOTSTAGE_ID_ACCUM_AVB_VERIFY,
 
 	/* a few spare for the user, from here */
 	BOOTSTAGE_ID_USER,
@@ -7,6 +7,8 @@
 #ifndef _CLI_HUSH_H_
 #define _CLI_HUSH_H_
 
+#include <linux/types.h>
+
 #define FLAG_EXIT_FROM_LOOP 1
 #define FLAG_PARSE_SEMICOLON (1 << 1)	  /* symbol ';' is special for parser */
 #define FLAG_REPARSING       (1 << 2)	  /* >=2nd pass */
@@ -67,6 +69,51 @@ static inline int set_local_var_modern(char *s, int flg_export)
 void unset_local_var(const char *name);
 char *get_local_var(const char *s);
 
+/**
+ * struct hush_stats - Information about scripts run by the modern hush parser
+ *
+ * This covers scripts run with run_command() and run_command_list(), which
+ * includes the 'run' and 'source' commands, but not commands typed at the
+ * prompt.
+ *
+ * @runs: Number of scripts run
+ * @hits: Number of scripts run which were found in the cache, already parsed
+ * @misses: Number of scripts run which were not in the cache, so were parsed
+ * @evictions: Number of scripts dropped from the cache to make room
+ * @cached: Number of scripts currently in the cache
+ * @parse_us: Total time spent parsing scripts, in microseconds
+ * @exec_us: Total time spent running scripts, not including parsing, in
+ *	microseconds
+ */
+struct hush_stats {
+	ulong runs;
+	ulong hits;
+	ulong misses;
+	ulong evictions;
+	uint cached;
+	u64 parse_us;
+	u64 exec_us;
+};
+
+/**
+ * hush_get_stats() - Get information about the scripts run
+ *
+ * @stats: Returns the information
+ */
+void hush_get_stats(struct hush_stats *stats);
+
+/**
+ * hush_flush_cache() - Drop all parsed scripts which are not running
+ */
+void hush_flush_cache(void);
+
+/**
+ * hush_reset_stats() - Reset the counters in struct hush_stats
+ *
+ * This leaves the number of cached scripts unchanged.
+ */
+void hush_reset_stats(void);
+
 #if defined(CONFIG_HUSH_INIT_VAR)
 extern int hush_init_var (void);
 #endif
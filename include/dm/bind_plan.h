@@ -0,0 +1,222 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Cached plan for binding devices from the devicetree
+ *
+ * Binding the devicetree involves checking each compatible string of each
+ * node against the match table of every driver. The result is the same on
+ * every boot of a given U-Boot binary with a given devicetree, so it can be
+ * recorded in the bloblist on one boot and followed on the next, with each
+ * node bound directly to its driver.
+ *
+ * The plan is only used if the devicetree and the set of drivers are the same
+ * as when it was recorded. Each entry is checked against the node's
+ * compatible strings as well, so if anything does not match, normal scanning
+ * takes over and a new plan is recorded.
+ */
+
+#ifndef _DM_BIND_PLAN_H
+#define _DM_BIND_PLAN_H
+
+#include <linux/errno.h>
+#include <linux/types.h>
+
+struct driver;
+struct udevice_id;
+
+/* Version of the bloblist record, incremented when the format changes */
+#define DM_BIND_PLAN_VERSION	1
+
+/**
+ * enum dm_bind_plan_drv_t - Special values for dm_bind_plan_ent.drv_idx
+ *
+ * @DM_BIND_PLAN_SEARCH: Search for a driver in the normal way, e.g. because
+ *	a driver refused to bind to the node when the plan was recorded
+ * @DM_BIND_PLAN_NONE: No driver matches the node
+ */
+enum dm_bind_plan_drv_t {
+	DM_BIND_PLAN_SEARCH	= 0xfffe,
+	DM_BIND_PLAN_NONE	= 0xffff,
+};
+
+/**
+ * struct dm_bind_plan_ent - Binding for a single devicetree node
+ *
+ * There is one entry for each call to lists_bind_fdt() without a specific
+ * driver, in the order in which the calls are made
+ *
+ * @drv_idx: Index of the driver in the driver linker list, or enum
+ *	dm_bind_plan_drv_t
+ * @match_idx: Index of the matching entry in the driver's of_match table
+ * @compat_ofs: Offset of the matching string in the node's compatible
+ *	property
+ * @compat_len: Length of the node's compatible property
+ */
+struct dm_bind_plan_ent {
+	u16 drv_idx;
+	u16 match_idx;
+	u16 compat_ofs;
+	u16 compat_len;
+};
+
+/**
+ * struct dm_bind_plan_hdr - Header for the bind plan in the bloblist
+ *
+ * @version: DM_BIND_PLAN_VERSION
+ * @fdt_crc: CRC32 of the control devicetree
+ * @drv_crc: CRC32 of the U-Boot version string and the list of driver names
+ * @count: Number of entries
+ * @ent: Entries
+ */
+struct dm_bind_plan_hdr {
+	u32 version;
+	u32 fdt_crc;
+	u32 drv_crc;
+	u32 count;
+	struct dm_bind_plan_ent ent[];
+};
+
+/**
+ * struct dm_bind_plan_stats - Information about the last use of the plan
+ *
+ * @planned: Number of entries in the plan found in the bloblist (0 if none)
+ * @hits: Number of nodes bound by following the plan
+ * @searched: Number of nodes which needed a normal driver search
+ * @written: true if a new plan was written to the bloblist
+ */
+struct dm_bind_plan_stats {
+	uint planned;
+	uint hits;
+	uint searched;
+	bool written;
+};
+
+#if CONFIG_IS_ENABLED(DM_BIND_PLAN)
+/**
+ * dm_bind_plan_start() - Start using the bind plan for a devicetree scan
+ *
+ * This looks for a valid plan in the bloblist and gets ready to record a new
+ * one. It must be followed by dm_bind_plan_finish() once the scan completes.
+ */
+void dm_bind_plan_start(void);
+
+/**
+ * dm_bind_plan_finish() - Finish using the bind plan
+ *
+ * If the plan was missing or was not followed, the recorded plan is written
+ * to the bloblist, provided that there is space
+ *
+ * @scan_ret: Result of the scan; if this is an error the recorded plan is
+ *	dropped
+ * Return: 0 if OK, -ENOSPC if there is no space for the plan in the bloblist,
+ *	-ENOMEM if out of memory while recording
+ */
+int dm_bind_plan_finish(int scan_ret);
+
+/**
+ * dm_bind_plan_active() - Check if a devicetree scan is using the plan
+ *
+ * Return: true if between dm_bind_plan_start() and dm_bind_plan_finish()
+ */
+bool dm_bind_plan_active(void);
+
+/**
+ * dm_bind_plan_next() - Get the planned driver for the next node
+ *
+ * The entry is checked against the node's compatible property. If it does not
+ * match, the plan is abandoned for the rest of the scan.
+ *
+ * @compat_list: Node's compatible property
+ * @compat_length: Length of @compat_list in bytes
+ * @drvp: Returns the driver to bind, or NULL if no driver matches the node
+ * @idp: Returns the matching entry in the driver's of_match table
+ * Return: 0 if OK, -EAGAIN if the caller must search for a driver and report
+ *	the result with dm_bind_plan_reserve() and dm_bind_plan_add()
+ */
+int dm_bind_plan_next(const char *compat_list, int compat_length,
+		      struct driver **drvp, const struct udevice_id **idp);
+
+/**
+ * dm_bind_plan_abandon() - Stop following the plan
+ *
+ * This is used if the planned driver refuses to bind. The caller must then
+ * search for a driver and report the result with dm_bind_plan_reserve() and
+ * dm_bind_plan_add().
+ */
+void dm_bind_plan_abandon(void);
+
+/**
+ * dm_bind_plan_reserve() - Reserve the plan entry for a node
+ *
+ * This must be called before a node is bound, since binding it may bind its
+ * child nodes as well and the plan must hold the parent first. The entry is
+ * filled in by dm_bind_plan_add() once the driver is known.
+ *
+ * Return: slot number of the entry, -ENOENT if no devicetree scan is using
+ *	the plan, -ENOMEM if out of memory
+ */
+int dm_bind_plan_reserve(void);
+
+/**
+ * dm_bind_plan_add() - Record the driver found for a node
+ *
+ * This does nothing if @slot is an error from dm_bind_plan_reserve()
+ *
+ * @slot: Slot number returned by dm_bind_plan_reserve()
+ * @compat_list: Node's compatible property
+ * @compat_length: Length of @compat_list in bytes
+ * @compat: Compatible string which matched, or NULL if none
+ * @drv: Driver which was bound, or NULL if none
+ * @id: Matching entry in @drv's of_match table
+ * @search: true if the node must be searched for again next time, e.g.
+ *	because a driver refused to bind
+ */
+void dm_bind_plan_add(int slot, const char *compat_list, int compat_length,
+		      const char *compat, struct driver *drv,
+		      const struct udevice_id *id, bool search);
+
+/**
+ * dm_bind_plan_get_stats() - Get information about the last use of the plan
+ *
+ * @stats: Returns the information
+ */
+void dm_bind_plan_get_stats(struct dm_bind_plan_stats *stats);
+#else
+static inline void dm_bind_plan_start(void)
+{
+}
+
+static inline int dm_bind_plan_finish(int scan_ret)
+{
+	return 0;
+}
+
+static inline bool dm_bind_plan_active(void)
+{
+	return false;
+}
+
+static inline int dm_bind_plan_next(const char *compat_list,
+				    int compat_length, struct driver **drvp,
+				    const struct udevice_id **idp)
+{
+	return -EAGAIN;
+}
+
+static inline void dm_bind_plan_abandon(void)
+{
+}
+
+static inline int dm_bind_plan_reserve(void)
+{
+	return -ENOENT;
+}
+
+static inline void dm_bind_plan_add(int slot, const char *compat_list,
+				    int compat_length, const char *compat,
+				    struct driver *drv,
+				    const struct udevice_id *id, bool search)
+{
+}
+#endif
+
+#endif
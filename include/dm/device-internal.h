@@ -12,6 +12,7 @@
 
 #include <event.h>
 #include <linker_lists.h>
+#include <dm/device.h>
 #include <dm/ofnode.h>
 
 struct device_node;
@@ -429,6 +430,102 @@ static inline void devres_release_all(struct udevice *dev)
 
 #endif /* DEVRES */
 
+/**
+ * struct dm_probe_timer - Keeps track of time spent probing a device
+ *
+ * @start: Time when binding or probing started, or 0 if no timer was
+ *	available
+ * @outer_nested: Time spent so far in nested binds or probes of the device
+ *	which is binding or probing this one
+ */
+struct dm_probe_timer {
+	ulong start;
+	ulong outer_nested;
+};
+
+#if CONFIG_IS_ENABLED(DM_PROBE_STATS)
+/**
+ * dm_probe_stats_time() - Get a timestamp for probe statistics
+ *
+ * Return: time in microseconds, or 0 if there is no timer available yet
+ */
+ulong dm_probe_stats_time(void);
+
+/**
+ * dm_probe_stats_add() - Record the time taken by a step of setting up a device
+ *
+ * @dev: Device being set up
+ * @stat: Step which has just completed
+ * @start: Value of dm_probe_stats_time() when the step started
+ */
+void dm_probe_stats_add(struct udevice *dev, enum dm_probe_stat_t stat,
+			ulong start);
+
+/**
+ * dm_probe_stats_bind_begin() - Note that a device is about to be bound
+ *
+ * @tmr: Timer to set up, to pass to dm_probe_stats_bind_end()
+ */
+void dm_probe_stats_bind_begin(struct dm_probe_timer *tmr);
+
+/**
+ * dm_probe_stats_bind_end() - Record the time taken to bind a device
+ *
+ * The time taken to bind any children since dm_probe_stats_bind_begin() was
+ * called is not included, since it is recorded against those children.
+ *
+ * @dev: Device which has been bound, or NULL if binding failed
+ * @tmr: Timer passed to dm_probe_stats_bind_begin()
+ */
+void dm_probe_stats_bind_end(struct udevice *dev, struct dm_probe_timer *tmr);
+
+/**
+ * dm_probe_stats_begin() - Note that a device is about to be probed
+ *
+ * @tmr: Timer to set up, to pass to dm_probe_stats_end()
+ */
+void dm_probe_stats_begin(struct dm_probe_timer *tmr);
+
+/**
+ * dm_probe_stats_end() - Record the time taken to probe a device
+ *
+ * This separates out the time taken to probe any other devices since
+ * dm_probe_stats_begin() was called.
+ *
+ * @dev: Device which has been probed (successfully or not)
+ * @tmr: Timer passed to dm_probe_stats_begin()
+ */
+void dm_probe_stats_end(struct udevice *dev, struct dm_probe_timer *tmr);
+#else
+static inline ulong dm_probe_stats_time(void)
+{
+	return 0;
+}
+
+static inline void dm_probe_stats_add(struct udevice *dev,
+				      enum dm_probe_stat_t stat, ulong start)
+{
+}
+
+static inline void dm_probe_stats_bind_begin(struct dm_probe_timer *tmr)
+{
+}
+
+static inline void dm_probe_stats_bind_end(struct udevice *dev,
+					   struct dm_probe_timer *tmr)
+{
+}
+
+static inline void dm_probe_stats_begin(struct dm_probe_timer *tmr)
+{
+}
+
+static inline void dm_probe_stats_end(struct udevice *dev,
+				      struct dm_probe_timer *tmr)
+{
+}
+#endif /* DM_PROBE_STATS */
+
 static inline int device_notify(const struct udevice *dev, enum event_t type)
 {
 #if CONFIG_IS_ENABLED(DM_EVENT)
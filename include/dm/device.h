@@ -112,6 +112,82 @@ enum {
 	DM_REMOVE_NO_PD		= 1 << 1,
 };
 
+/**
+ * enum dm_probe_stat_t - Times recorded for each device with DM_PROBE_STATS
+ *
+ * @DM_PROBE_STAT_BIND: Binding the device, excluding any children bound by
+ *	its driver, which are recorded against those children
+ * @DM_PROBE_STAT_OF_TO_PLAT: Reading the device's platform data with its
+ *	of_to_plat() method
+ * @DM_PROBE_STAT_PROBE: Probing the device, including the time taken by
+ *	of_to_plat() and by probing other devices along the way
+ * @DM_PROBE_STAT_NESTED: Probing other devices (parents, suppliers such as
+ *	clocks and regulators, children) while this device was being probed
+ * @DM_PROBE_STAT_COUNT: Number of times recorded
+ */
+enum dm_probe_stat_t {
+	DM_PROBE_STAT_BIND,
+	DM_PROBE_STAT_OF_TO_PLAT,
+	DM_PROBE_STAT_PROBE,
+	DM_PROBE_STAT_NESTED,
+
+	DM_PROBE_STAT_COUNT,
+};
+
+/**
+ * struct dm_probe_stats - Time taken to set up a device
+ *
+ * Times are in microseconds and are only recorded once a timer is available,
+ * so devices set up before that show as taking no time.
+ *
+ * @time_us: Time taken for each step (indexed by enum dm_probe_stat_t)
+ * @probe_count: Number of times the device has been probed, including any
+ *	failed attempts
+ */
+struct dm_probe_stats {
+	u32 time_us[DM_PROBE_STAT_COUNT];
+	u32 probe_count;
+};
+
+/* Version of the probe stats stored in the bloblist */
+#define DM_PROBE_STATS_VERSION	1
+
+/* Maximum length of a driver name in the probe stats, including nul */
+#define DM_PROBE_STATS_NAME_LEN	32
+
+/**
+ * struct dm_probe_stats_hdr - Header for probe stats stored in the bloblist
+ *
+ * @version: DM_PROBE_STATS_VERSION
+ * @hdr_size: Size of this header in bytes
+ * @rec_size: Size of each record (struct dm_probe_stats_rec) in bytes
+ * @count: Number of records following this header
+ */
+struct dm_probe_stats_hdr {
+	u32 version;
+	u32 hdr_size;
+	u32 rec_size;
+	u32 count;
+};
+
+/**
+ * struct dm_probe_stats_rec - Probe stats for a driver, stored in the bloblist
+ *
+ * @name: Driver name, nul-terminated (and truncated if necessary)
+ * @uclass_id: Uclass ID of the driver (enum uclass_id)
+ * @dev_count: Number of devices using the driver
+ * @probe_count: Number of times those devices were probed
+ * @time_us: Total time taken for each step by those devices, in microseconds
+ *	(indexed by enum dm_probe_stat_t)
+ */
+struct dm_probe_stats_rec {
+	char name[DM_PROBE_STATS_NAME_LEN];
+	u32 uclass_id;
+	u32 dev_count;
+	u32 probe_count;
+	u32 time_us[DM_PROBE_STAT_COUNT];
+};
+
 /**
  * struct udevice - An instance of a driver
  *
@@ -166,6 +242,7 @@ enum {
  * @dma_offset: Offset between the physical address space (CPU's) and the
  *		device's bus address space
  * @iommu: IOMMU device associated with this device
+ * @probe_stats: Time taken to bind and probe the device
  */
 struct udevice {
 	const struct driver *driver;
@@ -198,6 +275,9 @@ struct udevice {
 #if CONFIG_IS_ENABLED(IOMMU)
 	struct udevice *iommu;
 #endif
+#if CONFIG_IS_ENABLED(DM_PROBE_STATS)
+	struct dm_probe_stats probe_stats;
+#endif
 };
 
 static inline int dm_udevice_size(void)
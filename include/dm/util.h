@@ -51,6 +51,56 @@ void dm_dump_driver_compat(void);
 /* Dump out a list of drivers with static platform data */
 void dm_dump_static_driver_info(void);
 
+/**
+ * enum dm_probe_stats_by - How to group probe statistics
+ *
+ * @DM_PROBE_STATS_BY_DEVICE: Show each device separately
+ * @DM_PROBE_STATS_BY_DRIVER: Add up the times for all devices of each driver
+ * @DM_PROBE_STATS_BY_UCLASS: Add up the times for all devices in each uclass
+ */
+enum dm_probe_stats_by {
+	DM_PROBE_STATS_BY_DEVICE,
+	DM_PROBE_STATS_BY_DRIVER,
+	DM_PROBE_STATS_BY_UCLASS,
+};
+
+/**
+ * dm_dump_probe_stats() - Dump the time taken to bind and probe devices
+ *
+ * Entries are sorted by the time taken to probe them, slowest first, and
+ * entries which have never been probed are omitted unless @all is true
+ *
+ * @by: How to group the devices
+ * @all: true to show entries which have not been probed
+ */
+void dm_dump_probe_stats(enum dm_probe_stats_by by, bool all);
+
+/**
+ * dm_probe_stats_fdt_add() - Add probe times to bootstage info in a devicetree
+ *
+ * This adds one record for each driver to the /bootstage node, in the same
+ * format as bootstage uses, with a name of "probe <driver>" and an "accum"
+ * value giving the time spent in that driver's probe methods, excluding time
+ * spent probing other devices.
+ *
+ * @blob: Devicetree to update
+ * @parent: Offset of the /bootstage node
+ * @index: Index to use for the name of the first subnode added
+ * Return: 0 if OK, -ve on error
+ */
+int dm_probe_stats_fdt_add(void *blob, int parent, int index);
+
+/**
+ * dm_probe_stats_stash() - Store the probe times for each driver in a bloblist
+ *
+ * This writes a BLOBLISTT_U_BOOT_DM_PROBE_STATS record, holding a
+ * struct dm_probe_stats_hdr followed by a struct dm_probe_stats_rec for each
+ * driver which has devices
+ *
+ * Return: 0 if OK, -ve on error
+ */
+int dm_probe_stats_stash(void);
+
 /**
  * dm_dump_mem() - Dump stats on memory usage in driver model
  *
@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Batched reads and read-ahead for filesystems
+ *
+ * Filesystems normally read each part of a file as they find it, in between
+ * reading the metadata which says where the next part is. This allows them to
+ * queue the data reads instead, as a list of extents. When the list is
+ * submitted it is sorted by position on the device, extents which follow on
+ * from each other are merged and each merged run is read with a single
+ * request.
+ *
+ * While a file is being read, small reads through fs_devread() (mostly
+ * metadata) are served from a read-ahead window, so that neighbouring inode,
+ * directory and extent-tree blocks do not need a device request each.
+ */
+
+#ifndef __FS_IO_H
+#define __FS_IO_H
+
+#include <alist.h>
+#include <blk.h>
+#include <fs_internal.h>
+#include <linux/errno.h>
+#include <linux/string.h>
+
+struct disk_partition;
+
+/**
+ * struct fs_io_req - A queued read
+ *
+ * @pos: Byte position from the start of the partition
+ * @len: Number of bytes to read
+ * @buf: Buffer to read into
+ */
+struct fs_io_req {
+	u64 pos;
+	ulong len;
+	void *buf;
+};
+
+/**
+ * struct fs_io - A list of reads for one partition
+ *
+ * @desc: Block device to read from
+ * @part: Partition to read from
+ * @reqs: Queued reads, each a struct fs_io_req
+ */
+struct fs_io {
+	struct blk_desc *desc;
+	struct disk_partition *part;
+	struct alist reqs;
+};
+
+/**
+ * struct fs_io_stats - Statistics for batched reads and read-ahead
+ *
+ * @requests: Number of reads queued with fs_io_add()
+ * @merged: Number of queued reads merged with the one before
+ * @reads: Number of device reads used for the queued reads
+ * @bytes: Number of bytes read for the queued reads
+ * @ra_hits: Number of small reads served from the read-ahead window
+ * @ra_fills: Number of times the read-ahead window was filled
+ */
+struct fs_io_stats {
+	ulong requests;
+	ulong merged;
+	ulong reads;
+	u64 bytes;
+	ulong ra_hits;
+	ulong ra_fills;
+};
+
+#if CONFIG_IS_ENABLED(FS_IO)
+/**
+ * fs_io_init() - Set up a list of reads
+ *
+ * @io: List to set up
+ * @desc: Block device to read from
+ * @part: Partition to read from
+ */
+void fs_io_init(struct fs_io *io, struct blk_desc *desc,
+		struct disk_partition *part);
+
+/**
+ * fs_io_add() - Queue a read
+ *
+ * The buffer must not be used until fs_io_submit() returns. If too many reads
+ * are queued, they are submitted before this one is added.
+ *
+ * @io: List of reads
+ * @sector: Sector to read from, relative to the start of the partition
+ * @byte_offset: Byte offset from @sector
+ * @byte_len: Number of bytes to read
+ * @buf: Buffer to read into
+ * Return: 0 if OK, -ENOMEM if out of memory, -EIO on read error
+ */
+int fs_io_add(struct fs_io *io, lbaint_t sector, int byte_offset,
+	      ulong byte_len, void *buf);
+
+/**
+ * fs_io_submit() - Read everything in a list
+ *
+ * The list is empty afterwards and can be used again.
+ *
+ * @io: List of reads
+ * Return: 0 if OK, -EIO on read error
+ */
+int fs_io_submit(struct fs_io *io);
+
+/**
+ * fs_io_uninit() - Free a list of reads, dropping anything not submitted
+ *
+ * @io: List to free
+ */
+void fs_io_uninit(struct fs_io *io);
+
+/**
+ * fs_io_readahead_start() - Start using the read-ahead window
+ *
+ * This is called by the filesystem layer before a file is read
+ */
+void fs_io_readahead_start(void);
+
+/**
+ * fs_io_readahead_stop() - Stop using the read-ahead window and empty it
+ *
+ * This is called by the filesystem layer after a file is read, so that
+ * nothing written to the device afterwards can be hidden by the window.
+ */
+void fs_io_readahead_stop(void);
+
+/**
+ * fs_io_set_readahead() - Set the size of the read-ahead window
+ *
+ * @size: New size in bytes, or 0 to disable read-ahead
+ * Return: previous size
+ */
+ulong fs_io_set_readahead(ulong size);
+
+/**
+ * fs_io_read_cached() - Read through the read-ahead window
+ *
+ * This is used by fs_devread() for small reads. If the data is not in the
+ * window, the window is filled starting at @sector.
+ *
+ * @blk: Block device to read from
+ * @part: Partition to read from
+ * @sector: Sector to read from, relative to the start of the partition
+ * @byte_offset: Byte offset from @sector, less than the sector size
+ * @byte_len: Number of bytes to read
+ * @buf: Buffer to read into
+ * Return: true if the data was read, false if the caller must read it
+ */
+bool fs_io_read_cached(struct blk_desc *blk, struct disk_partition *part,
+		       lbaint_t sector, int byte_offset, int byte_len,
+		       char *buf);
+
+/**
+ * fs_io_stats() - Get statistics and reset them
+ *
+ * @stats: Returns the statistics
+ */
+void fs_io_stats(struct fs_io_stats *stats);
+#else
+static inline void fs_io_init(struct fs_io *io, struct blk_desc *desc,
+			      struct disk_partition *part)
+{
+	io->desc = desc;
+	io->part = part;
+}
+
+static inline int fs_io_add(struct fs_io *io, lbaint_t sector,
+			    int byte_offset, ulong byte_len, void *buf)
+{
+	if (!fs_devread(io->desc, io->part, sector, byte_offset, byte_len, buf))
+		return -EIO;
+
+	return 0;
+}
+
+static inline int fs_io_submit(struct fs_io *io)
+{
+	return 0;
+}
+
+static inline void fs_io_uninit(struct fs_io *io) {}
+static inline void fs_io_readahead_start(void) {}
+static inline void fs_io_readahead_stop(void) {}
+
+static inline ulong fs_io_set_readahead(ulong size)
+{
+	return 0;
+}
+
+static inline bool fs_io_read_cached(struct blk_desc *blk,
+				     struct disk_partition *part,
+				     lbaint_t sector, int byte_offset,
+				     int byte_len, char *buf)
+{
+	return false;
+}
+
+static inline void fs_io_stats(struct fs_io_stats *stats)
+{
+	memset(stats, '\0', sizeof(*stats));
+}
+#endif
+
+#endif
@@ -396,6 +396,7 @@ struct bootm_headers {
 #endif
 
 	int		verify;		/* env_get("verify")[0] != 'n' */
+	ulong		copied;		/* bytes copied to load addresses */
 
 #define BOOTM_STATE_START	0x00000001
 #define BOOTM_STATE_FINDOS	0x00000002
@@ -1314,6 +1315,28 @@ int fit_add_verification_data(const char *keydir, const char *keyfile,
 			      const char *cmdname, const char *algo_name,
 			      struct image_summary *summary);
 
+/**
+ * fit_calc_hashes() - calculate the hashes for all images in a FIT
+ *
+ * This calculates the value for each hash node of each image using a pool of
+ * threads, so that fit_add_verification_data() can write the values without
+ * calculating them again. The values are kept until fit_free_hashes() is
+ * called, so they are not calculated again if verification data must be
+ * added more than once, e.g. because the FIT had to be enlarged. Images with
+ * a cipher node are skipped, since their data changes each time they are
+ * encrypted.
+ *
+ * @fit:	Pointer to the FIT format image header
+ * @threads:	Number of threads to use, 0 for one per CPU
+ * Return: number of hashes calculated, or -ve on error
+ */
+int fit_calc_hashes(const void *fit, int threads);
+
+/**
+ * fit_free_hashes() - free the hash values from fit_calc_hashes()
+ */
+void fit_free_hashes(void);
+
 /**
  * fit_image_verify_with_data() - Verify an image with given data
  *
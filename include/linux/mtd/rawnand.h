@@ -98,6 +98,8 @@ void nand_wait_ready(struct mtd_info *mtd);
 
 /* Extended commands for large page devices */
 #define NAND_CMD_READSTART	0x30
+#define NAND_CMD_READCACHESEQ	0x31
+#define NAND_CMD_READCACHEEND	0x3f
 #define NAND_CMD_RNDOUTSTART	0xE0
 #define NAND_CMD_CACHEDPROG	0x15
 
@@ -217,12 +219,22 @@ enum nand_ecc_algo {
 /* Device needs 3rd row address cycle */
 #define NAND_ROW_ADDR_3		0x00004000
 
+/*
+ * Chip and controller support READ CACHE SEQUENTIAL: the controller's
+ * cmdfunc() can issue NAND_CMD_READCACHESEQ and NAND_CMD_READCACHEEND and
+ * its page accessors do not issue other commands between pages. Drivers opt
+ * in by setting this; it is cleared if the chip does not report the command
+ * in its ONFI parameter page.
+ */
+#define NAND_CACHE_READ		0x00008000
+
 /* Options valid for Samsung large page devices */
 #define NAND_SAMSUNG_LP_OPTIONS NAND_CACHEPRG
 
 /* Macros to identify the above */
 #define NAND_HAS_CACHEPROG(chip) ((chip->options & NAND_CACHEPRG))
 #define NAND_HAS_SUBPAGE_READ(chip) ((chip->options & NAND_SUBPAGE_READ))
+#define NAND_HAS_CACHE_READ(chip) ((chip->options & NAND_CACHE_READ))
 #define NAND_HAS_SUBPAGE_WRITE(chip) !((chip)->options & NAND_NO_SUBPAGE_WRITE)
 
 /* Non chip related options */
@@ -293,6 +305,9 @@ enum nand_ecc_algo {
 /* ONFI subfeature parameters length */
 #define ONFI_SUBFEATURE_PARAM_LEN	4
 
+/* ONFI optional commands READ CACHE supported? */
+#define ONFI_OPT_CMD_READ_CACHE		(1 << 1)
+
 /* ONFI optional commands SET/GET FEATURES supported? */
 #define ONFI_OPT_CMD_SET_GET_FEATURES	(1 << 2)
 
@@ -1240,6 +1255,12 @@ static inline int onfi_feature(struct nand_chip *chip)
 	return chip->onfi_version ? le16_to_cpu(chip->onfi_params.features) : 0;
 }
 
+/* return the supported optional commands. */
+static inline int onfi_opt_cmd(struct nand_chip *chip)
+{
+	return chip->onfi_version ? le16_to_cpu(chip->onfi_params.opt_cmd) : 0;
+}
+
 /* return the supported asynchronous timing mode. */
 static inline int onfi_get_async_timing_mode(struct nand_chip *chip)
 {
@@ -1261,6 +1282,11 @@ static inline int onfi_feature(struct nand_chip *chip)
 	return 0;
 }
 
+static inline int onfi_opt_cmd(struct nand_chip *chip)
+{
+	return 0;
+}
+
 static inline int onfi_get_async_timing_mode(struct nand_chip *chip)
 {
 	return ONFI_TIMING_MODE_UNKNOWN;
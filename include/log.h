@@ -13,6 +13,7 @@
 #include <linker_lists.h>
 #include <dm/uclass-id.h>
 #include <linux/bitops.h>
+#include <linux/errno.h>
 #include <linux/list.h>
 
 struct cmd_tbl;
@@ -428,6 +429,7 @@ enum log_device_flags {
  *
  * @name: Name of driver
  * @emit: Method to call to emit a log record via this device
+ * @emit_args: Method to call to emit an unformatted log record
  * @flags: Initial value for flags (use LOGDF_ENABLE to enable on start-up)
  */
 struct log_driver {
@@ -440,6 +442,17 @@ struct log_driver {
 	 * for processing. The filter is checked before calling this function.
 	 */
 	int (*emit)(struct log_device *ldev, struct log_rec *rec);
+
+	/**
+	 * @emit_args: emit a log record without formatting it (optional)
+	 *
+	 * If provided, this is called instead of @emit, with the format string
+	 * and arguments rather than the formatted message, so that the driver
+	 * can put off formatting until later. @rec->msg may be NULL. The
+	 * filter is checked before calling this function.
+	 */
+	int (*emit_args)(struct log_device *ldev, struct log_rec *rec,
+			 const char *fmt, va_list args);
 	unsigned short flags;
 };
 
@@ -696,6 +709,81 @@ static inline int log_get_default_format(void)
 	       (IS_ENABLED(CONFIG_LOGF_FUNC) ? BIT(LOGF_FUNC) : 0);
 }
 
+/**
+ * struct log_binary_stats - Information about the binary log ring
+ *
+ * @size: Size of the ring in bytes
+ * @used: Number of bytes used by records
+ * @count: Number of records in the ring
+ * @lost: Number of records dropped to make room for newer ones
+ * @truncated: Number of records whose arguments did not fit and were cut short
+ */
+struct log_binary_stats {
+	uint size;
+	uint used;
+	uint count;
+	uint lost;
+	uint truncated;
+};
+
+#if CONFIG_IS_ENABLED(LOG_BINARY)
+/**
+ * log_binary_dump() - Format and show the records in the binary log ring
+ *
+ * Records are shown oldest first, with a timestamp and the fields selected
+ * by the log format (see 'log format')
+ *
+ * Return: 0 if OK, -ENOENT if there is no ring
+ */
+int log_binary_dump(void);
+
+/**
+ * log_binary_export() - Export the binary log ring as text
+ *
+ * Formats the records in the same way as log_binary_dump() and writes them
+ * to a BLOBLISTT_U_BOOT_LOG_TEXT blob as a nul-terminated string, replacing
+ * any previous export, so that the OS can read it
+ *
+ * Return: 0 if OK, -ENOENT if there is no ring, -ENOSPC if there is not enough
+ *	space in the bloblist
+ */
+int log_binary_export(void);
+
+/**
+ * log_binary_clear() - Remove all records from the binary log ring
+ *
+ * The counts of lost and truncated records are reset too
+ */
+void log_binary_clear(void);
+
+/**
+ * log_binary_get_stats() - Get information about the binary log ring
+ *
+ * @stats: Returns the information
+ * Return: 0 if OK, -ENOENT if there is no ring
+ */
+int log_binary_get_stats(struct log_binary_stats *stats);
+#else
+static inline int log_binary_dump(void)
+{
+	return -ENOSYS;
+}
+
+static inline int log_binary_export(void)
+{
+	return -ENOSYS;
+}
+
+static inline void log_binary_clear(void)
+{
+}
+
+static inline int log_binary_get_stats(struct log_binary_stats *stats)
+{
+	return -ENOSYS;
+}
+#endif
+
 struct global_data;
 /**
  * log_fixup_for_gd_move() - Handle global_data moving to a new place
@@ -0,0 +1,98 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Memory test engine
+ *
+ * This tests a memory range using 64-bit accesses, a cache line at a time,
+ * splitting the range across secondary CPUs when CONFIG_SMP_WORK is enabled.
+ * Each write pass is followed by a cache flush, so that the read pass which
+ * follows it sees the contents of memory rather than the cache.
+ */
+
+#ifndef __MEMTEST_H
+#define __MEMTEST_H
+
+#include <linux/types.h>
+
+/* Maximum number of errors recorded in detail by each test */
+#define MEMTEST_MAX_ERRORS	8
+
+/**
+ * enum memtest_t - Tests which can be run
+ *
+ * @MEMTEST_ADDRESS: Write each word with its own address (XORed with the
+ *	pattern), then check it. This finds shorted or stuck address lines.
+ * @MEMTEST_INVERSIONS: Moving inversions: fill with the pattern, then going
+ *	up through memory check each word and write its inverse, then going
+ *	down check the inverse and write the pattern, then check the pattern.
+ *	This finds coupling faults between neighbouring cells.
+ * @MEMTEST_RANDOM: Write pseudo-random values derived from each word's
+ *	offset and the pattern, then check them. This finds data-dependent
+ *	faults.
+ * @MEMTEST_COUNT: Number of tests
+ */
+enum memtest_t {
+	MEMTEST_ADDRESS,
+	MEMTEST_INVERSIONS,
+	MEMTEST_RANDOM,
+
+	MEMTEST_COUNT,
+};
+
+/**
+ * struct memtest_error - Details of a word which read back incorrectly
+ *
+ * @addr: Address of the word
+ * @expect: Value expected
+ * @found: Value read
+ */
+struct memtest_error {
+	ulong addr;
+	u64 expect;
+	u64 found;
+};
+
+/**
+ * struct memtest_result - Result of running a test
+ *
+ * @errors: Number of words which read back incorrectly
+ * @num_recorded: Number of errors recorded in @error
+ * @error: First errors found (in order of address within each CPU's part of
+ *	the range, not in the order they were found)
+ * @bytes: Number of bytes read and written
+ * @time_us: Time taken in microseconds
+ */
+struct memtest_result {
+	ulong errors;
+	uint num_recorded;
+	struct memtest_error error[MEMTEST_MAX_ERRORS];
+	u64 bytes;
+	ulong time_us;
+};
+
+/**
+ * memtest_run() - Run a memory test
+ *
+ * The range is rounded inwards to a multiple of 8 bytes. Ctrl-C is checked
+ * regularly.
+ *
+ * @type: Test to run
+ * @buf: Pointer to the start of the memory to test
+ * @addr: Address of @buf to show in errors
+ * @size: Number of bytes to test
+ * @pattern: Pattern to use
+ * @res: Returns the result
+ * Return: 0 if the test ran (check @res->errors), -EINTR if interrupted,
+ *	-EINVAL if @type is not valid
+ */
+int memtest_run(enum memtest_t type, void *buf, ulong addr, ulong size,
+		u64 pattern, struct memtest_result *res);
+
+/**
+ * memtest_get_name() - Get the name of a test
+ *
+ * @type: Test to check
+ * Return: Name of the test, or "unknown"
+ */
+const char *memtest_get_name(enum memtest_t type);
+
+#endif
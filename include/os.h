@@ -530,6 +530,45 @@ int os_setup_signal_handlers(void);
  */
 void os_signal_action(int sig, unsigned long pc);
 
+/**
+ * os_profiler_start() - start taking profiling samples
+ *
+ * This uses the host's profiling timer (ITIMER_PROF), which counts the CPU
+ * time used by the process, so samples are not taken while sandbox is idle.
+ *
+ * @rate_hz:	number of samples to take per second of CPU time
+ * @func:	function to call for each sample, in signal context, with the
+ *		interrupted program counter and frame pointer
+ * Return:	0 if OK, -EINVAL if the rate is invalid, other -ve on error
+ */
+int os_profiler_start(unsigned int rate_hz,
+		      void (*func)(unsigned long pc, unsigned long fp));
+
+/**
+ * os_profiler_stop() - stop taking profiling samples
+ */
+void os_profiler_stop(void);
+
+/**
+ * os_thread_start() - start a host thread
+ *
+ * This is used to emulate secondary CPUs. The function runs concurrently with
+ * sandbox, so must only touch memory which is safe to share.
+ *
+ * @func:	function to run in the new thread
+ * @arg:	argument to pass to @func
+ * @threadp:	returns a handle for the thread, for use with os_thread_join()
+ * Return:	0 if OK, -ve on error
+ */
+int os_thread_start(void (*func)(void *arg), void *arg, void **threadp);
+
+/**
+ * os_thread_join() - wait for a host thread to finish
+ *
+ * @thread:	handle returned by os_thread_start()
+ */
+void os_thread_join(void *thread);
+
 /**
  * os_get_time_offset() - get time offset
  *
@@ -452,6 +452,17 @@ ulong disk_blk_erase(struct udevice *dev, lbaint_t start, lbaint_t blkcnt);
 #define part_get_info_ptr(x)	x
 #endif
 
+/**
+ * typedef part_info_func_t - Function called for each partition in a table
+ *
+ * @priv: Private data passed by the caller
+ * @part: Partition number (1 = first)
+ * @info: Partition information
+ * Return: 0 to continue, -ve to stop with that error
+ */
+typedef int (*part_info_func_t)(void *priv, int part,
+				struct disk_partition *info);
+
 /**
  * struct part_driver - partition driver
  */
@@ -488,12 +499,92 @@ struct part_driver {
 	 * -ve if not
 	 */
 	int (*test)(struct blk_desc *desc);
+
+	/**
+	 * @get_all:		Get information about all partitions (optional)
+	 *
+	 * This reads the partition table once and calls @get_all.func for
+	 * each partition in it. It is used to fill the partition cache.
+	 *
+	 * @get_all.desc:	Block device descriptor
+	 * @get_all.func:	Function to call for each partition
+	 * @get_all.priv:	Private data to pass to @get_all.func
+	 * @get_all.Return:
+	 * 0 if OK, -ve if the table could not be read or @get_all.func failed
+	 */
+	int (*get_all)(struct blk_desc *desc, part_info_func_t func,
+		       void *priv);
 };
 
 /* Declare a new U-Boot partition 'driver' */
 #define U_BOOT_PART_TYPE(__name)					\
 	ll_entry_declare(struct part_driver, __name, part_driver)
 
+/**
+ * struct part_cache_stats - Statistics for the partition cache
+ *
+ * @hits: Number of lookups answered from the cache
+ * @misses: Number of lookups passed to the partition driver
+ * @reads: Number of times a whole partition table was read
+ * @entries: Number of block devices with cached information
+ */
+struct part_cache_stats {
+	ulong hits;
+	ulong misses;
+	ulong reads;
+	uint entries;
+};
+
+#if CONFIG_IS_ENABLED(PARTITION_CACHE)
+/**
+ * part_cache_get_info() - Get information about a partition, using the cache
+ *
+ * If the information is not in the cache, this uses the driver to get it and
+ * adds it to the cache. The first time a device is looked up, the whole
+ * partition table is read if the driver supports that.
+ *
+ * @desc:	Block device descriptor
+ * @drv:	Partition driver for the device
+ * @part:	Partition number (1 = first)
+ * @info:	Returns partition information
+ * Return: 0 if OK, -ENOENT if the partition does not exist, other -ve value
+ * from the driver on error
+ */
+int part_cache_get_info(struct blk_desc *desc, struct part_driver *drv,
+			int part, struct disk_partition *info);
+
+/**
+ * part_cache_invalidate() - Drop cached information for a block device
+ *
+ * This is called when the device is written or erased, or its partition table
+ * is read again. Information for all hardware partitions is dropped.
+ *
+ * @desc:	Block device descriptor
+ */
+void part_cache_invalidate(struct blk_desc *desc);
+
+/**
+ * part_cache_stats() - Get partition-cache statistics and reset them
+ *
+ * @stats:	Returns the statistics
+ */
+void part_cache_stats(struct part_cache_stats *stats);
+
+/** part_cache_free() - Free all memory allocated to the partition cache */
+void part_cache_free(void);
+#else
+static inline int part_cache_get_info(struct blk_desc *desc,
+				      struct part_driver *drv, int part,
+				      struct disk_partition *info)
+{
+	return drv->get_info(desc, part, info);
+}
+
+static inline void part_cache_invalidate(struct blk_desc *desc) {}
+static inline void part_cache_stats(struct part_cache_stats *stats) {}
+static inline void part_cache_free(void) {}
+#endif
+
 #include <part_efi.h>
 
 #if CONFIG_IS_ENABLED(EFI_PARTITION)
@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Sampling profiler
+ *
+ * The profiler periodically records the program counter and the call stack
+ * (found by following frame pointers) into a buffer. The samples can be
+ * written out in the same format as the trace output (see trace.h), so that
+ * proftool can turn them into a flame graph.
+ */
+
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#include <linux/types.h>
+
+/* Maximum number of stack frames recorded in each sample */
+#define PROFILER_MAX_DEPTH	32
+
+/**
+ * struct profiler_stats - Information about the samples taken
+ *
+ * @rate_hz: Sample rate requested, in Hz
+ * @samples: Number of samples recorded
+ * @dropped: Number of samples dropped since the buffer was full
+ * @outside: Number of samples with a program counter outside U-Boot
+ * @used: Number of bytes of the buffer used
+ * @size: Size of the buffer in bytes
+ */
+struct profiler_stats {
+	uint rate_hz;
+	ulong samples;
+	ulong dropped;
+	ulong outside;
+	ulong used;
+	ulong size;
+};
+
+/**
+ * profiler_start() - Start taking samples
+ *
+ * Any previous samples are discarded
+ *
+ * @buf: Buffer to hold the samples, which must be 4-byte aligned
+ * @size: Size of the buffer in bytes
+ * @rate_hz: Number of samples to take per second
+ * Return: 0 if OK, -EALREADY if already running, -ENOSYS if there is no
+ *	sample timer on this architecture, other -ve on error
+ */
+int profiler_start(void *buf, ulong size, uint rate_hz);
+
+/**
+ * profiler_stop() - Stop taking samples
+ *
+ * The samples remain in the buffer until profiler_start() is called again
+ *
+ * Return: 0 if OK, -EALREADY if not running
+ */
+int profiler_stop(void);
+
+/**
+ * profiler_running() - Check whether samples are being taken
+ *
+ * Return: true if the profiler is running
+ */
+bool profiler_running(void);
+
+/**
+ * profiler_sample() - Record a sample
+ *
+ * This is called from the architecture's sample timer, in interrupt (or
+ * signal) context, so must not call anything which might not be re-entrant.
+ *
+ * @pc: Program counter which was interrupted
+ * @fp: Frame pointer at the time, or 0 if not known
+ */
+void profiler_sample(ulong pc, ulong fp);
+
+/**
+ * profiler_get_stats() - Get information about the samples taken
+ *
+ * @stats: Returns the information
+ */
+void profiler_get_stats(struct profiler_stats *stats);
+
+/**
+ * profiler_list_samples() - Write the samples into a buffer
+ *
+ * This writes a struct trace_output_hdr of type TRACE_CHUNK_SAMPLES followed
+ * by the samples, each a struct trace_output_sample followed by its offsets.
+ * The @needed parameter returns the number of bytes needed, which may be more
+ * than @buf_size if the buffer is too small.
+ *
+ * @buf: Buffer in which to place the data
+ * @buf_size: Size of buffer in bytes
+ * @needed: Returns number of bytes used / needed
+ * Return: 0 if OK, -ENOSPC if the buffer is too small
+ */
+int profiler_list_samples(void *buf, ulong buf_size, ulong *needed);
+
+/**
+ * arch_profiler_start() - Start the sample timer
+ *
+ * The architecture must call profiler_sample() from its timer interrupt at
+ * (roughly) the given rate. The default implementation returns -ENOSYS.
+ *
+ * @rate_hz: Number of samples to take per second
+ * Return: 0 if OK, -ve on error
+ */
+int arch_profiler_start(uint rate_hz);
+
+/**
+ * arch_profiler_stop() - Stop the sample timer
+ */
+void arch_profiler_stop(void);
+
+#endif
@@ -47,6 +47,8 @@ struct hsearch_data {
 	struct env_entry_node *table;
 	unsigned int size;
 	unsigned int filled;
+	/* Number of deleted entries still taking up a slot in the table */
+	unsigned int deleted;
 /*
  * Callback function which will check whether the given change for variable
  * "item" to "newval" may be applied or not, and possibly apply such change.
@@ -58,7 +60,22 @@ struct hsearch_data {
 			 enum env_op, int flag);
 };
 
-/* Create a new hash table which will contain at most "nel" elements.  */
+/**
+ * hash_string() - Compute a hash value for a string
+ *
+ * This uses the 32-bit FNV-1a hash, which mixes every character into all bits
+ * of the result, unlike a simple shift-and-add, which only looks at the last
+ * few characters of long strings.
+ *
+ * @str: String to hash
+ * Return: hash value
+ */
+unsigned int hash_string(const char *str);
+
+/*
+ * Create a new hash table which will initially hold "nel" elements. The
+ * table grows as needed when entries are added.
+ */
 int hcreate_r(size_t nel, struct hsearch_data *htab);
 
 /* Destroy current internal hash table.  */
@@ -69,6 +86,9 @@ void hdestroy_r(struct hsearch_data *htab);
  * action is `ENV_FIND' return found entry or signal error by returning
  * NULL.  If action is `ENV_ENTER' replace existing data (if any) with
  * item.data.
+ *
+ * The returned entry is only valid until the next ENV_ENTER action, which
+ * may move the entries if the table grows.
  * */
 int hsearch_r(struct env_entry item, enum env_action action,
 	      struct env_entry **retval, struct hsearch_data *htab, int flag);
@@ -1,7 +1,9 @@
 #ifndef __SERIAL_H__
 #define __SERIAL_H__
 
+#include <cyclic.h>
 #include <post.h>
+#include <linux/errno.h>
 
 struct serial_device {
 	/* enough bytes to match alignment of following func pointer */
@@ -294,6 +296,16 @@ struct dm_serial_ops {
  * @buf:	Pointer to the RX buffer
  * @rd_ptr:	Read pointer in the RX buffer
  * @wr_ptr:	Write pointer in the RX buffer
+ *
+ * @tx_dev:	Device which owns this TX buffer, NULL if the buffer is not used
+ * @tx_cyclic:	Cyclic function which drains the TX buffer
+ * @tx_buf:	TX buffer
+ * @tx_rd:	Read pointer in the TX buffer
+ * @tx_wr:	Write pointer in the TX buffer
+ * @tx_busy:	true while the TX buffer is being drained
+ * @tx_overflows: Number of times output had to wait for space in the buffer
+ * @tx_dropped:	Number of characters dropped, due to driver errors or because
+ *		the buffer was full while being drained
  */
 struct serial_dev_priv {
 	struct stdio_dev *sdev;
@@ -303,6 +315,31 @@ struct serial_dev_priv {
 	uint rd_ptr;
 	uint wr_ptr;
 #endif
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+	struct udevice *tx_dev;
+	struct cyclic_info tx_cyclic;
+	char tx_buf[CONFIG_SERIAL_TX_BUFFER_SIZE];
+	uint tx_rd;
+	uint tx_wr;
+	bool tx_busy;
+	ulong tx_overflows;
+	ulong tx_dropped;
+#endif
+};
+
+/**
+ * struct serial_tx_stats - information about a serial TX buffer
+ *
+ * @used:	Number of characters waiting in the buffer
+ * @size:	Size of the buffer
+ * @overflows:	Number of times output had to wait for space in the buffer
+ * @dropped:	Number of characters dropped
+ */
+struct serial_tx_stats {
+	uint used;
+	uint size;
+	ulong overflows;
+	ulong dropped;
 };
 
 /* Access the serial operations for a device */
@@ -341,6 +378,23 @@ int serial_setconfig(struct udevice *dev, uint config);
  */
 int serial_getinfo(struct udevice *dev, struct serial_device_info *info);
 
+/**
+ * serial_get_tx_stats() - Get information about a device's TX buffer
+ *
+ * @dev: Device pointer
+ * @stats: Returns the information
+ * Return: 0 if OK, -ENOSYS if the device does not use a TX buffer
+ */
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+int serial_get_tx_stats(struct udevice *dev, struct serial_tx_stats *stats);
+#else
+static inline int serial_get_tx_stats(struct udevice *dev,
+				      struct serial_tx_stats *stats)
+{
+	return -ENOSYS;
+}
+#endif
+
 /**
  * fetch_baud_from_dtb() - Fetch the baudrate value from DT
  *
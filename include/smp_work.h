@@ -0,0 +1,315 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Offloading of simple jobs to secondary CPUs
+ *
+ * U-Boot runs on the boot CPU only. On SMP systems the remaining CPUs are
+ * normally held in firmware (PSCI) or a spin table until the OS starts them.
+ * This API lets boot code hand self-contained jobs, such as hashing an image
+ * or copying a memory range, to those CPUs and wait for them to complete.
+ *
+ * Jobs run with a private copy of the global data and must not use the
+ * console, malloc(), driver model or anything else which is not safe to call
+ * concurrently with the boot CPU. When no secondary CPU is available, jobs
+ * are simply run on the boot CPU when posted.
+ */
+
+#ifndef __SMP_WORK_H
+#define __SMP_WORK_H
+
+#include <linux/errno.h>
+#include <linux/string.h>
+#include <linux/types.h>
+
+struct global_data;
+
+/**
+ * enum smp_work_state - State of a job
+ *
+ * @SMP_WORK_IDLE: Job has not been posted
+ * @SMP_WORK_QUEUED: Job has been posted but not started yet
+ * @SMP_WORK_RUNNING: Job is running
+ * @SMP_WORK_DONE: Job has completed, @ret holds its result
+ */
+enum smp_work_state {
+	SMP_WORK_IDLE,
+	SMP_WORK_QUEUED,
+	SMP_WORK_RUNNING,
+	SMP_WORK_DONE,
+};
+
+/**
+ * smp_work_func_t() - Function run by a job
+ *
+ * @arg: Argument provided in struct smp_work
+ * Return: 0 if OK, -ve on error
+ */
+typedef int (*smp_work_func_t)(void *arg);
+
+/**
+ * struct smp_work - A job to run on a secondary CPU
+ *
+ * @func: Function to run
+ * @arg: Argument to pass to @func
+ * @ret: Return value from @func, valid once @state is SMP_WORK_DONE
+ * @cpu: CPU which ran the job (0 for the boot CPU, else 1 + worker number)
+ * @state: Current state (enum smp_work_state)
+ */
+struct smp_work {
+	smp_work_func_t func;
+	void *arg;
+	int ret;
+	int cpu;
+	int state;
+};
+
+/**
+ * struct smp_work_cpu - Per-CPU state of a secondary CPU accepting work
+ *
+ * The first two members are read by the architecture entry code before the
+ * C environment is set up, so must stay at the start of the struct.
+ *
+ * @stack_top: Initial stack pointer for this CPU
+ * @gd: Global data for this CPU (a copy of the boot CPU's, marked with
+ *	GD_FLG_SMP_WORKER)
+ * @idx: Worker number, counting from 0
+ * @work: Job to run next, or NULL if idle. Set by the boot CPU, cleared by
+ *	the worker once the job is done
+ * @stop: Set by the boot CPU to ask the worker to stop
+ * @running: Set by the worker while it is accepting work
+ * @jobs: Number of jobs completed by this worker
+ * @stack: Base of the stack allocation
+ */
+struct smp_work_cpu {
+	ulong stack_top;
+	struct global_data *gd;
+	int idx;
+	struct smp_work *work;
+	bool stop;
+	bool running;
+	ulong jobs;
+	void *stack;
+};
+
+/**
+ * struct smp_work_hash - A job to hash a buffer
+ *
+ * @work: Job information
+ * @algo: Name of hash algorithm, e.g. "sha256"
+ * @data: Data to hash
+ * @size: Size of the data in bytes
+ * @value: Place to put the hash value, must be large enough for @algo
+ * @value_len: Returns the size of the hash value in bytes
+ */
+struct smp_work_hash {
+	struct smp_work work;
+	const char *algo;
+	const void *data;
+	size_t size;
+	u8 *value;
+	int value_len;
+};
+
+/**
+ * smp_work_setup() - Set up a job ready for posting
+ *
+ * @work: Job to set up
+ * @func: Function to run
+ * @arg: Argument to pass to @func
+ */
+static inline void smp_work_setup(struct smp_work *work, smp_work_func_t func,
+				  void *arg)
+{
+	work->func = func;
+	work->arg = arg;
+	work->ret = 0;
+	work->cpu = 0;
+	work->state = SMP_WORK_IDLE;
+}
+
+#if CONFIG_IS_ENABLED(SMP_WORK)
+/**
+ * smp_work_init() - Start the secondary CPUs ready to accept work
+ *
+ * This is called automatically on the first smp_work_post() and it is safe to
+ * call it more than once.
+ *
+ * Return: number of secondary CPUs available (which may be 0)
+ */
+int smp_work_init(void);
+
+/**
+ * smp_work_stop() - Stop all secondary CPUs
+ *
+ * This must be called before handing the secondary CPUs over to the OS. Any
+ * posted jobs must have completed. This also stops any CPU which was started
+ * but did not report in time, in case it comes up later. The CPUs are started
+ * again by the next call to smp_work_init() or smp_work_post().
+ */
+void smp_work_stop(void);
+
+/**
+ * smp_work_post() - Post a job to an idle secondary CPU
+ *
+ * If all secondary CPUs are busy (or there are none), the job is run on the
+ * boot CPU before this function returns. Either way, smp_work_wait() must be
+ * used to collect the result. This must only be called on the boot CPU.
+ *
+ * @work: Job to post, with @func and @arg set up
+ * Return: 0 if OK, -ve on error
+ */
+int smp_work_post(struct smp_work *work);
+
+/**
+ * smp_work_wait() - Wait for a job to complete
+ *
+ * @work: Job previously posted with smp_work_post()
+ * Return: return value of the job's function, -ENOENT if not posted
+ */
+int smp_work_wait(struct smp_work *work);
+
+/**
+ * smp_work_num_workers() - Get the number of secondary CPUs accepting work
+ *
+ * Return: number of workers, 0 if there are none or smp_work_init() has not
+ * been called
+ */
+int smp_work_num_workers(void);
+
+/**
+ * smp_work_loop() - Process jobs on a secondary CPU
+ *
+ * This is called by the architecture code on each secondary CPU once it has
+ * a stack, global data and caches set up. It returns when the boot CPU calls
+ * smp_work_stop().
+ *
+ * @cpu: State for this CPU
+ */
+void smp_work_loop(struct smp_work_cpu *cpu);
+
+/**
+ * arch_smp_work_start() - Start a secondary CPU
+ *
+ * The architecture code must start the @cpu->idx'th secondary CPU (not
+ * counting the boot CPU) such that it calls smp_work_loop() with @cpu
+ *
+ * @cpu: State for the CPU, with @stack_top and @gd set up
+ * Return: 0 if OK, -ENODEV if there is no such CPU, other -ve on error
+ */
+int arch_smp_work_start(struct smp_work_cpu *cpu);
+
+/**
+ * arch_smp_work_stop() - Tidy up after a secondary CPU has stopped
+ *
+ * This is called on the boot CPU once @cpu->stop is set and should wait until
+ * the CPU is powered down or parked. It is also called for a CPU which did
+ * not start in time and may never have entered smp_work_loop().
+ *
+ * @cpu: State for the CPU
+ * Return: 0 if the CPU is stopped and its memory can be freed, -ETIMEDOUT if
+ * it may still be running, other -ve on error
+ */
+int arch_smp_work_stop(struct smp_work_cpu *cpu);
+
+/**
+ * smp_work_run_all() - Post a list of jobs and wait for them all
+ *
+ * @works: Jobs to run, each set up with smp_work_setup()
+ * @count: Number of jobs
+ * Return: 0 if all jobs succeeded, else the first error returned
+ */
+int smp_work_run_all(struct smp_work *works, int count);
+
+/**
+ * smp_work_memcpy() - Copy a memory range, split across all CPUs
+ *
+ * The ranges must not overlap
+ *
+ * @dst: Destination address
+ * @src: Source address
+ * @len: Number of bytes to copy
+ * Return: 0 if OK, -ve on error
+ */
+int smp_work_memcpy(void *dst, const void *src, size_t len);
+
+/**
+ * smp_work_memset() - Fill a memory range, split across all CPUs
+ *
+ * @dst: Destination address
+ * @val: Byte value to fill with
+ * @len: Number of bytes to fill
+ * Return: 0 if OK, -ve on error
+ */
+int smp_work_memset(void *dst, int val, size_t len);
+
+/**
+ * smp_work_hash_post() - Post a job to hash a buffer
+ *
+ * Use smp_work_wait(&hash->work) to collect the result
+ *
+ * @hash: Hash job to post, with @algo, @data, @size and @value set up
+ * Return: 0 if OK, -ve on error
+ */
+int smp_work_hash_post(struct smp_work_hash *hash);
+#else
+static inline int smp_work_init(void)
+{
+	return 0;
+}
+
+static inline void smp_work_stop(void)
+{
+}
+
+static inline int smp_work_post(struct smp_work *work)
+{
+	/* There are no workers, so just run it here */
+	work->ret = work->func(work->arg);
+	work->cpu = 0;
+	work->state = SMP_WORK_DONE;
+
+	return 0;
+}
+
+static inline int smp_work_wait(struct smp_work *work)
+{
+	if (work->state == SMP_WORK_IDLE)
+		return -ENOENT;
+
+	return work->ret;
+}
+
+static inline int smp_work_num_workers(void)
+{
+	return 0;
+}
+
+static inline int smp_work_run_all(struct smp_work *works, int count)
+{
+	int ret = 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		smp_work_post(&works[i]);
+		if (!ret)
+			ret = smp_work_wait(&works[i]);
+	}
+
+	return ret;
+}
+
+static inline int smp_work_memcpy(void *dst, const void *src, size_t len)
+{
+	memcpy(dst, src, len);
+
+	return 0;
+}
+
+static inline int smp_work_memset(void *dst, int val, size_t len)
+{
+	memset(dst, val, len);
+
+	return 0;
+}
+#endif /* SMP_WORK */
+
+#endif
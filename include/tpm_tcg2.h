@@ -11,6 +11,9 @@
 #define __TPM_TCG_V2_H
 
 #include <tpm-v2.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
 
 /*
  * event types, cf.
@@ -170,6 +173,68 @@ struct tcg2_event_log {
 	bool found;
 };
 
+/**
+ * struct tcg2_digest_ctx - Context for hashing data for all active PCR banks
+ *
+ * This allows the digests for every active bank to be calculated in a single
+ * pass over the data, which may be added in several parts.
+ *
+ * @active:	Active PCR banks (TCG2_BOOT_HASH_ALG_...)
+ * @sha1:	SHA1 context
+ * @sha256:	SHA256 context
+ * @sha384:	SHA384 context
+ * @sha512:	SHA512 context
+ */
+struct tcg2_digest_ctx {
+	u32 active;
+	sha1_context sha1;
+	sha256_context sha256;
+	sha512_context sha384;
+	sha512_context sha512;
+};
+
+/**
+ * tcg2_digest_init() - Start calculating digests for a set of PCR banks
+ *
+ * Banks whose algorithm is not supported are dropped from @active.
+ *
+ * @ctx:	Context to set up
+ * @active:	PCR banks to calculate digests for (TCG2_BOOT_HASH_ALG_...)
+ */
+void tcg2_digest_init(struct tcg2_digest_ctx *ctx, u32 active);
+
+/**
+ * tcg2_digest_start() - Start calculating digests for the active PCR banks
+ *
+ * @dev:	TPM device
+ * @ctx:	Context to set up
+ * Return: zero on success, negative errno otherwise
+ */
+int tcg2_digest_start(struct udevice *dev, struct tcg2_digest_ctx *ctx);
+
+/**
+ * tcg2_digest_update() - Add data to the digests of the active PCR banks
+ *
+ * The data is processed a few KB at a time, each part being added to every
+ * digest while it is still in the CPU cache, so that it is only read from
+ * memory once.
+ *
+ * @ctx:	Context, set up by tcg2_digest_start() or tcg2_digest_init()
+ * @input:	Data to add
+ * @length:	Length of the data in bytes
+ */
+void tcg2_digest_update(struct tcg2_digest_ctx *ctx, const u8 *input,
+			u32 length);
+
+/**
+ * tcg2_digest_finish() - Finish the digests of the active PCR banks
+ *
+ * @ctx:	Context, set up by tcg2_digest_start() or tcg2_digest_init()
+ * @digest_list: List of digests to fill in
+ */
+void tcg2_digest_finish(struct tcg2_digest_ctx *ctx,
+			struct tpml_digest_values *digest_list);
+
 /**
  * Create a list of digests of the supported PCR banks for a given input data
  *
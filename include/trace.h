@@ -34,6 +34,7 @@ enum {
 enum trace_chunk_type {
 	TRACE_CHUNK_FUNCS,
 	TRACE_CHUNK_CALLS,
+	TRACE_CHUNK_SAMPLES,	/* see struct trace_output_sample */
 };
 
 /* A trace record for a function, as written to the profile output file */
@@ -42,6 +43,16 @@ struct trace_output_func {
 	uint32_t call_count;		/* Number of times called */
 };
 
+/*
+ * A sample from the sampling profiler, as written to the profile output file.
+ * This is followed by @depth function offsets (uint32_t) into the code,
+ * starting with the sampled program counter and followed by the return
+ * address in each caller. Offsets are in bytes, not function sites.
+ */
+struct trace_output_sample {
+	uint32_t depth;			/* Number of offsets which follow */
+};
+
 /* A header at the start of the trace output buffer */
 struct trace_output_hdr {
 	enum trace_chunk_type type;	/* Record type */
@@ -49,12 +60,22 @@ struct trace_output_hdr {
 	uint32_t rec_count;		/* Number of records */
 	uint32_t spare;			/* 0 */
 	uint64_t text_base;		/* Value of CONFIG_TEXT_BASE */
-	uint64_t spare2;		/* 0 */
+	uint64_t tick_rate;		/* Timestamp rate in Hz, 0 if in us */
 };
 
 /* Print statistics about traced function calls */
 void trace_print_stats(void);
 
+/**
+ * trace_print_func_times() - Print the functions which took the most time
+ *
+ * This needs CONFIG_TRACE_FUNC_TIMES. Functions are sorted by the time spent
+ * in the function itself, excluding the functions it called.
+ *
+ * @count: Maximum number of functions to show
+ */
+void trace_print_func_times(int count);
+
 /**
  * Dump a list of functions and call counts into a buffer
  *
@@ -73,7 +94,12 @@ int trace_list_functions(void *buff, size_t buff_size, size_t *needed);
 enum ftrace_flags {
 	FUNCF_EXIT		= 0UL << 30,
 	FUNCF_ENTRY		= 1UL << 30,
-	/* two more values are available */
+	/*
+	 * Timestamp resync: func and caller hold bits 30-61 and 62-63 of the
+	 * timestamp, which applies to all following records
+	 */
+	FUNCF_TIME_HI		= 2UL << 30,
+	/* one more value is available */
 
 	FUNCF_TIMESTAMP_MASK	= 0x3fffffff,
 };
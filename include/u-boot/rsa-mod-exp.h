@@ -64,6 +64,42 @@ void rsa_free_key_prop(struct key_prop *prop);
 int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 		struct key_prop *node, uint8_t *out);
 
+/**
+ * rsa_mod_exp_simple() - Perform RSA Modular Exponentiation using 32-bit words
+ *
+ * Operation: out[] = sig ^ exponent % modulus
+ *
+ * This is the original implementation, using square-and-multiply. It is used
+ * by rsa_mod_exp_sw() unless CONFIG_RSA_SOFTWARE_EXP_FAST is enabled and
+ * supports the key size.
+ *
+ * @sig:	RSA PKCS1.5 signature
+ * @sig_len:	Length of signature in number of bytes
+ * @node:	Node with RSA key elements like modulus, exponent, R^2, n0inv
+ * @out:	Result in form of byte array of len equal to sig_len
+ * Return:	0 if OK, -ve on error
+ */
+int rsa_mod_exp_simple(const uint8_t *sig, uint32_t sig_len,
+		       struct key_prop *node, uint8_t *out);
+
+/**
+ * rsa_mod_exp_fast() - Perform RSA Modular Exponentiation using native limbs
+ *
+ * Operation: out[] = sig ^ exponent % modulus
+ *
+ * This is used by rsa_mod_exp_sw() when CONFIG_RSA_SOFTWARE_EXP_FAST is
+ * enabled.
+ *
+ * @sig:	RSA PKCS1.5 signature
+ * @sig_len:	Length of signature in number of bytes
+ * @node:	Node with RSA key elements like modulus, exponent, R^2
+ * @out:	Result in form of byte array of len equal to sig_len
+ * Return:	0 if OK, -E2BIG if the key size is not a multiple of the limb
+ *		size, other -ve on error
+ */
+int rsa_mod_exp_fast(const uint8_t *sig, uint32_t sig_len,
+		     struct key_prop *node, uint8_t *out);
+
 int rsa_mod_exp(struct udevice *dev, const uint8_t *sig, uint32_t sig_len,
 		struct key_prop *node, uint8_t *out);
 
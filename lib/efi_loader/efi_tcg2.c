@@ -382,10 +382,9 @@ static efi_status_t tcg2_hash_pe_image(void *efi, u64 efi_size,
 	size_t wincerts_len;
 	struct efi_image_regions *regs = NULL;
 	void *new_efi = NULL;
-	u8 hash[TPM2_SHA512_DIGEST_SIZE];
+	struct tcg2_digest_ctx ctx;
 	struct udevice *dev;
 	efi_status_t ret = EFI_SUCCESS;
-	u32 active;
 	int i;
 
 	new_efi = efi_prepare_aligned_image(efi, &efi_size);
@@ -404,38 +403,14 @@ static efi_status_t tcg2_hash_pe_image(void *efi, u64 efi_size,
 		goto out;
 	}
 
-	if (tcg2_get_active_pcr_banks(dev, &active)) {
+	/* Hash each region once, for all the active PCR banks */
+	if (tcg2_digest_start(dev, &ctx)) {
 		ret = EFI_DEVICE_ERROR;
 		goto out;
 	}
-
-	digest_list->count = 0;
-	for (i = 0; i < ARRAY_SIZE(hash_algo_list); i++) {
-		u16 hash_alg = hash_algo_list[i].hash_alg;
-
-		if (!(active & hash_algo_list[i].hash_mask))
-			continue;
-		switch (hash_alg) {
-		case TPM2_ALG_SHA1:
-			hash_calculate("sha1", regs->reg, regs->num, hash);
-			break;
-		case TPM2_ALG_SHA256:
-			hash_calculate("sha256", regs->reg, regs->num, hash);
-			break;
-		case TPM2_ALG_SHA384:
-			hash_calculate("sha384", regs->reg, regs->num, hash);
-			break;
-		case TPM2_ALG_SHA512:
-			hash_calculate("sha512", regs->reg, regs->num, hash);
-			break;
-		default:
-			continue;
-		}
-		digest_list->digests[digest_list->count].hash_alg = hash_alg;
-		memcpy(&digest_list->digests[digest_list->count].digest, hash,
-		       (u32)tpm2_algorithm_to_len(hash_alg));
-		digest_list->count++;
-	}
+	for (i = 0; i < regs->num; i++)
+		tcg2_digest_update(&ctx, regs->reg[i].data, regs->reg[i].size);
+	tcg2_digest_finish(&ctx, digest_list);
 
 out:
 	if (new_efi != efi)
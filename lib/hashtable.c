@@ -83,6 +83,57 @@ static int isprime(unsigned int number)
 	return number % div != 0;
 }
 
+/* Change nel to the first prime number not smaller as nel. */
+static unsigned int next_prime(unsigned int nel)
+{
+	nel |= 1;		/* make odd */
+	while (!isprime(nel))
+		nel += 2;
+
+	return nel;
+}
+
+unsigned int hash_string(const char *str)
+{
+	unsigned int hval = 2166136261U;
+
+	while (*str) {
+		hval ^= (unsigned char)*str++;
+		hval *= 16777619U;
+	}
+
+	return hval;
+}
+
+/*
+ * First hash function:
+ * simply take the modul but prevent zero.
+ */
+static unsigned int hash_first(unsigned int hval, unsigned int size)
+{
+	hval %= size;
+	if (hval == 0)
+		++hval;
+
+	return hval;
+}
+
+/*
+ * Second hash function:
+ * as suggested in [Knuth]. Because the size is prime this guarantees to step
+ * through all available indices.
+ */
+static unsigned int hash_next(unsigned int idx, unsigned int hval,
+			      unsigned int size)
+{
+	unsigned int hval2 = 1 + hval % (size - 2);
+
+	if (idx <= hval2)
+		return size + idx - hval2;
+
+	return idx - hval2;
+}
+
 /*
  * Before using the hash table we must allocate memory for it.
  * Test for an existing table are done. We allocate one element
@@ -106,13 +157,9 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 		return 0;
 	}
 
-	/* Change nel to the first prime number not smaller as nel. */
-	nel |= 1;		/* make odd */
-	while (!isprime(nel))
-		nel += 2;
-
-	htab->size = nel;
+	htab->size = next_prime(nel);
 	htab->filled = 0;
+	htab->deleted = 0;
 
 	/* allocate memory and zero out */
 	htab->table = (struct env_entry_node *)calloc(htab->size + 1,
@@ -168,8 +215,9 @@ void hdestroy_r(struct hsearch_data *htab)
  * This is the search function. It uses double hashing with open addressing.
  * The argument item.key has to be a pointer to an zero terminated, most
  * probably strings of chars. The function for generating a number of the
- * strings is simple but fast. It can be replaced by a more complex function
- * like ajw (see [Aho,Sethi,Ullman]) if the needs are shown.
+ * strings is FNV-1a, which is simple but fast and spreads the values well.
+ * The table is grown when it gets too full, so the search stays fast as
+ * more entries are added.
  *
  * We use an trick to speed up the lookup. The table is created by hcreate
  * with one more element available. This enables us to use the index zero
@@ -197,6 +245,76 @@ void hdestroy_r(struct hsearch_data *htab)
  *   example for functions like hdelete().
  */
 
+/*
+ * hresize()
+ */
+
+/*
+ * The table is rebuilt when it gets too full, since with open addressing
+ * the lookup time increases quickly as the free slots run out. Deleted
+ * entries also take up slots until the table is rebuilt, so they are
+ * counted too.
+ *
+ * If the live entries take up more than half of the table it is doubled in
+ * size, otherwise it is rebuilt at the same size, which just drops the
+ * deleted entries. Either way the table ends up at most half full, so the
+ * cost of rebuilding it is spread over many insertions.
+ *
+ * This moves every entry in one go, rather than a few at a time during
+ * later operations, since callers hold the index and entry pointers
+ * returned by hsearch_r() and hmatch_r(), which must refer to a single
+ * table. Those pointers are not valid after an insertion.
+ */
+static int hresize(struct hsearch_data *htab, unsigned int nel)
+{
+	struct env_entry_node *table;
+	unsigned int size, i;
+
+	size = next_prime(nel);
+	table = calloc(size + 1, sizeof(struct env_entry_node));
+	if (!table)
+		return -ENOMEM;
+
+	for (i = 1; i <= htab->size; ++i) {
+		struct env_entry_node *node = &htab->table[i];
+		unsigned int hval, idx;
+
+		if (node->used <= 0)
+			continue;
+		hval = hash_first(hash_string(node->entry.key), size);
+		idx = hval;
+		while (table[idx].used != USED_FREE)
+			idx = hash_next(idx, hval, size);
+		table[idx] = *node;
+		table[idx].used = hval;
+	}
+	debug("hresize: table %p, filled %d, size %d => %d\n", htab,
+	      htab->filled, htab->size, size);
+
+	free(htab->table);
+	htab->table = table;
+	htab->size = size;
+	htab->deleted = 0;
+
+	return 0;
+}
+
+/* Make room for a new entry, if the table is getting full */
+static void hgrow(struct hsearch_data *htab)
+{
+	unsigned int used = htab->filled + htab->deleted + 1;
+	unsigned int nel = htab->size;
+
+	if (used * 4 <= htab->size * 3)
+		return;
+	if ((htab->filled + 1) * 2 > htab->size)
+		nel = htab->size * 2;
+
+	/* If there is no memory, carry on with the existing table */
+	if (hresize(htab, nel))
+		debug("hresize: cannot resize table %p\n", htab);
+}
+
 int hmatch_r(const char *match, int last_idx, struct env_entry **retval,
 	     struct hsearch_data *htab)
 {
@@ -237,6 +355,8 @@ static inline int _compare_and_overwrite_entry(struct env_entry item,
 		struct hsearch_data *htab, int flag, unsigned int hval,
 		unsigned int idx)
 {
+	struct env_entry_node *table;
+
 	if (htab->table[idx].used == hval
 	    && strcmp(item.key, htab->table[idx].entry.key) == 0) {
 		/* Overwrite existing value? */
@@ -253,6 +373,7 @@ static inline int _compare_and_overwrite_entry(struct env_entry item,
 			}
 
 			/* If there is a callback, call it */
+			table = htab->table;
 			if (do_callback(&htab->table[idx].entry, item.key,
 					item.data, env_op_overwrite, flag)) {
 				debug("callback() rejected setting variable "
@@ -262,6 +383,19 @@ static inline int _compare_and_overwrite_entry(struct env_entry item,
 				return 0;
 			}
 
+			/*
+			 * The callback may set other variables, which can
+			 * resize the table, so find the entry again if that
+			 * happened
+			 */
+			if (htab->table != table) {
+				idx = hsearch_r(item, ENV_FIND, retval, htab, 0);
+				if (!*retval) {
+					__set_errno(ENOENT);
+					return 0;
+				}
+			}
+
 			free(htab->table[idx].entry.data);
 			htab->table[idx].entry.data = strdup(item.data);
 			if (!htab->table[idx].entry.data) {
@@ -281,28 +415,22 @@ static inline int _compare_and_overwrite_entry(struct env_entry item,
 int hsearch_r(struct env_entry item, enum env_action action,
 	      struct env_entry **retval, struct hsearch_data *htab, int flag)
 {
+	struct env_entry_node *table;
 	unsigned int hval;
-	unsigned int count;
-	unsigned int len = strlen(item.key);
 	unsigned int idx;
 	unsigned int first_deleted = 0;
 	int ret;
 
-	/* Compute an value for the given string. Perhaps use a better method. */
-	hval = len;
-	count = len;
-	while (count-- > 0) {
-		hval <<= 4;
-		hval += item.key[count];
-	}
-
 	/*
-	 * First hash function:
-	 * simply take the modul but prevent zero.
+	 * Grow the table first if needed, so that the index found below
+	 * remains valid. This is only needed when adding an entry, but that is
+	 * not known until the search is done, so updating an existing entry
+	 * may also cause the table to grow.
 	 */
-	hval %= htab->size;
-	if (hval == 0)
-		++hval;
+	if (action == ENV_ENTER)
+		hgrow(htab);
+
+	hval = hash_first(hash_string(item.key), htab->size);
 
 	/* The first index tried. */
 	idx = hval;
@@ -312,8 +440,6 @@ int hsearch_r(struct env_entry item, enum env_action action,
 		 * Further action might be required according to the
 		 * action value.
 		 */
-		unsigned hval2;
-
 		if (htab->table[idx].used == USED_DELETED)
 			first_deleted = idx;
 
@@ -322,21 +448,8 @@ int hsearch_r(struct env_entry item, enum env_action action,
 		if (ret != -1)
 			return ret;
 
-		/*
-		 * Second hash function:
-		 * as suggested in [Knuth]
-		 */
-		hval2 = 1 + hval % (htab->size - 2);
-
 		do {
-			/*
-			 * Because SIZE is prime this guarantees to
-			 * step through all available indices.
-			 */
-			if (idx <= hval2)
-				idx = htab->size + idx - hval2;
-			else
-				idx -= hval2;
+			idx = hash_next(idx, hval, htab->size);
 
 			/*
 			 * If we visited all entries leave the loop
@@ -374,8 +487,10 @@ int hsearch_r(struct env_entry item, enum env_action action,
 		 * Create new entry;
 		 * create copies of item.key and item.data
 		 */
-		if (first_deleted)
+		if (first_deleted) {
 			idx = first_deleted;
+			--htab->deleted;
+		}
 
 		htab->table[idx].used = hval;
 		htab->table[idx].entry.key = strdup(item.key);
@@ -406,8 +521,17 @@ int hsearch_r(struct env_entry item, enum env_action action,
 		}
 
 		/* If there is a callback, call it */
-		if (do_callback(&htab->table[idx].entry, item.key, item.data,
-				env_op_create, flag)) {
+		table = htab->table;
+		ret = do_callback(&htab->table[idx].entry, item.key, item.data,
+				  env_op_create, flag);
+
+		/*
+		 * The callback may set other variables, which can resize the
+		 * table, so find the new entry again if that happened
+		 */
+		if (htab->table != table)
+			idx = hsearch_r(item, ENV_FIND, retval, htab, 0);
+		if (ret) {
 			debug("callback() rejected setting variable "
 				"%s, skipping it!\n", item.key);
 			_hdelete(item.key, htab, &htab->table[idx].entry, idx);
@@ -447,6 +571,7 @@ static void _hdelete(const char *key, struct hsearch_data *htab,
 	htab->table[idx].used = USED_DELETED;
 
 	--htab->filled;
+	++htab->deleted;
 }
 
 int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
@@ -164,17 +164,43 @@ static long lmb_regions_adjacent(struct alist *lmb_rgn_lst, unsigned long r1,
 
 static void lmb_remove_region(struct alist *lmb_rgn_lst, unsigned long r)
 {
-	unsigned long i;
 	struct lmb_region *rgn = lmb_rgn_lst->data;
 
-	for (i = r; i < lmb_rgn_lst->count - 1; i++) {
-		rgn[i].base = rgn[i + 1].base;
-		rgn[i].size = rgn[i + 1].size;
-		rgn[i].flags = rgn[i + 1].flags;
-	}
+	memmove(&rgn[r], &rgn[r + 1],
+		(lmb_rgn_lst->count - r - 1) * sizeof(*rgn));
 	lmb_rgn_lst->count--;
 }
 
+/**
+ * lmb_find_region() - Find the first region which ends at or above an address
+ * @lmb_rgn_lst: LMB list to search
+ * @addr: Address to look for
+ *
+ * The regions in each list are kept sorted by address and do not overlap, so
+ * their end addresses are sorted too, which allows a binary search. This keeps
+ * lookups fast when there are hundreds of regions, e.g. with EFI.
+ *
+ * Return: index of the first region whose last byte is at or above @addr, or
+ * the number of regions if there is none
+ */
+static unsigned long lmb_find_region(struct alist *lmb_rgn_lst,
+				     phys_addr_t addr)
+{
+	struct lmb_region *rgn = lmb_rgn_lst->data;
+	unsigned long low = 0, high = lmb_rgn_lst->count;
+
+	while (low < high) {
+		unsigned long mid = low + (high - low) / 2;
+
+		if (rgn[mid].base + rgn[mid].size - 1 < addr)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
 /* Assumption: base addr of region 1 < base addr of region 2 */
 static void lmb_coalesce_regions(struct alist *lmb_rgn_lst, unsigned long r1,
 				 unsigned long r2)
@@ -196,11 +222,8 @@ static void lmb_fix_over_lap_regions(struct alist *lmb_rgn_lst,
 	phys_addr_t base2 = rgn[r2].base;
 	phys_size_t size2 = rgn[r2].size;
 
-	if (base1 + size1 > base2 + size2) {
-		printf("This will not be a case any time\n");
-		return;
-	}
-	rgn[r1].size = base2 + size2 - base1;
+	/* Region 1 may have grown past the end of region 2 */
+	rgn[r1].size = max(base1 + size1, base2 + size2) - base1;
 	lmb_remove_region(lmb_rgn_lst, r2);
 }
 
@@ -387,17 +410,27 @@ static long lmb_add_region_flags(struct alist *lmb_rgn_lst, phys_addr_t base,
 	unsigned long coalesced = 0;
 	long ret, i;
 	struct lmb_region *rgn = lmb_rgn_lst->data;
+	phys_addr_t end = base + size - 1;
 
 	if (alist_err(lmb_rgn_lst))
 		return -1;
 
-	/* First try and coalesce this LMB with another. */
-	for (i = 0; i < lmb_rgn_lst->count; i++) {
+	/*
+	 * First try and coalesce this LMB with another. Regions which end
+	 * below base - 1 cannot overlap or adjoin this one, so skip them.
+	 */
+	for (i = lmb_find_region(lmb_rgn_lst, base ? base - 1 : 0);
+	     i < lmb_rgn_lst->count; i++) {
 		phys_addr_t rgnbase = rgn[i].base;
 		phys_size_t rgnsize = rgn[i].size;
 		phys_size_t rgnflags = rgn[i].flags;
-		phys_addr_t end = base + size - 1;
 		phys_addr_t rgnend = rgnbase + rgnsize - 1;
+
+		/* This region and all those after it are out of reach */
+		if (rgnbase > end && rgnbase - end > 1) {
+			i = lmb_rgn_lst->count;
+			break;
+		}
 		if (rgnbase <= base && end <= rgnend) {
 			if (flags == rgnflags)
 				/* Already have this region, so we're done */
@@ -435,17 +468,23 @@ static long lmb_add_region_flags(struct alist *lmb_rgn_lst, phys_addr_t base,
 		}
 	}
 
-	if (lmb_rgn_lst->count && i < lmb_rgn_lst->count - 1) {
+	/*
+	 * The region may now reach the ones above it, so merge them for as
+	 * long as that is true
+	 */
+	while (lmb_rgn_lst->count && i < lmb_rgn_lst->count - 1) {
 		rgn = lmb_rgn_lst->data;
-		if (rgn[i].flags == rgn[i + 1].flags) {
-			if (lmb_regions_adjacent(lmb_rgn_lst, i, i + 1)) {
-				lmb_coalesce_regions(lmb_rgn_lst, i, i + 1);
-				coalesced++;
-			} else if (lmb_regions_overlap(lmb_rgn_lst, i, i + 1)) {
-				/* fix overlapping area */
-				lmb_fix_over_lap_regions(lmb_rgn_lst, i, i + 1);
-				coalesced++;
-			}
+		if (rgn[i].flags != rgn[i + 1].flags)
+			break;
+		if (lmb_regions_adjacent(lmb_rgn_lst, i, i + 1)) {
+			lmb_coalesce_regions(lmb_rgn_lst, i, i + 1);
+			coalesced++;
+		} else if (lmb_regions_overlap(lmb_rgn_lst, i, i + 1)) {
+			/* fix overlapping area */
+			lmb_fix_over_lap_regions(lmb_rgn_lst, i, i + 1);
+			coalesced++;
+		} else {
+			break;
 		}
 	}
 
@@ -458,16 +497,12 @@ static long lmb_add_region_flags(struct alist *lmb_rgn_lst, phys_addr_t base,
 	rgn = lmb_rgn_lst->data;
 
 	/* Couldn't coalesce the LMB, so add it to the sorted table. */
-	for (i = lmb_rgn_lst->count; i >= 0; i--) {
-		if (i && base < rgn[i - 1].base) {
-			rgn[i] = rgn[i - 1];
-		} else {
-			rgn[i].base = base;
-			rgn[i].size = size;
-			rgn[i].flags = flags;
-			break;
-		}
-	}
+	i = lmb_find_region(lmb_rgn_lst, base);
+	memmove(&rgn[i + 1], &rgn[i],
+		(lmb_rgn_lst->count - i) * sizeof(*rgn));
+	rgn[i].base = base;
+	rgn[i].size = size;
+	rgn[i].flags = flags;
 
 	lmb_rgn_lst->count++;
 
@@ -504,20 +539,17 @@ static long _lmb_free(phys_addr_t base, phys_size_t size)
 	phys_addr_t end = base + size - 1;
 	int i;
 
-	rgnbegin = rgnend = 0; /* supress gcc warnings */
 	rgn = lmb_rgn_lst->data;
 	/* Find the region where (base, size) belongs to */
-	for (i = 0; i < lmb_rgn_lst->count; i++) {
-		rgnbegin = rgn[i].base;
-		rgnend = rgnbegin + rgn[i].size - 1;
-
-		if ((rgnbegin <= base) && (end <= rgnend))
-			break;
-	}
+	i = lmb_find_region(lmb_rgn_lst, base);
 
 	/* Didn't find the region */
 	if (i == lmb_rgn_lst->count)
 		return -1;
+	rgnbegin = rgn[i].base;
+	rgnend = rgnbegin + rgn[i].size - 1;
+	if (rgnbegin > base || end > rgnend)
+		return -1;
 
 	/* Check to see if we are removing entire region */
 	if ((rgnbegin == base) && (rgnend == end)) {
@@ -603,14 +635,13 @@ static long lmb_overlaps_region(struct alist *lmb_rgn_lst, phys_addr_t base,
 	unsigned long i;
 	struct lmb_region *rgn = lmb_rgn_lst->data;
 
-	for (i = 0; i < lmb_rgn_lst->count; i++) {
-		phys_addr_t rgnbase = rgn[i].base;
-		phys_size_t rgnsize = rgn[i].size;
-		if (lmb_addrs_overlap(base, size, rgnbase, rgnsize))
-			break;
-	}
+	/* Only the first region ending at or above base can overlap first */
+	i = lmb_find_region(lmb_rgn_lst, base);
+	if (i < lmb_rgn_lst->count &&
+	    lmb_addrs_overlap(base, size, rgn[i].base, rgn[i].size))
+		return i;
 
-	return (i < lmb_rgn_lst->count) ? i : -1;
+	return -1;
 }
 
 static phys_addr_t lmb_align_down(phys_addr_t addr, phys_size_t size)
@@ -791,7 +822,7 @@ phys_addr_t lmb_alloc_addr_flags(phys_addr_t base, phys_size_t size,
 /* Return number of bytes from a given address that are free */
 phys_size_t lmb_get_free_size(phys_addr_t addr)
 {
-	int i;
+	unsigned long i;
 	long rgn;
 	struct lmb_region *lmb_used = lmb.used_mem.data;
 	struct lmb_region *lmb_memory = lmb.free_mem.data;
@@ -799,16 +830,14 @@ phys_size_t lmb_get_free_size(phys_addr_t addr)
 	/* check if the requested address is in the memory regions */
 	rgn = lmb_overlaps_region(&lmb.free_mem, addr, 1);
 	if (rgn >= 0) {
-		for (i = 0; i < lmb.used_mem.count; i++) {
+		i = lmb_find_region(&lmb.used_mem, addr);
+		if (i < lmb.used_mem.count) {
 			if (addr < lmb_used[i].base) {
 				/* first reserved range > requested address */
 				return lmb_used[i].base - addr;
 			}
-			if (lmb_used[i].base +
-			    lmb_used[i].size > addr) {
-				/* requested addr is in this reserved range */
-				return 0;
-			}
+			/* requested addr is in this reserved range */
+			return 0;
 		}
 		/* if we come here: no reserved ranges above requested addr */
 		return lmb_memory[lmb.free_mem.count - 1].base +
@@ -819,15 +848,13 @@ phys_size_t lmb_get_free_size(phys_addr_t addr)
 
 int lmb_is_reserved_flags(phys_addr_t addr, int flags)
 {
-	int i;
+	unsigned long i;
 	struct lmb_region *lmb_used = lmb.used_mem.data;
 
-	for (i = 0; i < lmb.used_mem.count; i++) {
-		phys_addr_t upper = lmb_used[i].base +
-			lmb_used[i].size - 1;
-		if (addr >= lmb_used[i].base && addr <= upper)
-			return (lmb_used[i].flags & flags) == flags;
-	}
+	i = lmb_find_region(&lmb.used_mem, addr);
+	if (i < lmb.used_mem.count && addr >= lmb_used[i].base)
+		return (lmb_used[i].flags & flags) == flags;
+
 	return 0;
 }
 
@@ -0,0 +1,347 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Memory test engine
+ *
+ * See include/memtest.h for an overview. The range is split into chunks of
+ * at most MEMTEST_CHUNK bytes, which are handed out to the CPUs a batch at a
+ * time, so that Ctrl-C is checked and the watchdog serviced regularly even
+ * when there are no secondary CPUs.
+ *
+ * Jobs may run on secondary CPUs, so they must not use the console. Errors
+ * are recorded in the job and reported by the boot CPU.
+ */
+
+#include <console.h>
+#include <cpu_func.h>
+#include <errno.h>
+#include <memtest.h>
+#include <smp_work.h>
+#include <time.h>
+#include <u-boot/schedule.h>
+#include <asm/cache.h>
+#include <linux/kernel.h>
+#include <linux/sizes.h>
+
+/* Number of words checked together, a cache line on most CPUs */
+#define MEMTEST_LINE_WORDS	8
+
+/* Maximum size of each job */
+#define MEMTEST_CHUNK		SZ_16M
+
+#if CONFIG_IS_ENABLED(SMP_WORK)
+#define MEMTEST_MAX_JOBS	(CONFIG_SMP_WORK_MAX_CPUS + 1)
+#else
+#define MEMTEST_MAX_JOBS	1
+#endif
+
+/**
+ * enum memtest_op - Operation carried out by a pass over memory
+ *
+ * @OP_WRITE: Write the expected value to each word
+ * @OP_CHECK: Check each word has the expected value
+ * @OP_CHECK_INVERT: Check each word, then write its inverse, going up
+ * @OP_CHECK_INVERT_DOWN: Check each word, then write its inverse, going down
+ */
+enum memtest_op {
+	OP_WRITE,
+	OP_CHECK,
+	OP_CHECK_INVERT,
+	OP_CHECK_INVERT_DOWN,
+};
+
+/* Passes for each test */
+static const enum memtest_op memtest_passes[MEMTEST_COUNT][4] = {
+	[MEMTEST_ADDRESS] = { OP_WRITE, OP_CHECK },
+	[MEMTEST_INVERSIONS] = { OP_WRITE, OP_CHECK_INVERT,
+				 OP_CHECK_INVERT_DOWN, OP_CHECK },
+	[MEMTEST_RANDOM] = { OP_WRITE, OP_CHECK },
+};
+
+static const int memtest_num_passes[MEMTEST_COUNT] = {
+	[MEMTEST_ADDRESS] = 2,
+	[MEMTEST_INVERSIONS] = 4,
+	[MEMTEST_RANDOM] = 2,
+};
+
+static const char *const memtest_names[MEMTEST_COUNT] = {
+	[MEMTEST_ADDRESS] = "address",
+	[MEMTEST_INVERSIONS] = "inversions",
+	[MEMTEST_RANDOM] = "random",
+};
+
+/**
+ * struct memtest_job - Part of a pass, run on one CPU
+ *
+ * @work: Job information
+ * @type: Test being run
+ * @op: Operation to carry out
+ * @buf: First word to test
+ * @addr: Address of @buf, used for the address test and for errors
+ * @first: Index of the first word, counting from the start of the range
+ * @words: Number of words to test
+ * @pattern: Pattern to use (inverted during the second inversions pass)
+ * @errors: Number of errors found
+ * @num_recorded: Number of errors recorded in @error
+ * @error: First errors found
+ */
+struct memtest_job {
+	struct smp_work work;
+	enum memtest_t type;
+	enum memtest_op op;
+	u64 *buf;
+	ulong addr;
+	ulong first;
+	ulong words;
+	u64 pattern;
+	ulong errors;
+	uint num_recorded;
+	struct memtest_error error[MEMTEST_MAX_ERRORS];
+};
+
+/* Mix the bits of a value, as in the splitmix64 generator */
+static u64 memtest_mix(u64 val)
+{
+	val += 0x9e3779b97f4a7c15ULL;
+	val = (val ^ (val >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	val = (val ^ (val >> 27)) * 0x94d049bb133111ebULL;
+
+	return val ^ (val >> 31);
+}
+
+/*
+ * Get the value expected in word @i of a job. This is inlined into each loop
+ * with a constant @type, so that the switch disappears.
+ */
+static __always_inline u64 memtest_value(const struct memtest_job *job,
+					 enum memtest_t type, ulong i)
+{
+	switch (type) {
+	case MEMTEST_ADDRESS:
+		return (job->addr + i * sizeof(u64)) ^ job->pattern;
+	case MEMTEST_RANDOM:
+		return memtest_mix((job->first + i) ^ job->pattern);
+	default:
+		return job->pattern;
+	}
+}
+
+static void memtest_record(struct memtest_job *job, ulong i, u64 expect,
+			   u64 found)
+{
+	struct memtest_error *err;
+
+	job->errors++;
+	if (job->num_recorded == MEMTEST_MAX_ERRORS)
+		return;
+	err = &job->error[job->num_recorded++];
+	err->addr = job->addr + i * sizeof(u64);
+	err->expect = expect;
+	err->found = found;
+}
+
+static __always_inline void memtest_write(struct memtest_job *job,
+					  enum memtest_t type)
+{
+	u64 *buf = job->buf;
+	ulong i;
+
+	for (i = 0; i < job->words; i++)
+		buf[i] = memtest_value(job, type, i);
+}
+
+/*
+ * Check a cache line at a time, only looking at the individual words when
+ * something in the line is wrong
+ */
+static __always_inline void memtest_check(struct memtest_job *job,
+					  enum memtest_t type, bool invert)
+{
+	u64 *buf = job->buf;
+	ulong i, j, count;
+	u64 diff;
+
+	for (i = 0; i < job->words; i += MEMTEST_LINE_WORDS) {
+		count = min_t(ulong, MEMTEST_LINE_WORDS, job->words - i);
+		diff = 0;
+		for (j = i; j < i + count; j++)
+			diff |= buf[j] ^ memtest_value(job, type, j);
+		if (diff) {
+			for (j = i; j < i + count; j++) {
+				u64 expect = memtest_value(job, type, j);
+
+				if (buf[j] != expect)
+					memtest_record(job, j, expect, buf[j]);
+			}
+		}
+		if (invert) {
+			for (j = i; j < i + count; j++)
+				buf[j] = ~memtest_value(job, type, j);
+		}
+	}
+}
+
+/* Check and invert each word going down, as needed for moving inversions */
+static void memtest_check_invert_down(struct memtest_job *job)
+{
+	u64 *buf = job->buf;
+	u64 expect = job->pattern;
+	ulong i;
+
+	for (i = job->words; i-- > 0;) {
+		u64 found = buf[i];
+
+		if (found != expect)
+			memtest_record(job, i, expect, found);
+		buf[i] = ~expect;
+	}
+}
+
+static int memtest_job_func(void *arg)
+{
+	struct memtest_job *job = arg;
+	ulong start, end;
+	bool wrote = true;
+
+	switch (job->op) {
+	case OP_WRITE:
+		switch (job->type) {
+		case MEMTEST_ADDRESS:
+			memtest_write(job, MEMTEST_ADDRESS);
+			break;
+		case MEMTEST_RANDOM:
+			memtest_write(job, MEMTEST_RANDOM);
+			break;
+		default:
+			memtest_write(job, MEMTEST_INVERSIONS);
+			break;
+		}
+		break;
+	case OP_CHECK:
+		wrote = false;
+		switch (job->type) {
+		case MEMTEST_ADDRESS:
+			memtest_check(job, MEMTEST_ADDRESS, false);
+			break;
+		case MEMTEST_RANDOM:
+			memtest_check(job, MEMTEST_RANDOM, false);
+			break;
+		default:
+			memtest_check(job, MEMTEST_INVERSIONS, false);
+			break;
+		}
+		break;
+	case OP_CHECK_INVERT:
+		memtest_check(job, MEMTEST_INVERSIONS, true);
+		break;
+	case OP_CHECK_INVERT_DOWN:
+		memtest_check_invert_down(job);
+		break;
+	}
+
+	/* Push the data out to memory, so the next pass does not use the cache */
+	if (wrote) {
+		start = ALIGN_DOWN((ulong)job->buf, ARCH_DMA_MINALIGN);
+		end = ALIGN((ulong)(job->buf + job->words), ARCH_DMA_MINALIGN);
+		flush_dcache_range(start, end);
+	}
+
+	return 0;
+}
+
+/* Number of bytes read and written by an operation on each byte tested */
+static int memtest_op_accesses(enum memtest_op op)
+{
+	return op == OP_WRITE || op == OP_CHECK ? 1 : 2;
+}
+
+static int memtest_pass(enum memtest_t type, enum memtest_op op, u64 *buf,
+			ulong addr, ulong words, u64 pattern,
+			struct memtest_result *res)
+{
+	struct memtest_job jobs[MEMTEST_MAX_JOBS];
+	bool down = op == OP_CHECK_INVERT_DOWN;
+	ulong done, slice, first;
+	int count, num_jobs, i;
+	struct memtest_job *job;
+
+	num_jobs = min(smp_work_init() + 1, MEMTEST_MAX_JOBS);
+	for (done = 0; done < words;) {
+		/* Share out the next batch, in whole cache lines */
+		slice = DIV_ROUND_UP(words - done, num_jobs);
+		slice = ALIGN(slice, MEMTEST_LINE_WORDS);
+		slice = min_t(ulong, slice, MEMTEST_CHUNK / sizeof(u64));
+		for (count = 0; count < num_jobs && done < words; count++) {
+			job = &jobs[count];
+			memset(job, '\0', sizeof(*job));
+			job->words = min(slice, words - done);
+			first = down ? words - done - job->words : done;
+			job->type = type;
+			job->op = op;
+			job->buf = buf + first;
+			job->addr = addr + first * sizeof(u64);
+			job->first = first;
+			job->pattern = op == OP_CHECK_INVERT_DOWN ? ~pattern :
+				pattern;
+			smp_work_setup(&job->work, memtest_job_func, job);
+			done += job->words;
+		}
+		for (i = 0; i < count; i++)
+			smp_work_post(&jobs[i].work);
+		for (i = 0; i < count; i++) {
+			job = &jobs[i];
+			smp_work_wait(&job->work);
+			res->errors += job->errors;
+			memcpy(&res->error[res->num_recorded], job->error,
+			       min(job->num_recorded,
+				   MEMTEST_MAX_ERRORS - res->num_recorded) *
+			       sizeof(struct memtest_error));
+			res->num_recorded = min(res->num_recorded +
+						job->num_recorded,
+						(uint)MEMTEST_MAX_ERRORS);
+		}
+		schedule();
+		if (ctrlc())
+			return -EINTR;
+	}
+	res->bytes += (u64)words * sizeof(u64) * memtest_op_accesses(op);
+
+	return 0;
+}
+
+int memtest_run(enum memtest_t type, void *buf, ulong addr, ulong size,
+		u64 pattern, struct memtest_result *res)
+{
+	ulong start_time, skip, words;
+	int pass, ret;
+
+	memset(res, '\0', sizeof(*res));
+	if (type < 0 || type >= MEMTEST_COUNT)
+		return -EINVAL;
+
+	/* Use whole words only */
+	skip = ALIGN((ulong)buf, sizeof(u64)) - (ulong)buf;
+	if (skip >= size)
+		return 0;
+	buf += skip;
+	addr += skip;
+	words = (size - skip) / sizeof(u64);
+
+	start_time = timer_get_us();
+	for (pass = 0; pass < memtest_num_passes[type]; pass++) {
+		ret = memtest_pass(type, memtest_passes[type][pass], buf, addr,
+				   words, pattern, res);
+		if (ret)
+			return ret;
+	}
+	res->time_us = timer_get_us() - start_time;
+
+	return 0;
+}
+
+const char *memtest_get_name(enum memtest_t type)
+{
+	if (type < 0 || type >= MEMTEST_COUNT)
+		return "unknown";
+
+	return memtest_names[type];
+}
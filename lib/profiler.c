@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Sampling profiler
+ *
+ * See include/profiler.h for an overview. Samples are stored in the buffer in
+ * the same form as they are written out: a struct trace_output_sample followed
+ * by the offsets of the program counter and each return address, so that
+ * writing them out is just a copy.
+ *
+ * The call stack is found by following the chain of frame pointers, so U-Boot
+ * must be built with -fno-omit-frame-pointer (which CONFIG_PROFILER selects).
+ * Since the sample may interrupt code which does not keep a frame pointer,
+ * each frame is checked to be on the stack, above the previous one.
+ */
+
+#include <errno.h>
+#include <log.h>
+#include <profiler.h>
+#include <trace.h>
+#include <asm/global_data.h>
+#include <asm/sections.h>
+#include <linux/sizes.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Maximum distance from the sampler's stack to a frame being recorded */
+#define PROFILER_STACK_MAX	SZ_1M
+
+#ifdef CONFIG_RISCV
+/* The frame pointer points just above the saved frame pointer and ra */
+#define FRAME_OFFSET	(-2)
+#else
+#define FRAME_OFFSET	0
+#endif
+
+/**
+ * struct profiler_state - State of the profiler
+ *
+ * @running: true if samples are being taken
+ * @buf: Buffer holding the samples
+ * @stats: Information about the samples taken
+ */
+struct profiler_state {
+	bool running;
+	u32 *buf;
+	struct profiler_stats stats;
+};
+
+static struct profiler_state state;
+
+/* Get the address from which function offsets are measured */
+static ulong notrace text_base(void)
+{
+#ifdef CONFIG_SANDBOX
+	return (ulong)_init;
+#else
+	if (gd->flags & GD_FLG_RELOC)
+		return gd->relocaddr;
+
+	return CONFIG_TEXT_BASE;
+#endif
+}
+
+void notrace profiler_sample(ulong pc, ulong fp)
+{
+	struct profiler_stats *stats = &state.stats;
+	u32 offset[PROFILER_MAX_DEPTH];
+	ulong base = text_base();
+	ulong sp = (ulong)offset;
+	uint depth = 0, i;
+	ulong size;
+	u32 *rec;
+
+	if (!state.running)
+		return;
+	if (pc - base < gd->mon_len)
+		offset[depth++] = pc - base;
+	else
+		stats->outside++;
+
+	/*
+	 * Each frame holds the caller's frame pointer, followed by the return
+	 * address. Use the address before the return address so that a call
+	 * at the very end of a function is attributed to that function.
+	 */
+	while (fp && depth < PROFILER_MAX_DEPTH) {
+		ulong *frame = (ulong *)fp + FRAME_OFFSET;
+		ulong next, ret;
+
+		if ((ulong)frame < sp || (ulong)frame - sp > PROFILER_STACK_MAX ||
+		    (ulong)frame & (sizeof(ulong) - 1))
+			break;
+		next = frame[0];
+		ret = frame[1] - 1;
+		if (ret - base >= gd->mon_len)
+			break;
+		offset[depth++] = ret - base;
+		if (next <= fp)
+			break;
+		fp = next;
+	}
+	if (!depth)
+		return;
+
+	size = (1 + depth) * sizeof(u32);
+	if (stats->used + size > stats->size) {
+		stats->dropped++;
+		return;
+	}
+	rec = state.buf + stats->used / sizeof(u32);
+	*rec++ = depth;
+	for (i = 0; i < depth; i++)
+		*rec++ = offset[i];
+	stats->used += size;
+	stats->samples++;
+}
+
+__weak int arch_profiler_start(uint rate_hz)
+{
+	return -ENOSYS;
+}
+
+__weak void arch_profiler_stop(void)
+{
+}
+
+int profiler_start(void *buf, ulong size, uint rate_hz)
+{
+	int ret;
+
+	if (state.running)
+		return -EALREADY;
+	if (!rate_hz || (ulong)buf & (sizeof(u32) - 1))
+		return -EINVAL;
+	memset(&state.stats, '\0', sizeof(state.stats));
+	state.buf = buf;
+	state.stats.size = size;
+	state.stats.rate_hz = rate_hz;
+
+	state.running = true;
+	ret = arch_profiler_start(rate_hz);
+	if (ret) {
+		state.running = false;
+		return log_msg_ret("arc", ret);
+	}
+	log_debug("Profiling at %u Hz into %lx bytes\n", rate_hz, size);
+
+	return 0;
+}
+
+int profiler_stop(void)
+{
+	if (!state.running)
+		return -EALREADY;
+	arch_profiler_stop();
+	state.running = false;
+
+	return 0;
+}
+
+bool profiler_running(void)
+{
+	return state.running;
+}
+
+void profiler_get_stats(struct profiler_stats *stats)
+{
+	*stats = state.stats;
+}
+
+int profiler_list_samples(void *buf, ulong buf_size, ulong *needed)
+{
+	struct trace_output_hdr *hdr = buf;
+
+	*needed = sizeof(*hdr) + state.stats.used;
+	if (*needed > buf_size)
+		return -ENOSPC;
+
+	memset(hdr, '\0', sizeof(*hdr));
+	hdr->type = TRACE_CHUNK_SAMPLES;
+	hdr->version = TRACE_VERSION;
+	hdr->rec_count = state.stats.samples;
+	hdr->text_base = CONFIG_TEXT_BASE;
+	memcpy(hdr + 1, state.buf, state.stats.used);
+
+	return 0;
+}
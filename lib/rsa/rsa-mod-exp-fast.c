@@ -0,0 +1,361 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Faster software modular exponentiation for RSA
+ *
+ * This uses Montgomery multiplication with native-width limbs (64 bits where
+ * the compiler provides a 128-bit type), which needs a quarter of the
+ * multiplications of the 32-bit code in rsa-mod-exp.c, and sliding-window
+ * exponentiation, which helps with public exponents other than 65537.
+ */
+
+#ifndef USE_HOSTCC
+#include <log.h>
+#include <asm/byteorder.h>
+#include <linux/bitops.h>
+#include <linux/errno.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <linux/types.h>
+#else
+#include "mkimage.h"
+#define max(x, y)	((x) > (y) ? (x) : (y))
+#define fls64(x)	((x) ? 64 - __builtin_clzll(x) : 0)
+#endif
+#include <u-boot/rsa.h>
+#include <u-boot/rsa-mod-exp.h>
+
+#ifdef __SIZEOF_INT128__
+typedef uint64_t limb_t;
+typedef unsigned __int128 dlimb_t;
+#else
+typedef uint32_t limb_t;
+typedef uint64_t dlimb_t;
+#endif
+
+#define LIMB_BYTES	sizeof(limb_t)
+#define LIMB_BITS	(LIMB_BYTES * 8)
+#define MAX_LIMBS	(RSA_MAX_KEY_BITS / LIMB_BITS)
+
+/* Largest window used for exponentiation, needing 2^(n-1) table entries */
+#define MAX_WINDOW	4
+
+/* Default public exponent for backward compatibility */
+#define RSA_DEFAULT_PUBEXP	65537
+
+/**
+ * struct rsa_mont_ctx - Montgomery context for an RSA public key
+ *
+ * @len: Number of limbs in the modulus
+ * @n0inv: -1 / n[0] mod 2^LIMB_BITS
+ * @exponent: Public exponent
+ * @n: Modulus, as little-endian limb array
+ * @rr: R^2 mod n, where R = 2^(len * LIMB_BITS), as little-endian limb array
+ */
+struct rsa_mont_ctx {
+	uint len;
+	limb_t n0inv;
+	uint64_t exponent;
+	limb_t n[MAX_LIMBS];
+	limb_t rr[MAX_LIMBS];
+};
+
+/**
+ * load_be() - Convert a big-endian byte array to a little-endian limb array
+ *
+ * @dst: Destination limb array
+ * @src: Source bytes, @len * LIMB_BYTES of them
+ * @len: Number of limbs
+ */
+static void load_be(limb_t *dst, const uint8_t *src, uint len)
+{
+	const uint8_t *p;
+	limb_t val;
+	uint i, j;
+
+	for (i = 0; i < len; i++) {
+		p = src + (len - 1 - i) * LIMB_BYTES;
+		for (val = 0, j = 0; j < LIMB_BYTES; j++)
+			val = (val << 8) | p[j];
+		dst[i] = val;
+	}
+}
+
+/**
+ * store_be() - Convert a little-endian limb array to a big-endian byte array
+ *
+ * @dst: Destination bytes, @len * LIMB_BYTES of them
+ * @src: Source limb array
+ * @len: Number of limbs
+ */
+static void store_be(uint8_t *dst, const limb_t *src, uint len)
+{
+	limb_t val;
+	uint i;
+	int j;
+
+	for (i = 0; i < len; i++) {
+		val = src[len - 1 - i];
+		for (j = LIMB_BYTES - 1; j >= 0; j--, val >>= 8)
+			dst[i * LIMB_BYTES + j] = (uint8_t)val;
+	}
+}
+
+/**
+ * limb_inverse() - Calculate -1 / @n0 mod 2^LIMB_BITS
+ *
+ * This uses Newton's iteration, which doubles the number of correct bits each
+ * time, starting from @n0 itself, which is its own inverse mod 8.
+ *
+ * @n0: Lowest limb of the modulus, which must be odd
+ * Return: negated inverse
+ */
+static limb_t limb_inverse(limb_t n0)
+{
+	limb_t x = n0;
+	int i;
+
+	for (i = 0; i < 5; i++)
+		x *= 2 - n0 * x;
+
+	return -x;
+}
+
+/**
+ * mont_mul() - Montgomery multiplication
+ *
+ * Operation: res = a * b / R mod n
+ *
+ * This uses the Coarsely Integrated Operand Scanning method. Provided that
+ * a * b < n * R, the result is fully reduced, i.e. less than n.
+ *
+ * @ctx: Montgomery context
+ * @res: Result, which may be the same as @a or @b
+ * @a: Multiplier
+ * @b: Multiplicand
+ */
+static void mont_mul(const struct rsa_mont_ctx *ctx, limb_t *res,
+		     const limb_t *a, const limb_t *b)
+{
+	const limb_t *n = ctx->n;
+	uint len = ctx->len;
+	limb_t t[MAX_LIMBS + 2];
+	limb_t carry, m, borrow;
+	dlimb_t acc;
+	uint i, j;
+
+	memset(t, '\0', (len + 2) * sizeof(limb_t));
+	for (i = 0; i < len; i++) {
+		/* t += a[i] * b */
+		carry = 0;
+		for (j = 0; j < len; j++) {
+			acc = (dlimb_t)a[i] * b[j] + t[j] + carry;
+			t[j] = (limb_t)acc;
+			carry = acc >> LIMB_BITS;
+		}
+		acc = (dlimb_t)t[len] + carry;
+		t[len] = (limb_t)acc;
+		t[len + 1] = acc >> LIMB_BITS;
+
+		/* t = (t + m * n) / 2^LIMB_BITS, where the low limb is zero */
+		m = t[0] * ctx->n0inv;
+		acc = (dlimb_t)m * n[0] + t[0];
+		carry = acc >> LIMB_BITS;
+		for (j = 1; j < len; j++) {
+			acc = (dlimb_t)m * n[j] + t[j] + carry;
+			t[j - 1] = (limb_t)acc;
+			carry = acc >> LIMB_BITS;
+		}
+		acc = (dlimb_t)t[len] + carry;
+		t[len - 1] = (limb_t)acc;
+		t[len] = t[len + 1] + (limb_t)(acc >> LIMB_BITS);
+	}
+
+	/* t < 2n here, so one subtraction is enough to reduce it */
+	if (!t[len]) {
+		for (i = len; i > 0; i--) {
+			if (t[i - 1] != n[i - 1])
+				break;
+		}
+		if (i && t[i - 1] < n[i - 1]) {
+			memcpy(res, t, len * sizeof(limb_t));
+			return;
+		}
+	}
+	for (borrow = 0, i = 0; i < len; i++) {
+		acc = (dlimb_t)t[i] - n[i] - borrow;
+		res[i] = (limb_t)acc;
+		borrow = (acc >> LIMB_BITS) & 1;
+	}
+}
+
+/**
+ * count_window_muls() - Count multiplications for sliding-window exponentiation
+ *
+ * @exp: Exponent
+ * @bits: Number of bits in @exp
+ * @w: Window size
+ * Return: number of multiplications needed, including those for building the
+ *	table of odd powers
+ */
+static int count_window_muls(uint64_t exp, int bits, int w)
+{
+	int muls = w > 1 ? 1 << (w - 1) : 0;
+	int i, l;
+
+	for (i = bits - 1; i >= 0;) {
+		if (!(exp & (1ULL << i))) {
+			i--;
+			continue;
+		}
+		for (l = max(i - w + 1, 0); !(exp & (1ULL << l)); l++)
+			;
+		muls++;
+		i = l - 1;
+	}
+
+	return muls;
+}
+
+/**
+ * pow_mod() - Modular exponentiation with a sliding window
+ *
+ * Operation: val = val ^ exponent mod n
+ *
+ * @ctx: Montgomery context
+ * @val: Value to exponentiate, replaced with the result
+ * Return: 0 if OK, -EINVAL if the exponent is not valid
+ */
+static int pow_mod(const struct rsa_mont_ctx *ctx, limb_t *val)
+{
+	/* table[i] holds val^(2i + 1) in Montgomery form */
+	limb_t table[1 << (MAX_WINDOW - 1)][MAX_LIMBS];
+	limb_t acc[MAX_LIMBS];
+	uint64_t exp = ctx->exponent;
+	uint len = ctx->len;
+	int bits, w, best, muls;
+	int i, l, k, idx;
+	bool first;
+
+	bits = exp ? fls64(exp) : 0;
+	if (bits < 2) {
+		debug("Public exponent is too short (%d bits, minimum 2)\n",
+		      bits);
+		return -EINVAL;
+	}
+	if (!(exp & 1)) {
+		debug("LSB of RSA public exponent must be set.\n");
+		return -EINVAL;
+	}
+
+	for (w = 1, best = INT_MAX, k = 1; k <= MAX_WINDOW; k++) {
+		muls = count_window_muls(exp, bits, k);
+		if (muls < best) {
+			best = muls;
+			w = k;
+		}
+	}
+
+	mont_mul(ctx, table[0], val, ctx->rr);
+	if (w > 1) {
+		mont_mul(ctx, acc, table[0], table[0]);
+		for (i = 1; i < 1 << (w - 1); i++)
+			mont_mul(ctx, table[i], table[i - 1], acc);
+	}
+
+	/* The top bit is set, so the first window initialises acc */
+	for (i = bits - 1, first = true; i >= 0; i = l - 1) {
+		if (!(exp & (1ULL << i))) {
+			mont_mul(ctx, acc, acc, acc);
+			l = i;
+			continue;
+		}
+
+		/* Find the longest window ending in a set bit */
+		for (l = max(i - w + 1, 0); !(exp & (1ULL << l)); l++)
+			;
+		idx = (exp >> l & ((1ULL << (i - l + 1)) - 1)) >> 1;
+		if (first) {
+			memcpy(acc, table[idx], len * sizeof(limb_t));
+			first = false;
+			continue;
+		}
+		for (k = i; k >= l; k--)
+			mont_mul(ctx, acc, acc, acc);
+		mont_mul(ctx, acc, acc, table[idx]);
+	}
+
+	/* Convert out of Montgomery form by multiplying by 1 */
+	memset(val, '\0', len * sizeof(limb_t));
+	val[0] = 1;
+	mont_mul(ctx, val, acc, val);
+
+	return 0;
+}
+
+/**
+ * rsa_mont_ctx_setup() - Set up a Montgomery context from key properties
+ *
+ * @ctx: Context to set up
+ * @prop: Key properties
+ * Return: 0 if OK, -EFAULT if the key is not valid, -E2BIG if the key size is
+ *	not supported by this implementation
+ */
+static int rsa_mont_ctx_setup(struct rsa_mont_ctx *ctx,
+			      const struct key_prop *prop)
+{
+	uint64_t exponent;
+
+	if (!prop->num_bits || !prop->modulus || !prop->rr) {
+		debug("%s: Missing RSA key info", __func__);
+		return -EFAULT;
+	}
+	if (prop->num_bits > RSA_MAX_KEY_BITS ||
+	    prop->num_bits < RSA_MIN_KEY_BITS) {
+		debug("RSA key bits %u outside allowed range %d..%d\n",
+		      prop->num_bits, RSA_MIN_KEY_BITS, RSA_MAX_KEY_BITS);
+		return -EFAULT;
+	}
+	if (prop->num_bits % LIMB_BITS)
+		return -E2BIG;
+
+	if (prop->public_exponent) {
+		memcpy(&exponent, prop->public_exponent, sizeof(exponent));
+		ctx->exponent = be64_to_cpu(exponent);
+	} else {
+		ctx->exponent = RSA_DEFAULT_PUBEXP;
+	}
+	ctx->len = prop->num_bits / LIMB_BITS;
+	load_be(ctx->n, prop->modulus, ctx->len);
+	load_be(ctx->rr, prop->rr, ctx->len);
+	if (!(ctx->n[0] & 1)) {
+		debug("%s: RSA modulus must be odd\n", __func__);
+		return -EFAULT;
+	}
+	ctx->n0inv = limb_inverse(ctx->n[0]);
+
+	return 0;
+}
+
+int rsa_mod_exp_fast(const uint8_t *sig, uint32_t sig_len,
+		     struct key_prop *prop, uint8_t *out)
+{
+	struct rsa_mont_ctx ctx;
+	limb_t val[MAX_LIMBS];
+	int ret;
+
+	ret = rsa_mont_ctx_setup(&ctx, prop);
+	if (ret)
+		return ret;
+	if (sig_len != ctx.len * LIMB_BYTES) {
+		debug("Signature is of incorrect length %d\n", sig_len);
+		return -EINVAL;
+	}
+
+	load_be(val, sig, ctx.len);
+	ret = pow_mod(&ctx, val);
+	if (ret)
+		return ret;
+	store_be(out, val, ctx.len);
+
+	return 0;
+}
@@ -170,7 +170,7 @@ static int num_public_exponent_bits(const struct rsa_public_key *key,
 static int is_public_exponent_bit_set(const struct rsa_public_key *key,
 		int pos)
 {
-	return key->exponent & (1ULL << pos);
+	return !!(key->exponent & (1ULL << pos));
 }
 
 /**
@@ -254,16 +254,12 @@ static void rsa_convert_big_endian(uint32_t *dst, const uint32_t *src, int len)
 		dst[i] = fdt32_to_cpu(src[len - 1 - i]);
 }
 
-int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
-		struct key_prop *prop, uint8_t *out)
+int rsa_mod_exp_simple(const uint8_t *sig, uint32_t sig_len,
+		       struct key_prop *prop, uint8_t *out)
 {
 	struct rsa_public_key key;
 	int ret;
 
-	if (!prop) {
-		debug("%s: Skipping invalid prop", __func__);
-		return -EBADF;
-	}
 	key.n0inv = prop->n0inv;
 	key.len = prop->num_bits;
 
@@ -308,6 +304,26 @@ int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 	return 0;
 }
 
+int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
+		struct key_prop *prop, uint8_t *out)
+{
+	int ret;
+
+	if (!prop) {
+		debug("%s: Skipping invalid prop", __func__);
+		return -EBADF;
+	}
+
+	if (IS_ENABLED(CONFIG_RSA_SOFTWARE_EXP_FAST)) {
+		ret = rsa_mod_exp_fast(sig, sig_len, prop, out);
+		if (ret != -E2BIG)
+			return ret;
+		/* Key size not supported, so fall back to the simple code */
+	}
+
+	return rsa_mod_exp_simple(sig, sig_len, prop, out);
+}
+
 #if defined(CONFIG_CMD_ZYNQ_RSA)
 /**
  * zynq_pow_mod - in-place public exponentiation
@@ -9,12 +9,11 @@
 #include <tpm-common.h>
 #include <tpm-v2.h>
 #include <tpm_tcg2.h>
-#include <u-boot/sha1.h>
-#include <u-boot/sha256.h>
-#include <u-boot/sha512.h>
 #include <version_string.h>
+#include <watchdog.h>
 #include <asm/io.h>
 #include <linux/bitops.h>
+#include <linux/sizes.h>
 #include <linux/unaligned/be_byteshift.h>
 #include <linux/unaligned/generic.h>
 #include <linux/unaligned/le_byteshift.h>
@@ -92,64 +91,136 @@ u32 tcg2_event_get_size(struct tpml_digest_values *digest_list)
 	return len;
 }
 
-int tcg2_create_digest(struct udevice *dev, const u8 *input, u32 length,
-		       struct tpml_digest_values *digest_list)
+/*
+ * Amount of data added to all the digests at a time, small enough to stay in
+ * the CPU cache while each hash reads it
+ */
+#define TCG2_DIGEST_CHUNK	SZ_16K
+
+void tcg2_digest_init(struct tcg2_digest_ctx *ctx, u32 active)
 {
-	u8 final[sizeof(union tpmu_ha)];
-	sha256_context ctx_256;
-	sha512_context ctx_512;
-	sha1_context ctx;
-	u32 active;
 	size_t i;
-	u32 len;
+
+	ctx->active = active;
+	for (i = 0; i < ARRAY_SIZE(hash_algo_list); ++i) {
+		if (!(ctx->active & hash_algo_list[i].hash_mask))
+			continue;
+
+		switch (hash_algo_list[i].hash_alg) {
+		case TPM2_ALG_SHA1:
+			sha1_starts(&ctx->sha1);
+			break;
+		case TPM2_ALG_SHA256:
+			sha256_starts(&ctx->sha256);
+			break;
+		case TPM2_ALG_SHA384:
+			sha384_starts(&ctx->sha384);
+			break;
+		case TPM2_ALG_SHA512:
+			sha512_starts(&ctx->sha512);
+			break;
+		default:
+			printf("%s: unsupported algorithm %x\n", __func__,
+			       hash_algo_list[i].hash_alg);
+			ctx->active &= ~hash_algo_list[i].hash_mask;
+			break;
+		}
+	}
+}
+
+int tcg2_digest_start(struct udevice *dev, struct tcg2_digest_ctx *ctx)
+{
+	u32 active;
 	int rc;
 
 	rc = tcg2_get_active_pcr_banks(dev, &active);
 	if (rc)
 		return rc;
 
+	tcg2_digest_init(ctx, active);
+
+	return 0;
+}
+
+void tcg2_digest_update(struct tcg2_digest_ctx *ctx, const u8 *input,
+			u32 length)
+{
+	u32 chunk;
+	size_t i;
+
+	for (; length; input += chunk, length -= chunk) {
+		chunk = min_t(u32, length, TCG2_DIGEST_CHUNK);
+		for (i = 0; i < ARRAY_SIZE(hash_algo_list); ++i) {
+			if (!(ctx->active & hash_algo_list[i].hash_mask))
+				continue;
+
+			switch (hash_algo_list[i].hash_alg) {
+			case TPM2_ALG_SHA1:
+				sha1_update(&ctx->sha1, input, chunk);
+				break;
+			case TPM2_ALG_SHA256:
+				sha256_update(&ctx->sha256, input, chunk);
+				break;
+			case TPM2_ALG_SHA384:
+				sha384_update(&ctx->sha384, input, chunk);
+				break;
+			case TPM2_ALG_SHA512:
+				sha512_update(&ctx->sha512, input, chunk);
+				break;
+			}
+		}
+		schedule();
+	}
+}
+
+void tcg2_digest_finish(struct tcg2_digest_ctx *ctx,
+			struct tpml_digest_values *digest_list)
+{
+	u8 final[sizeof(union tpmu_ha)];
+	size_t i;
+
 	digest_list->count = 0;
 	for (i = 0; i < ARRAY_SIZE(hash_algo_list); ++i) {
-		if (!(active & hash_algo_list[i].hash_mask))
+		if (!(ctx->active & hash_algo_list[i].hash_mask))
 			continue;
 
 		switch (hash_algo_list[i].hash_alg) {
 		case TPM2_ALG_SHA1:
-			sha1_starts(&ctx);
-			sha1_update(&ctx, input, length);
-			sha1_finish(&ctx, final);
-			len = TPM2_SHA1_DIGEST_SIZE;
+			sha1_finish(&ctx->sha1, final);
 			break;
 		case TPM2_ALG_SHA256:
-			sha256_starts(&ctx_256);
-			sha256_update(&ctx_256, input, length);
-			sha256_finish(&ctx_256, final);
-			len = TPM2_SHA256_DIGEST_SIZE;
+			sha256_finish(&ctx->sha256, final);
 			break;
 		case TPM2_ALG_SHA384:
-			sha384_starts(&ctx_512);
-			sha384_update(&ctx_512, input, length);
-			sha384_finish(&ctx_512, final);
-			len = TPM2_SHA384_DIGEST_SIZE;
+			sha384_finish(&ctx->sha384, final);
 			break;
 		case TPM2_ALG_SHA512:
-			sha512_starts(&ctx_512);
-			sha512_update(&ctx_512, input, length);
-			sha512_finish(&ctx_512, final);
-			len = TPM2_SHA512_DIGEST_SIZE;
+			sha512_finish(&ctx->sha512, final);
 			break;
 		default:
-			printf("%s: unsupported algorithm %x\n", __func__,
-			       hash_algo_list[i].hash_alg);
 			continue;
 		}
 
 		digest_list->digests[digest_list->count].hash_alg =
 			hash_algo_list[i].hash_alg;
 		memcpy(&digest_list->digests[digest_list->count].digest, final,
-		       len);
+		       hash_algo_list[i].hash_len);
 		digest_list->count++;
 	}
+}
+
+int tcg2_create_digest(struct udevice *dev, const u8 *input, u32 length,
+		       struct tpml_digest_values *digest_list)
+{
+	struct tcg2_digest_ctx ctx;
+	int rc;
+
+	rc = tcg2_digest_start(dev, &ctx);
+	if (rc)
+		return rc;
+
+	tcg2_digest_update(&ctx, input, length);
+	tcg2_digest_finish(&ctx, digest_list);
 
 	return 0;
 }
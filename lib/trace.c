@@ -3,6 +3,7 @@
  * Copyright (c) 2012 The Chromium OS Authors.
  */
 
+#include <malloc.h>
 #include <mapmem.h>
 #include <time.h>
 #include <trace.h>
@@ -16,6 +17,35 @@ DECLARE_GLOBAL_DATA_PTR;
 static char trace_enabled __section(".data");
 static char trace_inited __section(".data");
 
+/* Maximum call depth for which function times are recorded */
+#define TRACE_TIME_DEPTH	64
+
+/**
+ * struct trace_func_time - Time spent in a function
+ *
+ * Times are in the units used for timestamps (see trace_time())
+ *
+ * @incl: Total time, including functions which it called
+ * @excl: Total time in the function itself
+ */
+struct trace_func_time {
+	u64 incl;
+	u64 excl;
+};
+
+/**
+ * struct trace_frame - A function which is being timed
+ *
+ * @func: Function number (see func_ptr_to_num())
+ * @start: Time when the function was entered
+ * @child: Time spent in functions which it called, so far
+ */
+struct trace_frame {
+	uintptr_t func;
+	u64 start;
+	u64 child;
+};
+
 /* The header block at the start of the trace memory area */
 struct trace_hdr {
 	int func_count;		/* Total number of function call sites */
@@ -34,6 +64,17 @@ struct trace_hdr {
 	ulong ftrace_size;	/* Num. of ftrace records we have space for */
 	ulong ftrace_count;	/* Num. of ftrace records written */
 	ulong ftrace_too_deep_count;	/* Functions that were too deep */
+	ulong ftrace_next;	/* Index of the next ftrace record to write */
+	bool ftrace_wrap;	/* Overwrite the oldest records when full */
+	u64 ftrace_time_hi;	/* Timestamp bits above the record's 30 bits */
+
+	/*
+	 * Time spent in each function, indexed like call_accum, or NULL if
+	 * not recorded
+	 */
+	struct trace_func_time *func_time;
+	struct trace_frame time_stack[TRACE_TIME_DEPTH];
+	int time_depth;		/* Depth of function calls being timed */
 
 	int depth;		/* Depth of function calls */
 	int depth_limit;	/* Depth limit to trace to */
@@ -104,20 +145,97 @@ static void notrace trace_swap_gd(void)
 
 #endif
 
+/**
+ * trace_time() - Get the current time for a trace record
+ *
+ * Return: timer ticks with CONFIG_TRACE_TICKS, else microseconds
+ */
+static u64 notrace trace_time(void)
+{
+	if (IS_ENABLED(CONFIG_TRACE_TICKS))
+		return get_ticks();
+
+	return timer_get_us();
+}
+
+static void notrace add_ftrace_rec(u32 func, u32 caller, u32 flags)
+{
+	if (hdr->ftrace_next < hdr->ftrace_size) {
+		struct trace_call *rec = &hdr->ftrace[hdr->ftrace_next++];
+
+		rec->func = func;
+		rec->caller = caller;
+		rec->flags = flags;
+		if (hdr->ftrace_wrap && hdr->ftrace_next == hdr->ftrace_size)
+			hdr->ftrace_next = 0;
+	}
+	hdr->ftrace_count++;
+}
+
 static void notrace add_ftrace(void *func_ptr, void *caller, ulong flags)
 {
+	u64 now, hi;
+
 	if (hdr->depth > hdr->depth_limit) {
 		hdr->ftrace_too_deep_count++;
 		return;
 	}
-	if (hdr->ftrace_count < hdr->ftrace_size) {
-		struct trace_call *rec = &hdr->ftrace[hdr->ftrace_count];
 
-		rec->func = func_ptr_to_num(func_ptr);
-		rec->caller = func_ptr_to_num(caller);
-		rec->flags = flags | (timer_get_us() & FUNCF_TIMESTAMP_MASK);
+	/*
+	 * Only 30 bits of timestamp fit in a record, which is about a second
+	 * with a 1GHz tick. Emit a resync record with the upper bits whenever
+	 * they change, so that tools can rebuild the full timestamp.
+	 */
+	now = trace_time();
+	hi = now >> 30;
+	if (hi != hdr->ftrace_time_hi) {
+		add_ftrace_rec(hi, hi >> 32,
+			       FUNCF_TIME_HI | (now & FUNCF_TIMESTAMP_MASK));
+		hdr->ftrace_time_hi = hi;
 	}
-	hdr->ftrace_count++;
+	add_ftrace_rec(func_ptr_to_num(func_ptr), func_ptr_to_num(caller),
+		       flags | (now & FUNCF_TIMESTAMP_MASK));
+}
+
+/**
+ * time_enter() - Start timing a function
+ *
+ * @func: Function number (see func_ptr_to_num())
+ */
+static void notrace time_enter(uintptr_t func)
+{
+	if (hdr->time_depth < TRACE_TIME_DEPTH) {
+		struct trace_frame *frame = &hdr->time_stack[hdr->time_depth];
+
+		frame->func = func;
+		frame->child = 0;
+		frame->start = trace_time();
+	}
+	hdr->time_depth++;
+}
+
+/* Stop timing the current function and add the time taken to its totals */
+static void notrace time_exit(void)
+{
+	struct trace_frame *frame;
+	u64 taken;
+
+	/* Ignore returns from functions entered before tracing started */
+	if (!hdr->time_depth)
+		return;
+	if (--hdr->time_depth >= TRACE_TIME_DEPTH)
+		return;
+
+	frame = &hdr->time_stack[hdr->time_depth];
+	taken = trace_time() - frame->start;
+	if (frame->func < hdr->func_count) {
+		struct trace_func_time *ftime = &hdr->func_time[frame->func];
+
+		ftime->incl += taken;
+		ftime->excl += taken - frame->child;
+	}
+	if (hdr->time_depth)
+		frame[-1].child += taken;
 }
 
 /**
@@ -154,6 +272,8 @@ void notrace __cyg_profile_func_enter(void *func_ptr, void *caller)
 		hdr->depth++;
 		if (hdr->depth > hdr->max_depth)
 			hdr->max_depth = hdr->depth;
+		if (hdr->func_time)
+			time_enter(func);
 		trace_swap_gd();
 		hdr->trace_locked = false;
 	}
@@ -169,6 +289,8 @@ void notrace __cyg_profile_func_exit(void *func_ptr, void *caller)
 {
 	if (trace_enabled) {
 		trace_swap_gd();
+		if (hdr->func_time)
+			time_exit();
 		hdr->depth--;
 		add_ftrace(func_ptr, caller, FUNCF_EXIT);
 		if (hdr->depth < hdr->min_depth)
@@ -251,7 +373,7 @@ int trace_list_calls(void *buff, size_t buff_size, size_t *needed)
 	struct trace_output_hdr *output_hdr = NULL;
 	void *end, *ptr = buff;
 	size_t rec, upto;
-	size_t count;
+	size_t count, first;
 
 	end = buff ? buff + buff_size : NULL;
 
@@ -260,18 +382,28 @@ int trace_list_calls(void *buff, size_t buff_size, size_t *needed)
 		output_hdr = ptr;
 	ptr += sizeof(struct trace_output_hdr);
 
-	/* Add information about each call */
+	/* Add information about each call, oldest first */
 	count = hdr->ftrace_count;
-	if (count > hdr->ftrace_size)
+	first = 0;
+	if (count > hdr->ftrace_size) {
 		count = hdr->ftrace_size;
+		if (hdr->ftrace_wrap)
+			first = hdr->ftrace_next;
+	}
 	for (rec = upto = 0; rec < count; rec++) {
 		if (ptr + sizeof(struct trace_call) < end) {
-			struct trace_call *call = &hdr->ftrace[rec];
+			struct trace_call *call;
 			struct trace_call *out = ptr;
 
-			out->func = call->func * FUNC_SITE_SIZE;
-			out->caller = call->caller * FUNC_SITE_SIZE;
-			out->flags = call->flags;
+			call = &hdr->ftrace[(first + rec) % hdr->ftrace_size];
+
+			if (TRACE_CALL_TYPE(call) == FUNCF_TIME_HI) {
+				*out = *call;
+			} else {
+				out->func = call->func * FUNC_SITE_SIZE;
+				out->caller = call->caller * FUNC_SITE_SIZE;
+				out->flags = call->flags;
+			}
 			upto++;
 		}
 		ptr += sizeof(struct trace_call);
@@ -284,6 +416,8 @@ int trace_list_calls(void *buff, size_t buff_size, size_t *needed)
 		output_hdr->type = TRACE_CHUNK_CALLS;
 		output_hdr->version = TRACE_VERSION;
 		output_hdr->text_base = CONFIG_TEXT_BASE;
+		if (IS_ENABLED(CONFIG_TRACE_TICKS))
+			output_hdr->tick_rate = get_tbclk();
 	}
 
 	/* Work out how must of the buffer we used */
@@ -319,8 +453,9 @@ void trace_print_stats(void)
 	print_grouped_ull(count, 10);
 	puts(" traced function calls");
 	if (hdr->ftrace_count > hdr->ftrace_size) {
-		printf(" (%lu dropped due to overflow)",
-		       hdr->ftrace_count - hdr->ftrace_size);
+		printf(" (%lu %s due to overflow)",
+		       hdr->ftrace_count - hdr->ftrace_size,
+		       hdr->ftrace_wrap ? "overwritten" : "dropped");
 	}
 
 	/* Add in minimum depth since the trace did not start at top level */
@@ -335,6 +470,61 @@ void trace_print_stats(void)
 	       (ulong)map_to_sysmem(hdr), (ulong)map_to_sysmem(hdr->ftrace));
 }
 
+void trace_print_func_times(int count)
+{
+	const struct trace_func_time *times;
+	uintptr_t *top;
+	int func, found, i;
+	char was_enabled;
+
+	if (!trace_inited || !hdr->func_time) {
+		printf("Function times are not recorded\n");
+		return;
+	}
+	if (count <= 0)
+		return;
+	top = calloc(count, sizeof(*top));
+	if (!top) {
+		printf("Out of memory\n");
+		return;
+	}
+
+	/* Avoid timing the functions used to collect and print the times */
+	was_enabled = trace_enabled;
+	trace_enabled = 0;
+
+	/* Keep a list of the functions with the most exclusive time */
+	times = hdr->func_time;
+	for (func = found = 0; func < hdr->func_count; func++) {
+		if (!times[func].incl)
+			continue;
+		if (found == count &&
+		    times[top[count - 1]].excl >= times[func].excl)
+			continue;
+		i = found < count ? found++ : count - 1;
+		for (; i > 0 && times[top[i - 1]].excl < times[func].excl; i--)
+			top[i] = top[i - 1];
+		top[i] = func;
+	}
+
+	if (IS_ENABLED(CONFIG_TRACE_TICKS))
+		printf("\nFunction times in ticks (%lu Hz)\n", get_tbclk());
+	else
+		printf("\nFunction times in microseconds\n");
+	printf("%8s %10s %15s %15s\n", "Offset", "Calls", "Inclusive",
+	       "Exclusive");
+	for (i = 0; i < found; i++) {
+		func = top[i];
+		printf("%8lx %10lu %15llu %15llu\n",
+		       (ulong)func * FUNC_SITE_SIZE,
+		       (ulong)hdr->call_accum[func],
+		       (unsigned long long)times[func].incl,
+		       (unsigned long long)times[func].excl);
+	}
+	free(top);
+	trace_enabled = was_enabled;
+}
+
 void notrace trace_set_enabled(int enabled)
 {
 	trace_enabled = enabled != 0;
@@ -361,8 +551,9 @@ static int get_func_count(void)
 int notrace trace_init(void *buff, size_t buff_size)
 {
 	int func_count = get_func_count();
-	size_t needed;
+	size_t needed, times_size = 0;
 	int was_disabled = !trace_enabled;
+	ulong early_count = 0;
 
 	if (func_count < 0)
 		return func_count;
@@ -394,6 +585,7 @@ int notrace trace_init(void *buff, size_t buff_size)
 		}
 		puts("\n");
 		memcpy(buff, hdr, used);
+		early_count = count;
 #else
 		puts("trace: already enabled\n");
 		return -EALREADY;
@@ -401,23 +593,38 @@ int notrace trace_init(void *buff, size_t buff_size)
 	}
 	hdr = (struct trace_hdr *)buff;
 	needed = sizeof(*hdr) + func_count * sizeof(uintptr_t);
-	if (needed > buff_size) {
+	if (IS_ENABLED(CONFIG_TRACE_FUNC_TIMES))
+		times_size = func_count * sizeof(struct trace_func_time);
+	if (needed + times_size > buff_size) {
 		printf("trace: buffer size %zx bytes: at least %zx needed\n",
-		       buff_size, needed);
+		       buff_size, needed + times_size);
 		return -ENOSPC;
 	}
 
 	if (was_disabled) {
 		memset(hdr, '\0', needed);
 		hdr->min_depth = INT_MAX;
+		hdr->ftrace_time_hi = ~0ULL;	/* start with a resync */
 	}
 	hdr->func_count = func_count;
 	hdr->call_accum = (uintptr_t *)(hdr + 1);
 
+	/* Function times go after the call counts, moving any early records */
+	hdr->func_time = NULL;
+	hdr->time_depth = 0;
+	if (times_size) {
+		hdr->func_time = buff + needed;
+		memmove(buff + needed + times_size, buff + needed,
+			early_count * sizeof(struct trace_call));
+		memset(hdr->func_time, '\0', times_size);
+		needed += times_size;
+	}
+
 	/* Use any remaining space for the timed function trace */
 	hdr->ftrace = (struct trace_call *)(buff + needed);
 	hdr->ftrace_size = (buff_size - needed) / sizeof(*hdr->ftrace);
 	hdr->depth_limit = CONFIG_TRACE_CALL_DEPTH_LIMIT;
+	hdr->ftrace_wrap = IS_ENABLED(CONFIG_TRACE_WRAP);
 
 	puts("trace: enabled\n");
 	trace_enabled = 1;
@@ -456,6 +663,7 @@ int notrace trace_early_init(void)
 	hdr->call_accum = (uintptr_t *)(hdr + 1);
 	hdr->func_count = func_count;
 	hdr->min_depth = INT_MAX;
+	hdr->ftrace_time_hi = ~0ULL;	/* start with a resync */
 
 	/* Use any remaining space for the timed function trace */
 	hdr->ftrace = (struct trace_call *)((char *)hdr + needed);
@@ -14,6 +14,7 @@
 #include <dm.h>
 #include <efi_default_filename.h>
 #include <expo.h>
+#include <part.h>
 #ifdef CONFIG_SANDBOX
 #include <asm/test.h>
 #endif
@@ -213,6 +214,70 @@ static int bootflow_cmd_scan_e(struct unit_test_state *uts)
 }
 BOOTSTD_TEST(bootflow_cmd_scan_e, UTF_DM | UTF_SCAN_FDT | UTF_CONSOLE);
 
+/* Check that scanning again uses the partition information from before */
+static int bootflow_scan_part_cache(struct unit_test_state *uts)
+{
+	struct part_cache_stats stats;
+
+	if (!CONFIG_IS_ENABLED(PARTITION_CACHE))
+		return -EAGAIN;
+
+	ut_assertok(bootstd_test_drop_bootdev_order(uts));
+	part_cache_stats(&stats);
+	ut_assertok(run_command("bootflow scan -a", 0));
+	part_cache_stats(&stats);
+	ut_assert(stats.entries > 0);
+
+	/* Nothing has been written, so no partition tables are read again */
+	ut_assertok(run_command("bootflow scan -a", 0));
+	part_cache_stats(&stats);
+	ut_assert(stats.hits > 0);
+	ut_asserteq(0, stats.misses);
+	ut_asserteq(0, stats.reads);
+
+	return 0;
+}
+BOOTSTD_TEST(bootflow_scan_part_cache, UTF_DM | UTF_SCAN_FDT);
+
+/* Check that scanning again uses the files read before */
+static int bootflow_scan_file_cache(struct unit_test_state *uts)
+{
+	struct bootflow_cache_stats stats;
+
+	if (!CONFIG_IS_ENABLED(BOOTSTD_FILE_CACHE))
+		return -EAGAIN;
+
+	ut_assertok(run_command("bootdev select 1", 0));
+	bootflow_cache_stats(&stats);
+	ut_assertok(run_command("bootflow scan", 0));
+	bootflow_cache_stats(&stats);
+	ut_asserteq(0, stats.hits);
+	ut_asserteq(1, stats.misses);
+	ut_asserteq(1, stats.entries);
+
+	/* extlinux.conf is not read again */
+	ut_assertok(run_command("bootflow scan", 0));
+	bootflow_cache_stats(&stats);
+	ut_asserteq(1, stats.hits);
+	ut_asserteq(0, stats.misses);
+	ut_asserteq(595, stats.saved);
+
+	ut_assertok(run_command("bootflow select 0", 0));
+	console_record_reset_enable();
+	ut_assertok(run_command("bootflow info", 0));
+	ut_assert_skip_to_line("Cache:     1 hits, 595 bytes saved");
+
+	/* Writing to the device drops its files, even if nothing changes */
+	ut_assertok(run_command("mmc dev 1", 0));
+	ut_assertok(run_command("mmc read 1000 0 1", 0));
+	ut_assertok(run_command("mmc write 1000 0 1", 0));
+	bootflow_cache_stats(&stats);
+	ut_asserteq(0, stats.entries);
+
+	return 0;
+}
+BOOTSTD_TEST(bootflow_scan_file_cache, UTF_DM | UTF_SCAN_FDT);
+
 /* Check 'bootflow info' */
 static int bootflow_cmd_info(struct unit_test_state *uts)
 {
@@ -237,6 +302,7 @@ static int bootflow_cmd_info(struct unit_test_state *uts)
 	ut_assert_nextline("Cmdline:   (none)");
 	ut_assert_nextline("Logo:      (none)");
 	ut_assert_nextline("FDT:       <NULL>");
+	ut_assert_nextline("Cache:     0 hits, 0 bytes saved");
 	ut_assert_nextline("Error:     0");
 	ut_assert_console_end();
 
@@ -1216,3 +1282,45 @@ static int bootflow_android(struct unit_test_state *uts)
 	return 0;
 }
 BOOTSTD_TEST(bootflow_android, UTF_CONSOLE);
+
+/* Test that the Android bootmeth does not read images again after AVB */
+static int bootflow_android_avb_preload(struct unit_test_state *uts)
+{
+	struct disk_partition boot, vendor_boot;
+	struct blk_desc *desc;
+	struct udevice *mmc;
+	ulong start, blocks, part_blocks;
+
+	if (!IS_ENABLED(CONFIG_BOOTMETH_ANDROID) ||
+	    !IS_ENABLED(CONFIG_AVB_VERIFY))
+		return -EAGAIN;
+
+	ut_assertok(scan_mmc_android_bootdev(uts, "mmc7"));
+	ut_assertok(uclass_get_device_by_name(UCLASS_MMC, "mmc7", &mmc));
+	ut_asserteq(7, blk_get_device_by_str("mmc", "7", &desc));
+	ut_assert(part_get_info_by_name(desc, "boot_a", &boot) > 0);
+	ut_assert(part_get_info_by_name(desc, "vendor_boot_a",
+					&vendor_boot) > 0);
+	part_blocks = boot.size + vendor_boot.size;
+
+	ut_assertok(env_set("loadaddr", "0x2000000"));
+	ut_assertok(env_set("vendor_boot_comp_addr_r", "0x3000000"));
+	ut_assertok(run_command("bootflow select mmc7.bootdev.whole", 0));
+	start = sandbox_mmc_get_blocks_read(mmc);
+	/* Sandbox stops once the images are loaded, before running bootm */
+	ut_asserteq(1, run_command("bootflow boot", 0));
+	blocks = sandbox_mmc_get_blocks_read(mmc) - start;
+
+	/*
+	 * The device is unlocked, so AVB loads the whole of each partition.
+	 * Reading them again to boot would double the number of blocks read.
+	 */
+	ut_assert(blocks >= part_blocks);
+	ut_assert(blocks < 2 * part_blocks);
+
+	ut_assertok(env_set("loadaddr", NULL));
+	ut_assertok(env_set("vendor_boot_comp_addr_r", NULL));
+
+	return 0;
+}
+BOOTSTD_TEST(bootflow_android_avb_preload, UTF_CONSOLE);
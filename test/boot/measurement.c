@@ -7,7 +7,10 @@
  */
 
 #include <bootm.h>
+#include <hash.h>
 #include <malloc.h>
+#include <tpm_api.h>
+#include <tpm_tcg2.h>
 #include <test/suites.h>
 #include <test/test.h>
 #include <test/ut.h>
@@ -54,6 +57,61 @@ static int measure(struct unit_test_state *uts)
 }
 MEASUREMENT_TEST(measure, 0);
 
+/* Check that the digests for all PCR banks match separate hashes */
+static int measure_digest(struct unit_test_state *uts)
+{
+	struct tpml_digest_values digest_list;
+	u8 expect[TPM2_SHA512_DIGEST_SIZE];
+	/* Cover several chunks, with a partial one at the end */
+	const size_t size = 100000;
+	struct tcg2_digest_ctx ctx;
+	struct udevice *dev;
+	u32 all = 0;
+	size_t i;
+	int len;
+	u8 *buf;
+
+	buf = malloc(size);
+	ut_assertnonnull(buf);
+	for (i = 0; i < size; i++)
+		buf[i] = i * 7 + (i >> 8);
+
+	/* Use every bank whose algorithm is enabled */
+	for (i = 0; i < ARRAY_SIZE(hash_algo_list); i++)
+		all |= hash_algo_list[i].hash_mask;
+
+	/* Add the data in uneven parts */
+	tcg2_digest_init(&ctx, all);
+	tcg2_digest_update(&ctx, buf, 1000);
+	tcg2_digest_update(&ctx, buf + 1000, size - 1000);
+	tcg2_digest_finish(&ctx, &digest_list);
+	ut_asserteq(ARRAY_SIZE(hash_algo_list), digest_list.count);
+	for (i = 0; i < digest_list.count; i++) {
+		u16 alg = digest_list.digests[i].hash_alg;
+
+		len = sizeof(expect);
+		ut_assertok(hash_block(tpm2_algorithm_name(alg), buf, size,
+				       expect, &len));
+		ut_asserteq(tpm2_algorithm_to_len(alg), len);
+		ut_asserteq_mem(expect, &digest_list.digests[i].digest, len);
+	}
+
+	/* The sandbox TPM only has a SHA256 bank */
+	ut_assertok(tcg2_platform_get_tpm2(&dev));
+	ut_assertok(tpm_auto_start(dev));
+	ut_assertok(tcg2_create_digest(dev, buf, size, &digest_list));
+	ut_asserteq(1, digest_list.count);
+	ut_asserteq(TPM2_ALG_SHA256, digest_list.digests[0].hash_alg);
+	len = sizeof(expect);
+	ut_assertok(hash_block("sha256", buf, size, expect, &len));
+	ut_asserteq_mem(expect, &digest_list.digests[0].digest, len);
+
+	free(buf);
+
+	return 0;
+}
+MEASUREMENT_TEST(measure_digest, 0);
+
 int do_ut_measurement(struct cmd_tbl *cmdtp, int flag, int argc,
 		      char *const argv[])
 {
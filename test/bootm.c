@@ -6,7 +6,12 @@
  */
 
 #include <bootm.h>
+#include <bootstage.h>
+#include <image.h>
+#include <lmb.h>
+#include <mapmem.h>
 #include <asm/global_data.h>
+#include <linux/libfdt.h>
 #include <test/suites.h>
 #include <test/test.h>
 #include <test/ut.h>
@@ -17,6 +22,13 @@ DECLARE_GLOBAL_DATA_PTR;
 
 enum {
 	BUF_SIZE	= 1024,
+
+	/* Layout of the FIT used for testing image loading */
+	FIT_ADDR	= 0x100000,
+	FIT_DATA_POS	= 0x1000,
+	FIT_DATA_SIZE	= 0x3000,
+	FIT_LOAD_ADDR	= 0x200000,
+	FIT_RSV_ADDR	= 0x300000,
 };
 
 #define CONSOLE_STR	"console=/dev/ttyS0"
@@ -238,6 +250,110 @@ static int bootm_test_subst_both(struct unit_test_state *uts)
 }
 BOOTM_TEST(bootm_test_subst_both, 0);
 
+/**
+ * setup_fit() - Create a FIT holding a single image with external data
+ *
+ * The image data is placed FIT_DATA_POS bytes into the FIT
+ *
+ * @uts: Test state
+ * @load: Load address for the image
+ */
+static int setup_fit(struct unit_test_state *uts, ulong load)
+{
+	void *fit = map_sysmem(FIT_ADDR, FIT_DATA_POS + FIT_DATA_SIZE);
+	u8 *data = fit + FIT_DATA_POS;
+	int images, node, i;
+
+	ut_assertok(fdt_create_empty_tree(fit, FIT_DATA_POS));
+	ut_assertok(fdt_setprop_string(fit, 0, FIT_DESC_PROP, "test"));
+	ut_assertok(fdt_setprop_u32(fit, 0, FIT_TIMESTAMP_PROP, 0));
+	images = fdt_add_subnode(fit, 0, "images");
+	ut_assert(images >= 0);
+	node = fdt_add_subnode(fit, images, "firmware-1");
+	ut_assert(node >= 0);
+	ut_assertok(fdt_setprop_string(fit, node, FIT_DESC_PROP, "firmware"));
+	ut_assertok(fdt_setprop_string(fit, node, FIT_TYPE_PROP, "firmware"));
+	ut_assertok(fdt_setprop_string(fit, node, FIT_ARCH_PROP, "sandbox"));
+	ut_assertok(fdt_setprop_string(fit, node, FIT_OS_PROP, "u-boot"));
+	ut_assertok(fdt_setprop_string(fit, node, FIT_COMP_PROP, "none"));
+	ut_assertok(fdt_setprop_u32(fit, node, FIT_LOAD_PROP, load));
+	ut_assertok(fdt_setprop_u32(fit, node, FIT_DATA_POSITION_PROP,
+				    FIT_DATA_POS));
+	ut_assertok(fdt_setprop_u32(fit, node, FIT_DATA_SIZE_PROP,
+				    FIT_DATA_SIZE));
+	ut_assertok(fdt_pack(fit));
+	ut_assert(fdt_totalsize(fit) <= FIT_DATA_POS);
+
+	for (i = 0; i < FIT_DATA_SIZE; i++)
+		data[i] = i;
+	unmap_sysmem(fit);
+
+	return 0;
+}
+
+/**
+ * load_fit() - Load the image from the test FIT
+ *
+ * @uts: Test state
+ * @copiedp: Returns the number of bytes copied while loading
+ * Return: result of fit_image_load()
+ */
+static int load_fit(struct unit_test_state *uts, ulong *copiedp)
+{
+	const char *uname = "firmware-1";
+	struct bootm_headers hdrs;
+	ulong data, len;
+	int ret;
+
+	memset(&hdrs, '\0', sizeof(hdrs));
+	ret = fit_image_load(&hdrs, FIT_ADDR, &uname, NULL, IH_ARCH_DEFAULT,
+			     IH_TYPE_LOADABLE, BOOTSTAGE_ID_FIT_LOADABLE_START,
+			     FIT_LOAD_OPTIONAL_NON_ZERO, &data, &len);
+	*copiedp = hdrs.copied;
+	if (ret < 0)
+		return ret;
+	ut_asserteq(FIT_DATA_SIZE, len);
+
+	return 0;
+}
+
+/* Test that image data is only copied when it is not already in place */
+static int bootm_test_fit_copy(struct unit_test_state *uts)
+{
+	struct lmb store;
+	ulong copied;
+	u8 *buf;
+
+	ut_assertok(lmb_push(&store));
+	ut_asserteq(0, lmb_add(0, gd->ram_size));
+
+	/* The data must be copied to the load address */
+	ut_assertok(setup_fit(uts, FIT_LOAD_ADDR));
+	ut_assertok(load_fit(uts, &copied));
+	ut_asserteq(FIT_DATA_SIZE, copied);
+	buf = map_sysmem(FIT_LOAD_ADDR, FIT_DATA_SIZE);
+	ut_asserteq_mem(map_sysmem(FIT_ADDR + FIT_DATA_POS, FIT_DATA_SIZE),
+			buf, FIT_DATA_SIZE);
+	unmap_sysmem(buf);
+
+	/* The data is already at its load address, so nothing is copied */
+	ut_assertok(setup_fit(uts, FIT_ADDR + FIT_DATA_POS));
+	ut_assertok(load_fit(uts, &copied));
+	ut_asserteq(0, copied);
+
+	/* Loading must not overwrite memory which is reserved */
+	ut_asserteq(0, lmb_reserve_flags(FIT_RSV_ADDR + FIT_DATA_SIZE / 2, 0x10,
+					 LMB_NOOVERWRITE));
+	ut_assertok(setup_fit(uts, FIT_RSV_ADDR));
+	ut_asserteq(-EXDEV, load_fit(uts, &copied));
+	ut_asserteq(0, copied);
+
+	lmb_pop(&store);
+
+	return 0;
+}
+BOOTM_TEST(bootm_test_fit_copy, 0);
+
 int do_ut_bootm(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	struct unit_test *tests = UNIT_TEST_SUITE_START(bootm_test);
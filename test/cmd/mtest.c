@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the fast 'mtest' command
+ */
+
+#include <command.h>
+#include <console.h>
+#include <cyclic.h>
+#include <mapmem.h>
+#include <dm/test.h>
+#include <test/ut.h>
+
+/* Declare a new mem test */
+#define MEM_TEST(_name, _flags)	UNIT_TEST(_name, _flags, mem_test)
+
+/*
+ * Emulate a word with some bits stuck at 1. The memory test calls schedule()
+ * after each pass, so this runs between the fill and the check.
+ */
+static void mem_test_stuck_bits(struct cyclic_info *cyclic)
+{
+	u64 *ptr = map_sysmem(0x1010, sizeof(u64));
+
+	*ptr |= 0xf0;
+	unmap_sysmem(ptr);
+}
+
+/* Check that 'mtest' reports errors found by each test */
+static int mem_test_mtest_errors(struct unit_test_state *uts)
+{
+	struct cyclic_info cyclic;
+	int ret;
+
+	if (!CONFIG_IS_ENABLED(CYCLIC))
+		return -EAGAIN;
+
+	cyclic_register(&cyclic, mem_test_stuck_bits, 0, "mem_test_stuck");
+	ret = run_command("mtest 1000 1100 0 1", 0);
+	cyclic_unregister(&cyclic);
+	ut_asserteq(1, ret);
+
+	ut_assert_nextline("Testing 00001000 ... 00001100:");
+	ut_assert_skip_to_linen("address     1 errors, ");
+	ut_assert_nextline("Mem error @ 0x00001010: found 00000000000010F0, expected 0000000000001010");
+
+	/* Found after the fill and again after the second inversion */
+	ut_assert_nextlinen("inversions  2 errors, ");
+	ut_assert_nextline("Mem error @ 0x00001010: found 00000000000000F0, expected 0000000000000000");
+	ut_assert_nextline("Mem error @ 0x00001010: found 00000000000000F0, expected 0000000000000000");
+	ut_assert_nextlinen("random      1 errors, ");
+	ut_assert_nextline("Mem error @ 0x00001010: found 975835DE1C9756FE, expected 975835DE1C9756CE");
+	ut_assert_nextline("%s", "");
+	ut_assert_nextline("Tested 1 iteration(s) with 4 errors.");
+	ut_assert_console_end();
+
+	return 0;
+}
+MEM_TEST(mem_test_mtest_errors, UTF_CONSOLE);
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for offloading work to secondary CPUs
+ */
+
+#include <malloc.h>
+#include <smp_work.h>
+#include <test/common.h>
+#include <test/test.h>
+#include <test/ut.h>
+#include <asm/global_data.h>
+#include <asm/test.h>
+#include <linux/sizes.h>
+#include <u-boot/sha256.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static int smp_work_test_func(void *arg)
+{
+	int *val = arg;
+
+	return (*val)++ ? -EEXIST : 0;
+}
+
+/* Test posting and waiting for jobs */
+static int common_test_smp_work_post(struct unit_test_state *uts)
+{
+	struct smp_work works[3];
+	int vals[3] = { 0, 0, 1 };
+	int i;
+
+	ut_assert(smp_work_init() >= 0);
+
+	smp_work_setup(&works[0], smp_work_test_func, &vals[0]);
+	ut_asserteq(-ENOENT, smp_work_wait(&works[0]));
+	ut_assertok(smp_work_post(&works[0]));
+	ut_assertok(smp_work_wait(&works[0]));
+	ut_asserteq(SMP_WORK_DONE, works[0].state);
+	ut_asserteq(1, vals[0]);
+
+	/* The error from the last job should be returned */
+	vals[0] = 0;
+	for (i = 0; i < ARRAY_SIZE(works); i++)
+		smp_work_setup(&works[i], smp_work_test_func, &vals[i]);
+	ut_asserteq(-EEXIST, smp_work_run_all(works, ARRAY_SIZE(works)));
+	for (i = 0; i < ARRAY_SIZE(works); i++)
+		ut_asserteq(SMP_WORK_DONE, works[i].state);
+	ut_asserteq(1, vals[0]);
+	ut_asserteq(1, vals[1]);
+	ut_asserteq(2, vals[2]);
+
+	return 0;
+}
+COMMON_TEST(common_test_smp_work_post, 0);
+
+static bool smp_work_test_release;
+
+/* Wait to be released, then check that this is running on a worker */
+static int smp_work_test_block(void *arg)
+{
+	while (!__atomic_load_n(&smp_work_test_release, __ATOMIC_ACQUIRE))
+		;
+
+	return gd->flags & GD_FLG_SMP_WORKER ? 0 : -EPERM;
+}
+
+/* Test running jobs on emulated secondary CPUs */
+static int common_test_smp_work_workers(struct unit_test_state *uts)
+{
+	struct smp_work works[3];
+	int val = 0;
+
+	/* Start two workers and one which is too slow to be used */
+	smp_work_stop();
+	sandbox_smp_work_set_cpus(3, true);
+	ut_asserteq(2, smp_work_init());
+	ut_asserteq(2, smp_work_num_workers());
+	ut_asserteq(3, sandbox_smp_work_threads());
+
+	/* Keep both workers busy, so the last job runs on the boot CPU */
+	__atomic_store_n(&smp_work_test_release, false, __ATOMIC_RELEASE);
+	smp_work_setup(&works[0], smp_work_test_block, NULL);
+	smp_work_setup(&works[1], smp_work_test_block, NULL);
+	smp_work_setup(&works[2], smp_work_test_func, &val);
+	ut_assertok(smp_work_post(&works[0]));
+	ut_assertok(smp_work_post(&works[1]));
+	ut_assertok(smp_work_post(&works[2]));
+	ut_asserteq(SMP_WORK_DONE, works[2].state);
+	ut_asserteq(0, works[2].cpu);
+	ut_asserteq(1, val);
+
+	__atomic_store_n(&smp_work_test_release, true, __ATOMIC_RELEASE);
+	ut_assertok(smp_work_wait(&works[0]));
+	ut_assertok(smp_work_wait(&works[1]));
+	ut_asserteq(1, works[0].cpu);
+	ut_asserteq(2, works[1].cpu);
+
+	/* Stopping must also collect the slow CPU */
+	smp_work_stop();
+	ut_asserteq(0, smp_work_num_workers());
+	ut_asserteq(0, sandbox_smp_work_threads());
+
+	/* Now there are no workers, so jobs run on the boot CPU */
+	sandbox_smp_work_set_cpus(0, false);
+	ut_asserteq(0, smp_work_init());
+	smp_work_setup(&works[0], smp_work_test_func, &val);
+	ut_assertok(smp_work_post(&works[0]));
+	ut_asserteq(-EEXIST, smp_work_wait(&works[0]));
+	ut_asserteq(0, works[0].cpu);
+
+	return 0;
+}
+COMMON_TEST(common_test_smp_work_workers, 0);
+
+/* Test splitting memory operations */
+static int common_test_smp_work_mem(struct unit_test_state *uts)
+{
+	const size_t size = SZ_1M + 3;
+	u8 *src, *dst;
+	size_t i;
+
+	src = malloc(size);
+	dst = malloc(size);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+
+	ut_assertok(smp_work_memset(src, 0xa5, size));
+	for (i = 0; i < size; i++)
+		ut_asserteq(0xa5, src[i]);
+
+	for (i = 0; i < size; i++)
+		src[i] = i * 7;
+	ut_assertok(smp_work_memcpy(dst, src, size));
+	ut_asserteq_mem(src, dst, size);
+
+	free(dst);
+	free(src);
+
+	return 0;
+}
+COMMON_TEST(common_test_smp_work_mem, 0);
+
+/* Test hashing a buffer */
+static int common_test_smp_work_hash(struct unit_test_state *uts)
+{
+	u8 expect[SHA256_SUM_LEN], value[SHA256_SUM_LEN];
+	struct smp_work_hash hash;
+	static const char data[] = "smp_work hash test";
+
+	sha256_csum_wd((const u8 *)data, sizeof(data), expect,
+		       CHUNKSZ_SHA256);
+
+	hash.algo = "sha256";
+	hash.data = data;
+	hash.size = sizeof(data);
+	hash.value = value;
+	ut_assertok(smp_work_hash_post(&hash));
+	ut_assertok(smp_work_wait(&hash.work));
+	ut_asserteq(SHA256_SUM_LEN, hash.value_len);
+	ut_asserteq_mem(expect, value, SHA256_SUM_LEN);
+
+	hash.algo = "nonsense";
+	ut_assertok(smp_work_hash_post(&hash));
+	ut_asserteq(-EPROTONOSUPPORT, smp_work_wait(&hash.work));
+
+	return 0;
+}
+COMMON_TEST(common_test_smp_work_hash, 0);
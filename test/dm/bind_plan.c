@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the devicetree bind plan
+ */
+
+#include <bloblist.h>
+#include <dm.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <asm/global_data.h>
+#include <dm/bind_plan.h>
+#include <dm/root.h>
+#include <dm/test.h>
+#include <dm/uclass-internal.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Size of the bloblist used for testing, enough for the test devicetree */
+#define TEST_BLOBLIST_SIZE	0x10000
+
+/**
+ * scan_with_plan() - Remove all devices and scan again using the plan
+ *
+ * @uts: Test state
+ * @stats: Returns information about the use of the plan
+ * @dev_countp: Returns the number of devices after the scan
+ * Return: 0 if OK, -ve on error
+ */
+static int scan_with_plan(struct unit_test_state *uts,
+			  struct dm_bind_plan_stats *stats, int *dev_countp)
+{
+	int id, uc_count;
+
+	for (id = UCLASS_ROOT + 1; id < UCLASS_COUNT; id++) {
+		struct uclass *uc;
+
+		uc = uclass_find(id);
+		if (uc)
+			ut_assertok(uclass_destroy(uc));
+	}
+
+	ut_assertok(dm_scan_plat(false));
+	dm_bind_plan_start();
+	ut_assertok(dm_extended_scan(false));
+	ut_assertok(dm_bind_plan_finish(0));
+	dm_bind_plan_get_stats(stats);
+	dm_get_stats(dev_countp, &uc_count);
+
+	return 0;
+}
+
+static int check_bind_plan(struct unit_test_state *uts)
+{
+	struct dm_bind_plan_stats stats;
+	struct dm_bind_plan_hdr *hdr;
+	struct dm_bind_plan_ent *ent;
+	int dev_count, count;
+	uint planned;
+
+	/* The first scan has no plan, so records one */
+	ut_assertok(scan_with_plan(uts, &stats, &dev_count));
+	ut_asserteq(0, stats.planned);
+	ut_asserteq(0, stats.hits);
+	ut_assert(stats.written);
+	hdr = bloblist_find(BLOBLISTT_U_BOOT_DM_BIND_PLAN, 0);
+	ut_assertnonnull(hdr);
+	ut_asserteq(DM_BIND_PLAN_VERSION, hdr->version);
+	ut_asserteq(stats.searched, hdr->count);
+	planned = hdr->count;
+
+	/* The second scan follows it, binding the same devices */
+	ut_assertok(scan_with_plan(uts, &stats, &count));
+	ut_asserteq(planned, stats.planned);
+	ut_assert(stats.hits > 0);
+	ut_asserteq(planned, stats.hits + stats.searched);
+	ut_assert(!stats.written);
+	ut_asserteq(dev_count, count);
+
+	/* A different devicetree invalidates the plan */
+	hdr->fdt_crc ^= 1;
+	ut_assertok(scan_with_plan(uts, &stats, &count));
+	ut_asserteq(0, stats.planned);
+	ut_assert(stats.written);
+	ut_asserteq(dev_count, count);
+
+	/* An entry that does not match the node is detected */
+	hdr = bloblist_find(BLOBLISTT_U_BOOT_DM_BIND_PLAN, 0);
+	ut_assertnonnull(hdr);
+	for (ent = hdr->ent; ent < hdr->ent + hdr->count; ent++) {
+		if (ent->drv_idx < DM_BIND_PLAN_SEARCH)
+			break;
+	}
+	ut_assert(ent < hdr->ent + hdr->count);
+	ent->match_idx = 0x7fff;
+	ut_assertok(scan_with_plan(uts, &stats, &count));
+	ut_asserteq(planned, stats.planned);
+	ut_assert(stats.hits < planned);
+	ut_assert(stats.written);
+	ut_asserteq(dev_count, count);
+
+	/* The rewritten plan is followed again */
+	ut_assertok(scan_with_plan(uts, &stats, &count));
+	ut_asserteq(planned, stats.hits + stats.searched);
+	ut_assert(!stats.written);
+	ut_asserteq(dev_count, count);
+
+	return 0;
+}
+
+/* Test recording and following the bind plan */
+static int dm_test_bind_plan(struct unit_test_state *uts)
+{
+	struct bloblist_hdr *old = gd->bloblist;
+	void *buf;
+	int ret;
+
+	/* Use a separate bloblist, since sandbox's one is too small */
+	buf = memalign(BLOBLIST_ALIGN, TEST_BLOBLIST_SIZE);
+	ut_assertnonnull(buf);
+	ut_assertok(bloblist_new(map_to_sysmem(buf), TEST_BLOBLIST_SIZE, 0,
+				 0));
+	ret = check_bind_plan(uts);
+	gd->bloblist = old;
+	free(buf);
+
+	return ret;
+}
+DM_TEST(dm_test_bind_plan, 0);
@@ -6,6 +6,7 @@
  */
 
 #include <errno.h>
+#include <command.h>
 #include <dm.h>
 #include <fdtdec.h>
 #include <log.h>
@@ -1351,3 +1352,53 @@ static int dm_test_dev_get_mem(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_dev_get_mem, UTF_SCAN_FDT);
+
+#if CONFIG_IS_ENABLED(DM_PROBE_STATS)
+/* Test recording the time taken to probe devices */
+static int dm_test_probe_stats(struct unit_test_state *uts)
+{
+	struct dm_probe_stats *bus_stats, *child_stats;
+	struct udevice *bus, *child;
+	ulong bus_probe, child_nested;
+	u32 bus_count, child_count;
+
+	/* The bus binds its children when it is probed */
+	ut_assertok(uclass_first_device_err(UCLASS_TEST_BUS, &bus));
+	ut_assertok(device_find_first_child(bus, &child));
+	ut_assertnonnull(child);
+	ut_assertok(device_remove(bus, DM_REMOVE_NORMAL));
+	bus_stats = &bus->probe_stats;
+	child_stats = &child->probe_stats;
+	bus_count = bus_stats->probe_count;
+	child_count = child_stats->probe_count;
+	bus_probe = bus_stats->time_us[DM_PROBE_STAT_PROBE];
+	child_nested = child_stats->time_us[DM_PROBE_STAT_NESTED];
+
+	/* Probing the child probes the bus first, which counts as nested */
+	ut_assertok(device_probe(child));
+	ut_asserteq(bus_count + 1, bus_stats->probe_count);
+	ut_asserteq(child_count + 1, child_stats->probe_count);
+	ut_assert(child_stats->time_us[DM_PROBE_STAT_NESTED] - child_nested >=
+		  bus_stats->time_us[DM_PROBE_STAT_PROBE] - bus_probe);
+	ut_assert(child_stats->time_us[DM_PROBE_STAT_PROBE] >=
+		  child_stats->time_us[DM_PROBE_STAT_NESTED]);
+
+	/* Probing an active device is not counted */
+	ut_assertok(device_probe(child));
+	ut_asserteq(child_count + 1, child_stats->probe_count);
+
+	ut_assertok(run_command("dm probe-stats", 0));
+	ut_assert_nextlinen("Driver ");
+	ut_assert_nextlinen("-----");
+	ut_assert_skip_to_linen("Total (us)");
+	ut_assert_console_end();
+
+	ut_assertok(run_command("dm probe-stats -u -a", 0));
+	ut_assert_nextlinen("Uclass ");
+	ut_assert_skip_to_linen("Total (us)");
+	ut_assert_console_end();
+
+	return 0;
+}
+DM_TEST(dm_test_probe_stats, UTF_SCAN_FDT | UTF_CONSOLE);
+#endif
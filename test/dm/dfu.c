@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for DFU on MMC
+ */
+
+#include <dfu.h>
+#include <dm.h>
+#include <env.h>
+#include <fs.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <dm/test.h>
+#include <test/ut.h>
+#include <linux/stringify.h>
+
+#define DFU_TEST_FILE	"dfu_test.bin"
+#define DFU_TEST_BLKSZ	0x1000
+#define DFU_TEST_SIZE	0x2800
+
+/* Get the size of the test file in the FAT partition of mmc1 */
+static int dfu_test_size(struct unit_test_state *uts, loff_t *sizep)
+{
+	ut_assertok(fs_set_blk_dev("mmc", "1:1", FS_TYPE_FAT));
+	ut_assertok(fs_size(DFU_TEST_FILE, sizep));
+
+	return 0;
+}
+
+/* Test that files are written to MMC as the data arrives */
+static int dm_test_dfu_mmc_stream(struct unit_test_state *uts)
+{
+	char alt[] = DFU_TEST_FILE " fat 1 1";
+	struct dfu_entity *dfu;
+	struct udevice *dev;
+	char *buf, *rbuf;
+	loff_t size;
+	int i, seq;
+
+	buf = malloc(DFU_TEST_SIZE);
+	ut_assertnonnull(buf);
+	rbuf = malloc(DFU_TEST_SIZE);
+	ut_assertnonnull(rbuf);
+	for (i = 0; i < DFU_TEST_SIZE; i++)
+		buf[i] = i * 7;
+
+	/* DFU looks up the MMC device without probing it */
+	ut_assertok(uclass_get_device_by_seq(UCLASS_MMC, 1, &dev));
+
+	/* Use a small DFU buffer so that it is drained several times */
+	ut_assertok(env_set("dfu_bufsiz", __stringify(DFU_TEST_BLKSZ)));
+	ut_assertok(dfu_config_entities(alt, "mmc", "1"));
+	dfu = dfu_get_entity(0);
+	ut_assertnonnull(dfu);
+
+	/* The first block is in the file before the transfer ends */
+	ut_assertok(dfu_write(dfu, buf, DFU_TEST_BLKSZ, 0));
+	ut_assertok(dfu_test_size(uts, &size));
+	ut_asserteq(DFU_TEST_BLKSZ, size);
+
+	for (i = DFU_TEST_BLKSZ, seq = 1; i < DFU_TEST_SIZE;
+	     i += DFU_TEST_BLKSZ, seq++)
+		ut_assertok(dfu_write(dfu, buf + i,
+				      min(DFU_TEST_SIZE - i, DFU_TEST_BLKSZ),
+				      seq));
+	ut_assertok(dfu_flush(dfu, NULL, 0, seq));
+
+	ut_assertok(dfu_test_size(uts, &size));
+	ut_asserteq(DFU_TEST_SIZE, size);
+	ut_assertok(fs_set_blk_dev("mmc", "1:1", FS_TYPE_FAT));
+	ut_assertok(fs_read(DFU_TEST_FILE, map_to_sysmem(rbuf), 0, 0, &size));
+	ut_asserteq(DFU_TEST_SIZE, size);
+	ut_asserteq_mem(buf, rbuf, DFU_TEST_SIZE);
+
+	/* A transfer with no data leaves an empty file */
+	ut_assertok(dfu_flush(dfu, NULL, 0, 0));
+	ut_assertok(dfu_test_size(uts, &size));
+	ut_asserteq(0, size);
+
+	ut_assertok(fs_set_blk_dev("mmc", "1:1", FS_TYPE_FAT));
+	ut_assertok(fs_unlink(DFU_TEST_FILE));
+	dfu_free_entities();
+	ut_assertok(env_set("dfu_bufsiz", NULL));
+	free(rbuf);
+	free(buf);
+
+	return 0;
+}
+DM_TEST(dm_test_dfu_mmc_stream, UTF_SCAN_PDATA | UTF_SCAN_FDT);
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for batched filesystem reads and read-ahead
+ */
+
+#include <blk.h>
+#include <dm.h>
+#include <fs_internal.h>
+#include <fs_io.h>
+#include <part.h>
+#include <dm/test.h>
+#include <test/ut.h>
+
+/* First sector used by the tests, and the number of sectors */
+#define TEST_START	100
+#define TEST_COUNT	32
+
+static u8 disk[TEST_COUNT * 512];
+static u8 out[TEST_COUNT * 512];
+
+/* Write a pattern to the test sectors and set up a partition around them */
+static int setup_disk(struct unit_test_state *uts, struct blk_desc **descp,
+		      struct disk_partition *part)
+{
+	struct blk_desc *desc;
+	int i;
+
+	ut_asserteq(2, blk_get_device_by_str("mmc", "2", &desc));
+	ut_asserteq(512, desc->blksz);
+	for (i = 0; i < sizeof(disk); i++)
+		disk[i] = i * 7 + (i >> 9);
+	ut_asserteq(TEST_COUNT, blk_dwrite(desc, TEST_START, TEST_COUNT, disk));
+
+	memset(part, '\0', sizeof(*part));
+	part->start = TEST_START;
+	part->size = TEST_COUNT;
+	part->blksz = desc->blksz;
+	*descp = desc;
+
+	return 0;
+}
+
+/* Check that queued reads are sorted, merged and read correctly */
+static int dm_test_fs_io_merge(struct unit_test_state *uts)
+{
+	struct disk_partition part;
+	struct fs_io_stats stats;
+	struct blk_desc *desc;
+	struct fs_io io;
+	u8 a[600], b[300];
+
+	ut_assertok(setup_disk(uts, &desc, &part));
+	memset(out, '\0', sizeof(out));
+	fs_io_stats(&stats);
+
+	fs_io_init(&io, desc, &part);
+
+	/* Out of order, but following on from each other on disk and memory */
+	ut_assertok(fs_io_add(&io, 8, 0, 4096, out + 4096));
+	ut_assertok(fs_io_add(&io, 0, 0, 4096, out));
+
+	/* Following on from each other on disk only */
+	ut_assertok(fs_io_add(&io, 20, 10, sizeof(a), a));
+	ut_assertok(fs_io_add(&io, 20, 10 + sizeof(a), sizeof(b), b));
+
+	/* A read on its own */
+	ut_assertok(fs_io_add(&io, 30, 100, 200, out + 8192));
+	ut_assertok(fs_io_submit(&io));
+	fs_io_uninit(&io);
+
+	ut_asserteq_mem(disk, out, 8192);
+	ut_asserteq_mem(disk + 20 * 512 + 10, a, sizeof(a));
+	ut_asserteq_mem(disk + 20 * 512 + 10 + sizeof(a), b, sizeof(b));
+	ut_asserteq_mem(disk + 30 * 512 + 100, out + 8192, 200);
+
+	fs_io_stats(&stats);
+	ut_asserteq(5, stats.requests);
+	ut_asserteq(2, stats.merged);
+	ut_asserteq(3, stats.reads);
+	ut_asserteq(8192 + sizeof(a) + sizeof(b) + 200, stats.bytes);
+
+	return 0;
+}
+DM_TEST(dm_test_fs_io_merge, UTF_SCAN_PDATA | UTF_SCAN_FDT);
+
+/* Check that small reads are served from the read-ahead window */
+static int dm_test_fs_io_readahead(struct unit_test_state *uts)
+{
+	struct disk_partition part;
+	struct fs_io_stats stats;
+	struct blk_desc *desc;
+	ulong old;
+	int i;
+
+	ut_assertok(setup_disk(uts, &desc, &part));
+	old = fs_io_set_readahead(8 * 512);
+	fs_io_stats(&stats);
+
+	/* Nothing is read ahead unless a file is being read */
+	ut_asserteq(1, fs_devread(desc, &part, 0, 0, 100, (char *)out));
+	fs_io_stats(&stats);
+	ut_asserteq(0, stats.ra_fills);
+
+	fs_io_readahead_start();
+	for (i = 0; i < 16; i++) {
+		ut_asserteq(1, fs_devread(desc, &part, i / 2, (i % 2) * 256, 256,
+					  (char *)out + i * 256));
+	}
+
+	/* The last window is cut short by the end of the partition */
+	ut_asserteq(1, fs_devread(desc, &part, TEST_COUNT - 1, 0, 512,
+				  (char *)out + 4096));
+	fs_io_readahead_stop();
+	ut_asserteq_mem(disk, out, 4096);
+	ut_asserteq_mem(disk + (TEST_COUNT - 1) * 512, out + 4096, 512);
+
+	fs_io_stats(&stats);
+	ut_asserteq(2, stats.ra_fills);
+	ut_asserteq(15, stats.ra_hits);
+	fs_io_set_readahead(old);
+
+	return 0;
+}
+DM_TEST(dm_test_fs_io_readahead, UTF_SCAN_PDATA | UTF_SCAN_FDT);
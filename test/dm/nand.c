@@ -3,14 +3,19 @@
  * Copyright (C) 2023 Sean Anderson <seanga2@gmail.com>
  */
 
+#include <command.h>
+#include <mapmem.h>
 #include <nand.h>
 #include <part.h>
 #include <rand.h>
+#include <ubi_uboot.h>
 #include <dm/test.h>
 #include <test/test.h>
 #include <test/ut.h>
+#include <asm/test.h>
 #include <linux/mtd/mtd.h>
 #include <linux/mtd/rawnand.h>
+#include <linux/sizes.h>
 
 static int run_test_nand(struct unit_test_state *uts, int dev, bool end)
 {
@@ -119,3 +124,158 @@ static int dm_test_nand1_end(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_nand1_end, UTF_SCAN_FDT);
+
+static int dm_test_nand_cache_read(struct unit_test_state *uts)
+{
+	nand_erase_options_t opts = { };
+	struct mtd_info *mtd;
+	size_t length, size;
+	uint seqs, ends, ppb;
+	loff_t off;
+	char *buf;
+	int *gold;
+	int i;
+
+	/* nand0 has no ONFI parameter page, so READ CACHE cannot be used */
+	mtd = get_nand_dev_by_index(0);
+	ut_assertnonnull(mtd);
+	ut_asserteq(0, NAND_HAS_CACHE_READ(mtd_to_nand(mtd)));
+
+	mtd = get_nand_dev_by_index(1);
+	ut_assertnonnull(mtd);
+	ut_assert(NAND_HAS_CACHE_READ(mtd_to_nand(mtd)));
+
+	/* Seed RNG for bit errors */
+	srand(1);
+
+	size = mtd->erasesize * 2;
+	buf = malloc(size);
+	ut_assertnonnull(buf);
+	gold = malloc(size);
+	ut_assertnonnull(gold);
+
+	opts.offset = 0;
+	opts.length = size;
+	opts.lim = U32_MAX;
+	ut_assertok(nand_erase_opts(mtd, &opts));
+
+	for (i = 0; i < size / sizeof(int); i++)
+		gold[i] = rand();
+	length = size;
+	ut_assertok(nand_write_skip_bad(mtd, 0, &length, NULL, U64_MAX,
+					(void *)gold, 0));
+	ut_asserteq(size, length);
+
+	/*
+	 * Read from the second page across the block boundary, ending part
+	 * of the way through a page, so that sequences stop at the end of
+	 * the block and before the last page
+	 */
+	off = mtd->writesize;
+	length = size - off - 100;
+	memset(buf, '\0', size);
+	sand_nand_get_cache_reads(mtd, &seqs, &ends);
+	ut_assertok(nand_read_skip_bad(mtd, off, &length, NULL, U64_MAX, buf));
+	ut_asserteq(size - off - 100, length);
+	ut_asserteq_mem((char *)gold + off, buf, length);
+
+	/*
+	 * Each block has a sequence of all but one page, with READ CACHE END
+	 * for its last page and READ CACHE SEQUENTIAL for the rest
+	 */
+	ppb = mtd->erasesize / mtd->writesize;
+	sand_nand_get_cache_reads(mtd, &seqs, &ends);
+	ut_asserteq(2 * (ppb - 2), seqs);
+	ut_asserteq(2, ends);
+
+	/* A single page is read without a sequence */
+	length = mtd->writesize;
+	ut_assertok(nand_read_skip_bad(mtd, off, &length, NULL, U64_MAX, buf));
+	sand_nand_get_cache_reads(mtd, &seqs, &ends);
+	ut_asserteq(0, seqs);
+	ut_asserteq(0, ends);
+
+	free(gold);
+	free(buf);
+
+	return 0;
+}
+DM_TEST(dm_test_nand_cache_read, UTF_SCAN_FDT);
+
+/* Attach UBI, reading the headers of each PEB together where possible */
+static int dm_test_nand_ubi_attach(struct unit_test_state *uts)
+{
+	nand_erase_options_t opts = { };
+	const size_t size = SZ_64K;
+	struct mtd_info *mtd;
+	uint threshold;
+	char *buf, *gold;
+	int good, i;
+	loff_t off;
+
+	if (!IS_ENABLED(CONFIG_CMD_UBI))
+		return -EAGAIN;
+
+	mtd = get_nand_dev_by_index(0);
+	ut_assertnonnull(mtd);
+
+	/* Start with an empty device, which UBI formats when attaching */
+	opts.length = mtd->size;
+	opts.quiet = 1;
+	ut_assertok(nand_erase_opts(mtd, &opts));
+	for (off = 0, good = 0; off < mtd->size; off += mtd->erasesize)
+		good += !mtd_block_isbad(mtd, off);
+
+	/*
+	 * Every read has a corrected bit-flip, so stop MTD reporting them, or
+	 * UBI would scrub every PEB
+	 */
+	threshold = mtd->bitflip_threshold;
+	mtd->bitflip_threshold = mtd->ecc_strength + 1;
+
+	srand(1);
+	buf = malloc(size);
+	ut_assertnonnull(buf);
+	gold = malloc(size);
+	ut_assertnonnull(gold);
+	for (i = 0; i < size; i++)
+		gold[i] = rand();
+
+	ut_assertok(run_command("ubi part nand0", 0));
+	ut_assertok(run_commandf("ubi create test %zx static", size));
+	ut_assertok(run_commandf("ubi write %lx test %zx",
+				 (ulong)map_to_sysmem(gold), size));
+	ut_assertok(run_command("ubi detach", 0));
+
+	/* Both headers of every PEB are read with a single request */
+	ut_assertok(run_command("ubi part nand0", 0));
+	ut_asserteq(good, ubi_devices[0]->hdrs_together);
+	ut_asserteq(0, ubi_devices[0]->hdrs_apart);
+	ut_assertok(run_commandf("ubi read %lx test %zx",
+				 (ulong)map_to_sysmem(buf), size));
+	ut_asserteq_mem(gold, buf, size);
+	ut_assertok(run_command("ubi detach", 0));
+
+	/* An ECC error reading them together falls back to separate reads */
+	sand_nand_fail_reads(mtd, 1);
+	ut_assertok(run_command("ubi part nand0", 0));
+	ut_asserteq(good - 1, ubi_devices[0]->hdrs_together);
+	ut_asserteq(1, ubi_devices[0]->hdrs_apart);
+	memset(buf, '\0', size);
+	ut_assertok(run_commandf("ubi read %lx test %zx",
+				 (ulong)map_to_sysmem(buf), size));
+	ut_asserteq_mem(gold, buf, size);
+	ut_assertok(run_command("ubi detach", 0));
+
+	mtd->bitflip_threshold = threshold;
+	free(gold);
+	free(buf);
+
+	return 0;
+}
+/*
+ * The ubi command uses the NAND devices which U-Boot probed at start-up, so
+ * there is no need to scan the devicetree. The nodes of those devices are only
+ * valid in the live tree that U-Boot started with.
+ */
+DM_TEST(dm_test_nand_ubi_attach, UTF_LIVE_TREE | UTF_CONSOLE);
@@ -3,6 +3,7 @@
  * Copyright (C) 2020 Sean Anderson <sean.anderson@seco.com>
  */
 
+#include <blk.h>
 #include <dm.h>
 #include <mmc.h>
 #include <part.h>
@@ -194,3 +195,75 @@ static int dm_test_part_get_info_by_type(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_part_get_info_by_type, UTF_SCAN_PDATA | UTF_SCAN_FDT);
+
+/* Check that the partition table is only read once and dropped on writes */
+static int dm_test_part_cache(struct unit_test_state *uts)
+{
+	char str_disk_guid[UUID_STR_LEN + 1];
+	struct part_cache_stats stats;
+	struct blk_desc *mmc_dev_desc;
+	struct disk_partition info;
+	struct disk_partition parts[2] = {
+		{
+			.start = 48,
+			.size = 1,
+			.name = "test1",
+		},
+		{
+			.start = 49,
+			.size = 1,
+			.name = "test2",
+		},
+	};
+	char buf[512];
+	uint entries;
+	int i;
+
+	if (!CONFIG_IS_ENABLED(PARTITION_CACHE))
+		return -EAGAIN;
+
+	ut_asserteq(2, blk_get_device_by_str("mmc", "2", &mmc_dev_desc));
+	if (CONFIG_IS_ENABLED(RANDOM_UUID)) {
+		gen_rand_uuid_str(parts[0].uuid, UUID_STR_FORMAT_STD);
+		gen_rand_uuid_str(parts[1].uuid, UUID_STR_FORMAT_STD);
+		gen_rand_uuid_str(str_disk_guid, UUID_STR_FORMAT_STD);
+	}
+	ut_assertok(gpt_restore(mmc_dev_desc, str_disk_guid, parts,
+				ARRAY_SIZE(parts)));
+	part_cache_stats(&stats);
+
+	/* Look through all the partitions, as 'part list' does */
+	for (i = 1; i <= MAX_SEARCH_PARTITIONS; i++) {
+		int ret = part_get_info(mmc_dev_desc, i, &info);
+
+		if (i <= ARRAY_SIZE(parts)) {
+			ut_assertok(ret);
+			ut_asserteq(parts[i - 1].start, info.start);
+			ut_asserteq_str((char *)parts[i - 1].name,
+					(char *)info.name);
+		} else {
+			ut_asserteq(-ENOENT, ret);
+		}
+	}
+	ut_asserteq(2, part_get_info_by_name(mmc_dev_desc, "test2", &info));
+
+	/* The table should have been read just once */
+	part_cache_stats(&stats);
+	ut_asserteq(1, stats.reads);
+	ut_asserteq(0, stats.misses);
+	ut_asserteq(MAX_SEARCH_PARTITIONS + 2, stats.hits);
+	entries = stats.entries;
+
+	/* Writing to the device drops the information */
+	ut_asserteq(1, blk_dread(mmc_dev_desc, 60, 1, buf));
+	ut_asserteq(1, blk_dwrite(mmc_dev_desc, 60, 1, buf));
+	part_cache_stats(&stats);
+	ut_asserteq(entries - 1, stats.entries);
+
+	ut_assertok(part_get_info(mmc_dev_desc, 1, &info));
+	part_cache_stats(&stats);
+	ut_asserteq(1, stats.reads);
+
+	return 0;
+}
+DM_TEST(dm_test_part_cache, UTF_SCAN_PDATA | UTF_SCAN_FDT);
@@ -6,11 +6,14 @@
 #include <log.h>
 #include <serial.h>
 #include <dm.h>
+#include <asm/global_data.h>
 #include <asm/serial.h>
 #include <dm/test.h>
 #include <test/test.h>
 #include <test/ut.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
 static const char test_message[] =
 	"This is a test message\n"
 	"consisting of multiple lines\n";
@@ -88,3 +91,54 @@ static int dm_test_serial(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_serial, UTF_SCAN_FDT);
+
+/* Test buffering of serial output while the UART is busy */
+static int dm_test_serial_tx_buffer(struct unit_test_state *uts)
+{
+	struct serial_tx_stats stats, before;
+	struct udevice *dev;
+	size_t start, len;
+	int i;
+
+	if (!CONFIG_IS_ENABLED(SERIAL_TX_BUFFER))
+		return -EAGAIN;
+	dev = gd->cur_serial_dev;
+	ut_assertnonnull(dev);
+	ut_assertok(serial_get_tx_stats(dev, &before));
+	ut_asserteq(CONFIG_SERIAL_TX_BUFFER_SIZE, before.size);
+	ut_asserteq(0, before.used);
+
+	/* Each newline is sent as \r\n */
+	len = sizeof(test_message) - 1 + 2;
+
+	/* Output stays in the buffer while the UART is busy */
+	sandbox_serial_endisable(false);
+	start = sandbox_serial_written();
+	sandbox_serial_set_busy(1);
+	serial_puts(test_message);
+	ut_asserteq(start, sandbox_serial_written());
+	ut_assertok(serial_get_tx_stats(dev, &stats));
+	ut_asserteq(len, stats.used);
+
+	/* Flushing sends it all */
+	serial_flush();
+	ut_asserteq(len, sandbox_serial_written() - start);
+	ut_assertok(serial_get_tx_stats(dev, &stats));
+	ut_asserteq(0, stats.used);
+	ut_asserteq(before.dropped, stats.dropped);
+
+	/* Once the buffer is full, output waits for the UART */
+	start = sandbox_serial_written();
+	sandbox_serial_set_busy(CONFIG_SERIAL_TX_BUFFER_SIZE + 10);
+	for (i = 0; i < CONFIG_SERIAL_TX_BUFFER_SIZE + 1; i++)
+		serial_putc('x');
+	sandbox_serial_endisable(true);
+	ut_assertok(serial_get_tx_stats(dev, &stats));
+	ut_asserteq(before.overflows + 1, stats.overflows);
+	ut_asserteq(0, stats.used);
+	ut_asserteq(CONFIG_SERIAL_TX_BUFFER_SIZE + 1,
+		    sandbox_serial_written() - start);
+
+	return 0;
+}
+DM_TEST(dm_test_serial_tx_buffer, 0);
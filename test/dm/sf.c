@@ -4,6 +4,7 @@
  */
 
 #include <command.h>
+#include <console.h>
 #include <dm.h>
 #include <fdtdec.h>
 #include <mapmem.h>
@@ -92,6 +93,15 @@ static int dm_test_spi_flash_func(struct unit_test_state *uts)
 		"host save hostfs - 0 spi.bin 200000;"
 		"sf probe;"
 		"sf test 0 10000", -1,  0));
+
+	/* Sandbox's SPI controller cannot map the flash, so it is emulated */
+	console_record_reset();
+	ut_assertok(run_command("sf bench 0 10000", 0));
+	ut_assert_nextline("Read opcode 03, protocol 1-1-1, 0 dummy cycles");
+	ut_assert_nextlinen("spi-mem ops ");
+	ut_assert_nextlinen("dirmap (emulated) ");
+	ut_assert_console_end();
+
 	/*
 	 * Since we are about to destroy all devices, we must tell sandbox
 	 * to forget the emulation device
@@ -100,4 +110,4 @@ static int dm_test_spi_flash_func(struct unit_test_state *uts)
 
 	return 0;
 }
-DM_TEST(dm_test_spi_flash_func, UTF_SCAN_PDATA | UTF_SCAN_FDT);
+DM_TEST(dm_test_spi_flash_func, UTF_SCAN_PDATA | UTF_SCAN_FDT | UTF_CONSOLE);
@@ -8,6 +8,7 @@
 #include <log.h>
 #include <search.h>
 #include <stdio.h>
+#include <time.h>
 #include <vsprintf.h>
 #include <test/env.h>
 #include <test/ut.h>
@@ -118,7 +119,118 @@ static int env_test_htab_deletes(struct unit_test_state *uts)
 	ut_assertok(htab_check_fill(uts, &htab, SIZE / 2));
 	ut_asserteq(SIZE / 2, htab.filled);
 
+	/* deleted entries must not be allowed to fill up the table */
+	ut_assert((htab.filled + htab.deleted) * 4 <= htab.size * 3);
+
 	hdestroy_r(&htab);
 	return 0;
 }
 ENV_TEST(env_test_htab_deletes, 0);
+
+/* Add many more entries than the table was created with */
+static int env_test_htab_grow(struct unit_test_state *uts)
+{
+	struct hsearch_data htab;
+
+	memset(&htab, 0, sizeof(htab));
+	ut_asserteq(1, hcreate_r(SIZE, &htab));
+
+	ut_assertok(htab_fill(uts, &htab, SIZE * 100));
+	ut_assertok(htab_check_fill(uts, &htab, SIZE * 100));
+	ut_asserteq(SIZE * 100, htab.filled);
+
+	/* the table should have grown to keep a good number of free slots */
+	ut_assert(htab.filled * 4 <= htab.size * 3);
+
+	hdestroy_r(&htab);
+	return 0;
+}
+ENV_TEST(env_test_htab_grow, 0);
+
+/* Table used by htab_grow_cb() */
+static struct hsearch_data *grow_htab;
+
+/* Callback which adds enough variables to make the table grow */
+static int htab_grow_cb(const char *name, const char *value, enum env_op op,
+			int flags)
+{
+	struct env_entry item, *ritem;
+	char key[20];
+	int i;
+
+	for (i = 0; i < SIZE * 4; i++) {
+		sprintf(key, "grow%d", i);
+		item.callback = NULL;
+		item.data = key;
+		item.flags = 0;
+		item.key = key;
+		hsearch_r(item, ENV_ENTER, &ritem, grow_htab, 0);
+	}
+
+	return 0;
+}
+
+/* Overwrite a variable whose callback makes the table grow */
+static int env_test_htab_grow_callback(struct unit_test_state *uts)
+{
+	struct hsearch_data htab;
+	struct env_entry item, *ritem, *found;
+
+	memset(&htab, 0, sizeof(htab));
+	ut_asserteq(1, hcreate_r(SIZE, &htab));
+	grow_htab = &htab;
+
+	item.callback = NULL;
+	item.flags = 0;
+	item.key = "var";
+	item.data = "old";
+	ut_asserteq(1, hsearch_r(item, ENV_ENTER, &ritem, &htab, 0));
+	ritem->callback = htab_grow_cb;
+
+	item.data = "new";
+	hsearch_r(item, ENV_ENTER, &ritem, &htab, 0);
+	ut_assertnonnull(ritem);
+	ut_asserteq(1 + SIZE * 4, htab.filled);
+
+	/* The returned entry must be the one now in the table */
+	hsearch_r(item, ENV_FIND, &found, &htab, 0);
+	ut_asserteq_ptr(found, ritem);
+	ut_asserteq_str("new", ritem->data);
+
+	hdestroy_r(&htab);
+	return 0;
+}
+ENV_TEST(env_test_htab_grow_callback, 0);
+
+/* Show how long it takes to set and get variables with various table sizes */
+static int env_test_htab_perf(struct unit_test_state *uts)
+{
+	static const int fill[] = { SIZE, SIZE * 16, SIZE * 256 };
+	struct hsearch_data htab;
+	ulong set_us, get_us;
+	int i, pass, passes;
+
+	for (i = 0; i < ARRAY_SIZE(fill); i++) {
+		memset(&htab, 0, sizeof(htab));
+		ut_asserteq(1, hcreate_r(SIZE, &htab));
+
+		set_us = timer_get_us();
+		ut_assertok(htab_fill(uts, &htab, fill[i]));
+		set_us = timer_get_us() - set_us;
+
+		/* look up about the same number of variables each time */
+		passes = max(1, ITERATIONS / fill[i]);
+		get_us = timer_get_us();
+		for (pass = 0; pass < passes; pass++)
+			ut_assertok(htab_check_fill(uts, &htab, fill[i]));
+		get_us = timer_get_us() - get_us;
+
+		printf("%6d entries, size %6d: set %4lu ns, get %4lu ns\n",
+		       fill[i], htab.size, set_us * 1000 / fill[i],
+		       get_us * 1000 / (fill[i] * passes));
+		hdestroy_r(&htab);
+	}
+
+	return 0;
+}
+ENV_TEST(env_test_htab_perf, 0);
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Tests for keeping parsed scripts in the modern hush parser
+ */
+
+#include <cli_hush.h>
+#include <command.h>
+#include <env.h>
+#include <test/hush.h>
+#include <test/ut.h>
+#include <asm/global_data.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static int hush_test_cache(struct unit_test_state *uts)
+{
+	struct hush_stats start, stats;
+	int i;
+
+	if (!(gd->flags & GD_FLG_HUSH_MODERN_PARSER))
+		return -EAGAIN;
+
+	/* Scripts which are running (such as this test) are not dropped */
+	hush_flush_cache();
+	hush_get_stats(&start);
+	ut_assertok(env_set("cache_test", "for i in 1 2; do echo $i; done"));
+
+	/* The second run of the same script is a hit */
+	ut_assertok(run_command("true", 0));
+	hush_get_stats(&stats);
+	ut_asserteq(1, stats.misses - start.misses);
+	ut_asserteq(0, stats.hits - start.hits);
+	ut_assertok(run_command("true", 0));
+	hush_get_stats(&stats);
+	ut_asserteq(1, stats.misses - start.misses);
+	ut_asserteq(1, stats.hits - start.hits);
+	hush_flush_cache();
+	hush_get_stats(&start);
+
+	/* Both 'run cache_test' and the variable are parsed the first time */
+	for (i = 0; i < 3; i++) {
+		ut_assertok(run_command("run cache_test", 0));
+		ut_assert_nextline("1");
+		ut_assert_nextline("2");
+		ut_assert_console_end();
+	}
+	hush_get_stats(&stats);
+	ut_asserteq(6, stats.runs - start.runs);
+	ut_asserteq(2, stats.misses - start.misses);
+	ut_asserteq(4, stats.hits - start.hits);
+	ut_asserteq(start.cached + 2, stats.cached);
+
+	/* A changed variable must be parsed again */
+	ut_assertok(env_set("cache_test", "echo changed"));
+	ut_assertok(run_command("run cache_test", 0));
+	ut_assert_nextline("changed");
+	ut_assert_console_end();
+	hush_get_stats(&stats);
+	ut_asserteq(3, stats.misses - start.misses);
+	ut_asserteq(5, stats.hits - start.hits);
+	ut_asserteq(start.cached + 3, stats.cached);
+
+	/* The exit code must be the same when the script is reused */
+	for (i = 0; i < 2; i++)
+		ut_asserteq(1, run_command("false", 0));
+
+	/* The 'hush flush' script is still running, so stays in the cache */
+	ut_assertok(run_command("hush flush", 0));
+	hush_get_stats(&stats);
+	ut_asserteq(start.cached + 1, stats.cached);
+
+	ut_assertok(env_set("cache_test", NULL));
+
+	return 0;
+}
+HUSH_TEST(hush_test_cache, UTF_CONSOLE);
+
+/* Test that the least recently used script is dropped when the cache is full */
+static int hush_test_cache_lru(struct unit_test_state *uts)
+{
+	struct hush_stats start, stats;
+	char cmd[30];
+	int i;
+
+	if (!(gd->flags & GD_FLG_HUSH_MODERN_PARSER))
+		return -EAGAIN;
+
+	/* Scripts which are running (such as this test) stay in the cache */
+	hush_flush_cache();
+	hush_get_stats(&start);
+
+	/* Fill the cache, then run one more script */
+	for (i = 0; i <= CONFIG_HUSH_SCRIPT_CACHE_SIZE - start.cached; i++) {
+		snprintf(cmd, sizeof(cmd), "setenv cache_test %d", i);
+		ut_assertok(run_command(cmd, 0));
+	}
+	hush_get_stats(&stats);
+	ut_asserteq(CONFIG_HUSH_SCRIPT_CACHE_SIZE, stats.cached);
+	ut_asserteq(i, stats.misses - start.misses);
+	ut_asserteq(1, stats.evictions - start.evictions);
+
+	/* The last script is still there, but the first one was dropped */
+	ut_assertok(run_command(cmd, 0));
+	hush_get_stats(&stats);
+	ut_asserteq(1, stats.hits - start.hits);
+	ut_assertok(run_command("setenv cache_test 0", 0));
+	hush_get_stats(&stats);
+	ut_asserteq(i + 1, stats.misses - start.misses);
+	ut_asserteq(2, stats.evictions - start.evictions);
+
+	ut_assertok(env_set("cache_test", NULL));
+	hush_flush_cache();
+
+	return 0;
+}
+HUSH_TEST(hush_test_cache_lru, 0);
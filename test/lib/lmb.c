@@ -8,6 +8,8 @@
 #include <lmb.h>
 #include <log.h>
 #include <malloc.h>
+#include <rand.h>
+#include <time.h>
 #include <dm/test.h>
 #include <test/lib.h>
 #include <test/test.h>
@@ -802,3 +804,200 @@ static int lib_test_lmb_flags(struct unit_test_state *uts)
 	return 0;
 }
 LIB_TEST(lib_test_lmb_flags, 0);
+
+/* Number of pages in the memory covered by the stress test */
+#define STRESS_PAGES		4096
+#define STRESS_PAGE_SIZE	0x1000
+#define STRESS_OPS		10000
+
+/**
+ * struct lmb_stress - Model of the memory map, one byte per page
+ *
+ * @mem: true if the page has been added as memory
+ * @used: true if the page has been reserved or allocated
+ */
+struct lmb_stress {
+	bool mem[STRESS_PAGES];
+	bool used[STRESS_PAGES];
+};
+
+static phys_addr_t stress_addr(phys_addr_t ram, int page)
+{
+	return ram + (phys_addr_t)page * STRESS_PAGE_SIZE;
+}
+
+/* Check that a list holds exactly the runs of pages set in the model */
+static int stress_check_list(struct unit_test_state *uts, struct alist *lst,
+			     const bool *model, phys_addr_t ram)
+{
+	struct lmb_region *rgn = lst->data;
+	int page, start, i = 0;
+
+	for (page = 0; page < STRESS_PAGES;) {
+		if (!model[page]) {
+			page++;
+			continue;
+		}
+		for (start = page; page < STRESS_PAGES && model[page]; page++)
+			;
+		ut_assert(i < lst->count);
+		ut_asserteq_64(stress_addr(ram, start), rgn[i].base);
+		ut_asserteq_64((phys_size_t)(page - start) * STRESS_PAGE_SIZE,
+			       rgn[i].size);
+		i++;
+	}
+	ut_asserteq(i, lst->count);
+
+	return 0;
+}
+
+/* Check the free size at a page against the model */
+static int stress_check_free_size(struct unit_test_state *uts,
+				  struct lmb_stress *st, phys_addr_t ram,
+				  int page)
+{
+	phys_size_t expect = 0;
+	int last, end;
+
+	if (st->mem[page] && !st->used[page]) {
+		for (end = page; end < STRESS_PAGES && !st->used[end]; end++)
+			;
+		/* With no reservation above, the end of memory is used */
+		if (end == STRESS_PAGES) {
+			for (last = STRESS_PAGES; !st->mem[last - 1]; last--)
+				;
+			end = last;
+		}
+		expect = (phys_size_t)(end - page) * STRESS_PAGE_SIZE;
+	}
+	ut_asserteq_64(expect, lmb_get_free_size(stress_addr(ram, page)));
+
+	return 0;
+}
+
+/* Check whether there is a free, aligned run of pages in the model */
+static bool stress_can_alloc(struct lmb_stress *st, int pages, int align)
+{
+	int start, i;
+
+	for (start = 0; start + pages <= STRESS_PAGES; start += align) {
+		for (i = start; i < start + pages; i++) {
+			if (!st->mem[i] || st->used[i])
+				break;
+		}
+		if (i == start + pages)
+			return true;
+	}
+
+	return false;
+}
+
+/* Carry out many random operations, checking against a simple model */
+static int lib_test_lmb_stress(struct unit_test_state *uts)
+{
+	const phys_addr_t ram = 0x40000000;
+	struct alist *mem_lst, *used_lst;
+	struct lmb_stress *st;
+	struct lmb store;
+	int op, page, pages, align, start, end, i;
+	phys_addr_t addr;
+	ulong start_time;
+	long ret;
+
+	st = calloc(1, sizeof(*st));
+	ut_assertnonnull(st);
+	ut_assertok(setup_lmb_test(uts, &store, &mem_lst, &used_lst));
+	srand(1234);
+
+	/* Start with four banks of memory, with gaps between them */
+	for (i = 0; i < 4; i++) {
+		start = i * STRESS_PAGES / 4;
+		end = start + STRESS_PAGES / 5;
+		ut_assertok(lmb_add(stress_addr(ram, start),
+				    (phys_size_t)(end - start) *
+				    STRESS_PAGE_SIZE));
+		memset(&st->mem[start], true, end - start);
+	}
+
+	start_time = timer_get_us();
+	for (op = 0; op < STRESS_OPS; op++) {
+		page = rand() % STRESS_PAGES;
+		pages = 1 + rand() % 16;
+		switch (rand() % 16) {
+		case 0:
+			/* add memory, which may join banks together */
+			pages = min(pages * 4, STRESS_PAGES - page);
+			ret = lmb_add(stress_addr(ram, page),
+				      (phys_size_t)pages * STRESS_PAGE_SIZE);
+			ut_assert(ret >= 0);
+			memset(&st->mem[page], true, pages);
+			break;
+		case 1 ... 5:
+			/* reserve, which may overlap other reservations */
+			pages = min(pages, STRESS_PAGES - page);
+			ret = lmb_reserve(stress_addr(ram, page),
+					  (phys_size_t)pages *
+					  STRESS_PAGE_SIZE);
+			ut_assert(ret >= 0);
+			memset(&st->used[page], true, pages);
+			break;
+		case 6 ... 10:
+			align = rand() & 1 ? 1 : 16;
+			addr = lmb_alloc_flags((phys_size_t)pages *
+					       STRESS_PAGE_SIZE,
+					       align * STRESS_PAGE_SIZE,
+					       LMB_NONE);
+			if (!addr) {
+				ut_assert(!stress_can_alloc(st, pages, align));
+				break;
+			}
+			start = (addr - ram) / STRESS_PAGE_SIZE;
+			ut_asserteq(0, start % align);
+			ut_assert(start + pages <= STRESS_PAGES);
+			for (i = start; i < start + pages; i++) {
+				ut_assert(st->mem[i]);
+				ut_assert(!st->used[i]);
+				st->used[i] = true;
+			}
+			break;
+		default:
+			if (!st->used[page]) {
+				ut_asserteq(-1, lmb_free(stress_addr(ram, page),
+							 STRESS_PAGE_SIZE));
+				break;
+			}
+			/* free part of the reservation holding this page */
+			for (end = page; end < STRESS_PAGES && st->used[end];
+			     end++)
+				;
+			pages = min(pages, end - page);
+			ut_assertok(lmb_free(stress_addr(ram, page),
+					     (phys_size_t)pages *
+					     STRESS_PAGE_SIZE));
+			memset(&st->used[page], false, pages);
+			break;
+		}
+
+		page = rand() % STRESS_PAGES;
+		ut_asserteq(st->used[page],
+			    lmb_is_reserved_flags(stress_addr(ram, page),
+						  LMB_NONE));
+		ut_assertok(stress_check_free_size(uts, st, ram, page));
+		if (!(op % 100)) {
+			ut_assertok(stress_check_list(uts, mem_lst, st->mem,
+						      ram));
+			ut_assertok(stress_check_list(uts, used_lst, st->used,
+						      ram));
+		}
+	}
+	printf("%d operations in %lu us, %d reserved regions\n", STRESS_OPS,
+	       timer_get_us() - start_time, used_lst->count);
+	ut_assertok(stress_check_list(uts, mem_lst, st->mem, ram));
+	ut_assertok(stress_check_list(uts, used_lst, st->used, ram));
+
+	lmb_pop(&store);
+	free(st);
+
+	return 0;
+}
+LIB_TEST(lib_test_lmb_stress, 0);
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the memory test engine
+ */
+
+#include <cyclic.h>
+#include <malloc.h>
+#include <memtest.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+#include <linux/sizes.h>
+
+/* Size of the memory tested, not a multiple of the cache line */
+#define TEST_SIZE	(SZ_1M + 0x18)
+
+/* Run each test on a buffer and check there are no errors */
+static int lib_test_memtest(struct unit_test_state *uts)
+{
+	struct memtest_result res;
+	enum memtest_t type;
+	u64 *buf;
+
+	buf = malloc(TEST_SIZE);
+	ut_assertnonnull(buf);
+
+	for (type = 0; type < MEMTEST_COUNT; type++) {
+		ut_assertok(memtest_run(type, buf, 0x1000, TEST_SIZE,
+					0x55aa55aa55aa55aaULL, &res));
+		ut_asserteq(0, res.errors);
+		ut_asserteq(0, res.num_recorded);
+
+		/* Moving inversions leaves the pattern in memory */
+		if (type == MEMTEST_INVERSIONS) {
+			ut_asserteq_64(0x55aa55aa55aa55aaULL, buf[0]);
+			ut_asserteq_64(0x55aa55aa55aa55aaULL,
+				       buf[TEST_SIZE / 8 - 1]);
+		}
+	}
+
+	/* Write + check, then write + 2 x check-invert + check */
+	ut_assertok(memtest_run(MEMTEST_ADDRESS, buf, 0x1000, TEST_SIZE, 0,
+				&res));
+	ut_asserteq_64(2ULL * TEST_SIZE, res.bytes);
+	ut_asserteq_64(0x1000, buf[0]);
+	ut_asserteq_64(0x1008, buf[1]);
+	ut_assertok(memtest_run(MEMTEST_INVERSIONS, buf, 0x1000, TEST_SIZE, 0,
+				&res));
+	ut_asserteq_64(6ULL * TEST_SIZE, res.bytes);
+
+	/* A misaligned start is rounded up to a whole word */
+	ut_assertok(memtest_run(MEMTEST_RANDOM, (void *)buf + 3, 0x1003, 0x40,
+				0, &res));
+	ut_asserteq_64(2 * 0x38, res.bytes);
+
+	ut_asserteq(-EINVAL, memtest_run(MEMTEST_COUNT, buf, 0, 0x40, 0, &res));
+	ut_asserteq_str("inversions", memtest_get_name(MEMTEST_INVERSIONS));
+	ut_asserteq_str("unknown", memtest_get_name(MEMTEST_COUNT));
+
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_memtest, 0);
+
+/**
+ * struct memtest_fault - Fault injected into the buffer by a test
+ *
+ * memtest_run() calls schedule() after each pass, so a cyclic function can
+ * corrupt the buffer after the fill and before the check which follows it.
+ * The buffer is small enough to be handled in a single batch.
+ *
+ * @cyclic: Cyclic function which corrupts the buffer
+ * @buf: Buffer being tested
+ * @xor: Value to XOR into each word
+ * @count: Number of words to corrupt
+ * @done: true once the buffer has been corrupted
+ */
+struct memtest_fault {
+	struct cyclic_info cyclic;
+	u64 *buf;
+	u64 xor;
+	uint count;
+	bool done;
+};
+
+static void memtest_fault_func(struct cyclic_info *cyclic)
+{
+	struct memtest_fault *fault;
+	uint i;
+
+	fault = container_of(cyclic, struct memtest_fault, cyclic);
+	if (fault->done)
+		return;
+	for (i = 0; i < fault->count; i++)
+		fault->buf[i] ^= fault->xor;
+	fault->done = true;
+}
+
+/* Run a test, corrupting @count words at @buf after the first pass */
+static int memtest_run_fault(enum memtest_t type, u64 *base, u64 *buf,
+			     u64 xor, uint count, struct memtest_result *res)
+{
+	struct memtest_fault fault = {
+		.buf = buf,
+		.xor = xor,
+		.count = count,
+	};
+	int ret;
+
+	cyclic_register(&fault.cyclic, memtest_fault_func, 0, "memtest_fault");
+	ret = memtest_run(type, base, 0x1000, TEST_SIZE, 0x55aa55aa55aa55aaULL,
+			  res);
+	cyclic_unregister(&fault.cyclic);
+
+	return ret;
+}
+
+/* Check that errors are found and recorded */
+static int lib_test_memtest_errors(struct unit_test_state *uts)
+{
+	struct memtest_result res;
+	struct memtest_error *err;
+	u64 *buf;
+	int i;
+
+	if (!CONFIG_IS_ENABLED(CYCLIC))
+		return -EAGAIN;
+
+	buf = malloc(TEST_SIZE);
+	ut_assertnonnull(buf);
+
+	/* One word is corrupted after the fill */
+	ut_assertok(memtest_run_fault(MEMTEST_ADDRESS, buf, buf + 8, 0xff, 1,
+				      &res));
+	ut_asserteq(1, res.errors);
+	ut_asserteq(1, res.num_recorded);
+	err = &res.error[0];
+	ut_asserteq(0x1040, err->addr);
+	ut_asserteq_64(0x1040 ^ 0x55aa55aa55aa55aaULL, err->expect);
+	ut_asserteq_64(0x1040 ^ 0x55aa55aa55aa55aaULL ^ 0xff, err->found);
+
+	/* Moving inversions finds it in the first check and recovers */
+	ut_assertok(memtest_run_fault(MEMTEST_INVERSIONS, buf, buf + 8, 0xff, 1,
+				      &res));
+	ut_asserteq(1, res.errors);
+	ut_asserteq(0x1040, res.error[0].addr);
+	ut_asserteq_64(0x55aa55aa55aa55aaULL, res.error[0].expect);
+	ut_asserteq_64(0x55aa55aa55aa55aaULL ^ 0xff, res.error[0].found);
+
+	/* Only the first errors are recorded, but all are counted */
+	ut_assertok(memtest_run_fault(MEMTEST_RANDOM, buf, buf + 0x20,
+				      1ULL << 63, MEMTEST_MAX_ERRORS + 4,
+				      &res));
+	ut_asserteq(MEMTEST_MAX_ERRORS + 4, res.errors);
+	ut_asserteq(MEMTEST_MAX_ERRORS, res.num_recorded);
+	for (i = 0; i < MEMTEST_MAX_ERRORS; i++) {
+		err = &res.error[i];
+		ut_asserteq(0x1100 + i * 8, err->addr);
+		ut_asserteq_64(err->expect ^ (1ULL << 63), err->found);
+	}
+
+	/* Without the fault there are no errors */
+	ut_assertok(memtest_run(MEMTEST_RANDOM, buf, 0x1000, TEST_SIZE, 0,
+				&res));
+	ut_asserteq(0, res.errors);
+
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_memtest_errors, 0);
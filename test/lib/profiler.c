@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the sampling profiler
+ */
+
+#include <profiler.h>
+#include <time.h>
+#include <trace.h>
+#include <asm/global_data.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Size of the buffer used for samples */
+#define TEST_BUF_SIZE	0x4000
+
+/* Maximum time to wait for samples, in milliseconds */
+#define TEST_TIMEOUT_MS	2000
+
+static u32 sample_buf[TEST_BUF_SIZE / sizeof(u32)];
+static u32 out_buf[TEST_BUF_SIZE / sizeof(u32) + 16];
+
+/* Use some CPU time, so that samples are taken */
+static void busy_loop(void)
+{
+	volatile int count;
+
+	for (count = 0; count < 100000; count++)
+		;
+}
+
+/* Test taking samples and writing them out */
+static int lib_test_profiler(struct unit_test_state *uts)
+{
+	struct trace_output_sample *sample;
+	struct trace_output_hdr *hdr;
+	struct profiler_stats stats;
+	ulong start, needed;
+	u32 *offset;
+	int i;
+
+	ut_assertok(profiler_start(sample_buf, sizeof(sample_buf), 1000));
+	ut_assert(profiler_running());
+	ut_asserteq(-EALREADY, profiler_start(sample_buf, sizeof(sample_buf),
+					      1000));
+
+	/* The host's profiling timer only counts CPU time */
+	start = get_timer(0);
+	do {
+		busy_loop();
+		profiler_get_stats(&stats);
+	} while (!stats.samples && get_timer(start) < TEST_TIMEOUT_MS);
+
+	ut_assertok(profiler_stop());
+	ut_assert(!profiler_running());
+	ut_asserteq(-EALREADY, profiler_stop());
+
+	profiler_get_stats(&stats);
+	ut_assert(stats.samples > 0);
+	ut_asserteq(1000, stats.rate_hz);
+	ut_asserteq(sizeof(sample_buf), stats.size);
+	ut_assert(stats.used <= stats.size);
+
+	ut_asserteq(-ENOSPC, profiler_list_samples(out_buf, sizeof(*hdr),
+						   &needed));
+	ut_asserteq(sizeof(*hdr) + stats.used, needed);
+	ut_assertok(profiler_list_samples(out_buf, sizeof(out_buf), &needed));
+	hdr = (struct trace_output_hdr *)out_buf;
+	ut_asserteq(TRACE_CHUNK_SAMPLES, hdr->type);
+	ut_asserteq(TRACE_VERSION, hdr->version);
+	ut_asserteq(stats.samples, hdr->rec_count);
+
+	/* Each sample has at least one offset, all within U-Boot */
+	sample = (struct trace_output_sample *)(hdr + 1);
+	for (i = 0; i < hdr->rec_count; i++) {
+		uint depth = sample->depth;
+
+		ut_assert(depth > 0 && depth <= PROFILER_MAX_DEPTH);
+		offset = (u32 *)(sample + 1);
+		while (depth--)
+			ut_assert(*offset++ < gd->mon_len);
+		sample = (struct trace_output_sample *)offset;
+	}
+	ut_asserteq_ptr((void *)hdr + needed, sample);
+
+	return 0;
+}
+LIB_TEST(lib_test_profiler, 0);
@@ -8,10 +8,12 @@
 
 #include <command.h>
 #include <image.h>
+#include <asm/unaligned.h>
 #include <test/lib.h>
 #include <test/test.h>
 #include <test/ut.h>
 #include <u-boot/rsa.h>
+#include <u-boot/rsa-mod-exp.h>
 
 #ifdef CONFIG_RSA_VERIFY_WITH_PKEY
 /*
@@ -200,4 +202,41 @@ static int lib_rsa_verify_invalid(struct unit_test_state *uts)
 	return CMD_RET_SUCCESS;
 }
 LIB_TEST(lib_rsa_verify_invalid, 0);
+
+/**
+ * lib_rsa_mod_exp_fast() - unit test for rsa_mod_exp_fast()
+ *
+ * Check rsa_mod_exp_fast() against rsa_mod_exp_simple() with exponents of
+ * various sizes, so that each window size is used
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_rsa_mod_exp_fast(struct unit_test_state *uts)
+{
+	static const u64 exponents[] = {
+		3, 65537, 0xc5a1f3e7, 0xf0e1d2c3b4a59687, 0xffffffffffffffff,
+	};
+	u8 expect[256], out[256];
+	struct key_prop *prop;
+	int i;
+
+	if (!IS_ENABLED(CONFIG_RSA_SOFTWARE_EXP_FAST))
+		return -EAGAIN;
+
+	ut_assertok(rsa_gen_key_prop(public_key, public_key_len, &prop));
+	for (i = 0; i < ARRAY_SIZE(exponents); i++) {
+		put_unaligned_be64(exponents[i],
+				   (void *)prop->public_exponent);
+		ut_assertok(rsa_mod_exp_simple(data_enc, data_enc_len, prop,
+					       expect));
+		ut_assertok(rsa_mod_exp_fast(data_enc, data_enc_len, prop,
+					     out));
+		ut_asserteq_mem(expect, out, sizeof(out));
+	}
+	rsa_free_key_prop(prop);
+
+	return 0;
+}
+LIB_TEST(lib_rsa_mod_exp_fast, 0);
 #endif /* RSA_VERIFY_WITH_PKEY */
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the binary log ring
+ */
+
+#include <bloblist.h>
+#include <console.h>
+#include <log.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <asm/global_data.h>
+#include <test/log.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Size of the bloblist used for testing, enough for the ring and its export */
+#define TEST_BLOBLIST_SIZE	0x20000
+
+/**
+ * check_dump_line() - Check the next line of 'log dump' output
+ *
+ * This skips the timestamp, which varies
+ *
+ * @uts: Test state
+ * @expect: Expected line, without the timestamp
+ * Return: 0 if OK, -ve on error
+ */
+static int check_dump_line(struct unit_test_state *uts, const char *expect)
+{
+	const char *msg;
+
+	ut_assert(console_record_readline(uts->actual_str,
+					  sizeof(uts->actual_str)) >= 0);
+	msg = strstr(uts->actual_str, "] ");
+	ut_assertnonnull(msg);
+	ut_asserteq_str(expect, msg + 2);
+
+	return 0;
+}
+
+static int check_log_binary(struct unit_test_state *uts)
+{
+	static const u8 mac[] = {0x02, 0x00, 0x11, 0x22, 0x33, 0x44};
+	struct log_binary_stats stats;
+	char str[] = "before";
+	const char *text;
+	char long_str[100];
+	char ptr_str[20];
+	uint used;
+	int i;
+
+	log_binary_clear();
+	ut_assertok(log_binary_get_stats(&stats));
+	ut_asserteq(0, stats.count);
+	ut_asserteq(CONFIG_LOG_BINARY_SIZE, stats.size);
+
+	/* Strings and %p extensions are copied, other arguments are not */
+	log(LOGC_SANDBOX, LOGL_ERR,
+	    "int %d/%3x long %ld ll %lld str %s mac %pM star %*d%%\n", -3, 0x2a,
+	    123456789L, 1234567890123LL, str, mac, 4, 7);
+	strcpy(str, "after");
+	ut_assert_nextline("int -3/ 2a long 123456789 ll 1234567890123 str before "
+			   "mac 02:00:11:22:33:44 star    7%%");
+	ut_assertok(log_binary_get_stats(&stats));
+	ut_asserteq(1, stats.count);
+	ut_asserteq(0, stats.lost);
+	ut_asserteq(0, stats.truncated);
+
+	gd->log_fmt = BIT(LOGF_LEVEL) | BIT(LOGF_CAT) | BIT(LOGF_MSG);
+	ut_assertok(run_command("log dump", 0));
+	gd->log_fmt = BIT(LOGF_MSG);
+	ut_assertok(check_dump_line(uts, "ERR.sandbox, int -3/ 2a long 123456789 "
+				    "ll 1234567890123 str before mac "
+				    "02:00:11:22:33:44 star    7%"));
+	ut_assert_console_end();
+
+	/* Arguments which do not fit are dropped */
+	memset(long_str, 'x', sizeof(long_str) - 1);
+	long_str[sizeof(long_str) - 1] = '\0';
+	log(LOGC_SANDBOX, LOGL_ERR, "%s %s %s %s %d\n", long_str, long_str,
+	    long_str, long_str, 1);
+	ut_assert_skipline();
+	ut_assertok(log_binary_get_stats(&stats));
+	ut_asserteq(2, stats.count);
+	ut_asserteq(1, stats.truncated);
+
+	/* Fill the ring, so that the oldest records are dropped */
+	for (i = 0; i < CONFIG_LOG_BINARY_SIZE / 32; i++)
+		log(LOGC_SANDBOX, LOGL_DEBUG_IO, "record %d\n", i);
+	ut_assertok(log_binary_get_stats(&stats));
+	ut_assert(stats.lost > 0);
+	ut_asserteq(i + 2, stats.count + stats.lost);
+	ut_assert(stats.used <= stats.size);
+
+	ut_assertok(run_command("log dump -c", 0));
+	for (i = stats.lost - 2; i < CONFIG_LOG_BINARY_SIZE / 32; i++) {
+		snprintf(uts->expect_str, sizeof(uts->expect_str),
+			 "record %d", i);
+		ut_assertok(check_dump_line(uts, uts->expect_str));
+	}
+	ut_assert_console_end();
+	ut_assertok(log_binary_get_stats(&stats));
+	ut_asserteq(0, stats.count);
+	ut_asserteq(0, stats.used);
+
+	/* Unknown %p suffixes are skipped, leaving a plain pointer */
+	log(LOGC_SANDBOX, LOGL_ERR, "%p\n", mac);
+	ut_assert_skipline();
+	ut_assertok(log_binary_get_stats(&stats));
+	used = stats.used;
+	log_binary_clear();
+	log(LOGC_SANDBOX, LOGL_ERR, "%pS\n", mac);
+	snprintf(ptr_str, sizeof(ptr_str), "%p", mac);
+	ut_assert_nextline("%s", ptr_str);
+	ut_assertok(log_binary_get_stats(&stats));
+	ut_asserteq(used, stats.used);
+	ut_assertok(run_command("log dump -c", 0));
+	ut_assertok(check_dump_line(uts, ptr_str));
+	ut_assert_console_end();
+
+	/* Export the records as text */
+	log(LOGC_SANDBOX, LOGL_ERR, "exported %d\n", 42);
+	ut_assert_skipline();
+	ut_assertok(run_command("log dump -e", 0));
+	ut_assert_console_end();
+	text = bloblist_find(BLOBLISTT_U_BOOT_LOG_TEXT, 0);
+	ut_assertnonnull(text);
+	ut_assertnonnull(strstr(text, "] exported 42\n"));
+
+	return 0;
+}
+
+/* Test recording log messages in the binary log ring */
+static int log_test_binary(struct unit_test_state *uts)
+{
+	enum log_category_t cat_list[] = { LOGC_SANDBOX, LOGC_END };
+	struct bloblist_hdr *old = gd->bloblist;
+	struct log_binary_stats stats;
+	int log_level = gd->default_log_level;
+	int log_fmt = gd->log_fmt;
+	int filt, ret;
+	void *buf;
+
+	/* Sandbox's bloblist holds the ring, but not the exported text too */
+	ut_assertok(log_binary_get_stats(&stats));
+	ut_asserteq(CONFIG_LOG_BINARY_SIZE, stats.size);
+	buf = memalign(BLOBLIST_ALIGN, TEST_BLOBLIST_SIZE);
+	ut_assertnonnull(buf);
+	ut_assertok(bloblist_new(map_to_sysmem(buf), TEST_BLOBLIST_SIZE, 0,
+				 0));
+	gd->default_log_level = LOGL_INFO;
+	gd->log_fmt = BIT(LOGF_MSG);
+
+	/* Record debug messages too, but only those from this test */
+	filt = log_add_filter("binary", cat_list, LOGL_DEBUG_IO, NULL);
+	ut_assert(filt >= 0);
+	ret = check_log_binary(uts);
+	log_remove_filter("binary", filt);
+	gd->log_fmt = log_fmt;
+	gd->default_log_level = log_level;
+	gd->bloblist = old;
+	free(buf);
+
+	return ret;
+}
+LOG_TEST(log_test_binary);
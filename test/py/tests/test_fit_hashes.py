@@ -55,6 +55,24 @@ class ReadonlyFitImage(object):
 
         return self.hashable_nodes
 
+    def get_all_hashes(self):
+        """Get the value of every hash node of every image
+
+        Returns:
+            dict: key: path to the hash node, value: tuple:
+                str: algorithm
+                str: hash value, in hex
+        """
+        hashes = {}
+        for image in self.__fdt_list('/images').split():
+            for node in self.__fdt_list(f'/images/{image}').split():
+                if 'hash-' not in node:
+                    continue
+                path = f'/images/{image}/{node}'
+                hashes[path] = (self.__fdt_get(path, 'algo'),
+                                self.__fdt_get_sexadecimal(path, 'value'))
+        return hashes
+
     def verify_hashes(self):
         for image in self.hashable_nodes:
             algos = set()
@@ -112,3 +130,41 @@ def test_mkimage_hashes(u_boot_console):
         raise ValueError('FIT image has no "/image" nodes with "hash-..."')
 
     fit.verify_hashes()
+
+
+@pytest.mark.buildconfigspec('hash')
+@pytest.mark.requiredtool('dtc')
+@pytest.mark.requiredtool('fdtget')
+def test_mkimage_hashes_parallel(u_boot_console):
+    """Test that hashes calculated in parallel match a serial build"""
+
+    def assemble_fit_image(dest_fit, jobs):
+        dtc_args = f'-I dts -O dtb -i {tempdir}'
+        util.run_and_log(cons, [mkimage, '-D', dtc_args, '-j', str(jobs),
+                                '-f', f'{datadir}/hash-images.its', dest_fit])
+
+    cons = u_boot_console
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    datadir = cons.config.source_dir + '/test/py/tests/vboot/'
+    tempdir = os.path.join(cons.config.result_dir, 'hashes-parallel')
+    os.makedirs(tempdir, exist_ok=True)
+
+    util.run_and_log(cons, f'dtc {datadir}/sandbox-kernel.dts -O dtb -o '
+                           f'{tempdir}/sandbox-kernel.dtb')
+
+    # Make the kernel large enough that the hashes take a little while
+    with open(f'{tempdir}/test-kernel.bin', 'wb') as fd:
+        fd.write(bytes(range(256)) * 4096)
+
+    serial_fit = f'{tempdir}/serial.fit'
+    assemble_fit_image(serial_fit, 1)
+    serial = ReadonlyFitImage(cons, serial_fit).get_all_hashes()
+
+    # Both images and all seven algorithms should be present
+    assert len(serial) == 14
+    assert len(set(algo for algo, _ in serial.values())) == 7
+
+    parallel_fit = f'{tempdir}/parallel.fit'
+    assemble_fit_image(parallel_fit, 4)
+    parallel = ReadonlyFitImage(cons, parallel_fit).get_all_hashes()
+    assert serial == parallel
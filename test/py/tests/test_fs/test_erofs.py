@@ -19,7 +19,21 @@ def generate_file(name, size):
     file.write(content)
     file.close()
 
-def make_erofs_image(build_dir):
+def generate_big_file(name, size):
+    """
+    Generates a file with numbered lines, which compresses to many pclusters.
+    """
+    with open(name, 'w') as outf:
+        line = 0
+        written = 0
+        while written < size:
+            text = 'line %d\n' % line
+            text = text[:size - written]
+            outf.write(text)
+            written += len(text)
+            line += 1
+
+def make_erofs_image(build_dir, alg):
     """
     Makes the EROFS images used for the test.
 
@@ -27,6 +41,7 @@ def make_erofs_image(build_dir):
     erofs_src_dir/
     ├── f4096
     ├── f7812
+    ├── f300000
     ├── subdir/
     │   └── subdir-file
     ├── symdir -> subdir
@@ -41,6 +56,9 @@ def make_erofs_image(build_dir):
     # 7812: Compressed file
     generate_file(os.path.join(root, 'f7812'), 7812)
 
+    # 300000: Compressed file spanning many adjacent pclusters
+    generate_big_file(os.path.join(root, 'f300000'), 300000)
+
     # sub-directory with a single file inside
     subdir_path = os.path.join(root, 'subdir')
     os.makedirs(subdir_path)
@@ -53,8 +71,8 @@ def make_erofs_image(build_dir):
     input_path = os.path.join(build_dir, EROFS_SRC_DIR)
     output_path = os.path.join(build_dir, EROFS_IMAGE_NAME)
     args = ' '.join([output_path, input_path])
-    subprocess.run(['mkfs.erofs -zlz4 ' + args], shell=True, check=True,
-                   stdout=subprocess.DEVNULL)
+    subprocess.run(['mkfs.erofs -z%s %s' % (alg, args)], shell=True,
+                   check=True, stdout=subprocess.DEVNULL)
 
 def clean_erofs_image(build_dir):
     """
@@ -73,8 +91,9 @@ def erofs_ls_at_root(u_boot_console):
     slash = u_boot_console.run_command('erofsls host 0 /')
     assert no_slash == slash
 
-    expected_lines = ['./', '../', '4096   f4096', '7812   f7812', 'subdir/',
-                      '<SYM>   symdir', '<SYM>   symfile', '4 file(s), 3 dir(s)']
+    expected_lines = ['./', '../', '4096   f4096', '7812   f7812',
+                      '300000   f300000', 'subdir/', '<SYM>   symdir',
+                      '<SYM>   symfile', '5 file(s), 3 dir(s)']
 
     output = u_boot_console.run_command('erofsls host 0')
     for line in expected_lines:
@@ -138,8 +157,8 @@ def erofs_load_files_at_root(u_boot_console):
     """
     Test load file from the root directory.
     """
-    files = ['f4096', 'f7812']
-    sizes = ['4096', '7812']
+    files = ['f4096', 'f7812', 'f300000']
+    sizes = ['4096', '7812', '300000']
     address = '$kernel_addr_r'
     erofs_load_files(u_boot_console, files, sizes, address)
 
@@ -183,16 +202,9 @@ def erofs_run_all_tests(u_boot_console):
     erofs_load_files_at_symlink(u_boot_console)
     erofs_load_non_existent_file(u_boot_console)
 
-@pytest.mark.boardspec('sandbox')
-@pytest.mark.buildconfigspec('cmd_fs_generic')
-@pytest.mark.buildconfigspec('cmd_erofs')
-@pytest.mark.buildconfigspec('fs_erofs')
-@pytest.mark.requiredtool('mkfs.erofs')
-@pytest.mark.requiredtool('md5sum')
-
-def test_erofs(u_boot_console):
+def erofs_run_test(u_boot_console, alg):
     """
-    Executes the erofs test suite.
+    Makes an image compressed with the given algorithm and runs all tests.
     """
     build_dir = u_boot_console.config.build_dir
 
@@ -207,7 +219,7 @@ def test_erofs(u_boot_console):
 
     try:
         # setup test environment
-        make_erofs_image(build_dir)
+        make_erofs_image(build_dir, alg)
         image_path = os.path.join(build_dir, EROFS_IMAGE_NAME)
         u_boot_console.run_command('host bind 0 {}'.format(image_path))
         # run all tests
@@ -218,3 +230,42 @@ def test_erofs(u_boot_console):
 
     # clean test environment
     clean_erofs_image(build_dir)
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_fs_generic')
+@pytest.mark.buildconfigspec('cmd_erofs')
+@pytest.mark.buildconfigspec('fs_erofs')
+@pytest.mark.requiredtool('mkfs.erofs')
+@pytest.mark.requiredtool('md5sum')
+
+def test_erofs(u_boot_console):
+    """
+    Executes the erofs test suite.
+    """
+    erofs_run_test(u_boot_console, 'lz4')
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_fs_generic')
+@pytest.mark.buildconfigspec('cmd_erofs')
+@pytest.mark.buildconfigspec('fs_erofs_zip_lzma')
+@pytest.mark.requiredtool('mkfs.erofs')
+@pytest.mark.requiredtool('md5sum')
+
+def test_erofs_lzma(u_boot_console):
+    """
+    Executes the erofs test suite with MicroLZMA compression.
+    """
+    erofs_run_test(u_boot_console, 'lzma')
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_fs_generic')
+@pytest.mark.buildconfigspec('cmd_erofs')
+@pytest.mark.buildconfigspec('fs_erofs_zip_zstd')
+@pytest.mark.requiredtool('mkfs.erofs')
+@pytest.mark.requiredtool('md5sum')
+
+def test_erofs_zstd(u_boot_console):
+    """
+    Executes the erofs test suite with Zstandard compression.
+    """
+    erofs_run_test(u_boot_console, 'zstd')
@@ -10,8 +10,10 @@ test one at a time, as well setting up some files needed by the tests.
 import collections
 import getpass
 import gzip
+import hashlib
 import os
 import os.path
+import struct
 import pytest
 
 import u_boot_utils
@@ -425,6 +427,38 @@ def setup_cros_image(cons):
 
     return fname
 
+def make_vbmeta(images):
+    """Create an Android Verified Boot vbmeta image
+
+    This has a hash descriptor for each image. It is not signed, so it only
+    passes verification on an unlocked device.
+
+    Args:
+        images (dict): Image data (bytes) for each partition name, without
+            the slot suffix
+
+    Returns:
+        bytes: vbmeta image
+    """
+    descs = b''
+    for name, data in images.items():
+        salt = b''
+        digest = hashlib.sha256(salt + data).digest()
+        body = struct.pack('>Q32sIIII60x', len(data), b'sha256', len(name),
+                           len(salt), len(digest), 0)
+        body += name.encode() + salt + digest
+        body += bytes(-len(body) % 8)
+
+        # AVB_DESCRIPTOR_TAG_HASH
+        descs += struct.pack('>QQ', 2, len(body)) + body
+    aux = descs + bytes(-len(descs) % 64)
+
+    # Header with no authentication block and AVB_ALGORITHM_TYPE_NONE
+    hdr = struct.pack('>4sIIQQIQQQQQQQQQQQII48s80x', b'AVB0', 1, 0, 0,
+                      len(aux), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, len(descs), 0,
+                      0, 0, b'')
+    return hdr + aux
+
 def setup_android_image(cons):
     """Create a 20MB disk image with Android partitions"""
     Partition = collections.namedtuple('part', 'start,size,name')
@@ -462,6 +496,7 @@ def setup_android_image(cons):
         {'num': 3, 'label':'boot_b', 'size': '4M'},
         {'num': 4, 'label':'vendor_boot_a', 'size': '4M'},
         {'num': 5, 'label':'vendor_boot_b', 'size': '4M'},
+        {'num': 6, 'label':'vbmeta_a', 'size': '128'},
     ]
 
     for part in required_parts:
@@ -489,12 +524,17 @@ def setup_android_image(cons):
     test_abootimg.AbootimgTestDiskImage(cons, 'bootv4.img', test_abootimg.boot_img_hex)
     boot_img = os.path.join(cons.config.result_dir, 'bootv4.img')
     with open(boot_img, 'rb') as inf:
-        set_part_data(2, inf.read())
+        boot_data = inf.read()
+    set_part_data(2, boot_data)
 
     test_abootimg.AbootimgTestDiskImage(cons, 'vendor_boot.img', test_abootimg.vboot_img_hex)
     vendor_boot_img = os.path.join(cons.config.result_dir, 'vendor_boot.img')
     with open(vendor_boot_img, 'rb') as inf:
-        set_part_data(4, inf.read())
+        vendor_boot_data = inf.read()
+    set_part_data(4, vendor_boot_data)
+
+    set_part_data(6, make_vbmeta({'boot': boot_data,
+                                  'vendor_boot': vendor_boot_data}))
 
     with open(fname, 'wb') as outf:
         outf.write(disk_data)
@@ -5,6 +5,7 @@
  */
 
 #include <blk.h>
+#include <bootflow.h>
 #include <console.h>
 #include <cyclic.h>
 #include <dm.h>
@@ -12,6 +13,7 @@
 #include <net.h>
 #include <of_live.h>
 #include <os.h>
+#include <part.h>
 #include <usb.h>
 #include <dm/ofnode.h>
 #include <dm/root.h>
@@ -403,6 +405,8 @@ static int test_post_run(struct unit_test_state *uts, struct unit_test *test)
 	uts->of_other = NULL;
 
 	blkcache_free();
+	part_cache_free();
+	bootflow_cache_free();
 
 	return 0;
 }
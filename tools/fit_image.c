@@ -24,6 +24,56 @@
 
 static struct legacy_img_hdr header;
 
+/**
+ * struct fit_timing - Time taken by each stage of creating the FIT
+ *
+ * All times are in milliseconds
+ *
+ * @build: Time to compile the .its or build the FIT automatically
+ * @import: Time to move external data into the FIT
+ * @hash: Time to calculate the hashes of the images
+ * @add: Time to add hashes and signatures, including retries, but not @hash
+ * @extract: Time to move the data outside the FIT
+ * @hashes: Number of hashes calculated
+ * @attempts: Number of attempts needed to add hashes and signatures
+ */
+static struct fit_timing {
+	double build;
+	double import;
+	double hash;
+	double add;
+	double extract;
+	int hashes;
+	int attempts;
+} fit_timing;
+
+static double fit_time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void fit_show_timing(struct image_tool_params *params)
+{
+	struct fit_timing *tm = &fit_timing;
+
+	fprintf(stderr, "%s: FIT timing (ms):\n", params->cmdname);
+	fprintf(stderr, "  %-12s %10.1f\n", "build", tm->build);
+	fprintf(stderr, "  %-12s %10.1f\n", "import", tm->import);
+	fprintf(stderr, "  %-12s %10.1f  (%d hashes, %d threads)\n", "hash",
+		tm->hash, tm->hashes,
+		params->jobs ? params->jobs :
+		(int)sysconf(_SC_NPROCESSORS_ONLN));
+	fprintf(stderr, "  %-12s %10.1f  (%d attempts)\n", "sign/add",
+		tm->add, tm->attempts);
+	fprintf(stderr, "  %-12s %10.1f\n", "extract", tm->extract);
+	fprintf(stderr, "  %-12s %10.1f\n", "total",
+		tm->build + tm->import + tm->hash + tm->add + tm->extract);
+}
+
 static int fit_add_file_data(struct image_tool_params *params, size_t size_inc,
 			     const char *tmpfile)
 {
@@ -72,6 +122,17 @@ static int fit_add_file_data(struct image_tool_params *params, size_t size_inc,
 				      params->cmdname);
 	}
 
+	if (!ret) {
+		double start = fit_time_ms();
+
+		ret = fit_calc_hashes(ptr, params->jobs);
+		if (ret > 0)
+			fit_timing.hashes = ret;
+		fit_timing.hash += fit_time_ms() - start;
+		if (ret > 0)
+			ret = 0;
+	}
+
 	if (!ret) {
 		ret = fit_add_verification_data(params->keydir,
 						params->keyfile, dest_blob, ptr,
@@ -153,11 +214,19 @@ static int fdt_property_file(struct image_tool_params *params,
 	ret = fdt_property_placeholder(fdt, "data", sbuf.st_size, &ptr);
 	if (ret)
 		goto err;
-	ret = read(fd, ptr, sbuf.st_size);
-	if (ret != sbuf.st_size) {
-		fprintf(stderr, "%s: Can't read %s: %s\n",
-			params->cmdname, fname, strerror(errno));
-		goto err;
+
+	/* Map the file, since a single read() may not return all of it */
+	if (sbuf.st_size) {
+		void *buf;
+
+		buf = mmap(NULL, sbuf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (buf == MAP_FAILED) {
+			fprintf(stderr, "%s: Can't read %s: %s\n",
+				params->cmdname, fname, strerror(errno));
+			goto err;
+		}
+		memcpy(ptr, buf, sbuf.st_size);
+		munmap(buf, sbuf.st_size);
 	}
 	close(fd);
 
@@ -749,6 +818,7 @@ static int fit_handle_file(struct image_tool_params *params)
 	char tmpfile[MKIMAGE_MAX_TMPFILE_LEN];
 	char bakfile[MKIMAGE_MAX_TMPFILE_LEN + 4] = {0};
 	char cmd[MKIMAGE_MAX_DTC_CMDLINE_LEN];
+	double start;
 	size_t size_inc;
 	int ret;
 
@@ -766,6 +836,7 @@ static int fit_handle_file(struct image_tool_params *params)
 	sprintf (tmpfile, "%s%s", params->imagefile, MKIMAGE_TMPFILE_SUFFIX);
 
 	/* We either compile the source file, or use the existing FIT image */
+	start = fit_time_ms();
 	if (params->auto_fit) {
 		if (fit_build(params, tmpfile)) {
 			fprintf(stderr, "%s: failed to build FIT\n",
@@ -792,10 +863,14 @@ static int fit_handle_file(struct image_tool_params *params)
 		goto err_system;
 	}
 
+	fit_timing.build = fit_time_ms() - start;
+
 	/* Move the data so it is internal to the FIT, if needed */
+	start = fit_time_ms();
 	ret = fit_import_data(params, tmpfile);
 	if (ret)
 		goto err_system;
+	fit_timing.import = fit_time_ms() - start;
 
 	/*
 	 * Copy the tmpfile to bakfile, then in the following loop
@@ -810,21 +885,27 @@ static int fit_handle_file(struct image_tool_params *params)
 	 * space in either FDT, so keep trying until we succeed.
 	 *
 	 * Note: this is pretty inefficient for signing, since we must
-	 * calculate the signature every time. It would be better to calculate
-	 * all the data and then store it in a separate step. However, this
-	 * would be considerably more complex to implement. Generally a few
-	 * steps of this loop is enough to sign with several keys.
+	 * calculate the signature every time. The hashes are only calculated
+	 * the first time (see fit_calc_hashes()), but it would be better to
+	 * calculate all the data and then store it in a separate step.
+	 * However, this would be considerably more complex to implement.
+	 * Generally a few steps of this loop is enough to sign with several
+	 * keys.
 	 */
+	start = fit_time_ms();
 	for (size_inc = 0; size_inc < 64 * 1024; size_inc += 1024) {
 		if (copyfile(bakfile, tmpfile) < 0) {
 			printf("Can't copy %s to %s\n", bakfile, tmpfile);
 			ret = -EIO;
 			break;
 		}
+		fit_timing.attempts++;
 		ret = fit_add_file_data(params, size_inc, tmpfile);
 		if (!ret || ret != -ENOSPC)
 			break;
 	}
+	fit_timing.add = fit_time_ms() - start - fit_timing.hash;
+	fit_free_hashes();
 
 	if (ret) {
 		fprintf(stderr, "%s Can't add hashes to FIT blob: %d\n",
@@ -834,9 +915,11 @@ static int fit_handle_file(struct image_tool_params *params)
 
 	/* Move the data so it is external to the FIT, if requested */
 	if (params->external_data) {
+		start = fit_time_ms();
 		ret = fit_extract_data(params, tmpfile);
 		if (ret)
 			goto err_system;
+		fit_timing.extract = fit_time_ms() - start;
 	}
 
 	if (rename (tmpfile, params->imagefile) == -1) {
@@ -849,6 +932,8 @@ static int fit_handle_file(struct image_tool_params *params)
 		return EXIT_FAILURE;
 	}
 	unlink(bakfile);
+	if (params->vflag)
+		fit_show_timing(params);
 	return EXIT_SUCCESS;
 
 err_system:
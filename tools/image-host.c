@@ -12,6 +12,7 @@
 #include <bootm.h>
 #include <fdt_region.h>
 #include <image.h>
+#include <pthread.h>
 #include <version.h>
 
 #if CONFIG_IS_ENABLED(FIT_SIGNATURE)
@@ -49,6 +50,202 @@ static int fit_set_hash_value(void *fit, int noffset, uint8_t *value,
 	return 0;
 }
 
+/**
+ * struct fit_host_hash - Hash of an image, calculated by fit_calc_hashes()
+ *
+ * @image_name: Name of the image node
+ * @node_name: Name of the hash node
+ * @algo: Hash algorithm
+ * @data: Data to hash, only valid while the hashes are being calculated
+ * @size: Size of data in bytes
+ * @value: Calculated hash value
+ * @value_len: Length of @value in bytes
+ * @ret: 0 if the hash was calculated, -ve on error
+ */
+struct fit_host_hash {
+	char *image_name;
+	char *node_name;
+	char *algo;
+	const void *data;
+	size_t size;
+	uint8_t value[FIT_MAX_HASH_LEN];
+	int value_len;
+	int ret;
+};
+
+/**
+ * struct fit_host_hashes - Hashes calculated ahead of adding them to the FIT
+ *
+ * @hashes: Hashes, one for each hash node
+ * @count: Number of hashes
+ * @next: Next hash to be calculated by a thread
+ * @lock: Protects @next
+ */
+static struct fit_host_hashes {
+	struct fit_host_hash *hashes;
+	int count;
+	int next;
+	pthread_mutex_t lock;
+} fit_host_hashes = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static void *fit_hash_thread(void *arg)
+{
+	struct fit_host_hashes *hh = arg;
+
+	while (true) {
+		struct fit_host_hash *hash;
+
+		pthread_mutex_lock(&hh->lock);
+		hash = hh->next < hh->count ? &hh->hashes[hh->next++] : NULL;
+		pthread_mutex_unlock(&hh->lock);
+		if (!hash)
+			break;
+		if (!hash->ret && calculate_hash(hash->data, hash->size, hash->algo,
+				   hash->value, &hash->value_len))
+			hash->ret = -EPROTONOSUPPORT;
+	}
+
+	return NULL;
+}
+
+static bool fit_image_has_cipher(const void *fit, int image_noffset)
+{
+	return fdt_subnode_offset(fit, image_noffset, FIT_CIPHER_NODENAME) >= 0;
+}
+
+int fit_calc_hashes(const void *fit, int threads)
+{
+	struct fit_host_hashes *hh = &fit_host_hashes;
+	int images_noffset, image_noffset, noffset;
+	struct fit_host_hash *hashes, *hash;
+	pthread_t *tids;
+	int count, pass, i;
+	const void *data;
+	const char *algo;
+	size_t size;
+
+	/* The hashes are already known if this is a retry */
+	if (hh->hashes)
+		return 0;
+
+	images_noffset = fdt_path_offset(fit, FIT_IMAGES_PATH);
+	if (images_noffset < 0)
+		return 0;
+
+	/* Count the hash nodes in the first pass, fill them in the second */
+	hashes = NULL;
+	for (pass = 0; pass < 2; pass++) {
+		count = 0;
+		fdt_for_each_subnode(image_noffset, fit, images_noffset) {
+			if (fit_image_has_cipher(fit, image_noffset) ||
+			    fit_image_get_data(fit, image_noffset, &data,
+					       &size))
+				continue;
+			fdt_for_each_subnode(noffset, fit, image_noffset) {
+				if (strncmp(fit_get_name(fit, noffset, NULL),
+					    FIT_HASH_NODENAME,
+					    strlen(FIT_HASH_NODENAME)) ||
+				    fit_image_hash_get_algo(fit, noffset,
+							    &algo))
+					continue;
+				if (hashes) {
+					hash = &hashes[count];
+					hash->image_name = strdup(fit_get_name(
+						fit, image_noffset, NULL));
+					hash->node_name = strdup(fit_get_name(
+						fit, noffset, NULL));
+					hash->algo = strdup(algo);
+					if (!hash->image_name ||
+					    !hash->node_name || !hash->algo)
+						hash->ret = -ENOMEM;
+					hash->data = data;
+					hash->size = size;
+				}
+				count++;
+			}
+		}
+		if (!count)
+			return 0;
+		if (!hashes) {
+			hashes = calloc(count, sizeof(*hashes));
+			if (!hashes)
+				return -ENOMEM;
+		}
+	}
+	hh->hashes = hashes;
+	hh->count = count;
+	hh->next = 0;
+
+	if (!threads)
+		threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads > count)
+		threads = count;
+	tids = threads > 1 ? calloc(threads, sizeof(*tids)) : NULL;
+
+	/* Fall back to using just this thread if others cannot be started */
+	for (i = 0; tids && i < threads; i++) {
+		if (pthread_create(&tids[i], NULL, fit_hash_thread, hh))
+			break;
+	}
+	fit_hash_thread(hh);
+	while (i--)
+		pthread_join(tids[i], NULL);
+	free(tids);
+
+	/* The data is not kept mapped, so don't keep pointers to it */
+	for (i = 0; i < count; i++)
+		hashes[i].data = NULL;
+
+	return count;
+}
+
+void fit_free_hashes(void)
+{
+	struct fit_host_hashes *hh = &fit_host_hashes;
+	int i;
+
+	for (i = 0; i < hh->count; i++) {
+		free(hh->hashes[i].image_name);
+		free(hh->hashes[i].node_name);
+		free(hh->hashes[i].algo);
+	}
+	free(hh->hashes);
+	hh->hashes = NULL;
+	hh->count = 0;
+}
+
+/**
+ * fit_get_calc_hash() - Get a hash calculated by fit_calc_hashes()
+ *
+ * @image_name: Name of the image node
+ * @node_name: Name of the hash node
+ * @algo: Hash algorithm
+ * @size: Size of the image data
+ * Return: hash, or NULL if it must be calculated
+ */
+static const struct fit_host_hash *fit_get_calc_hash(const char *image_name,
+						     const char *node_name,
+						     const char *algo,
+						     size_t size)
+{
+	struct fit_host_hashes *hh = &fit_host_hashes;
+	int i;
+
+	for (i = 0; i < hh->count; i++) {
+		const struct fit_host_hash *hash = &hh->hashes[i];
+
+		if (!hash->ret && hash->size == size &&
+		    !strcmp(hash->image_name, image_name) &&
+		    !strcmp(hash->node_name, node_name) &&
+		    !strcmp(hash->algo, algo))
+			return hash;
+	}
+
+	return NULL;
+}
+
 /**
  * fit_image_process_hash - Process a single subnode of the images/ node
  *
@@ -65,6 +262,7 @@ static int fit_set_hash_value(void *fit, int noffset, uint8_t *value,
 static int fit_image_process_hash(void *fit, const char *image_name,
 		int noffset, const void *data, size_t size)
 {
+	const struct fit_host_hash *hash;
 	uint8_t value[FIT_MAX_HASH_LEN];
 	const char *node_name;
 	int value_len;
@@ -80,7 +278,11 @@ static int fit_image_process_hash(void *fit, const char *image_name,
 		return -ENOENT;
 	}
 
-	if (calculate_hash(data, size, algo, value, &value_len)) {
+	hash = fit_get_calc_hash(image_name, node_name, algo, size);
+	if (hash) {
+		memcpy(value, hash->value, hash->value_len);
+		value_len = hash->value_len;
+	} else if (calculate_hash(data, size, algo, value, &value_len)) {
 		fprintf(stderr,
 			"Unsupported hash algorithm (%s) for '%s' hash node in '%s' image node\n",
 			algo, node_name, image_name);
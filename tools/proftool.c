@@ -58,6 +58,7 @@ enum {
 	LEN_STACK_SIZE	= 4,		/* number of nested length fix-ups */
 	TRACE_PAGE_MASK	= TRACE_PAGE_SIZE - 1,
 	MAX_STACK_DEPTH	= 50,		/* Max nested function calls */
+	MAX_SAMPLE_DEPTH = 256,		/* Max stack frames in a sample */
 	MAX_LINE_LEN	= 500,		/* Max characters per line */
 };
 
@@ -70,6 +71,9 @@ enum {
  * @OUT_FMT_FLAMEGRAPH_CALLS: Write a file suitable for flamegraph.pl
  * @OUT_FMT_FLAMEGRAPH_TIMING: Write a file suitable for flamegraph.pl with the
  * counts set to the number of microseconds used by each function
+ * @OUT_FMT_FLAMEGRAPH_SAMPLES: Write a file suitable for flamegraph.pl using the
+ * samples from U-Boot's sampling profiler, with the counts set to the number
+ * of samples taken in each call stack
  */
 enum out_format_t {
 	OUT_FMT_DEFAULT,
@@ -77,6 +81,7 @@ enum out_format_t {
 	OUT_FMT_FUNCGRAPH,
 	OUT_FMT_FLAMEGRAPH_CALLS,
 	OUT_FMT_FLAMEGRAPH_TIMING,
+	OUT_FMT_FLAMEGRAPH_SAMPLES,
 };
 
 /* Section types for v7 format (trace-cmd format) */
@@ -253,7 +258,11 @@ struct func_info *func_list;
 
 int func_count;			/* number of functions */
 struct trace_call *call_list;	/* list of all calls in the input trace file */
+ulong *call_times;		/* timestamp of each call in microseconds */
 int call_count;			/* number of calls */
+uint32_t *sample_list;		/* samples from the sampling profiler */
+size_t sample_words;		/* number of words in sample_list */
+int sample_count;		/* number of samples */
 int verbose;	/* Verbosity level 0=none, 1=warn, 2=notice, 3=info, 4=debug */
 ulong text_offset;		/* text address of first function */
 ulong text_base;		/* CONFIG_TEXT_BASE from trace file */
@@ -292,7 +301,8 @@ static void usage(void)
 		"   -f <subtype>\tSpecify output subtype\n"
 		"   -m <map>\tSpecify System.map file\n"
 		"   -o <fname>\tSpecify output file\n"
-		"   -t <fname>\tSpecify trace data file (from U-Boot 'trace calls')\n"
+		"   -t <fname>\tSpecify trace data file (from U-Boot 'trace calls' or\n"
+		"\t\t'profile samples')\n"
 		"   -v <0-4>\tSpecify verbosity\n"
 		"\n"
 		"Subtypes for dump-ftrace:\n"
@@ -301,7 +311,8 @@ static void usage(void)
 		"\n"
 		"Subtypes for dump-flamegraph\n"
 		"   calls - create a flamegraph of stack frames\n"
-		"   timing - create a flamegraph of microseconds for each stack frame\n");
+		"   timing - create a flamegraph of microseconds for each stack frame\n"
+		"   samples - create a flamegraph from sampling-profiler samples\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -449,10 +460,81 @@ static struct func_info *find_caller_by_offset(uint offset)
 		else
 			return &func_list[mid];
 	}
+	if (high > low && h_cmp_offset(&key, &func_list[high]) >= 0)
+		return &func_list[high];
 
 	return low >= 0 ? &func_list[low] : NULL;
 }
 
+/**
+ * ticks_to_us() - Convert a timestamp from ticks to microseconds
+ *
+ * @ticks: Timestamp in ticks
+ * @tick_rate: Tick rate in Hz, or 0 if the timestamp is already in us
+ * Returns: timestamp in microseconds
+ */
+static uint64_t ticks_to_us(uint64_t ticks, uint64_t tick_rate)
+{
+	if (!tick_rate)
+		return ticks;
+
+	/* split the calculation so that it cannot overflow */
+	return ticks / tick_rate * 1000000 +
+		ticks % tick_rate * 1000000 / tick_rate;
+}
+
+/**
+ * calc_call_times() - Work out the full timestamp of each call
+ *
+ * Each call only holds the bottom 30 bits of its timestamp. U-Boot emits a
+ * FUNCF_TIME_HI record with the upper bits whenever they change, so use these
+ * to rebuild the full timestamp, then drop them from call_list so that
+ * nothing else needs to know about them.
+ *
+ * If the trace buffer wrapped, the calls before the first resync record are
+ * assumed to be in the period just before it.
+ *
+ * @tick_rate: Tick rate in Hz, or 0 if timestamps are in us
+ * Returns: 0 if OK, -1 on error
+ */
+static int calc_call_times(uint64_t tick_rate)
+{
+	struct trace_call *call;
+	uint64_t hi = 0;
+	int i, upto;
+
+	call_times = calloc(call_count, sizeof(*call_times));
+	if (!call_times) {
+		error("Cannot allocate call_times\n");
+		return -1;
+	}
+
+	for (i = 0, call = call_list; i < call_count; i++, call++) {
+		if (TRACE_CALL_TYPE(call) == FUNCF_TIME_HI) {
+			hi = call->func | (uint64_t)call->caller << 32;
+			if (hi)
+				hi--;
+			break;
+		}
+	}
+
+	for (i = 0, upto = 0, call = call_list; i < call_count; i++, call++) {
+		uint64_t timestamp;
+
+		if (TRACE_CALL_TYPE(call) == FUNCF_TIME_HI) {
+			hi = call->func | (uint64_t)call->caller << 32;
+			continue;
+		}
+		timestamp = hi << 30 | (call->flags & FUNCF_TIMESTAMP_MASK);
+		call_times[upto] = ticks_to_us(timestamp, tick_rate);
+		call_list[upto++] = *call;
+	}
+	notice("resync records: %d\n", call_count - upto);
+	call_count = upto;
+
+	return 0;
+}
+
 /**
  * read_calls() - Read the list of calls from the trace data
  *
@@ -460,9 +542,10 @@ static struct func_info *find_caller_by_offset(uint offset)
  *
  * @fin: File to read from
  * @count: Number of calls to read
+ * @tick_rate: Tick rate in Hz, or 0 if timestamps are in us
  * Returns: 0 if OK, -1 on error
  */
-static int read_calls(FILE *fin, size_t count)
+static int read_calls(FILE *fin, size_t count, uint64_t tick_rate)
 {
 	struct trace_call *call_data;
 	int i;
@@ -480,6 +563,52 @@ static int read_calls(FILE *fin, size_t count)
 		if (read_data(fin, call_data, sizeof(*call_data)))
 			return -1;
 	}
+
+	return calc_call_times(tick_rate);
+}
+
+/**
+ * read_samples() - Read the samples from the sampling profiler
+ *
+ * Each sample is a depth followed by that number of function offsets, starting
+ * with the leaf function. They are stored in sample_list in the same form.
+ *
+ * @fin: File to read from
+ * @count: Number of samples to read
+ * Returns: 0 if OK, -1 on error
+ */
+static int read_samples(FILE *fin, size_t count)
+{
+	size_t size = sample_words;
+	int i;
+
+	notice("sample count: %zu\n", count);
+	for (i = 0; i < count; i++) {
+		uint32_t depth;
+
+		if (read_data(fin, &depth, sizeof(depth)))
+			return -1;
+		if (!depth || depth > MAX_SAMPLE_DEPTH) {
+			error("Invalid sample depth %u\n", depth);
+			return -1;
+		}
+		if (sample_words + 1 + depth > size) {
+			size = (size + 1 + depth) * 2;
+			sample_list = realloc(sample_list,
+					      size * sizeof(*sample_list));
+			if (!sample_list) {
+				error("Cannot allocate sample_list\n");
+				return -1;
+			}
+		}
+		sample_list[sample_words++] = depth;
+		if (read_data(fin, sample_list + sample_words,
+			      depth * sizeof(*sample_list)))
+			return -1;
+		sample_words += depth;
+	}
+	sample_count += count;
+
 	return 0;
 }
 
@@ -512,7 +641,12 @@ static int read_trace(FILE *fin)
 			break;
 
 		case TRACE_CHUNK_CALLS:
-			if (read_calls(fin, hdr.rec_count))
+			if (read_calls(fin, hdr.rec_count, hdr.tick_rate))
+				return 1;
+			break;
+
+		case TRACE_CHUNK_SAMPLES:
+			if (read_samples(fin, hdr.rec_count))
 				return 1;
 			break;
 		}
@@ -1363,8 +1497,7 @@ static int write_pages(struct twriter *tw, enum out_format_t out_format,
 		else /* 2 header words and then 3 or 8 others */
 			rec_words = 2 + (entry ? 3 : 8);
 
-		/* convert timestamp from us to ns */
-		timestamp = call->flags & FUNCF_TIMESTAMP_MASK;
+		timestamp = call_times[i];
 		if (in_page) {
 			if (page_upto + rec_words * 4 > TRACE_PAGE_SIZE) {
 				if (finish_page(tw))
@@ -1635,6 +1768,38 @@ static struct flame_node *create_node(const char *msg)
 	return node;
 }
 
+/**
+ * get_child() - Get the child node for a function, creating it if needed
+ *
+ * @state: Current flamegraph state
+ * @node: Parent node
+ * @func: Function to look for
+ * Returns: Child node, or NULL if out of memory
+ */
+static struct flame_node *get_child(struct flame_state *state,
+				    struct flame_node *node,
+				    struct func_info *func)
+{
+	struct flame_node *child;
+
+	/* see if we have this as a child node already */
+	list_for_each_entry(child, &node->child_head, sibling_node) {
+		if (child->func == func)
+			return child;
+	}
+
+	/* create a new node */
+	child = create_node("child");
+	if (!child)
+		return NULL;
+	list_add_tail(&child->sibling_node, &node->child_head);
+	child->func = func;
+	child->parent = node;
+	state->nodes++;
+
+	return child;
+}
+
 /**
  * process_call(): Add a call to the flamegraph info
  *
@@ -1658,26 +1823,11 @@ static int process_call(struct flame_state *state, bool entry, ulong timestamp,
 	int stack_ptr = state->stack_ptr;
 
 	if (entry) {
-		struct flame_node *child, *chd;
-
-		/* see if we have this as a child node already */
-		child = NULL;
-		list_for_each_entry(chd, &node->child_head, sibling_node) {
-			if (chd->func == func) {
-				child = chd;
-				break;
-			}
-		}
-		if (!child) {
-			/* create a new node */
-			child = create_node("child");
-			if (!child)
-				return -1;
-			list_add_tail(&child->sibling_node, &node->child_head);
-			child->func = func;
-			child->parent = node;
-			state->nodes++;
-		}
+		struct flame_node *child;
+
+		child = get_child(state, node, func);
+		if (!child)
+			return -1;
 		debug("entry %s: move from %s to %s\n", func->name,
 		      node->func ? node->func->name : "(root)",
 		      child->func->name);
@@ -1755,7 +1905,7 @@ static int make_flame_tree(enum out_format_t out_format,
 
 	for (i = 0, call = call_list; i < call_count; i++, call++) {
 		bool entry = TRACE_CALL_TYPE(call) == FUNCF_ENTRY;
-		ulong timestamp = call->flags & FUNCF_TIMESTAMP_MASK;
+		ulong timestamp = call_times[i];
 		struct func_info *func;
 
 		func = find_func_by_offset(call->func);
@@ -1774,6 +1924,56 @@ static int make_flame_tree(enum out_format_t out_format,
 	return 0;
 }
 
+/**
+ * make_sample_tree() - Create a tree of stack traces from profiler samples
+ *
+ * This produces the same tree as make_flame_tree(), except that the count in
+ * each node is the number of samples taken with exactly that call stack, so
+ * only the nodes for the sampled functions have a count.
+ *
+ * @treep: Returns the resulting flamegraph tree
+ * Returns: 0 on success, -ve on error
+ */
+static int make_sample_tree(struct flame_node **treep)
+{
+	struct flame_state state;
+	struct flame_node *tree;
+	size_t pos;
+
+	tree = create_node("tree");
+	if (!tree)
+		return -1;
+	state.nodes = 0;
+
+	for (pos = 0; pos < sample_words; pos += 1 + sample_list[pos]) {
+		uint32_t depth = sample_list[pos];
+		struct flame_node *node = tree;
+		int i;
+
+		/* Samples start with the leaf, so work back from the caller */
+		for (i = depth - 1; i >= 0; i--) {
+			uint32_t offset = sample_list[pos + 1 + i];
+			struct func_info *func;
+
+			func = find_caller_by_offset(offset);
+			if (!func) {
+				warn("Cannot find function at %lx\n",
+				     text_offset + offset);
+				continue;
+			}
+			node = get_child(&state, node, func);
+			if (!node)
+				return -1;
+		}
+		node->count++;
+	}
+	fprintf(stderr, "%d nodes from %d samples\n", state.nodes,
+		sample_count);
+	*treep = tree;
+
+	return 0;
+}
+
 /**
  * output_tree() - Output a flamegraph tree
  *
@@ -1810,7 +2010,7 @@ static int output_tree(FILE *fout, enum out_format_t out_format,
 	char *str = abuf_data(str_buf);
 
 	if (node->count) {
-		if (out_format == OUT_FMT_FLAMEGRAPH_CALLS) {
+		if (out_format != OUT_FMT_FLAMEGRAPH_TIMING) {
 			fprintf(fout, "%s %d\n", str, node->count);
 		} else {
 			/*
@@ -1875,8 +2075,12 @@ static int make_flamegraph(FILE *fout, enum out_format_t out_format)
 	char *str;
 	int ret = 0;
 
-	if (make_flame_tree(out_format, &tree))
+	if (out_format == OUT_FMT_FLAMEGRAPH_SAMPLES) {
+		if (make_sample_tree(&tree))
+			return -1;
+	} else if (make_flame_tree(out_format, &tree)) {
 		return -1;
+	}
 
 	abuf_init(&str_buf);
 	if (!abuf_realloc(&str_buf, 500))
@@ -1937,9 +2141,13 @@ static int prof_tool(int argc, char *const argv[],
 		} else if (!strcmp(cmd, "dump-flamegraph")) {
 			FILE *fout;
 
+			/* Use the samples if there is no call trace */
 			if (out_format != OUT_FMT_FLAMEGRAPH_CALLS &&
-			    out_format != OUT_FMT_FLAMEGRAPH_TIMING)
-				out_format = OUT_FMT_FLAMEGRAPH_CALLS;
+			    out_format != OUT_FMT_FLAMEGRAPH_TIMING &&
+			    out_format != OUT_FMT_FLAMEGRAPH_SAMPLES)
+				out_format = sample_count && !call_count ?
+					OUT_FMT_FLAMEGRAPH_SAMPLES :
+					OUT_FMT_FLAMEGRAPH_CALLS;
 			fout = fopen(out_fname, "w");
 			if (!fout) {
 				fprintf(stderr, "Cannot write file '%s'\n",
@@ -1980,9 +2188,11 @@ int main(int argc, char *argv[])
 				out_format = OUT_FMT_FLAMEGRAPH_CALLS;
 			} else if (!strcmp("timing", optarg)) {
 				out_format = OUT_FMT_FLAMEGRAPH_TIMING;
+			} else if (!strcmp("samples", optarg)) {
+				out_format = OUT_FMT_FLAMEGRAPH_SAMPLES;
 			} else {
 				fprintf(stderr,
-					"Invalid format: use function, funcgraph, calls, timing\n");
+					"Invalid format: use function, funcgraph, calls, timing, samples\n");
 				exit(1);
 			}
 			break;